@@ -102,8 +102,8 @@ void loop() {
   SerialCommands::update();
   
   #ifdef HAS_PUBNUB
-  // Note: PubNubManager::loop() ne fait plus rien - le thread gère tout
-  // On garde l'appel pour compatibilité mais il est vide
+  // Le thread PubNub gère le réseau ; loop() met le journal hors ligne sur la SD
+  // tant que le thread ne tourne pas
   PubNubManager::loop();
   
   // Vérifier si PubNub doit se connecter automatiquement quand le WiFi devient disponible
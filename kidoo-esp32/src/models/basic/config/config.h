@@ -31,6 +31,13 @@
 // La plupart des WS2812B utilisent GRB
 #define COLOR_ORDER GRB
 
+// Effets LED compilés dans le firmware (registre compile-time)
+// Les effets non listés ne sont pas liés ; LED_EFFECT_NONE est toujours disponible
+#define HAS_LED_EFFECT_RAINBOW true
+#define HAS_LED_EFFECT_PULSE true
+#define HAS_LED_EFFECT_GLOSSY true
+#define HAS_LED_EFFECT_ROTATE true
+
 // ============================================
 // Configuration de la carte SD (SPI)
 // ============================================
@@ -1,9 +1,13 @@
 #include "model_pubnub_routes.h"
 #include "../../common/managers/led/led_manager.h"
+#include "../../common/managers/led/led_names.h"
+#include "../../common/managers/led/led_latency.h"
 #include "../../common/managers/init/init_manager.h"
 #include "../../common/managers/wifi/wifi_manager.h"
 #include "../../common/managers/pubnub/pubnub_manager.h"
 #include "../../common/managers/sd/sd_manager.h"
+#include "../../common/managers/config/config_manager.h"
+#include "../../common/managers/log/log_manager.h"
 #include "../../common/managers/nfc/nfc_manager.h"
 #include "../../common/utils/mac_utils.h"
 
@@ -11,6 +15,10 @@
  * Routes PubNub spécifiques au modèle Kidoo Basic
  */
 
+// Table des actions (voir le header)
+constexpr PubNubRoute ModelBasicPubNubRoutes::ROUTES[];
+const size_t ModelBasicPubNubRoutes::ROUTE_COUNT;
+
 bool ModelBasicPubNubRoutes::processMessage(const JsonObject& json) {
   // Vérifier que l'action est présente
   if (!json["action"].is<const char*>()) {
@@ -27,21 +35,10 @@ bool ModelBasicPubNubRoutes::processMessage(const JsonObject& json) {
   Serial.print("[PUBNUB-ROUTE] Traitement de l'action: ");
   Serial.println(action);
   
-  // Router vers le bon handler
-  if (strcmp(action, "get-info") == 0 || strcmp(action, "getinfo") == 0) {
-    return handleGetInfo(json);
-  }
-  else if (strcmp(action, "brightness") == 0) {
-    return handleBrightness(json);
-  }
-  else if (strcmp(action, "sleep-timeout") == 0 || strcmp(action, "sleeptimeout") == 0 || strcmp(action, "sleep") == 0) {
-    return handleSleepTimeout(json);
-  }
-  else if (strcmp(action, "reboot") == 0 || strcmp(action, "restart") == 0) {
-    return handleReboot(json);
-  }
-  else if (strcmp(action, "led") == 0) {
-    return handleLed(json);
+  // Router vers le bon handler (recherche dichotomique dans la table triée)
+  const PubNubRoute* route = findNamed(ROUTES, ROUTE_COUNT, action);
+  if (route != nullptr) {
+    return route->value(json);
   }
   
   Serial.print("[PUBNUB-ROUTE] Action inconnue: ");
@@ -55,7 +52,16 @@ bool ModelBasicPubNubRoutes::handleGetInfo(const JsonObject& json) {
   
   Serial.println("[PUBNUB-ROUTE] get-info: Préparation des informations du Kidoo...");
   
-  SDConfig config = SDManager::getConfig();
+  // Champs copiés : les lectures SD qui suivent peuvent durer
+  char wifiSsid[sizeof(SDConfig::wifi_ssid)];
+  uint8_t ledBrightness;
+  uint32_t sleepTimeoutMs;
+  ConfigManager::read([&](const SDConfig& config) {
+    strncpy(wifiSsid, config.wifi_ssid, sizeof(wifiSsid) - 1);
+    wifiSsid[sizeof(wifiSsid) - 1] = '\0';
+    ledBrightness = config.led_brightness;
+    sleepTimeoutMs = config.sleep_timeout_ms;
+  });
   
   // Récupérer les infos de stockage
   uint64_t totalBytes = 0;
@@ -75,9 +81,15 @@ bool ModelBasicPubNubRoutes::handleGetInfo(const JsonObject& json) {
     strcpy(macStr, "00:00:00:00:00:00"); // Valeur par défaut en cas d'erreur
   }
   
+  // Latence commande -> LED par source (ms), objet vide si rien n'a été mesuré
+  char latencyJson[256];
+  if (LEDLatency::formatJson(latencyJson, sizeof(latencyJson)) == 0) {
+    strcpy(latencyJson, "{}");
+  }
+  
   // Construire le JSON de réponse
   // Note: On utilise un buffer assez grand pour toutes les infos
-  char infoJson[512];
+  char infoJson[768];
   snprintf(infoJson, sizeof(infoJson),
     "{"
       "\"type\":\"info\","
@@ -100,24 +112,26 @@ bool ModelBasicPubNubRoutes::handleGetInfo(const JsonObject& json) {
       "},"
       "\"nfc\":{"
         "\"available\":%s"
-      "}"
+      "},"
+      "\"latency\":%s"
     "}",
     DEFAULT_DEVICE_NAME,
     macStr,
     WiFiManager::getLocalIP().c_str(),
     millis() / 1000,  // uptime en secondes
     ESP.getFreeHeap(),
-    config.wifi_ssid,
+    wifiSsid,
     WiFiManager::getRSSI(),
-    (config.led_brightness * 100 + 127) / 255,  // brightness en % avec arrondi correct
-    config.sleep_timeout_ms,
+    (ledBrightness * 100 + 127) / 255,  // brightness en % avec arrondi correct
+    (unsigned long)sleepTimeoutMs,
     totalBytes,
     freeBytes,
     usedBytes,
-    NFCManager::isAvailable() ? "true" : "false"
+    NFCManager::isAvailable() ? "true" : "false",
+    latencyJson
   );
   
-  if (PubNubManager::publish(infoJson)) {
+  if (PubNubManager::publish(infoJson, PUBLISH_PRIORITY_CRITICAL)) {
     Serial.println("[PUBNUB-ROUTE] get-info: Informations publiees avec succes");
   } else {
     Serial.println("[PUBNUB-ROUTE] get-info: Erreur lors de la publication des informations");
@@ -164,9 +178,7 @@ bool ModelBasicPubNubRoutes::handleBrightness(const JsonObject& json) {
     Serial.println("%");
     
     // Sauvegarder dans la config
-    SDConfig config = SDManager::getConfig();
-    config.led_brightness = brightness;
-    SDManager::saveConfig(config);
+    ConfigManager::update([&](SDConfig& config) { config.led_brightness = brightness; });
     
     return true;
   }
@@ -212,9 +224,7 @@ bool ModelBasicPubNubRoutes::handleSleepTimeout(const JsonObject& json) {
     timeout = 300000;
   }
   
-  SDConfig config = SDManager::getConfig();
-  config.sleep_timeout_ms = timeout;
-  SDManager::saveConfig(config);
+  ConfigManager::update([&](SDConfig& config) { config.sleep_timeout_ms = timeout; });
   
   if (timeout == 0) {
     Serial.println("[PUBNUB-ROUTE] Sleep mode desactive");
@@ -254,6 +264,9 @@ bool ModelBasicPubNubRoutes::handleReboot(const JsonObject& json) {
     Serial.println("[PUBNUB-ROUTE] Redemarrage immediat");
   }
   
+  // Sauvegarde de configuration et logs d'erreur encore en attente (écriture différée)
+  ConfigManager::flush();
+  LogManager::flush();
   ESP.restart();
   
   return true;  // Ne sera jamais atteint
@@ -271,24 +284,11 @@ bool ModelBasicPubNubRoutes::handleLed(const JsonObject& json) {
     const char* colorStr = json["color"].as<const char*>();
     uint8_t r = 0, g = 0, b = 0;
     
-    if (colorStr[0] == '#' && strlen(colorStr) == 7) {
-      // Format hex #RRGGBB
-      long hexColor = strtol(colorStr + 1, nullptr, 16);
-      r = (hexColor >> 16) & 0xFF;
-      g = (hexColor >> 8) & 0xFF;
-      b = hexColor & 0xFF;
+    // Format hex #RRGGBB ou nom (red, green, blue, etc.) ; couleur inconnue = éteint
+    if (!ledColorFromName(colorStr, r, g, b)) {
+      Serial.print("[PUBNUB-ROUTE] Couleur inconnue: ");
+      Serial.println(colorStr);
     }
-    else if (strcmp(colorStr, "red") == 0) { r = 255; g = 0; b = 0; }
-    else if (strcmp(colorStr, "green") == 0) { r = 0; g = 255; b = 0; }
-    else if (strcmp(colorStr, "blue") == 0) { r = 0; g = 0; b = 255; }
-    else if (strcmp(colorStr, "white") == 0) { r = 255; g = 255; b = 255; }
-    else if (strcmp(colorStr, "yellow") == 0) { r = 255; g = 255; b = 0; }
-    else if (strcmp(colorStr, "cyan") == 0) { r = 0; g = 255; b = 255; }
-    else if (strcmp(colorStr, "magenta") == 0) { r = 255; g = 0; b = 255; }
-    else if (strcmp(colorStr, "orange") == 0) { r = 255; g = 165; b = 0; }
-    else if (strcmp(colorStr, "purple") == 0) { r = 128; g = 0; b = 128; }
-    else if (strcmp(colorStr, "pink") == 0) { r = 255; g = 192; b = 203; }
-    // off/black = 0,0,0 (déjà initialisé)
     
     LEDManager::setColor(r, g, b);
     Serial.print("[PUBNUB-ROUTE] Couleur: ");
@@ -301,17 +301,16 @@ bool ModelBasicPubNubRoutes::handleLed(const JsonObject& json) {
     const char* effectStr = json["effect"].as<const char*>();
     LEDEffect effect = LED_EFFECT_NONE;
     
-    if (strcmp(effectStr, "none") == 0 || strcmp(effectStr, "solid") == 0) effect = LED_EFFECT_NONE;
-    else if (strcmp(effectStr, "pulse") == 0) effect = LED_EFFECT_PULSE;
-    else if (strcmp(effectStr, "rotate") == 0) effect = LED_EFFECT_ROTATE;
-    else if (strcmp(effectStr, "rainbow") == 0) effect = LED_EFFECT_RAINBOW;
-    else if (strcmp(effectStr, "glossy") == 0) effect = LED_EFFECT_GLOSSY;
-    else if (strcmp(effectStr, "off") == 0) {
+    if (strcmp(effectStr, "off") == 0) {
       // Éteindre les LEDs
       LEDManager::clear();
       Serial.println("[PUBNUB-ROUTE] LEDs eteintes");
       return true;
     }
+    if (!ledEffectFromName(effectStr, effect)) {
+      Serial.print("[PUBNUB-ROUTE] Effet inconnu: ");
+      Serial.println(effectStr);
+    }
     
     LEDManager::setEffect(effect);
     Serial.print("[PUBNUB-ROUTE] Effet: ");
@@ -337,3 +336,7 @@ void ModelBasicPubNubRoutes::printRoutes() {
   Serial.println("{ \"action\": \"led\", \"effect\": \"none|pulse|rotate|rainbow|glossy|off\" }");
   Serial.println("==========================================");
 }
+
+void ModelBasicPubNubRoutes::benchmarkRoutes() {
+  pubnubBenchmarkRoutes(ROUTES, ROUTE_COUNT);
+}
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "../../common/managers/pubnub/pubnub_routes.h"
 
 /**
  * Routes PubNub spécifiques au modèle Kidoo Basic
@@ -35,6 +36,11 @@ public:
    * Afficher les routes disponibles
    */
   static void printRoutes();
+  
+  /**
+   * Mesurer le coût du dispatch des actions (commande "pubnub-routes bench")
+   */
+  static void benchmarkRoutes();
 
 private:
   // Handlers pour chaque action
@@ -43,6 +49,21 @@ private:
   static bool handleSleepTimeout(const JsonObject& json);
   static bool handleReboot(const JsonObject& json);
   static bool handleLed(const JsonObject& json);
+  
+  // Actions -> handlers, triées par nom (alias compris)
+  static constexpr PubNubRoute ROUTES[] = {
+    {"brightness",     handleBrightness},
+    {"get-info",       handleGetInfo},
+    {"getinfo",        handleGetInfo},
+    {"led",            handleLed},
+    {"reboot",         handleReboot},
+    {"restart",        handleReboot},
+    {"sleep",          handleSleepTimeout},
+    {"sleep-timeout",  handleSleepTimeout},
+    {"sleeptimeout",   handleSleepTimeout},
+  };
+  static const size_t ROUTE_COUNT = sizeof(ROUTES) / sizeof(ROUTES[0]);
+  static_assert(isNameTableSorted(ROUTES), "ROUTES doit etre trie par nom");
 };
 
 #endif // MODEL_BASIC_PUBNUB_ROUTES_H
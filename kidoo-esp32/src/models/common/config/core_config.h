@@ -71,6 +71,8 @@
   #define CORE_BLE          0
   #define CORE_AUDIO        0
   #define CORE_MAIN         0
+  #define CORE_CONFIG_WRITER 0
+  #define CORE_LOG_WRITER   0
 #else
   // ESP32/S3 Dual-core :
   // Core 0 : WiFi stack + Réseau + BLE + LED (tâches moins critiques)
@@ -79,6 +81,8 @@
   #define CORE_WIFI_RETRY   0   // WiFi retry thread
   #define CORE_BLE          0   // BLE sur Core 0 (partage avec WiFi, même radio)
   #define CORE_LED          0   // LEDManager sur Core 0 (FastLED désactive les interruptions)
+  #define CORE_CONFIG_WRITER 0  // Écriture différée de config.json (SD, loin de l'audio)
+  #define CORE_LOG_WRITER   0   // Écriture des logs d'erreur sur la SD
 
   // Core 1 : Audio uniquement (temps-réel critique, isolé)
   #define CORE_AUDIO        1   // AudioManager (I2S, DOIT être isolé des LEDs)
@@ -96,6 +100,8 @@
   #define PRIORITY_PUBNUB     2   // Réseau
   #define PRIORITY_BLE_COMMAND 2  // Traitement commandes BLE (même priorité que PubNub)
   #define PRIORITY_WIFI_RETRY 1   // Background
+  #define PRIORITY_CONFIG_WRITER 1 // Background
+  #define PRIORITY_LOG_WRITER 1   // Background
 #else
   // Dual-core : Plus de marge car les tâches sont réparties
   // Audio a la priorité maximale pour éviter les claquements
@@ -104,6 +110,8 @@
   #define PRIORITY_PUBNUB     2   // Basse - réseau non critique
   #define PRIORITY_BLE_COMMAND 2  // Traitement commandes BLE (même priorité que PubNub)
   #define PRIORITY_WIFI_RETRY 1   // Très basse - retry en background
+  #define PRIORITY_CONFIG_WRITER 1 // Très basse - écriture différée de config.json
+  #define PRIORITY_LOG_WRITER 1   // Très basse - écriture des logs par blocs
 #endif
 
 // ============================================
@@ -118,6 +126,25 @@
   #define USE_PSRAM_FOR_LED_BUFFER    false
 #endif
 
+// ============================================
+// Sortie LED
+// ============================================
+
+// Driver RMT asynchrone (API legacy ESP-IDF 4.x, framework Arduino 2.x) :
+// émission sans masquer les interruptions, compatible avec l'audio I2S à 60 FPS.
+// Sinon : Adafruit NeoPixel (show() bloquant, limité à ~30 FPS).
+#include <esp_idf_version.h>
+#if defined(ESP_IDF_VERSION_MAJOR) && ESP_IDF_VERSION_MAJOR < 5
+  #define LED_OUTPUT_USE_RMT          true
+#else
+  #define LED_OUTPUT_USE_RMT          false
+#endif
+
+// Sortie simulée qui enregistre les trames (tests sur PC, défini par l'env native)
+#ifndef LED_OUTPUT_USE_MOCK
+  #define LED_OUTPUT_USE_MOCK         false
+#endif
+
 // ============================================
 // Tailles de stack des tâches (en bytes)
 // ============================================
@@ -127,6 +154,8 @@
 #define STACK_SIZE_PUBNUB       8192    // PubNubManager (HTTP + JSON)
 #define STACK_SIZE_WIFI_RETRY   4096    // WiFi retry
 #define STACK_SIZE_BLE_COMMAND  8192    // Tâche de traitement des commandes BLE (JSON parsing, base64, etc.)
+#define STACK_SIZE_CONFIG_WRITER 6144   // Écriture différée de config.json (sérialisation JSON + SD)
+#define STACK_SIZE_LOG_WRITER   4096    // Écriture des logs d'erreur sur la SD (bloc statique)
 
 // ============================================
 // Helpers pour l'allocation mémoire
@@ -18,6 +18,11 @@
 #define DEFAULT_SLEEP_TIMEOUT_MS 10000   // 10 secondes par défaut
 #define MIN_SLEEP_TIMEOUT_MS 5000        // Minimum: 5 secondes
 #define SLEEP_FADE_DURATION_MS 1000      // Durée de l'animation de fade-out (1 seconde)
+#define LED_TRANSITION_DURATION_MS 400   // Fondu enchaîné entre deux effets / couleurs (0 = immédiat)
+
+// Heure des jours sans horaire de coucher / réveil (jour désactivé)
+#define DEFAULT_BEDTIME_HOUR 20
+#define DEFAULT_WAKEUP_HOUR 7
 
 // Version du firmware Kidoo
 #define FIRMWARE_VERSION "1.0.0"
@@ -1,6 +1,7 @@
 #include "../managers/init/init_manager.h"
 #include "../managers/led/led_manager.h"
 #include "../managers/sd/sd_manager.h"
+#include "../managers/config/config_manager.h"
 #include "../../../../../color/colors.h"
 #include "../../model_config.h"
 
@@ -27,7 +28,7 @@ bool InitManager::initLED() {
   // SAUF si pas de WiFi configuré : dans ce cas, BLE sera activé auto, donc pas de retour lumineux
   #ifdef HAS_WIFI
   if (HAS_WIFI) {
-    const SDConfig& config = InitManager::getConfig();
+    const SDConfig& config = ConfigManager::get();
     if (strlen(config.wifi_ssid) > 0) {
       // WiFi configuré -> orange pour indiquer l'init en cours
       LEDManager::setColor(COLOR_ORANGE);
@@ -1,6 +1,7 @@
 #include "../managers/init/init_manager.h"
 #include "../managers/wifi/wifi_manager.h"
 #include "../managers/sd/sd_manager.h"
+#include "../managers/config/config_manager.h"
 #include "../managers/rtc/rtc_manager.h"
 #include "../../model_config.h"
 
@@ -29,7 +30,7 @@ bool InitManager::initWiFi() {
   }
   
   // Tenter de se connecter au WiFi configuré
-  const SDConfig& config = InitManager::getConfig();
+  const SDConfig& config = ConfigManager::get();
   
   if (strlen(config.wifi_ssid) > 0) {
     Serial.print("[INIT] Tentative de connexion WiFi a: ");
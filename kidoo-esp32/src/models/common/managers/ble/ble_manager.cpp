@@ -3,6 +3,7 @@
 #include "commands/ble_command_handler.h"
 #include "../ble_config/ble_config_manager.h"
 #include "../../config/core_config.h"
+#include "../led/led_latency.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/queue.h>
@@ -26,6 +27,7 @@
 struct BLECommandMessage {
   char data[BLE_COMMAND_MAX_SIZE + 1];  // +1 pour le null terminator
   size_t length;
+  uint32_t receivedUs;  // Réception (micros()), pour la latence commande -> LED
 };
 
 // Variables statiques BLE (seulement si HAS_BLE est défini)
@@ -65,7 +67,11 @@ void bleCommandTask(void* parameter) {
         
         // Traiter la commande (avec une stack plus grande)
         Serial.println("[BLE-TASK] Appel de BLECommandHandler::handleCommand...");
-        bool result = BLECommandHandler::handleCommand(data);
+        bool result;
+        {
+          LEDLatencyScope latencyScope(LED_SOURCE_BLE, msg.receivedUs);
+          result = BLECommandHandler::handleCommand(data);
+        }
         Serial.print("[BLE-TASK] Resultat de handleCommand: ");
         Serial.println(result ? "true" : "false");
         
@@ -109,6 +115,7 @@ class MyCharacteristicCallbacks: public BLECharacteristicCallbacks {
     strncpy(msg.data, value.c_str(), BLE_COMMAND_MAX_SIZE);
     msg.data[BLE_COMMAND_MAX_SIZE] = '\0';  // Assurer le null terminator
     msg.length = value.length();
+    msg.receivedUs = micros();
     
     // Envoyer la commande à la queue (non-bloquant avec timeout de 0)
     // Si la queue est pleine, on ignore la commande (ne devrait pas arriver)
@@ -11,6 +11,7 @@
 #include "../../ble_config/ble_config_manager.h"
 #include "../../init/init_manager.h"
 #include "../../sd/sd_manager.h"  // Pour la définition complète de SDConfig
+#include "../../config/config_manager.h"
 #include "../../../config/default_config.h"  // Pour FIRMWARE_VERSION
 #include <ESP.h>
 
@@ -222,7 +223,7 @@ bool BLECommandHandler::handleCommand(const String& data) {
         }
         
         // Récupérer la configuration depuis la SD card
-        const SDConfig& config = InitManager::getConfig();
+        const SDConfig& config = ConfigManager::get();
         
         // Récupérer la version du firmware Kidoo (définie dans default_config.h)
         String firmwareVersion = FIRMWARE_VERSION;
@@ -2,6 +2,7 @@
 #include <ArduinoJson.h>
 #include "../../../init/init_manager.h"
 #include "../../../sd/sd_manager.h"
+#include "../../../config/config_manager.h"
 #include "../../../wifi/wifi_manager.h"
 #include "../../../led/led_manager.h"
 
@@ -126,21 +127,17 @@ bool BLESetupCommand::execute(const String& jsonData) {
       // Connexion réussie : sauvegarder la configuration
       Serial.println("[BLE-COMMAND] Connexion WiFi reussie! Sauvegarde de la configuration...");
       
-      // Récupérer la configuration actuelle
-      SDConfig config = InitManager::getConfig();
-      
-      // Mettre à jour le SSID et le password
-      strncpy(config.wifi_ssid, ssid.c_str(), sizeof(config.wifi_ssid) - 1);
-      config.wifi_ssid[sizeof(config.wifi_ssid) - 1] = '\0';
-      strncpy(config.wifi_password, password.c_str(), sizeof(config.wifi_password) - 1);
-      config.wifi_password[sizeof(config.wifi_password) - 1] = '\0';
-      
-      // Sauvegarder la configuration
+      // Sauvegarder la configuration (SSID et password mis à jour sur place)
       if (!SDManager::isAvailable()) {
         Serial.println("[BLE-COMMAND] ERREUR: Carte SD non disponible");
         WiFiManager::disconnect(); // Déconnecter car on ne peut pas sauvegarder
         wifiConnected = false;
-      } else if (!InitManager::updateConfig(config)) {
+      } else if (!ConfigManager::update([&ssid, &password](SDConfig& config) {
+                   strncpy(config.wifi_ssid, ssid.c_str(), sizeof(config.wifi_ssid) - 1);
+                   config.wifi_ssid[sizeof(config.wifi_ssid) - 1] = '\0';
+                   strncpy(config.wifi_password, password.c_str(), sizeof(config.wifi_password) - 1);
+                   config.wifi_password[sizeof(config.wifi_password) - 1] = '\0';
+                 })) {
         Serial.println("[BLE-COMMAND] ERREUR: Impossible de sauvegarder la configuration");
         WiFiManager::disconnect(); // Déconnecter car on ne peut pas sauvegarder
         wifiConnected = false;
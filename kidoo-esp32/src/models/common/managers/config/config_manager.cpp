@@ -0,0 +1,303 @@
+#include "config_manager.h"
+#include "config_snapshot.h"
+#include "../../config/core_config.h"
+#include <string.h>
+
+SDConfig ConfigManager::buffers[2];
+volatile uint8_t ConfigManager::active = 0;
+volatile uint32_t ConfigManager::generation = 0;
+SemaphoreHandle_t ConfigManager::writeMutex = nullptr;
+SemaphoreHandle_t ConfigManager::sdMutex = nullptr;
+TaskHandle_t ConfigManager::writerTaskHandle = nullptr;
+bool ConfigManager::pending = false;
+uint32_t ConfigManager::firstPendingMs = 0;
+uint32_t ConfigManager::lastChangeMs = 0;
+uint32_t ConfigManager::snapshots = 0;
+uint32_t ConfigManager::snapshotRetries = 0;
+uint32_t ConfigManager::saves = 0;
+uint32_t ConfigManager::sdWrites = 0;
+uint32_t ConfigManager::saveFailures = 0;
+uint32_t ConfigManager::bytesWritten = 0;
+uint32_t ConfigManager::writeUsTotal = 0;
+uint32_t ConfigManager::writeUsMax = 0;
+uint32_t ConfigManager::loadUs = 0;
+uint32_t ConfigManager::lastSaveUs = 0;
+const char* ConfigManager::source = "defaut";
+
+// Copie écrite sur la SD (les écrivains peuvent publier pendant l'écriture)
+static SDConfig writeCopy;
+
+void ConfigManager::init() {
+  if (writeMutex == nullptr) {
+    writeMutex = xSemaphoreCreateMutex();
+  }
+  if (sdMutex == nullptr) {
+    sdMutex = xSemaphoreCreateMutex();
+  }
+
+  unsigned long start = micros();
+  if (ConfigSnapshot::load(buffers[0])) {
+    loadUs = micros() - start;
+    source = "image binaire";
+  } else {
+    importJson(buffers[0]);  // Valeurs par défaut si pas de SD ou de fichier
+  }
+  active = 0;
+  generation = 1;
+
+  // Sans tâche, commitUpdate() écrit immédiatement (comportement d'avant)
+  if (writerTaskHandle == nullptr) {
+    BaseType_t result = xTaskCreatePinnedToCore(
+        writerTask,
+        "ConfigWriter",
+        STACK_SIZE_CONFIG_WRITER,
+        nullptr,
+        PRIORITY_CONFIG_WRITER,
+        &writerTaskHandle,
+        CORE_CONFIG_WRITER);
+    if (result != pdPASS) {
+      writerTaskHandle = nullptr;
+      Serial.println("[CONFIG] ERREUR: Impossible de creer la tache d'ecriture, ecritures immediates");
+    }
+  }
+}
+
+void ConfigManager::importJson(SDConfig& target) {
+  unsigned long start = micros();
+  target = SDManager::loadConfig();
+  loadUs = micros() - start;
+  source = target.valid ? "config.json" : "defaut";
+  // Prochain démarrage : une seule lecture au lieu du parsing JSON
+  if (target.valid) {
+    ConfigSnapshot::store(target);
+  }
+}
+
+const SDConfig& ConfigManager::get() {
+  return buffers[active];
+}
+
+void ConfigManager::snapshot(SDConfig& out) {
+  // Les écrivains ne touchent qu'au tampon inactif : si aucune bascule n'a eu
+  // lieu pendant la copie, le tampon copié est resté publié et intact
+  while (true) {
+    uint32_t before = generation;
+    __sync_synchronize();
+    uint8_t index = active;
+    memcpy(&out, &buffers[index], sizeof(SDConfig));
+    __sync_synchronize();
+    if (generation == before) {
+      break;
+    }
+    snapshotRetries++;
+  }
+  snapshots++;
+}
+
+uint32_t ConfigManager::getGeneration() {
+  return generation;
+}
+
+bool ConfigManager::save(const SDConfig& config) {
+  SDConfig& draft = beginUpdate();
+  draft = config;
+  return commitUpdate();
+}
+
+SDConfig& ConfigManager::beginUpdate() {
+  if (writeMutex != nullptr) {
+    xSemaphoreTake(writeMutex, portMAX_DELAY);
+  }
+  uint8_t next = active ^ 1;
+  buffers[next] = buffers[active];
+  return buffers[next];
+}
+
+bool ConfigManager::commitUpdate() {
+  // Publier : tampon complet d'abord, bascule ensuite
+  __sync_synchronize();
+  active ^= 1;
+  generation++;
+
+  // SD ensuite, en différé : les sauvegardes rapprochées ne donnent qu'une écriture
+  saves++;
+  bool queued = SDManager::isAvailable();
+  if (queued) {
+    uint32_t now = millis();
+    if (!pending) {
+      firstPendingMs = now;
+    }
+    lastChangeMs = now;
+    pending = true;
+  }
+
+  if (writeMutex != nullptr) {
+    xSemaphoreGive(writeMutex);
+  }
+
+  if (queued) {
+    if (writerTaskHandle != nullptr) {
+      xTaskNotifyGive(writerTaskHandle);
+    } else {
+      flush();
+    }
+  }
+  return queued;
+}
+
+void ConfigManager::writerTask(void* parameter) {
+  (void)parameter;
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    // Attendre WRITE_DEBOUNCE_MS sans nouvelle sauvegarde (au plus WRITE_MAX_DELAY_MS)
+    while (true) {
+      xSemaphoreTake(writeMutex, portMAX_DELAY);
+      bool isPending = pending;
+      uint32_t now = millis();
+      uint32_t quiet = now - lastChangeMs;
+      uint32_t waited = now - firstPendingMs;
+      xSemaphoreGive(writeMutex);
+
+      if (!isPending) {
+        break;  // Déjà écrite par flush()
+      }
+      if (quiet >= WRITE_DEBOUNCE_MS || waited >= WRITE_MAX_DELAY_MS) {
+        flush();
+        break;
+      }
+      uint32_t wait = WRITE_DEBOUNCE_MS - quiet;
+      if (WRITE_MAX_DELAY_MS - waited < wait) {
+        wait = WRITE_MAX_DELAY_MS - waited;
+      }
+      // Une nouvelle sauvegarde réveille la tâche : le délai est recalculé
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+    }
+  }
+}
+
+bool ConfigManager::flush() {
+  if (sdMutex != nullptr) {
+    xSemaphoreTake(sdMutex, portMAX_DELAY);
+  }
+  bool ok = flushLocked();
+  if (sdMutex != nullptr) {
+    xSemaphoreGive(sdMutex);
+  }
+  return ok;
+}
+
+bool ConfigManager::flushLocked() {
+  // Copier la dernière configuration publiée : les écrivains ne sont pas bloqués pendant l'écriture
+  if (writeMutex != nullptr) {
+    xSemaphoreTake(writeMutex, portMAX_DELAY);
+  }
+  bool isPending = pending;
+  if (isPending) {
+    writeCopy = buffers[active];
+    pending = false;
+  }
+  if (writeMutex != nullptr) {
+    xSemaphoreGive(writeMutex);
+  }
+  if (!isPending) {
+    return true;
+  }
+
+  if (writeToSD(writeCopy)) {
+    return true;
+  }
+
+  // Échec : reste en attente, réessayée à la prochaine sauvegarde ou au prochain flush()
+  if (writeMutex != nullptr) {
+    xSemaphoreTake(writeMutex, portMAX_DELAY);
+  }
+  if (!pending) {
+    firstPendingMs = millis();
+    lastChangeMs = firstPendingMs;
+  }
+  pending = true;
+  if (writeMutex != nullptr) {
+    xSemaphoreGive(writeMutex);
+  }
+  return false;
+}
+
+bool ConfigManager::writeToSD(const SDConfig& config) {
+  // Image invalidée avant config.json : une coupure entre les deux force un réimport
+  unsigned long start = micros();
+  size_t written = 0;
+  ConfigSnapshot::invalidate();
+  bool saved = SDManager::saveConfig(config, &written);
+  if (saved) {
+    ConfigSnapshot::store(config);
+  }
+  lastSaveUs = micros() - start;
+
+  sdWrites++;
+  writeUsTotal += lastSaveUs;
+  if (lastSaveUs > writeUsMax) {
+    writeUsMax = lastSaveUs;
+  }
+  if (saved) {
+    bytesWritten += written;
+  } else {
+    saveFailures++;
+  }
+  return saved;
+}
+
+bool ConfigManager::reload() {
+  if (!SDManager::isAvailable()) {
+    return false;
+  }
+  if (sdMutex != nullptr) {
+    xSemaphoreTake(sdMutex, portMAX_DELAY);
+  }
+  // Sauvegarde en attente écrite d'abord : elle serait perdue par la relecture
+  flushLocked();
+  if (writeMutex != nullptr) {
+    xSemaphoreTake(writeMutex, portMAX_DELAY);
+  }
+  // Lecture directement dans le tampon inactif (écrivains verrouillés)
+  // config.json a été modifié : toujours réimporté, l'image est réécrite
+  uint8_t next = active ^ 1;
+  importJson(buffers[next]);
+  __sync_synchronize();
+  active = next;
+  generation++;
+  if (writeMutex != nullptr) {
+    xSemaphoreGive(writeMutex);
+  }
+  if (sdMutex != nullptr) {
+    xSemaphoreGive(sdMutex);
+  }
+  return true;
+}
+
+const char* ConfigManager::getSource() {
+  return source;
+}
+
+uint32_t ConfigManager::getLoadUs() {
+  return loadUs;
+}
+
+void ConfigManager::printStats() {
+  Serial.println("");
+  Serial.println("========== Configuration (RAM) ==========");
+  Serial.printf("[CONFIG] Generation: %lu\n", (unsigned long)generation);
+  Serial.printf("[CONFIG] Chargement (%s): %lu us (demarrage ou reload uniquement)\n",
+                source, (unsigned long)loadUs);
+  Serial.printf("[CONFIG] Sauvegardes: %lu demandees, %lu ecritures SD (%lu regroupees), %lu echecs%s\n",
+                (unsigned long)saves, (unsigned long)sdWrites,
+                (unsigned long)(saves > sdWrites ? saves - sdWrites : 0),
+                (unsigned long)saveFailures, pending ? ", une en attente" : "");
+  Serial.printf("[CONFIG] Ecriture SD: %lu octets au total, %lu us au total, max %lu us, derniere %lu us\n",
+                (unsigned long)bytesWritten, (unsigned long)writeUsTotal,
+                (unsigned long)writeUsMax, (unsigned long)lastSaveUs);
+  Serial.printf("[CONFIG] Copies: %lu (%lu recommencees)\n",
+                (unsigned long)snapshots, (unsigned long)snapshotRetries);
+  Serial.printf("[CONFIG] Taille: %u octets x 2 tampons\n", (unsigned)sizeof(SDConfig));
+  Serial.println("=========================================");
+}
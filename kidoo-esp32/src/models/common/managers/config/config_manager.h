@@ -0,0 +1,158 @@
+#ifndef CONFIG_MANAGER_H
+#define CONFIG_MANAGER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "../sd/sd_manager.h"
+
+/**
+ * Configuration du système en RAM (source unique)
+ *
+ * La configuration est lue une fois au démarrage (image binaire /config.bin,
+ * ou import de config.json si elle est absente ou périmée, voir ConfigSnapshot),
+ * puis n'est plus lue que depuis la RAM : la SD n'est accédée qu'à la sauvegarde.
+ *
+ * - Deux tampons : un écrivain prépare la nouvelle configuration dans le
+ *   tampon inactif puis la publie d'un coup (bascule + génération incrémentée).
+ *   Un lecteur ne voit jamais une configuration à moitié écrite.
+ * - get() donne une référence sans copie, réservée aux lectures courtes qui
+ *   ne bloquent pas (elle peut être réécrite à la deuxième sauvegarde qui
+ *   suit) : pas d'attente réseau, SD ou connexion WiFi pendant qu'on la garde.
+ * - read() copie quelques champs de façon cohérente, snapshot() toute la
+ *   configuration : à utiliser par les lecteurs qui bloquent ensuite.
+ * - getGeneration() change à chaque sauvegarde : un module peut garder les
+ *   valeurs qu'il a dérivées de la configuration tant qu'elle ne change pas.
+ * - Les écrivains (tâches PubNub, BLE, loop) sont sérialisés par un mutex.
+ * - L'écriture SD est différée : une tâche de fond écrit config.json quand
+ *   les modifications se sont calmées (WRITE_DEBOUNCE_MS sans nouvelle
+ *   sauvegarde, au plus WRITE_MAX_DELAY_MS après la première). Une rafale
+ *   (potentiomètre, set-bedtime-config répétés...) ne donne qu'une écriture.
+ *   flush() écrit tout de suite (avant un redémarrage, une lecture du fichier).
+ */
+
+class ConfigManager {
+public:
+  /**
+   * Charger config.json (ou les valeurs par défaut sans SD)
+   * À appeler une fois, après l'init de la SD
+   */
+  static void init();
+
+  // Configuration courante (référence, aucune copie) : lecture courte et non bloquante
+  static const SDConfig& get();
+
+  // Copie cohérente de la configuration courante
+  static void snapshot(SDConfig& out);
+
+  /**
+   * Copier quelques champs de façon cohérente (sans copier toute la configuration)
+   * @param copy Appelé avec la configuration publiée ; rappelé si une sauvegarde
+   *             a réécrit le tampon pendant la lecture (il ne doit que copier)
+   */
+  template <typename F>
+  static void read(F copy) {
+    while (true) {
+      uint32_t before = generation;
+      __sync_synchronize();
+      copy((const SDConfig&)buffers[active]);
+      __sync_synchronize();
+      if (generation == before) {
+        break;
+      }
+      snapshotRetries++;
+    }
+    snapshots++;
+  }
+
+  // Incrémentée à chaque configuration publiée (1 après init)
+  static uint32_t getGeneration();
+
+  /**
+   * Publier une nouvelle configuration et programmer sa sauvegarde sur la SD
+   * @return false si la SD n'est pas disponible (la configuration en RAM est tout de même publiée)
+   */
+  static bool save(const SDConfig& config);
+
+  /**
+   * Modifier la configuration sur place et programmer sa sauvegarde (aucune copie sur la pile)
+   * @param modify Appelé avec le brouillon (copie de la configuration courante)
+   * @return false si la SD n'est pas disponible
+   */
+  template <typename F>
+  static bool update(F modify) {
+    SDConfig& draft = beginUpdate();
+    modify(draft);
+    return commitUpdate();
+  }
+
+  /**
+   * Écrire tout de suite la sauvegarde en attente (bloquant)
+   * @return false si l'écriture SD échoue (elle reste en attente)
+   */
+  static bool flush();
+
+  /**
+   * Relire config.json (après une écriture directe du fichier, ex. config-set)
+   * @return false si la SD n'est pas disponible
+   */
+  static bool reload();
+
+  // Origine de la configuration chargée : "image binaire", "config.json" ou "defaut"
+  static const char* getSource();
+
+  // Durée du chargement de la configuration au démarrage (ou au dernier reload)
+  static uint32_t getLoadUs();
+
+  // Afficher la génération et les compteurs (lectures, sauvegardes, écritures SD)
+  static void printStats();
+
+  static const uint32_t WRITE_DEBOUNCE_MS = 1000;   // Calme avant l'écriture
+  static const uint32_t WRITE_MAX_DELAY_MS = 5000;  // Écriture au plus tard (modifications continues)
+
+private:
+  // Verrouiller les écrivains et copier la configuration courante dans le tampon inactif
+  static SDConfig& beginUpdate();
+
+  // Publier le tampon inactif, programmer l'écriture SD, déverrouiller
+  static bool commitUpdate();
+
+  // Tâche d'écriture différée
+  static void writerTask(void* parameter);
+
+  // Écrire la sauvegarde en attente (sdMutex pris par l'appelant)
+  static bool flushLocked();
+
+  // config.json puis l'image binaire, compteurs mis à jour
+  static bool writeToSD(const SDConfig& config);
+
+  // Importer config.json dans target (durée dans loadUs) et en écrire l'image binaire
+  static void importJson(SDConfig& target);
+
+  static SDConfig buffers[2];
+  static volatile uint8_t active;          // Tampon publié
+  static volatile uint32_t generation;
+  static SemaphoreHandle_t writeMutex;
+  static SemaphoreHandle_t sdMutex;        // Une seule écriture SD à la fois (tâche, flush, reload)
+  static TaskHandle_t writerTaskHandle;
+
+  // Sauvegarde en attente (protégé par writeMutex)
+  static bool pending;
+  static uint32_t firstPendingMs;
+  static uint32_t lastChangeMs;
+
+  static uint32_t snapshots;
+  static uint32_t snapshotRetries;         // Copie recommencée (sauvegarde pendant la copie)
+  static uint32_t saves;                   // Sauvegardes demandées
+  static uint32_t sdWrites;                // Écritures de config.json (les autres ont été regroupées)
+  static uint32_t saveFailures;
+  static uint32_t bytesWritten;            // Octets de config.json écrits
+  static uint32_t writeUsTotal;            // Temps passé à écrire sur la SD
+  static uint32_t writeUsMax;
+  static uint32_t loadUs;                  // Durée du chargement (image ou config.json)
+  static const char* source;               // Origine de la configuration chargée
+  static uint32_t lastSaveUs;              // Durée de la dernière écriture SD
+};
+
+#endif // CONFIG_MANAGER_H
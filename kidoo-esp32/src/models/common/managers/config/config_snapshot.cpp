@@ -0,0 +1,120 @@
+#include "config_snapshot.h"
+#include "../../utils/crc_utils.h"
+#include <SD.h>
+#include <stddef.h>
+
+const char* ConfigSnapshot::FILE_PATH = "/config.bin";
+
+// Fichier source de l'image (voir SDManager)
+static const char* SOURCE_PATH = "/config.json";
+
+static const uint32_t SNAPSHOT_MAGIC = 0x4746434B;  // "KCFG"
+
+// En-tête de /config.bin, suivi de la structure SDConfig
+struct ConfigSnapshotHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t configSize;   // sizeof(SDConfig) du firmware qui a écrit l'image
+  uint32_t sourceSize;   // Taille de config.json à l'écriture de l'image
+  uint32_t sourceTime;   // Date de modification de config.json
+  uint32_t crc;          // CRC32 de l'en-tête (jusqu'à ce champ) puis de la configuration
+};
+
+static uint32_t snapshotCrc(const ConfigSnapshotHeader& header, const SDConfig& config) {
+  uint32_t crc = crc32Update(0, &header, offsetof(ConfigSnapshotHeader, crc));
+  return crc32Update(crc, &config, sizeof(SDConfig));
+}
+
+bool ConfigSnapshot::readSourceStamp(uint32_t& size, uint32_t& time) {
+  File source = SD.open(SOURCE_PATH, FILE_READ);
+  if (!source) {
+    return false;
+  }
+  size = source.size();
+  time = (uint32_t)source.getLastWrite();
+  source.close();
+  return true;
+}
+
+bool ConfigSnapshot::load(SDConfig& out) {
+  if (!SDManager::isAvailable() || !SD.exists(FILE_PATH)) {
+    return false;
+  }
+
+  // Sans config.json, l'image n'a plus de source (carte réinitialisée)
+  uint32_t sourceSize = 0;
+  uint32_t sourceTime = 0;
+  if (!readSourceStamp(sourceSize, sourceTime)) {
+    return false;
+  }
+
+  File file = SD.open(FILE_PATH, FILE_READ);
+  if (!file) {
+    return false;
+  }
+  if (file.size() != sizeof(ConfigSnapshotHeader) + sizeof(SDConfig)) {
+    file.close();
+    return false;
+  }
+
+  // Lecture directement dans out : son contenu n'est valable que si on retourne true
+  ConfigSnapshotHeader header;
+  bool complete = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                  file.read((uint8_t*)&out, sizeof(SDConfig)) == sizeof(SDConfig);
+  file.close();
+  if (!complete) {
+    return false;
+  }
+
+  if (header.magic != SNAPSHOT_MAGIC || header.version != VERSION ||
+      header.configSize != sizeof(SDConfig)) {
+    Serial.println("[CONFIG] Image binaire d'une autre version, reimport de config.json");
+    return false;
+  }
+  if (header.crc != snapshotCrc(header, out)) {
+    Serial.println("[CONFIG] Image binaire corrompue (CRC), reimport de config.json");
+    return false;
+  }
+  if (header.sourceSize != sourceSize || header.sourceTime != sourceTime) {
+    Serial.println("[CONFIG] config.json modifie depuis l'image binaire, reimport");
+    return false;
+  }
+  return true;
+}
+
+bool ConfigSnapshot::store(const SDConfig& config) {
+  if (!SDManager::isAvailable()) {
+    return false;
+  }
+
+  ConfigSnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = SNAPSHOT_MAGIC;
+  header.version = VERSION;
+  header.configSize = sizeof(SDConfig);
+  if (!readSourceStamp(header.sourceSize, header.sourceTime)) {
+    return false;
+  }
+  header.crc = snapshotCrc(header, config);
+
+  File file = SD.open(FILE_PATH, FILE_WRITE);
+  if (!file) {
+    return false;
+  }
+  size_t written = file.write((const uint8_t*)&header, sizeof(header));
+  written += file.write((const uint8_t*)&config, sizeof(SDConfig));
+  file.close();
+
+  if (written != sizeof(header) + sizeof(SDConfig)) {
+    // Image incomplète : la supprimer plutôt que de la relire au démarrage
+    SD.remove(FILE_PATH);
+    return false;
+  }
+  return true;
+}
+
+void ConfigSnapshot::invalidate() {
+  if (SDManager::isAvailable() && SD.exists(FILE_PATH)) {
+    SD.remove(FILE_PATH);
+  }
+}
@@ -0,0 +1,52 @@
+#ifndef CONFIG_SNAPSHOT_H
+#define CONFIG_SNAPSHOT_H
+
+#include <Arduino.h>
+#include "../sd/sd_manager.h"
+
+/**
+ * Image binaire de la configuration (démarrage rapide)
+ *
+ * config.json reste le format lisible (import/export, édition à la main) ;
+ * /config.bin garde une copie binaire de SDConfig, relue en une seule lecture
+ * au démarrage au lieu de parser le JSON.
+ *
+ * - En-tête versionné : l'image est ignorée si la version ou la taille de
+ *   SDConfig ne correspondent plus au firmware
+ * - CRC32 sur l'en-tête et la configuration : une image corrompue est ignorée
+ * - L'image mémorise la taille et la date de modification de config.json :
+ *   si le fichier a été modifié depuis (édition sur PC...), il est réimporté
+ *
+ * Ordre d'écriture (ConfigManager) : invalidate(), config.json, puis store().
+ * Une coupure entre les deux laisse un config.json sans image : il est
+ * simplement réimporté au démarrage suivant.
+ */
+
+class ConfigSnapshot {
+public:
+  /**
+   * Lire l'image si elle correspond à config.json
+   * @return false si absente, périmée ou corrompue (config.json à importer)
+   */
+  static bool load(SDConfig& out);
+
+  /**
+   * Écrire l'image de la configuration (après l'écriture de config.json)
+   * @return false si la SD n'est pas disponible ou si l'écriture échoue
+   */
+  static bool store(const SDConfig& config);
+
+  // Supprimer l'image (avant une écriture de config.json)
+  static void invalidate();
+
+  // Changer à chaque modification de la structure SDConfig
+  static const uint16_t VERSION = 2;
+
+private:
+  // Taille et date de modification de config.json (false si absent)
+  static bool readSourceStamp(uint32_t& size, uint32_t& time);
+
+  static const char* FILE_PATH;
+};
+
+#endif // CONFIG_SNAPSHOT_H
@@ -1,6 +1,7 @@
 #include "init_manager.h"
 #include "../led/led_manager.h"
 #include "../sd/sd_manager.h"
+#include "../config/config_manager.h"
 #include "../serial/serial_manager.h"
 #include "../log/log_manager.h"
 #include "../nfc/nfc_manager.h"
@@ -31,7 +32,6 @@ SystemStatus InitManager::systemStatus = {
   INIT_NOT_STARTED   // audio
 };
 bool InitManager::initialized = false;
-SDConfig* InitManager::globalConfig = nullptr;
 
 bool InitManager::init() {
   // 1. Initialiser la communication série EN PREMIER (priorité absolue)
@@ -106,6 +106,10 @@ bool InitManager::init() {
         Serial.println("[INIT] ERREUR: Echec LED");
       }
       allSuccess = false;
+    } else if (serialAvailable) {
+      // Temps de démarrage jusqu'aux LEDs prêtes (comparer image binaire / import config.json)
+      Serial.printf("[INIT] LEDs pretes a %lu ms (configuration: %s, %lu us)\n",
+                    millis(), ConfigManager::getSource(), (unsigned long)ConfigManager::getLoadUs());
     }
     delay(100);
   }
@@ -529,39 +533,3 @@ void InitManager::printStatus() {
   Serial.println(isSystemReady() ? "OUI" : "NON");
   Serial.println("[INIT] ========================================");
 }
-
-const SDConfig& InitManager::getConfig() {
-  static SDConfig defaultConfig;
-  
-  if (globalConfig == nullptr) {
-    // Si pas de config globale, retourner une config par défaut
-    SDManager::initDefaultConfig(&defaultConfig);
-    return defaultConfig;
-  }
-  
-  return *globalConfig;
-}
-
-bool InitManager::isConfigValid() {
-  return globalConfig != nullptr && globalConfig->valid;
-}
-
-void InitManager::setGlobalConfig(SDConfig* config) {
-  globalConfig = config;
-}
-
-bool InitManager::updateConfig(const SDConfig& config) {
-  if (globalConfig == nullptr) {
-    return false;
-  }
-  
-  // Copier la nouvelle configuration
-  *globalConfig = config;
-  
-  // Sauvegarder sur la SD
-  if (SDManager::isAvailable()) {
-    return SDManager::saveConfig(config);
-  }
-  
-  return false;
-}
@@ -3,9 +3,6 @@
 
 #include <Arduino.h>
 
-// Forward declaration
-struct SDConfig;
-
 /**
  * Gestionnaire d'initialisation du système
  * 
@@ -57,18 +54,7 @@ public:
   // Afficher le statut de tous les composants (pour debug)
   static void printStatus();
   
-  // Configuration globale
-  // Obtenir la configuration système (accessible de n'importe où)
-  static const SDConfig& getConfig();
-  
-  // Vérifier si la configuration est valide
-  static bool isConfigValid();
-  
-  // Stocker la configuration globalement (utilisé en interne)
-  static void setGlobalConfig(SDConfig* config);
-  
-  // Mettre à jour et sauvegarder la configuration
-  static bool updateConfig(const SDConfig& config);
+  // Configuration globale : voir ConfigManager (config/config_manager.h)
 
 private:
   // Initialiser chaque composant individuellement
@@ -87,7 +73,6 @@ private:
   // Variables statiques
   static SystemStatus systemStatus;
   static bool initialized;
-  static SDConfig* globalConfig;  // Configuration globale du système
   
   // Configuration Serial
   static const unsigned long SERIAL_BAUD_RATE = 115200;
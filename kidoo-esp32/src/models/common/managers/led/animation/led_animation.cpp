@@ -0,0 +1,221 @@
+#include "led_animation.h"
+#include <string.h>
+#include "../led_fixed_math.h"
+
+LEDAnimationDecoder::LEDAnimationDecoder()
+  : open(false), error(nullptr), current(0), hasNext(false), nextIndex(0),
+    segmentStartMs(0), readPos(0), readLength(0), bytesRead(0), keyframesLoaded(0) {
+  memset(&source, 0, sizeof(source));
+  memset(&header, 0, sizeof(header));
+}
+
+bool LEDAnimationDecoder::fail(const char* message) {
+  error = message;
+  open = false;
+  return false;
+}
+
+bool LEDAnimationDecoder::readBytes(uint8_t* dest, uint32_t length) {
+  while (length > 0) {
+    if (readPos >= readLength) {
+      // Tampon vide : lecture anticipée d'un bloc
+      int32_t count = source.read(source.context, readBuffer, LED_ANIMATION_READ_AHEAD);
+      if (count <= 0) {
+        return false;
+      }
+      readPos = 0;
+      readLength = (uint16_t)count;
+      bytesRead += (uint32_t)count;
+    }
+    uint32_t chunk = readLength - readPos;
+    if (chunk > length) {
+      chunk = length;
+    }
+    memcpy(dest, readBuffer + readPos, chunk);
+    readPos += chunk;
+    dest += chunk;
+    length -= chunk;
+  }
+  return true;
+}
+
+bool LEDAnimationDecoder::readKeyframe(Keyframe& keyframe) {
+  uint8_t head[LED_ANIMATION_KEYFRAME_HEADER_SIZE];
+  if (!readBytes(head, sizeof(head)) || !readBytes(keyframe.indices, header.ledCount)) {
+    return fail("keyframe tronquee");
+  }
+  keyframe.durationMs = (uint16_t)(head[0] | (head[1] << 8));
+  keyframe.easing = (head[2] < LED_EASING_COUNT) ? head[2] : LED_EASING_LINEAR;
+
+  // Index hors palette : couleur 0 plutôt qu'une lecture hors tableau au rendu
+  for (uint16_t i = 0; i < header.ledCount; i++) {
+    if (keyframe.indices[i] >= header.paletteCount) {
+      keyframe.indices[i] = 0;
+    }
+  }
+  keyframesLoaded++;
+  return true;
+}
+
+bool LEDAnimationDecoder::rewind() {
+  readPos = 0;
+  readLength = 0;
+  if (!source.seek(source.context, LED_ANIMATION_HEADER_SIZE + header.paletteCount * 3)) {
+    return fail("retour au debut impossible");
+  }
+  return true;
+}
+
+bool LEDAnimationDecoder::begin(const LEDAnimationSource& newSource) {
+  source = newSource;
+  open = false;
+  error = nullptr;
+  readPos = 0;
+  readLength = 0;
+  bytesRead = 0;
+  keyframesLoaded = 0;
+
+  uint8_t raw[LED_ANIMATION_HEADER_SIZE];
+  if (source.read == nullptr || source.seek == nullptr || !readBytes(raw, sizeof(raw))) {
+    return fail("en-tete tronque");
+  }
+  if (memcmp(raw, LED_ANIMATION_MAGIC, 4) != 0) {
+    return fail("format inconnu (magic)");
+  }
+  if (raw[4] != LED_ANIMATION_VERSION) {
+    return fail("version non supportee");
+  }
+  header.flags = raw[5];
+  header.paletteCount = raw[6];
+  header.ledCount = (uint16_t)(raw[8] | (raw[9] << 8));
+  header.keyframeCount = (uint16_t)(raw[10] | (raw[11] << 8));
+
+  if (header.paletteCount == 0 || header.paletteCount > LED_ANIMATION_MAX_PALETTE) {
+    return fail("palette invalide");
+  }
+  if (header.ledCount == 0 || header.ledCount > LED_ANIMATION_MAX_LEDS) {
+    return fail("nombre de LEDs invalide");
+  }
+  if (header.keyframeCount == 0) {
+    return fail("aucune keyframe");
+  }
+  if (!readBytes(palette, header.paletteCount * 3)) {
+    return fail("palette tronquee");
+  }
+
+  current = 0;
+  segmentStartMs = 0;
+  if (!readKeyframe(keyframes[0])) {
+    return false;
+  }
+
+  // Keyframe d'arrivée : la suivante, ou la première si l'animation boucle
+  hasNext = true;
+  nextIndex = 1;
+  if (header.keyframeCount == 1) {
+    hasNext = false;
+  } else if (!readKeyframe(keyframes[1])) {
+    return false;
+  }
+
+  open = true;
+  return true;
+}
+
+void LEDAnimationDecoder::end() {
+  open = false;
+}
+
+bool LEDAnimationDecoder::advance() {
+  segmentStartMs += keyframes[current].durationMs;
+  current ^= 1;
+
+  // La keyframe d'arrivée devient la keyframe de départ : lire la suivante
+  nextIndex++;
+  if (nextIndex == header.keyframeCount) {
+    if ((header.flags & LED_ANIMATION_FLAG_LOOP) == 0) {
+      hasNext = false;
+      return true;
+    }
+    // Transition de bouclage : dernière keyframe -> première
+    if (!rewind()) {
+      return false;
+    }
+  } else if (nextIndex > header.keyframeCount) {
+    // La première keyframe est devenue keyframe de départ : la lecture reprend à la deuxième
+    nextIndex = 1;
+  }
+  return readKeyframe(keyframes[current ^ 1]);
+}
+
+uint16_t LEDAnimationDecoder::applyEasing(uint8_t easing, uint16_t t) {
+  switch (easing) {
+    case LED_EASING_STEP:
+      return (t >= LED_Q15_ONE) ? LED_Q15_ONE : 0;
+    case LED_EASING_EASE_IN_OUT:
+      return ledSmoothstepQ15(t);
+    case LED_EASING_EASE_IN:
+      return (uint16_t)(((uint32_t)t * t) >> 15);
+    case LED_EASING_EASE_OUT: {
+      uint32_t inv = LED_Q15_ONE - t;
+      return (uint16_t)(LED_Q15_ONE - ((inv * inv) >> 15));
+    }
+    default:
+      return t;
+  }
+}
+
+uint32_t LEDAnimationDecoder::render(uint8_t* pixels, uint16_t count, uint32_t elapsedMs) {
+  if (!open || count == 0) {
+    return LED_ANIMATION_NO_DEADLINE;
+  }
+
+  // Avancer jusqu'à la transition contenant elapsedMs. Après un long saut dans le
+  // temps, les tours complets sont sautés d'un coup au lieu de relire tout le fichier
+  uint32_t steps = 0;
+  uint32_t cycleStartMs = segmentStartMs;
+  while (hasNext && elapsedMs - segmentStartMs >= keyframes[current].durationMs) {
+    if (steps++ == header.keyframeCount) {
+      uint32_t cycleMs = segmentStartMs - cycleStartMs;
+      if (cycleMs == 0) {
+        // Boucle de durée nulle : rester sur la keyframe courante
+        segmentStartMs = elapsedMs;
+        break;
+      }
+      segmentStartMs += (elapsedMs - segmentStartMs) / cycleMs * cycleMs;
+      continue;
+    }
+    if (!advance()) {
+      return LED_ANIMATION_NO_DEADLINE;
+    }
+  }
+
+  const Keyframe& from = keyframes[current];
+  const Keyframe& to = keyframes[current ^ 1];
+  uint32_t inSegment = elapsedMs - segmentStartMs;
+  uint16_t t = 0;
+  uint32_t nextDelay = LED_ANIMATION_NO_DEADLINE;
+  if (hasNext) {
+    t = applyEasing(from.easing, ledProgressQ15(inSegment, from.durationMs));
+    // Maintien : rien ne change avant la fin de la transition
+    nextDelay = (from.easing == LED_EASING_STEP) ? from.durationMs - inSegment : 0;
+  }
+
+  for (uint16_t i = 0; i < count; i++) {
+    // Keyframe étirée sur la bande si le fichier décrit un autre nombre de LEDs
+    uint16_t src = (count == header.ledCount) ? i : (uint16_t)((uint32_t)i * header.ledCount / count);
+    const uint8_t* a = palette + from.indices[src] * 3;
+    uint8_t* p = pixels + i * 3;
+    if (t == 0) {
+      p[0] = a[0];
+      p[1] = a[1];
+      p[2] = a[2];
+    } else {
+      const uint8_t* b = palette + to.indices[src] * 3;
+      p[0] = ledLerp8(a[0], b[0], t);
+      p[1] = ledLerp8(a[1], b[1], t);
+      p[2] = ledLerp8(a[2], b[2], t);
+    }
+  }
+  return nextDelay;
+}
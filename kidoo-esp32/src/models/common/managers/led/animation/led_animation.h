@@ -0,0 +1,150 @@
+#ifndef LED_ANIMATION_H
+#define LED_ANIMATION_H
+
+#include <stdint.h>
+
+/**
+ * Animations LED par keyframes (fichiers .kan sur la carte SD)
+ *
+ * Format binaire compact (little-endian) envoyé par l'application :
+ *
+ *   En-tête (16 octets)
+ *     0  magic "KAN1"
+ *     4  uint8  version (1)
+ *     5  uint8  flags (bit 0 : boucle)
+ *     6  uint8  nombre de couleurs de la palette (1..LED_ANIMATION_MAX_PALETTE)
+ *     7  uint8  réservé (0)
+ *     8  uint16 nombre de LEDs décrites par keyframe
+ *    10  uint16 nombre de keyframes
+ *    12  uint32 réservé (0)
+ *   Palette : 3 octets RGB linéaires par couleur
+ *   Keyframes, chacune :
+ *     uint16 durée de la transition vers la keyframe suivante (ms)
+ *     uint8  easing (LEDAnimationEasing)
+ *     uint8  réservé (0)
+ *     uint8  index de palette par LED
+ *
+ * Le décodeur ne garde en RAM que la palette, les deux keyframes encadrant
+ * l'instant courant et un petit tampon de lecture anticipée : le fichier est
+ * lu au fil de l'eau, quelle que soit sa taille.
+ *
+ * Il ne dépend ni d'Arduino ni de la carte SD (source de lecture abstraite) :
+ * il peut être compilé et mesuré sur l'hôte.
+ */
+
+#define LED_ANIMATION_MAGIC "KAN1"
+#define LED_ANIMATION_VERSION 1
+#define LED_ANIMATION_HEADER_SIZE 16
+#define LED_ANIMATION_KEYFRAME_HEADER_SIZE 4
+#define LED_ANIMATION_FLAG_LOOP 0x01
+
+// Limites du décodeur (RAM : 2 keyframes + palette + tampon de lecture)
+#ifndef LED_ANIMATION_MAX_LEDS
+#define LED_ANIMATION_MAX_LEDS 300
+#endif
+#define LED_ANIMATION_MAX_PALETTE 64
+#define LED_ANIMATION_READ_AHEAD 128
+
+// Aucune nouvelle trame nécessaire (animation terminée ou en erreur)
+#define LED_ANIMATION_NO_DEADLINE 0xFFFFFFFFUL
+
+// Courbes de transition entre deux keyframes
+enum LEDAnimationEasing {
+  LED_EASING_LINEAR = 0,     // Interpolation linéaire
+  LED_EASING_STEP = 1,       // Maintien puis saut à la keyframe suivante
+  LED_EASING_EASE_IN_OUT = 2,  // Smoothstep
+  LED_EASING_EASE_IN = 3,    // Départ lent (t²)
+  LED_EASING_EASE_OUT = 4,   // Arrivée lente (1 - (1 - t)²)
+  LED_EASING_COUNT
+};
+
+/**
+ * Source de lecture du fichier (carte SD sur la cible, mémoire sur l'hôte)
+ */
+struct LEDAnimationSource {
+  void* context;
+  // Lire jusqu'à length octets, retourne le nombre d'octets lus (0 = fin, <0 = erreur)
+  int32_t (*read)(void* context, uint8_t* buffer, uint32_t length);
+  // Se positionner à un offset absolu depuis le début du fichier
+  bool (*seek)(void* context, uint32_t offset);
+};
+
+struct LEDAnimationHeader {
+  uint8_t flags;
+  uint8_t paletteCount;
+  uint16_t ledCount;
+  uint16_t keyframeCount;
+};
+
+class LEDAnimationDecoder {
+public:
+  LEDAnimationDecoder();
+
+  /**
+   * Lire l'en-tête, la palette et les deux premières keyframes
+   * @return false si le fichier est invalide (voir errorMessage())
+   */
+  bool begin(const LEDAnimationSource& source);
+
+  // Fermer l'animation (la source reste à la charge de l'appelant)
+  void end();
+
+  /**
+   * Dessiner l'instant elapsedMs de l'animation
+   * Les keyframes sont lues au fil de l'eau à mesure que le temps avance ;
+   * le temps ne doit pas reculer (rappeler begin() pour repartir du début).
+   * @param pixels Buffer RGB (count * 3 octets)
+   * @param count Nombre de LEDs de la bande (la keyframe est étirée si différent)
+   * @param elapsedMs Temps écoulé depuis le début de l'animation
+   * @return Délai (ms) avant le prochain changement, 0 si en transition,
+   *         LED_ANIMATION_NO_DEADLINE si l'animation est figée ou en erreur
+   */
+  uint32_t render(uint8_t* pixels, uint16_t count, uint32_t elapsedMs);
+
+  bool isOpen() const { return open; }
+  const char* errorMessage() const { return error; }
+  const LEDAnimationHeader& getHeader() const { return header; }
+
+  // Statistiques de lecture (benchmark)
+  uint32_t getBytesRead() const { return bytesRead; }
+  uint32_t getKeyframesLoaded() const { return keyframesLoaded; }
+
+private:
+  struct Keyframe {
+    uint16_t durationMs;
+    uint8_t easing;
+    uint8_t indices[LED_ANIMATION_MAX_LEDS];
+  };
+
+  bool fail(const char* message);
+  bool readBytes(uint8_t* dest, uint32_t length);
+  bool readKeyframe(Keyframe& keyframe);
+  bool rewind();
+
+  // Passer à la keyframe suivante et lire celle d'après
+  bool advance();
+
+  static uint16_t applyEasing(uint8_t easing, uint16_t t);
+
+  LEDAnimationSource source;
+  LEDAnimationHeader header;
+  bool open;
+  const char* error;
+
+  uint8_t palette[LED_ANIMATION_MAX_PALETTE * 3];
+  Keyframe keyframes[2];
+  uint8_t current;         // Index de la keyframe de départ dans keyframes[]
+  bool hasNext;            // false : dernière keyframe atteinte (sans boucle)
+  uint16_t nextIndex;      // Position dans le fichier de la keyframe d'arrivée
+  uint32_t segmentStartMs; // Début de la transition courante
+
+  // Lecture anticipée
+  uint8_t readBuffer[LED_ANIMATION_READ_AHEAD];
+  uint16_t readPos;
+  uint16_t readLength;
+
+  uint32_t bytesRead;
+  uint32_t keyframesLoaded;
+};
+
+#endif // LED_ANIMATION_H
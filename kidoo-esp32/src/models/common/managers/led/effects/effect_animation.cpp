@@ -0,0 +1,115 @@
+#include "led_effect.h"
+
+#ifdef HAS_LED_EFFECT_ANIMATION
+
+#include <SD.h>
+#include "../animation/led_animation.h"
+#include "../../sd/sd_manager.h"
+
+// Animation keyframes lue au fil de l'eau depuis la carte SD (fichier .kan)
+// Le fichier est choisi par ledAnimationSelect() (n'importe quelle tâche) puis
+// ouvert et lu uniquement par la tâche LED, au rendu
+
+static LEDAnimationDecoder decoder;
+static File animationFile;
+
+// Sélection du fichier (écrite par l'appelant, lue par la tâche LED)
+static portMUX_TYPE selectionMux = portMUX_INITIALIZER_UNLOCKED;
+static char selectedPath[LED_ANIMATION_PATH_MAX] = "";
+static uint32_t selectedGeneration = 0;
+static uint32_t openedGeneration = 0;
+static bool reopenRequested = true;
+static uint32_t timelineStartMs = 0;  // Temps écoulé de l'effet à l'ouverture du fichier
+
+static int32_t readFromFile(void* context, uint8_t* buffer, uint32_t length) {
+  return (int32_t)((File*)context)->read(buffer, length);
+}
+
+static bool seekInFile(void* context, uint32_t offset) {
+  return ((File*)context)->seek(offset);
+}
+
+bool ledAnimationSelect(const char* path) {
+  if (path == nullptr || path[0] != '/' || strlen(path) >= LED_ANIMATION_PATH_MAX) {
+    return false;
+  }
+  portENTER_CRITICAL(&selectionMux);
+  strcpy(selectedPath, path);
+  selectedGeneration++;
+  portEXIT_CRITICAL(&selectionMux);
+  return true;
+}
+
+static void openSelectedAnimation(uint32_t elapsedMs) {
+  char path[LED_ANIMATION_PATH_MAX];
+  portENTER_CRITICAL(&selectionMux);
+  strcpy(path, selectedPath);
+  openedGeneration = selectedGeneration;
+  portEXIT_CRITICAL(&selectionMux);
+
+  reopenRequested = false;
+  timelineStartMs = elapsedMs;
+  decoder.end();
+  if (animationFile) {
+    animationFile.close();
+  }
+
+  if (path[0] == '\0') {
+    return;
+  }
+  if (!SDManager::isAvailable()) {
+    Serial.println("[LED] Animation: carte SD non disponible");
+    return;
+  }
+  animationFile = SD.open(path, FILE_READ);
+  if (!animationFile) {
+    Serial.printf("[LED] Animation: fichier introuvable %s\n", path);
+    return;
+  }
+
+  LEDAnimationSource source = {&animationFile, readFromFile, seekInFile};
+  if (!decoder.begin(source)) {
+    Serial.printf("[LED] Animation %s invalide: %s\n", path, decoder.errorMessage());
+    animationFile.close();
+    return;
+  }
+  const LEDAnimationHeader& header = decoder.getHeader();
+  Serial.printf("[LED] Animation %s: %u keyframes, %u LEDs, %u couleurs%s\n", path,
+                header.keyframeCount, header.ledCount, header.paletteCount,
+                (header.flags & LED_ANIMATION_FLAG_LOOP) ? ", boucle" : "");
+}
+
+static void initAnimation() {
+  // Redémarrage de l'effet : relire le fichier depuis le début
+  reopenRequested = true;
+}
+
+static uint32_t renderAnimation(uint8_t* pixels, uint16_t count, uint32_t elapsedMs, const LEDEffectParams& params) {
+  (void)params;
+  if (reopenRequested || openedGeneration != selectedGeneration) {
+    openSelectedAnimation(elapsedMs);
+  }
+
+  if (!decoder.isOpen()) {
+    // Aucun fichier valide : bande éteinte
+    ledFill(pixels, count, 0, 0, 0);
+    return LED_EFFECT_NO_DEADLINE;
+  }
+
+  uint32_t nextDelay = decoder.render(pixels, count, elapsedMs - timelineStartMs);
+  if (!decoder.isOpen()) {
+    Serial.printf("[LED] Animation interrompue: %s\n", decoder.errorMessage());
+    animationFile.close();
+  }
+  return nextDelay;
+}
+
+const LEDEffectDescriptor LED_EFFECT_ANIMATION_DESCRIPTOR = {
+  LED_EFFECT_ANIMATION,
+  "ANIMATION",
+  16,
+  initAnimation,
+  renderAnimation
+};
+
+#endif // HAS_LED_EFFECT_ANIMATION
@@ -0,0 +1,66 @@
+#include "led_effect.h"
+#include "../led_fixed_math.h"
+
+#ifdef HAS_LED_EFFECT_BREATHE
+
+// Palette de couleurs douces et apaisantes pour la respiration
+static const uint8_t BREATHE_COLORS[][3] = {
+  {30, 100, 255},   // Bleu doux
+  {100, 150, 255},  // Bleu ciel
+  {150, 100, 255},  // Violet doux
+  {255, 100, 150},  // Rose doux
+  {255, 150, 100},  // Orange doux
+  {150, 255, 150},  // Vert doux
+  {255, 200, 100}   // Jaune doux
+};
+static const uint32_t BREATHE_NUM_COLORS = sizeof(BREATHE_COLORS) / sizeof(BREATHE_COLORS[0]);
+
+static const uint32_t COLOR_CHANGE_INTERVAL_MS = 30000;     // Changement de couleur toutes les 30 secondes
+static const uint32_t COLOR_TRANSITION_DURATION_MS = 2000;  // 2 secondes pour la transition
+static const uint32_t BREATHE_CYCLE_MS = 3000;              // Cycle inspiration + expiration
+
+// Effet de respiration avec changement de couleur toutes les 30 secondes
+// L'état (couleur courante / précédente) se déduit du temps écoulé : aucun état interne
+static uint32_t renderBreathe(uint8_t* pixels, uint16_t count, uint32_t elapsedMs, const LEDEffectParams& params) {
+  (void)params;
+  // Couleur cible (cycle infini) et couleur précédente pour la transition
+  uint32_t colorIndex = elapsedMs / COLOR_CHANGE_INTERVAL_MS;
+  const uint8_t* target = BREATHE_COLORS[colorIndex % BREATHE_NUM_COLORS];
+  const uint8_t* previous = BREATHE_COLORS[(colorIndex == 0 ? 0 : colorIndex - 1) % BREATHE_NUM_COLORS];
+  
+  uint32_t transitionElapsed = elapsedMs % COLOR_CHANGE_INTERVAL_MS;
+  uint8_t currentR, currentG, currentB;
+  if (transitionElapsed < COLOR_TRANSITION_DURATION_MS) {
+    // Transition en cours : courbe d'ease-in-out pour une transition plus douce
+    uint16_t easedFactor = ledSmoothstepQ15(ledProgressQ15(transitionElapsed, COLOR_TRANSITION_DURATION_MS));
+    currentR = ledLerp8(previous[0], target[0], easedFactor);
+    currentG = ledLerp8(previous[1], target[1], easedFactor);
+    currentB = ledLerp8(previous[2], target[2], easedFactor);
+  } else {
+    currentR = target[0];
+    currentG = target[1];
+    currentB = target[2];
+  }
+  
+  // Respiration sinusoïdale (Q15) : sin va de -1 à 1, transformé en 0.3 à 1.0
+  // pour garder un minimum de luminosité : 0.65 + 0.35 * sin
+  uint32_t breatheElapsed = elapsedMs % BREATHE_CYCLE_MS;
+  int16_t breatheSin = ledSinQ15(ledPhaseFromMs(breatheElapsed, BREATHE_CYCLE_MS));
+  uint16_t breatheFactor = (uint16_t)(21299 + ((breatheSin * 11469) >> 15));
+  
+  ledFill(pixels, count,
+          ledScale8Q15(currentR, breatheFactor),
+          ledScale8Q15(currentG, breatheFactor),
+          ledScale8Q15(currentB, breatheFactor));
+  return LED_EFFECT_BREATHE_DESCRIPTOR.frameIntervalMs;
+}
+
+const LEDEffectDescriptor LED_EFFECT_BREATHE_DESCRIPTOR = {
+  LED_EFFECT_BREATHE,
+  "BREATHE",
+  33,
+  nullptr,
+  renderBreathe
+};
+
+#endif // HAS_LED_EFFECT_BREATHE
@@ -0,0 +1,26 @@
+#include "led_effect.h"
+
+#ifdef HAS_LED_EFFECT_GLOSSY
+
+// Effet glossy multicolore
+// Le dégradé avance d'un pas de teinte toutes les 16 ms
+static uint32_t renderGlossy(uint8_t* pixels, uint16_t count, uint32_t elapsedMs, const LEDEffectParams& params) {
+  (void)params;
+  uint8_t offset = (uint8_t)(elapsedMs / 16);
+  
+  for (uint16_t i = 0; i < count; i++) {
+    uint8_t hue = (uint8_t)((i * 256 / count) + offset);
+    ledHsvToRgb(hue, 200, 255, pixels + i * 3);
+  }
+  return LED_EFFECT_GLOSSY_DESCRIPTOR.frameIntervalMs;
+}
+
+const LEDEffectDescriptor LED_EFFECT_GLOSSY_DESCRIPTOR = {
+  LED_EFFECT_GLOSSY,
+  "GLOSSY",
+  16,
+  nullptr,
+  renderGlossy
+};
+
+#endif // HAS_LED_EFFECT_GLOSSY
@@ -0,0 +1,78 @@
+#include "led_effect.h"
+#include "../led_fixed_math.h"
+
+#ifdef HAS_LED_EFFECT_NIGHTLIGHT
+
+// Cycle de déplacement : ~6 secondes pour traverser toute la bande
+static const uint32_t NIGHTLIGHT_CYCLE_MS = 6000;
+
+// Couleurs de base : bleu et blanc
+static const uint8_t BLUE_R = 30;
+static const uint8_t BLUE_G = 100;
+static const uint8_t BLUE_B = 255;
+static const uint8_t WHITE_R = 200;
+static const uint8_t WHITE_G = 220;
+static const uint8_t WHITE_B = 255;
+
+// Effet de veilleuse avec vagues bleu/blanc qui se déplacent de gauche à droite
+static uint32_t renderNightlight(uint8_t* pixels, uint16_t count, uint32_t elapsedMs, const LEDEffectParams& params) {
+  (void)params;
+  // Phase de défilement (2^32 = un cycle complet)
+  // Le décalage vaut 2 * count LEDs par cycle : pour une vague de fréquence k
+  // (en périodes par bande), la phase recule donc de 2k tours par cycle
+  uint32_t scrollPhase = ledPhaseFromMs(elapsedMs % NIGHTLIGHT_CYCLE_MS, NIGHTLIGHT_CYCLE_MS);
+  
+  // 3 vagues sinusoïdales (accumulateurs de phase, 2^32 = 2*PI)
+  // Vague 1 : 1.5 période par bande (bleu dominant) - mouvement lent
+  // Vague 2 : 2.5 périodes, déphasée de PI/3 (blanc subtil) - mouvement moyen
+  // Vague 3 : 4 périodes, déphasée de PI/2 (accent bleu) - mouvement rapide
+  // Pas par LED = k / count tour
+  const uint32_t wave1Step = (uint32_t)((3ULL << 31) / count);
+  const uint32_t wave2Step = (uint32_t)((5ULL << 31) / count);
+  const uint32_t wave3Step = (uint32_t)((8ULL << 31) / count);
+  uint32_t wave1Phase = 0UL - 3UL * scrollPhase;
+  uint32_t wave2Phase = LED_PHASE_SIXTH - 5UL * scrollPhase;
+  uint32_t wave3Phase = LED_PHASE_QUARTER - 8UL * scrollPhase;
+  
+  for (uint16_t i = 0; i < count; i++) {
+    // (sin + 1) en Q15 : 0..65535
+    int32_t wave1 = ledSinQ15(wave1Phase) + LED_Q15_ONE;
+    int32_t wave2 = ledSinQ15(wave2Phase) + LED_Q15_ONE;
+    int32_t wave3 = ledSinQ15(wave3Phase) + LED_Q15_ONE;
+    
+    // Combiner les vagues (mélange bleu/blanc - bleu dominant), en Q15 :
+    // bleu  = ((wave1 * 0.6 + wave3 * 0.4) * 0.7) + 0.3 de fond bleu minimal
+    //       = 0.21 * (sin1 + 1) + 0.084 * (sin3 + 1) + 0.3
+    // blanc = wave2 * 0.2 = 0.1 * (sin2 + 1)
+    int32_t blueFactor = ((wave1 * 13763) >> 16) + ((wave3 * 5505) >> 16) + 9830;
+    int32_t whiteFactor = (wave2 * 6554) >> 16;
+    
+    // Normaliser pour éviter la saturation, mais garder un minimum
+    int32_t total = blueFactor + whiteFactor;
+    if (total > LED_Q15_ONE) {
+      blueFactor = (blueFactor << 15) / total;
+      whiteFactor = (whiteFactor << 15) / total;
+    }
+    
+    // Calculer les composantes RGB finales
+    ledSetPixel(pixels, i,
+                (uint8_t)((BLUE_R * blueFactor + WHITE_R * whiteFactor) >> 15),
+                (uint8_t)((BLUE_G * blueFactor + WHITE_G * whiteFactor) >> 15),
+                (uint8_t)((BLUE_B * blueFactor + WHITE_B * whiteFactor) >> 15));
+    
+    wave1Phase += wave1Step;
+    wave2Phase += wave2Step;
+    wave3Phase += wave3Step;
+  }
+  return LED_EFFECT_NIGHTLIGHT_DESCRIPTOR.frameIntervalMs;
+}
+
+const LEDEffectDescriptor LED_EFFECT_NIGHTLIGHT_DESCRIPTOR = {
+  LED_EFFECT_NIGHTLIGHT,
+  "NIGHTLIGHT",
+  33,
+  nullptr,
+  renderNightlight
+};
+
+#endif // HAS_LED_EFFECT_NIGHTLIGHT
@@ -0,0 +1,43 @@
+#include "led_effect.h"
+
+#ifdef HAS_LED_EFFECT_PULSE
+
+// Cycle de respiration : ~2.5 secondes pour un cycle complet (inspiration + expiration)
+static const uint32_t PULSE_CYCLE_MS = 2500;
+
+// Minimum réduit à 30 pour un effet plus sombre en bas (~12% de luminosité)
+static const uint8_t PULSE_MIN = 30;
+static const uint8_t PULSE_MAX = 255;
+static const uint8_t PULSE_RANGE = PULSE_MAX - PULSE_MIN;  // 225
+
+// Effet de pulsation (respiration) rapide et fluide sur la couleur courante
+static uint32_t renderPulse(uint8_t* pixels, uint16_t count, uint32_t elapsedMs, const LEDEffectParams& params) {
+  uint32_t elapsed = elapsedMs % PULSE_CYCLE_MS;
+  
+  // Calculer la phase normalisée (0 à 1023 pour précision)
+  uint16_t phase = (elapsed * 1024) / PULSE_CYCLE_MS;
+  
+  // Phase 0-511 : montée (inspiration), Phase 512-1023 : descente (expiration)
+  // Courbe quadratique pour une accélération progressive
+  uint16_t smoothPhase = (phase < 512) ? phase : (511 - (phase - 512));
+  smoothPhase = (smoothPhase * smoothPhase) / 512;
+  uint8_t pulseValue = PULSE_MIN + ((smoothPhase * PULSE_RANGE) / 512);
+  
+  // Appliquer la pulsation à la couleur
+  uint8_t r = (((params.color >> 16) & 0xFF) * pulseValue) / 255;
+  uint8_t g = (((params.color >> 8) & 0xFF) * pulseValue) / 255;
+  uint8_t b = ((params.color & 0xFF) * pulseValue) / 255;
+  
+  ledFill(pixels, count, r, g, b);
+  return LED_EFFECT_PULSE_DESCRIPTOR.frameIntervalMs;
+}
+
+const LEDEffectDescriptor LED_EFFECT_PULSE_DESCRIPTOR = {
+  LED_EFFECT_PULSE,
+  "PULSE",
+  16,
+  nullptr,
+  renderPulse
+};
+
+#endif // HAS_LED_EFFECT_PULSE
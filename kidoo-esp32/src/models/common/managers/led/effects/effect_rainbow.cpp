@@ -0,0 +1,25 @@
+#include "led_effect.h"
+
+#ifdef HAS_LED_EFFECT_RAINBOW
+
+// Effet arc-en-ciel qui défile
+// La teinte avance de 2 pas toutes les 16 ms (un tour complet en ~2 s)
+static uint32_t renderRainbow(uint8_t* pixels, uint16_t count, uint32_t elapsedMs, const LEDEffectParams& params) {
+  (void)params;
+  uint8_t hue = (uint8_t)(elapsedMs / 8);
+  
+  for (uint16_t i = 0; i < count; i++) {
+    ledHsvToRgb((uint8_t)(hue + i * 2), 255, 255, pixels + i * 3);
+  }
+  return LED_EFFECT_RAINBOW_DESCRIPTOR.frameIntervalMs;
+}
+
+const LEDEffectDescriptor LED_EFFECT_RAINBOW_DESCRIPTOR = {
+  LED_EFFECT_RAINBOW,
+  "RAINBOW",
+  16,
+  nullptr,
+  renderRainbow
+};
+
+#endif // HAS_LED_EFFECT_RAINBOW
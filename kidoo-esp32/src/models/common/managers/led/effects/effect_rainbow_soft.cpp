@@ -0,0 +1,41 @@
+#include "led_effect.h"
+
+#ifdef HAS_LED_EFFECT_RAINBOW_SOFT
+
+// Cycle complet de l'arc-en-ciel : ~30 secondes pour un tour complet (beaucoup plus lent)
+static const uint32_t RAINBOW_SOFT_CYCLE_MS = 30000;
+
+// Effet arc-en-ciel doux et lent pour veilleuse
+// La teinte de base ne change que tous les ~117 ms : inutile de redessiner entre deux pas
+static uint32_t renderRainbowSoft(uint8_t* pixels, uint16_t count, uint32_t elapsedMs, const LEDEffectParams& params) {
+  (void)params;
+  uint32_t elapsed = elapsedMs % RAINBOW_SOFT_CYCLE_MS;
+  
+  // Calculer la teinte de base (0 à 255)
+  uint16_t baseHue = (elapsed * 256) / RAINBOW_SOFT_CYCLE_MS;
+  
+  // Répartir l'arc-en-ciel sur toute la bande LED
+  // Chaque LED a une teinte légèrement différente pour créer un dégradé
+  for (uint16_t i = 0; i < count; i++) {
+    uint16_t hue = (baseHue + (i * 256 / count)) % 256;
+    
+    // Saturation et luminosité réduites pour un effet plus doux et apaisant
+    // Saturation: 200/255 (78%) pour des couleurs moins vives
+    // Luminosité: 180/255 (70%) pour un effet plus doux
+    ledHsvToRgb((uint8_t)hue, 200, 180, pixels + i * 3);
+  }
+  
+  // Prochaine trame utile : passage au pas de teinte suivant
+  uint32_t nextStep = ((baseHue + 1) * RAINBOW_SOFT_CYCLE_MS + 255) / 256;
+  return nextStep - elapsed;
+}
+
+const LEDEffectDescriptor LED_EFFECT_RAINBOW_SOFT_DESCRIPTOR = {
+  LED_EFFECT_RAINBOW_SOFT,
+  "RAINBOW_SOFT",
+  100,
+  nullptr,
+  renderRainbowSoft
+};
+
+#endif // HAS_LED_EFFECT_RAINBOW_SOFT
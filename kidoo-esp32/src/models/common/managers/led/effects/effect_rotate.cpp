@@ -0,0 +1,91 @@
+#include "led_effect.h"
+
+#ifdef HAS_LED_EFFECT_ROTATE
+
+// Cycle de rotation : ~5 secondes pour un tour complet
+// Plus lent = chaque LED reste allumée plus longtemps = animation plus fluide
+static const uint32_t ROTATE_CYCLE_MS = 5000;
+
+// Intensité (15-255) d'une LED selon sa distance à la tête du serpent
+static uint8_t snakeIntensity(int32_t absDistance, int32_t maxSnakeDistance) {
+  if (absDistance == 0) {
+    // Tête : luminosité maximale
+    return 255;
+  }
+  
+  // Queue vers tête : proche de la tête = plus élevé, normalisé sur 0-256
+  uint32_t x = ((uint32_t)(maxSnakeDistance - absDistance) * 256) / maxSnakeDistance;
+  
+  // Courbe en 3 zones pour fade-out progressif mais queue qui s'éteint assez vite
+  // - Queue lointaine (x < 80) : s'éteint rapidement (presque invisible)
+  // - Queue moyenne (80 < x < 180) : fade-out progressif (visible mais faible)
+  // - Queue proche vers tête (x > 180) : montée rapide vers maximum
+  uint32_t fadeValue;
+  if (x < 80) {
+    fadeValue = (x * x) / 80;  // 0-80, extinction rapide
+  } else if (x < 180) {
+    uint32_t xNormalized = x - 80;  // 0-100
+    fadeValue = 80 + (xNormalized * xNormalized) / 40;  // 80-330
+  } else {
+    uint32_t xNormalized = x - 180;  // 0-76
+    fadeValue = 330 + (xNormalized * xNormalized * xNormalized) / 300;  // 330-406
+  }
+  
+  if (fadeValue > 256) fadeValue = 256;
+  
+  // Queue lointaine : 15 (presque éteinte), moyenne : 15-150, proche : 150-255
+  return 15 + ((fadeValue * 240) / 256);
+}
+
+// Effet de rotation type "serpent" avec début (tête) et fin (queue) progressifs
+static uint32_t renderRotate(uint8_t* pixels, uint16_t count, uint32_t elapsedMs, const LEDEffectParams& params) {
+  uint32_t elapsed = elapsedMs % ROTATE_CYCLE_MS;
+  
+  // Position de la tête avec précision fractionnaire (256x) pour fluidité maximale
+  int32_t stripLengthPrecise = (int32_t)count * 256;
+  int32_t headPositionPrecise = (int32_t)(((uint64_t)elapsed * stripLengthPrecise) / ROTATE_CYCLE_MS);
+  
+  // Longueur du serpent : 30% de la bande, queue visible mais pas trop longue
+  int32_t maxSnakeDistance = (int32_t)((count * 30) / 100) * 256;
+  
+  uint8_t colorR = (params.color >> 16) & 0xFF;
+  uint8_t colorG = (params.color >> 8) & 0xFF;
+  uint8_t colorB = params.color & 0xFF;
+  
+  for (uint16_t ledIndex = 0; ledIndex < count; ledIndex++) {
+    // Centre de la LED (+128) pour une transition plus douce entre LEDs
+    int32_t ledPositionPrecise = ((int32_t)ledIndex * 256) + 128;
+    
+    // Distance depuis la tête (distance la plus courte, en tenant compte du wrap-around)
+    int32_t distanceToHead = headPositionPrecise - ledPositionPrecise;
+    if (distanceToHead > stripLengthPrecise / 2) {
+      distanceToHead -= stripLengthPrecise;
+    } else if (distanceToHead < -stripLengthPrecise / 2) {
+      distanceToHead += stripLengthPrecise;
+    }
+    int32_t absDistance = (distanceToHead < 0) ? -distanceToHead : distanceToHead;
+    
+    // LED en dehors du serpent : éteinte
+    if (absDistance > maxSnakeDistance || maxSnakeDistance == 0) {
+      ledSetPixel(pixels, ledIndex, 0, 0, 0);
+      continue;
+    }
+    
+    uint8_t intensity = snakeIntensity(absDistance, maxSnakeDistance);
+    ledSetPixel(pixels, ledIndex,
+                (colorR * intensity) / 255,
+                (colorG * intensity) / 255,
+                (colorB * intensity) / 255);
+  }
+  return LED_EFFECT_ROTATE_DESCRIPTOR.frameIntervalMs;
+}
+
+const LEDEffectDescriptor LED_EFFECT_ROTATE_DESCRIPTOR = {
+  LED_EFFECT_ROTATE,
+  "ROTATE",
+  16,
+  nullptr,
+  renderRotate
+};
+
+#endif // HAS_LED_EFFECT_ROTATE
@@ -0,0 +1,123 @@
+#ifndef LED_EFFECT_H
+#define LED_EFFECT_H
+
+#include <Arduino.h>
+#include "../../../../model_config.h"
+#include "../led_manager.h"
+
+/**
+ * Interface commune des effets LED
+ * 
+ * Chaque effet est décrit par un LEDEffectDescriptor (un par fichier effect_*.cpp)
+ * et enregistré dans le registre compile-time (led_effect_registry.cpp).
+ * Seuls les effets activés dans la config du modèle (HAS_LED_EFFECT_*) sont
+ * compilés et liés dans le firmware.
+ * 
+ * Un effet ne touche jamais directement la bande : il dessine des valeurs
+ * linéaires dans un buffer RGB (3 octets par LED) à partir du temps écoulé
+ * depuis son activation. Gamma et luminosité sont appliqués en une seule passe
+ * de sortie.
+ * LEDManager gère le démarrage, le wrap-around de millis() et l'envoi à la bande.
+ */
+
+// Aucune nouvelle trame nécessaire tant que les paramètres ne changent pas
+#define LED_EFFECT_NO_DEADLINE 0xFFFFFFFFUL
+
+// Paramètres fournis à l'effet à chaque trame
+// La luminosité n'en fait pas partie : elle est appliquée en sortie par LEDManager
+struct LEDEffectParams {
+  uint32_t color;       // Couleur définie via setColor() (0xRRGGBB)
+};
+
+/**
+ * Réinitialiser l'état interne de l'effet (optionnel, nullptr si sans état)
+ */
+typedef void (*LEDEffectInitFn)();
+
+/**
+ * Dessiner une trame
+ * @param pixels Buffer RGB (count * 3 octets)
+ * @param count Nombre de LEDs
+ * @param elapsedMs Temps écoulé depuis l'activation de l'effet (sans wrap-around)
+ * @param params Couleur courante
+ * @return Délai (ms) avant la prochaine trame utile, LED_EFFECT_NO_DEADLINE si statique
+ */
+typedef uint32_t (*LEDEffectRenderFn)(uint8_t* pixels, uint16_t count, uint32_t elapsedMs, const LEDEffectParams& params);
+
+struct LEDEffectDescriptor {
+  LEDEffect id;
+  const char* name;
+  uint16_t frameIntervalMs;   // Cadence propre à l'effet
+  LEDEffectInitFn init;
+  LEDEffectRenderFn render;
+};
+
+/**
+ * Registre des effets compilés pour ce modèle
+ */
+class LEDEffectRegistry {
+public:
+  // Trouver un effet (nullptr si non compilé pour ce modèle)
+  static const LEDEffectDescriptor* find(LEDEffect id);
+  
+  // Nombre d'effets compilés et accès par index (pour lister / benchmarker)
+  static size_t count();
+  static const LEDEffectDescriptor* at(size_t index);
+};
+
+// ============================================
+// Helpers partagés par les effets
+// ============================================
+
+inline void ledSetPixel(uint8_t* pixels, uint16_t index, uint8_t r, uint8_t g, uint8_t b) {
+  uint8_t* p = pixels + index * 3;
+  p[0] = r;
+  p[1] = g;
+  p[2] = b;
+}
+
+inline void ledFill(uint8_t* pixels, uint16_t count, uint8_t r, uint8_t g, uint8_t b) {
+  for (uint16_t i = 0; i < count; i++) {
+    ledSetPixel(pixels, i, r, g, b);
+  }
+}
+
+// Convertir HSV en RGB (entier, 8 bits)
+inline void ledHsvToRgb(uint8_t h, uint8_t s, uint8_t v, uint8_t* rgb) {
+  if (s == 0) {
+    rgb[0] = rgb[1] = rgb[2] = v;
+    return;
+  }
+  
+  uint8_t region = h / 43;
+  uint8_t remainder = (h - (region * 43)) * 6;
+  
+  uint8_t p = (v * (255 - s)) >> 8;
+  uint8_t q = (v * (255 - ((s * remainder) >> 8))) >> 8;
+  uint8_t t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+  
+  switch (region) {
+    case 0: rgb[0] = v; rgb[1] = t; rgb[2] = p; break;
+    case 1: rgb[0] = q; rgb[1] = v; rgb[2] = p; break;
+    case 2: rgb[0] = p; rgb[1] = v; rgb[2] = t; break;
+    case 3: rgb[0] = p; rgb[1] = q; rgb[2] = v; break;
+    case 4: rgb[0] = t; rgb[1] = p; rgb[2] = v; break;
+    default: rgb[0] = v; rgb[1] = p; rgb[2] = q; break;
+  }
+}
+
+// Descripteurs définis dans effects/effect_*.cpp
+extern const LEDEffectDescriptor LED_EFFECT_RAINBOW_DESCRIPTOR;
+extern const LEDEffectDescriptor LED_EFFECT_RAINBOW_SOFT_DESCRIPTOR;
+extern const LEDEffectDescriptor LED_EFFECT_PULSE_DESCRIPTOR;
+extern const LEDEffectDescriptor LED_EFFECT_GLOSSY_DESCRIPTOR;
+extern const LEDEffectDescriptor LED_EFFECT_ROTATE_DESCRIPTOR;
+extern const LEDEffectDescriptor LED_EFFECT_NIGHTLIGHT_DESCRIPTOR;
+extern const LEDEffectDescriptor LED_EFFECT_BREATHE_DESCRIPTOR;
+extern const LEDEffectDescriptor LED_EFFECT_ANIMATION_DESCRIPTOR;
+
+// Animation SD (effects/effect_animation.cpp) : fichier lu au prochain rendu
+#define LED_ANIMATION_PATH_MAX 64
+bool ledAnimationSelect(const char* path);
+
+#endif // LED_EFFECT_H
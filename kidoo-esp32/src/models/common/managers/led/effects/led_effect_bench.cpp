@@ -0,0 +1,475 @@
+#include "led_effect_bench.h"
+#include "../led_compositor.h"
+#include "../led_fixed_math.h"
+#include "../../../utils/crc_utils.h"
+#ifdef HAS_LED_EFFECT_ANIMATION
+#include <new>
+#include "../animation/led_animation.h"
+#endif
+
+// Tailles de bande mesurées (NUM_LEDS des modèles inclus)
+const uint16_t LEDEffectBench::SIZES[] = {16, 30, 42, 60, 120, 300};
+const size_t LEDEffectBench::SIZE_COUNT = sizeof(SIZES) / sizeof(SIZES[0]);
+
+// Timestamps simulés des trames de référence (début, transitions, plusieurs cycles)
+static const uint32_t GOLDEN_TIMESTAMPS_MS[] = {0, 16, 1000, 2777, 15000, 31234, 61000, 123456};
+static const size_t GOLDEN_TIMESTAMP_COUNT = sizeof(GOLDEN_TIMESTAMPS_MS) / sizeof(GOLDEN_TIMESTAMPS_MS[0]);
+
+// Paramètres fixes des trames de référence
+static const uint32_t GOLDEN_COLOR = 0xFF8000;
+
+// Checksums de référence (à régénérer si le rendu d'un effet change volontairement)
+struct GoldenEntry {
+  LEDEffect id;
+  uint32_t checksum;
+};
+
+static const GoldenEntry GOLDEN_CHECKSUMS[] = {
+  {LED_EFFECT_RAINBOW,      0xD8A62A6FUL},
+  {LED_EFFECT_PULSE,        0xA5ADFC1BUL},
+  {LED_EFFECT_GLOSSY,       0x6DC20979UL},
+  {LED_EFFECT_ROTATE,       0x6FFF89E1UL},
+  {LED_EFFECT_NIGHTLIGHT,   0x47E3573DUL},
+  {LED_EFFECT_BREATHE,      0x9257F534UL},
+  {LED_EFFECT_RAINBOW_SOFT, 0x09F309FCUL}
+};
+
+uint32_t LEDEffectBench::expectedChecksum(LEDEffect id) {
+  for (size_t i = 0; i < sizeof(GOLDEN_CHECKSUMS) / sizeof(GOLDEN_CHECKSUMS[0]); i++) {
+    if (GOLDEN_CHECKSUMS[i].id == id) {
+      return GOLDEN_CHECKSUMS[i].checksum;
+    }
+  }
+  return 0;
+}
+
+uint32_t LEDEffectBench::goldenChecksum(const LEDEffectDescriptor* effect) {
+  static uint8_t pixels[MAX_LEDS * 3];
+  
+  LEDEffectParams params;
+  params.color = GOLDEN_COLOR;
+  
+  uint32_t crc = 0;
+  for (size_t s = 0; s < SIZE_COUNT; s++) {
+    uint16_t count = SIZES[s];
+    if (effect->init != nullptr) {
+      effect->init();
+    }
+    for (size_t t = 0; t < GOLDEN_TIMESTAMP_COUNT; t++) {
+      memset(pixels, 0, count * 3);
+      effect->render(pixels, count, GOLDEN_TIMESTAMPS_MS[t], params);
+      crc = crc32Update(crc, pixels, count * 3);
+    }
+  }
+  return crc;
+}
+
+uint32_t LEDEffectBench::measureRender(const LEDEffectDescriptor* effect, uint16_t count,
+                                       uint32_t frames, uint8_t* pixels) {
+  if (frames == 0) {
+    return 0;
+  }
+  LEDEffectParams params;
+  params.color = GOLDEN_COLOR;
+  if (effect->init != nullptr) {
+    effect->init();
+  }
+  
+  // Timestamps simulés à 60 FPS
+  unsigned long start = micros();
+  for (uint32_t f = 0; f < frames; f++) {
+    effect->render(pixels, count, f * 16, params);
+  }
+  unsigned long elapsedUs = micros() - start;
+  return (uint32_t)((uint64_t)elapsedUs * 1000 / frames);
+}
+
+bool LEDEffectBench::run(uint32_t framesPerSize) {
+  if (framesPerSize == 0) {
+    framesPerSize = 1;
+  }
+  
+  // Buffer alloué seulement pendant la mesure
+  uint8_t* pixels = (uint8_t*)malloc(MAX_LEDS * 3);
+  if (pixels == nullptr) {
+    Serial.println("[LED-BENCH] ERREUR: Allocation buffer echouee");
+    return false;
+  }
+  
+  Serial.println("");
+  Serial.println("========== Benchmark effets LED ==========");
+  Serial.printf("[LED-BENCH] %u effet(s) compile(s), %lu trames par taille\n",
+                (unsigned)LEDEffectRegistry::count(), (unsigned long)framesPerSize);
+  
+  Serial.print("[LED-BENCH] Effet        ");
+  for (size_t s = 0; s < SIZE_COUNT; s++) {
+    Serial.printf(" %6u", SIZES[s]);
+  }
+  Serial.println("  (ns/trame)");
+  
+  bool allMatch = true;
+  for (size_t e = 0; e < LEDEffectRegistry::count(); e++) {
+    const LEDEffectDescriptor* effect = LEDEffectRegistry::at(e);
+    if (effect->id == LED_EFFECT_ANIMATION) {
+      // Lit la carte SD et partage son état avec la tâche LED : mesuré à part
+      continue;
+    }
+    Serial.printf("[LED-BENCH] %-13s", effect->name);
+    
+    for (size_t s = 0; s < SIZE_COUNT; s++) {
+      Serial.printf(" %6lu", (unsigned long)measureRender(effect, SIZES[s], framesPerSize, pixels));
+      
+      // Laisser tourner les autres tâches entre deux mesures
+      vTaskDelay(1);
+    }
+    
+    uint32_t checksum = goldenChecksum(effect);
+    uint32_t expected = expectedChecksum(effect->id);
+    if (expected == 0) {
+      Serial.printf("  golden=%08lX (pas de reference)\n", (unsigned long)checksum);
+    } else if (checksum == expected) {
+      Serial.println("  golden OK");
+    } else {
+      Serial.printf("  golden ECHEC (%08lX, attendu %08lX)\n", (unsigned long)checksum, (unsigned long)expected);
+      allMatch = false;
+    }
+  }
+  
+  if (!runCompositor(framesPerSize, pixels)) {
+    allMatch = false;
+  }
+  
+#ifdef HAS_LED_EFFECT_ANIMATION
+  if (!runAnimation(framesPerSize, pixels)) {
+    allMatch = false;
+  }
+#endif
+  
+  free(pixels);
+  
+  Serial.println(allMatch ? "[LED-BENCH] Trames de reference: OK" : "[LED-BENCH] Trames de reference: ECHEC");
+  Serial.println("==========================================");
+  return allMatch;
+}
+
+// Trames de référence du compositeur : calques synthétiques, luminosité 50 %
+static const uint16_t COMPOSITE_GOLDEN_ALPHAS[] = {0, 1, 8192, 16384, 24576, 32767, LED_Q15_ONE};
+
+// Deux calques + tables de sortie, alloués seulement pendant la mesure
+struct BenchLayers {
+  uint8_t* from;
+  uint8_t* to;
+  uint8_t (*lut)[256];
+  
+  bool open() {
+    from = (uint8_t*)malloc(LEDEffectBench::MAX_LEDS * 3);
+    to = (uint8_t*)malloc(LEDEffectBench::MAX_LEDS * 3);
+    lut = (uint8_t (*)[256])malloc(3 * 256);
+    if (from == nullptr || to == nullptr || lut == nullptr) {
+      close();
+      return false;
+    }
+    for (int c = 0; c < 3; c++) {
+      ledBuildOutputLut(lut[c], 128, 255);
+    }
+    return true;
+  }
+  
+  void close() {
+    free(from);
+    free(to);
+    free(lut);
+    from = nullptr;
+    to = nullptr;
+    lut = nullptr;
+  }
+};
+
+uint32_t LEDEffectBench::compositeChecksum(uint8_t* pixels) {
+  BenchLayers layers;
+  if (!layers.open()) {
+    return 0;
+  }
+  
+  // Mélange seul (indépendant des effets compilés pour le modèle)
+  uint32_t crc = 0;
+  for (size_t s = 0; s < SIZE_COUNT; s++) {
+    uint16_t count = SIZES[s];
+    for (uint16_t i = 0; i < count * 3; i++) {
+      layers.from[i] = (uint8_t)(i * 7 + 13);
+      layers.to[i] = (uint8_t)(255 - i * 3);
+    }
+    for (size_t a = 0; a < sizeof(COMPOSITE_GOLDEN_ALPHAS) / sizeof(COMPOSITE_GOLDEN_ALPHAS[0]); a++) {
+      uint16_t alpha = COMPOSITE_GOLDEN_ALPHAS[a];
+      ledCompositeFrame(pixels, layers.from, layers.to, count, alpha, layers.lut);
+      crc = crc32Update(crc, pixels, count * 3);
+      // Fondus de sleep / réveil : un des calques est noir
+      ledCompositeFrame(pixels, layers.from, nullptr, count, alpha, layers.lut);
+      crc = crc32Update(crc, pixels, count * 3);
+      ledCompositeFrame(pixels, nullptr, layers.to, count, alpha, layers.lut);
+      crc = crc32Update(crc, pixels, count * 3);
+    }
+  }
+  
+  layers.close();
+  return crc;
+}
+
+uint32_t LEDEffectBench::measureTransition(uint16_t count, uint32_t frames, uint8_t* pixels) {
+  BenchLayers layers;
+  if (frames == 0 || !layers.open()) {
+    return 0;
+  }
+  
+  // Calques rendus par deux effets du registre (les deux premiers sans état)
+  const LEDEffectDescriptor* effects[2] = {nullptr, nullptr};
+  size_t found = 0;
+  for (size_t e = 0; e < LEDEffectRegistry::count() && found < 2; e++) {
+    const LEDEffectDescriptor* effect = LEDEffectRegistry::at(e);
+    if (effect->init == nullptr) {
+      effects[found++] = effect;
+    }
+  }
+  
+  LEDEffectParams params;
+  params.color = GOLDEN_COLOR;
+  memset(layers.from, 0, count * 3);
+  memset(layers.to, 0, count * 3);
+  
+  // Trame de fondu enchaîné complète : rendu des deux calques, mélange et sortie
+  unsigned long start = micros();
+  for (uint32_t f = 0; f < frames; f++) {
+    if (effects[0] != nullptr) {
+      effects[0]->render(layers.from, count, f * 16, params);
+    }
+    if (effects[1] != nullptr) {
+      effects[1]->render(layers.to, count, f * 16, params);
+    }
+    ledCompositeFrame(pixels, layers.from, layers.to, count, (uint16_t)((f * 97) & 0x7FFF), layers.lut);
+  }
+  unsigned long elapsedUs = micros() - start;
+  
+  layers.close();
+  return (uint32_t)((uint64_t)elapsedUs * 1000 / frames);
+}
+
+bool LEDEffectBench::runCompositor(uint32_t framesPerSize, uint8_t* pixels) {
+  Serial.printf("[LED-BENCH] %-13s", "TRANSITION");
+  uint32_t worstNs = 0;
+  for (size_t s = 0; s < SIZE_COUNT; s++) {
+    uint32_t ns = measureTransition(SIZES[s], framesPerSize, pixels);
+    if (ns > worstNs) {
+      worstNs = ns;
+    }
+    Serial.printf(" %6lu", (unsigned long)ns);
+    vTaskDelay(1);
+  }
+  
+  uint32_t crc = compositeChecksum(pixels);
+  bool ok = (crc == COMPOSITE_GOLDEN_CHECKSUM);
+  if (crc == 0) {
+    Serial.println("  ERREUR: Allocation compositeur echouee");
+  } else if (ok) {
+    Serial.println("  golden OK");
+  } else {
+    Serial.printf("  golden ECHEC (%08lX, attendu %08lX)\n", (unsigned long)crc, (unsigned long)COMPOSITE_GOLDEN_CHECKSUM);
+  }
+  
+  unsigned long worstUs = worstNs / 1000;
+  bool withinBudget = (worstUs <= LED_TRANSITION_FRAME_BUDGET_US);
+  Serial.printf("[LED-BENCH] Transition: pire trame %lu us (budget %u us) %s\n",
+                worstUs, (unsigned)LED_TRANSITION_FRAME_BUDGET_US, withinBudget ? "OK" : "DEPASSE");
+  return ok && withinBudget;
+}
+
+#ifdef HAS_LED_EFFECT_ANIMATION
+
+// Animation synthétique : 16 couleurs, 60 LEDs, 32 keyframes de 250 ms, toutes les courbes
+static const uint8_t ANIM_BENCH_PALETTE = 16;
+static const uint16_t ANIM_BENCH_LEDS = 60;
+static const uint16_t ANIM_BENCH_KEYFRAMES = 32;
+static const uint16_t ANIM_BENCH_KEYFRAME_MS = 250;
+
+struct MemorySource {
+  const uint8_t* data;
+  uint32_t size;
+  uint32_t pos;
+};
+
+static int32_t readFromMemory(void* context, uint8_t* buffer, uint32_t length) {
+  MemorySource* src = (MemorySource*)context;
+  uint32_t available = src->size - src->pos;
+  if (length > available) {
+    length = available;
+  }
+  memcpy(buffer, src->data + src->pos, length);
+  src->pos += length;
+  return (int32_t)length;
+}
+
+static bool seekInMemory(void* context, uint32_t offset) {
+  MemorySource* src = (MemorySource*)context;
+  if (offset > src->size) {
+    return false;
+  }
+  src->pos = offset;
+  return true;
+}
+
+static uint32_t buildBenchAnimation(uint8_t* data) {
+  uint8_t* p = data;
+  memcpy(p, LED_ANIMATION_MAGIC, 4);
+  p[4] = LED_ANIMATION_VERSION;
+  p[5] = LED_ANIMATION_FLAG_LOOP;
+  p[6] = ANIM_BENCH_PALETTE;
+  p[7] = 0;
+  p[8] = ANIM_BENCH_LEDS & 0xFF;
+  p[9] = ANIM_BENCH_LEDS >> 8;
+  p[10] = ANIM_BENCH_KEYFRAMES & 0xFF;
+  p[11] = ANIM_BENCH_KEYFRAMES >> 8;
+  memset(p + 12, 0, 4);
+  p += LED_ANIMATION_HEADER_SIZE;
+  
+  for (uint8_t c = 0; c < ANIM_BENCH_PALETTE; c++) {
+    ledHsvToRgb(c * 16, 255, 255, p);
+    p += 3;
+  }
+  for (uint16_t k = 0; k < ANIM_BENCH_KEYFRAMES; k++) {
+    p[0] = ANIM_BENCH_KEYFRAME_MS & 0xFF;
+    p[1] = ANIM_BENCH_KEYFRAME_MS >> 8;
+    p[2] = k % LED_EASING_COUNT;
+    p[3] = 0;
+    p += LED_ANIMATION_KEYFRAME_HEADER_SIZE;
+    for (uint16_t i = 0; i < ANIM_BENCH_LEDS; i++) {
+      *p++ = (i + k * 3) % ANIM_BENCH_PALETTE;
+    }
+  }
+  return p - data;
+}
+
+// Fichier synthétique en RAM et décodeur, alloués seulement pendant la mesure
+struct BenchAnimation {
+  uint8_t* file;
+  MemorySource memory;
+  LEDAnimationSource source;
+  LEDAnimationDecoder* decoder;
+  
+  bool open() {
+    uint32_t fileSize = LED_ANIMATION_HEADER_SIZE + ANIM_BENCH_PALETTE * 3 +
+                        ANIM_BENCH_KEYFRAMES * (LED_ANIMATION_KEYFRAME_HEADER_SIZE + ANIM_BENCH_LEDS);
+    file = (uint8_t*)malloc(fileSize);
+    decoder = new (std::nothrow) LEDAnimationDecoder();
+    if (file == nullptr || decoder == nullptr) {
+      close();
+      return false;
+    }
+    buildBenchAnimation(file);
+    memory = {file, fileSize, 0};
+    source = {&memory, readFromMemory, seekInMemory};
+    return true;
+  }
+  
+  // Repartir du début du fichier
+  bool rewind() {
+    memory.pos = 0;
+    return decoder->begin(source);
+  }
+  
+  void close() {
+    delete decoder;
+    free(file);
+    decoder = nullptr;
+    file = nullptr;
+  }
+};
+
+uint32_t LEDEffectBench::animationChecksum(uint8_t* pixels) {
+  BenchAnimation anim;
+  if (!anim.open()) {
+    return 0;
+  }
+  
+  // Décodage complet (en-tête, boucle, courbes, étirement) à chaque taille de bande
+  uint32_t crc = 0;
+  bool ok = true;
+  for (size_t s = 0; s < SIZE_COUNT && ok; s++) {
+    ok = anim.rewind();
+    for (size_t t = 0; t < GOLDEN_TIMESTAMP_COUNT && ok; t++) {
+      memset(pixels, 0, SIZES[s] * 3);
+      anim.decoder->render(pixels, SIZES[s], GOLDEN_TIMESTAMPS_MS[t]);
+      crc = crc32Update(crc, pixels, SIZES[s] * 3);
+      ok = anim.decoder->isOpen();
+    }
+  }
+  if (!ok) {
+    Serial.printf("[LED-BENCH] ERREUR animation: %s\n", anim.decoder->errorMessage());
+  }
+  
+  anim.close();
+  return ok ? crc : 0;
+}
+
+uint32_t LEDEffectBench::measureAnimation(uint16_t count, uint32_t frames, uint8_t* pixels,
+                                          uint32_t* bytesRead) {
+  BenchAnimation anim;
+  if (frames == 0 || !anim.open()) {
+    return 0;
+  }
+  
+  bool ok = anim.rewind();
+  unsigned long start = micros();
+  for (uint32_t f = 0; f < frames && ok; f++) {
+    anim.decoder->render(pixels, count, f * 16);
+    ok = anim.decoder->isOpen();
+  }
+  unsigned long elapsedUs = micros() - start;
+  if (bytesRead != nullptr) {
+    *bytesRead = anim.decoder->getBytesRead();
+  }
+  if (!ok) {
+    Serial.printf("[LED-BENCH] ERREUR animation: %s\n", anim.decoder->errorMessage());
+  }
+  
+  anim.close();
+  if (!ok) {
+    return 0;
+  }
+  // Au moins 1 ns : 0 est réservé à l'échec
+  uint32_t ns = (uint32_t)((uint64_t)elapsedUs * 1000 / frames);
+  return ns > 0 ? ns : 1;
+}
+
+bool LEDEffectBench::runAnimation(uint32_t framesPerSize, uint8_t* pixels) {
+  Serial.printf("[LED-BENCH] %-13s", "ANIMATION");
+  uint64_t totalBytes = 0;
+  uint64_t totalNs = 0;
+  bool ok = true;
+  for (size_t s = 0; s < SIZE_COUNT && ok; s++) {
+    uint32_t bytesRead = 0;
+    uint32_t ns = measureAnimation(SIZES[s], framesPerSize, pixels, &bytesRead);
+    ok = (ns != 0);
+    totalNs += (uint64_t)ns * framesPerSize;
+    totalBytes += bytesRead;
+    
+    Serial.printf(" %6lu", (unsigned long)ns);
+    vTaskDelay(1);
+  }
+  
+  uint32_t crc = ok ? animationChecksum(pixels) : 0;
+  if (!ok || crc == 0) {
+    Serial.println("  ERREUR");
+    ok = false;
+  } else if (crc == ANIMATION_GOLDEN_CHECKSUM) {
+    Serial.println("  golden OK");
+  } else {
+    Serial.printf("  golden ECHEC (%08lX, attendu %08lX)\n", (unsigned long)crc, (unsigned long)ANIMATION_GOLDEN_CHECKSUM);
+    ok = false;
+  }
+  if (totalNs > 0) {
+    Serial.printf("[LED-BENCH] Animation: %lu octets lus en flux, %lu Ko/s\n",
+                  (unsigned long)totalBytes, (unsigned long)(totalBytes * 1000000000ULL / 1024 / totalNs));
+  }
+  return ok;
+}
+
+#endif // HAS_LED_EFFECT_ANIMATION
@@ -0,0 +1,104 @@
+#ifndef LED_EFFECT_BENCH_H
+#define LED_EFFECT_BENCH_H
+
+#include <Arduino.h>
+#include "led_effect.h"
+
+/**
+ * Banc de mesure du rendu des effets LED (sans matériel)
+ * 
+ * Chaque effet compilé est rendu dans des buffers RGB en RAM, pour plusieurs
+ * tailles de bande (16 à 300 LEDs) et des timestamps simulés :
+ * - temps moyen par trame (ns) pour détecter une régression de la boucle de rendu
+ * - checksum des trames rendues comparé aux trames de référence (golden frames)
+ * 
+ * - coût d'une trame de transition du compositeur comparé à son budget
+ * 
+ * Le rendu ne dépend que du descripteur d'effet : la bande réelle et la tâche LED
+ * ne sont pas touchées pendant la mesure.
+ * 
+ * Les mêmes mesures tournent sur PC (pio test -e native : test_led_effects,
+ * test_led_animation, test_led_compositor) ;
+ * la commande série led-bench les refait sur la carte.
+ */
+
+class LEDEffectBench {
+public:
+  /**
+   * Mesurer et vérifier tous les effets compilés (résultat sur Serial)
+   * @param framesPerSize Nombre de trames rendues par taille de bande
+   * @return true si toutes les trames correspondent aux références
+   */
+  static bool run(uint32_t framesPerSize);
+  
+  /**
+   * Checksum (CRC32) des trames de référence d'un effet
+   * Les trames sont rendues pour chaque taille de bande et chaque timestamp simulé
+   */
+  static uint32_t goldenChecksum(const LEDEffectDescriptor* effect);
+  
+  /**
+   * Checksum de référence stocké pour un effet
+   * @return 0 si aucune référence (effet sans trames de référence)
+   */
+  static uint32_t expectedChecksum(LEDEffect id);
+  
+  /**
+   * Temps moyen de rendu d'une trame (timestamps simulés à 60 FPS)
+   * @param pixels Buffer d'au moins count * 3 octets
+   * @return Durée moyenne par trame en ns
+   */
+  static uint32_t measureRender(const LEDEffectDescriptor* effect, uint16_t count,
+                                uint32_t frames, uint8_t* pixels);
+  
+  /**
+   * Checksum des trames de référence du compositeur (calques synthétiques,
+   * fondus enchaînés et fondus vers / depuis le noir)
+   * @return 0 si l'allocation des calques échoue
+   */
+  static uint32_t compositeChecksum(uint8_t* pixels);
+  
+  /**
+   * Temps moyen d'une trame de transition : rendu des deux calques, mélange et sortie
+   * (à comparer à LED_TRANSITION_FRAME_BUDGET_US)
+   * @return Durée moyenne par trame en ns, 0 si l'allocation échoue
+   */
+  static uint32_t measureTransition(uint16_t count, uint32_t frames, uint8_t* pixels);
+  
+  static const uint32_t COMPOSITE_GOLDEN_CHECKSUM = 0xFE435FBCUL;
+  
+#ifdef HAS_LED_EFFECT_ANIMATION
+  /**
+   * Checksum des trames de référence du décodeur d'animations keyframes
+   * (fichier synthétique en RAM, sans carte SD)
+   * @return 0 si le décodage échoue
+   */
+  static uint32_t animationChecksum(uint8_t* pixels);
+  
+  /**
+   * Temps moyen de décodage + rendu d'une trame du fichier synthétique
+   * @param bytesRead Octets lus en flux pendant la mesure (nullptr si inutile)
+   * @return Durée moyenne par trame en ns, 0 si le décodage échoue
+   */
+  static uint32_t measureAnimation(uint16_t count, uint32_t frames, uint8_t* pixels,
+                                   uint32_t* bytesRead);
+  
+  static const uint32_t ANIMATION_GOLDEN_CHECKSUM = 0x2BD8205FUL;
+#endif
+  
+  // Tailles de bande mesurées (NUM_LEDS des modèles inclus)
+  static const uint16_t SIZES[];
+  static const size_t SIZE_COUNT;
+  static const uint16_t MAX_LEDS = 300;
+
+private:
+  // Coût des trames de transition comparé au budget et trames de référence (sur Serial)
+  static bool runCompositor(uint32_t framesPerSize, uint8_t* pixels);
+  
+#ifdef HAS_LED_EFFECT_ANIMATION
+  // Débit du décodeur d'animations keyframes (fichier synthétique en RAM, sans carte SD)
+  static bool runAnimation(uint32_t framesPerSize, uint8_t* pixels);
+#endif
+};
+
+#endif // LED_EFFECT_BENCH_H
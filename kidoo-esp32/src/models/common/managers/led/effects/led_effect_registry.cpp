@@ -0,0 +1,53 @@
+#include "led_effect.h"
+
+// Registre compile-time : seuls les effets activés dans la config du modèle
+// (HAS_LED_EFFECT_*) sont référencés, les autres ne sont pas liés (-Wl,--gc-sections)
+static const LEDEffectDescriptor* const EFFECT_REGISTRY[] = {
+#ifdef HAS_LED_EFFECT_RAINBOW
+  &LED_EFFECT_RAINBOW_DESCRIPTOR,
+#endif
+#ifdef HAS_LED_EFFECT_PULSE
+  &LED_EFFECT_PULSE_DESCRIPTOR,
+#endif
+#ifdef HAS_LED_EFFECT_GLOSSY
+  &LED_EFFECT_GLOSSY_DESCRIPTOR,
+#endif
+#ifdef HAS_LED_EFFECT_ROTATE
+  &LED_EFFECT_ROTATE_DESCRIPTOR,
+#endif
+#ifdef HAS_LED_EFFECT_NIGHTLIGHT
+  &LED_EFFECT_NIGHTLIGHT_DESCRIPTOR,
+#endif
+#ifdef HAS_LED_EFFECT_BREATHE
+  &LED_EFFECT_BREATHE_DESCRIPTOR,
+#endif
+#ifdef HAS_LED_EFFECT_RAINBOW_SOFT
+  &LED_EFFECT_RAINBOW_SOFT_DESCRIPTOR,
+#endif
+#ifdef HAS_LED_EFFECT_ANIMATION
+  &LED_EFFECT_ANIMATION_DESCRIPTOR,
+#endif
+  nullptr  // Sentinelle (évite un tableau vide si aucun effet n'est activé)
+};
+
+static const size_t EFFECT_COUNT = sizeof(EFFECT_REGISTRY) / sizeof(EFFECT_REGISTRY[0]) - 1;
+
+const LEDEffectDescriptor* LEDEffectRegistry::find(LEDEffect id) {
+  for (size_t i = 0; i < EFFECT_COUNT; i++) {
+    if (EFFECT_REGISTRY[i]->id == id) {
+      return EFFECT_REGISTRY[i];
+    }
+  }
+  return nullptr;
+}
+
+size_t LEDEffectRegistry::count() {
+  return EFFECT_COUNT;
+}
+
+const LEDEffectDescriptor* LEDEffectRegistry::at(size_t index) {
+  if (index >= EFFECT_COUNT) {
+    return nullptr;
+  }
+  return EFFECT_REGISTRY[index];
+}
@@ -0,0 +1,51 @@
+#include "led_compositor.h"
+#include "led_fixed_math.h"
+
+static inline uint8_t layerValue(const uint8_t* layer, uint32_t index) {
+  return (layer != nullptr) ? layer[index] : 0;
+}
+
+void ledBlendLayers(uint8_t* out, const uint8_t* from, const uint8_t* to, uint16_t count, uint16_t alpha) {
+  uint32_t length = (uint32_t)count * 3;
+  for (uint32_t i = 0; i < length; i++) {
+    out[i] = ledLerp8(layerValue(from, i), layerValue(to, i), alpha);
+  }
+}
+
+void ledCompositeFrame(uint8_t* out, const uint8_t* from, const uint8_t* to, uint16_t count,
+                       uint16_t alpha, const uint8_t lut[3][256]) {
+  // Extrémités de la transition : un seul calque visible, pas de mélange
+  const uint8_t* single = nullptr;
+  bool blend = true;
+  if (alpha >= LED_Q15_ONE) {
+    single = to;
+    blend = false;
+  } else if (alpha == 0) {
+    single = from;
+    blend = false;
+  }
+  
+  if (!blend) {
+    if (single == nullptr) {
+      for (uint16_t i = 0; i < count; i++) {
+        uint8_t* p = out + i * 3;
+        p[0] = lut[0][0];
+        p[1] = lut[1][0];
+        p[2] = lut[2][0];
+      }
+      return;
+    }
+    for (uint32_t i = 0; i < (uint32_t)count * 3; i += 3) {
+      out[i] = lut[0][single[i]];
+      out[i + 1] = lut[1][single[i + 1]];
+      out[i + 2] = lut[2][single[i + 2]];
+    }
+    return;
+  }
+  
+  for (uint32_t i = 0; i < (uint32_t)count * 3; i += 3) {
+    out[i] = lut[0][ledLerp8(layerValue(from, i), layerValue(to, i), alpha)];
+    out[i + 1] = lut[1][ledLerp8(layerValue(from, i + 1), layerValue(to, i + 1), alpha)];
+    out[i + 2] = lut[2][ledLerp8(layerValue(from, i + 2), layerValue(to, i + 2), alpha)];
+  }
+}
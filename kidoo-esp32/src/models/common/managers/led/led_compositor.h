@@ -0,0 +1,44 @@
+#ifndef LED_COMPOSITOR_H
+#define LED_COMPOSITOR_H
+
+#include <stdint.h>
+
+/**
+ * Compositeur à deux calques pour les transitions LED
+ * 
+ * Le calque sortant (ancien effet, ancienne couleur) et le calque entrant
+ * (effet courant) sont rendus dans deux buffers RGB linéaires séparés puis
+ * mélangés en virgule fixe (alpha Q15). Un calque nullptr vaut du noir :
+ * le même chemin sert aux fondus enchaînés entre effets, à l'entrée en sleep
+ * (courant -> noir) et au réveil (noir -> courant).
+ * 
+ * Aucune dépendance Arduino : compilable et mesurable sur l'hôte.
+ */
+
+// Budget de rendu d'une trame de transition (deux calques + mélange + sortie)
+// sur la plus grande bande mesurée par led-bench (300 LEDs)
+#define LED_TRANSITION_FRAME_BUDGET_US 2000
+
+/**
+ * Mélanger deux calques dans un buffer linéaire
+ * @param out Buffer de sortie (count * 3 octets, peut être from ou to)
+ * @param from Calque sortant (nullptr = noir)
+ * @param to Calque entrant (nullptr = noir)
+ * @param count Nombre de LEDs
+ * @param alpha Progression Q15 (0 = from, LED_Q15_ONE = to)
+ */
+void ledBlendLayers(uint8_t* out, const uint8_t* from, const uint8_t* to, uint16_t count, uint16_t alpha);
+
+/**
+ * Mélanger deux calques et appliquer les tables de sortie en une seule passe
+ * @param out Octets de sortie (count * 3)
+ * @param from Calque sortant (nullptr = noir)
+ * @param to Calque entrant (nullptr = noir)
+ * @param count Nombre de LEDs
+ * @param alpha Progression Q15 (0 = from, LED_Q15_ONE = to)
+ * @param lut Tables gamma × luminosité × correction (R, G, B)
+ */
+void ledCompositeFrame(uint8_t* out, const uint8_t* from, const uint8_t* to, uint16_t count,
+                       uint16_t alpha, const uint8_t lut[3][256]);
+
+#endif // LED_COMPOSITOR_H
@@ -0,0 +1,110 @@
+#ifndef LED_FIXED_MATH_H
+#define LED_FIXED_MATH_H
+
+#include <stdint.h>
+
+/**
+ * Arithmétique en virgule fixe pour les effets LED
+ * 
+ * L'ESP32-C3 (modèles Mini et Dream) n'a pas de FPU : chaque sin() ou
+ * multiplication float est émulée en logiciel. Les effets animés utilisent
+ * donc ces helpers entiers à la place de <math.h>.
+ * 
+ * Conventions :
+ * - Q15 : 1.0 = 32768 (LED_Q15_ONE), valeurs signées -32767..32767 pour sin
+ * - Phase : un tour complet (2*PI) = 2^32, l'accumulateur uint32_t boucle
+ *   naturellement (pas de modulo, pas de gestion du wrap-around)
+ * - Les tables sont const -> stockées en flash
+ */
+
+#define LED_Q15_ONE 32768
+#define LED_SINE_TABLE_SIZE 256
+
+// Phases remarquables (fractions de tour)
+#define LED_PHASE_QUARTER 0x40000000UL  // PI/2
+#define LED_PHASE_SIXTH   0x2AAAAAAAUL  // PI/3
+
+extern const int16_t LED_SINE_Q15_TABLE[LED_SINE_TABLE_SIZE + 1];
+
+// Courbe gamma 2.2 : intensité lumineuse 16 bits (0..65535) par valeur linéaire 8 bits
+extern const uint16_t LED_GAMMA16_TABLE[256];
+
+/**
+ * Sinus Q15 par table + interpolation linéaire
+ * @param phase Phase 32 bits (2^32 = un tour)
+ * @return sin(phase) en Q15 (-32767..32767)
+ */
+inline int16_t ledSinQ15(uint32_t phase) {
+  uint32_t index = phase >> 24;
+  int32_t frac = (phase >> 8) & 0xFFFF;
+  int32_t a = LED_SINE_Q15_TABLE[index];
+  int32_t b = LED_SINE_Q15_TABLE[index + 1];
+  return (int16_t)(a + (((b - a) * frac) >> 16));
+}
+
+/**
+ * Convertir un temps écoulé dans un cycle en phase 32 bits
+ * @param elapsedMs Temps écoulé (doit être < cycleMs)
+ * @param cycleMs Durée d'un tour complet
+ * @return Phase 32 bits (2^32 = cycleMs)
+ */
+inline uint32_t ledPhaseFromMs(uint32_t elapsedMs, uint32_t cycleMs) {
+  return (uint32_t)(((uint64_t)elapsedMs << 32) / cycleMs);
+}
+
+/**
+ * Progression linéaire Q15 (0..LED_Q15_ONE) d'une durée
+ * @param elapsedMs Temps écoulé (borné à durationMs)
+ * @param durationMs Durée totale
+ */
+inline uint16_t ledProgressQ15(uint32_t elapsedMs, uint32_t durationMs) {
+  if (elapsedMs >= durationMs) {
+    return LED_Q15_ONE;
+  }
+  return (uint16_t)(((uint64_t)elapsedMs << 15) / durationMs);
+}
+
+/**
+ * Courbe ease-in-out (smoothstep : t² * (3 - 2t)) en Q15
+ * Calculée plutôt que tabulée : deux multiplications entières coûtent moins
+ * qu'une lecture de table interpolée comme ledSinQ15
+ * @param t Progression Q15 (0..LED_Q15_ONE)
+ * @return Progression lissée Q15 (0..LED_Q15_ONE)
+ */
+inline uint16_t ledSmoothstepQ15(uint16_t t) {
+  uint32_t t2 = ((uint32_t)t * t) >> 15;
+  return (uint16_t)((t2 * (3UL * LED_Q15_ONE - 2UL * t)) >> 15);
+}
+
+/**
+ * Interpolation entière entre deux composantes 8 bits
+ * @param from Valeur de départ
+ * @param to Valeur d'arrivée
+ * @param t Progression Q15 (0..LED_Q15_ONE)
+ */
+inline uint8_t ledLerp8(uint8_t from, uint8_t to, uint16_t t) {
+  return (uint8_t)((((int32_t)from << 15) + ((int32_t)to - from) * (int32_t)t) >> 15);
+}
+
+/**
+ * Mettre à l'échelle une composante 8 bits par un facteur Q15
+ * @param value Composante (0-255)
+ * @param factor Facteur Q15 (0..LED_Q15_ONE)
+ */
+inline uint8_t ledScale8Q15(uint8_t value, uint16_t factor) {
+  return (uint8_t)(((uint32_t)value * factor) >> 15);
+}
+
+/**
+ * Construire la table de sortie d'un canal : gamma × luminosité × correction
+ * 
+ * Une valeur non nulle reste au minimum à 1 tant que la luminosité et la
+ * correction sont non nulles : les faibles luminosités (bedtime) ne tombent
+ * pas au noir.
+ * @param lut Table de 256 entrées à remplir
+ * @param brightness Luminosité globale (0-255)
+ * @param correction Correction du canal (0-255, 255 = aucune)
+ */
+void ledBuildOutputLut(uint8_t* lut, uint8_t brightness, uint8_t correction);
+
+#endif // LED_FIXED_MATH_H
@@ -0,0 +1,212 @@
+#include "led_latency.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <string.h>
+
+LEDLatency::SourceStats LEDLatency::sources[LED_SOURCE_COUNT];
+
+// Portées ouvertes, une par tâche réceptrice (PubNub, BLE, série, loop)
+struct ActiveStamp {
+  TaskHandle_t task;
+  uint32_t receivedUs;
+  LEDCommandSource source;
+  int depth;
+};
+static const int MAX_ACTIVE_STAMPS = 4;
+static ActiveStamp activeStamps[MAX_ACTIVE_STAMPS];
+static portMUX_TYPE latencyMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Bornes supérieures des classes de l'histogramme (ms), la dernière classe est >= 500 ms
+static const uint32_t BUCKET_LIMITS_MS[] = {1, 2, 5, 10, 20, 50, 100, 200, 500};
+
+static const char* SOURCE_NAMES[LED_SOURCE_COUNT] = {"pubnub", "ble", "serial", "potentiometer"};
+
+void LEDLatency::beginCommand(LEDCommandSource source, uint32_t receivedUs) {
+  if (receivedUs == 0) {
+    receivedUs = micros();
+  }
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+
+  portENTER_CRITICAL(&latencyMux);
+  ActiveStamp* freeStamp = nullptr;
+  for (int i = 0; i < MAX_ACTIVE_STAMPS; i++) {
+    if (activeStamps[i].depth > 0 && activeStamps[i].task == task) {
+      // Portée imbriquée : la source externe est conservée
+      activeStamps[i].depth++;
+      portEXIT_CRITICAL(&latencyMux);
+      return;
+    }
+    if (activeStamps[i].depth == 0 && freeStamp == nullptr) {
+      freeStamp = &activeStamps[i];
+    }
+  }
+  // Plus de place : la commande ne sera simplement pas mesurée
+  if (freeStamp != nullptr) {
+    freeStamp->task = task;
+    freeStamp->receivedUs = receivedUs;
+    freeStamp->source = source;
+    freeStamp->depth = 1;
+  }
+  portEXIT_CRITICAL(&latencyMux);
+}
+
+void LEDLatency::endCommand() {
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+  portENTER_CRITICAL(&latencyMux);
+  for (int i = 0; i < MAX_ACTIVE_STAMPS; i++) {
+    if (activeStamps[i].depth > 0 && activeStamps[i].task == task) {
+      activeStamps[i].depth--;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&latencyMux);
+}
+
+bool LEDLatency::currentStamp(LEDCommandSource& source, uint32_t& receivedUs) {
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+  bool found = false;
+  portENTER_CRITICAL(&latencyMux);
+  for (int i = 0; i < MAX_ACTIVE_STAMPS; i++) {
+    if (activeStamps[i].depth > 0 && activeStamps[i].task == task) {
+      source = activeStamps[i].source;
+      receivedUs = activeStamps[i].receivedUs;
+      found = true;
+      break;
+    }
+  }
+  portEXIT_CRITICAL(&latencyMux);
+  return found;
+}
+
+void LEDLatency::record(LEDCommandSource source, uint32_t latencyUs) {
+  if (source >= LED_SOURCE_COUNT) {
+    return;
+  }
+  uint32_t latencyMs = latencyUs / 1000;
+  int bucket = 0;
+  while (bucket < HISTOGRAM_BUCKETS - 1 && latencyMs >= BUCKET_LIMITS_MS[bucket]) {
+    bucket++;
+  }
+
+  portENTER_CRITICAL(&latencyMux);
+  SourceStats& stats = sources[source];
+  stats.count++;
+  stats.histogram[bucket]++;
+  if (latencyUs > stats.maxUs) {
+    stats.maxUs = latencyUs;
+  }
+  stats.samplesUs[stats.sampleIndex] = latencyUs;
+  stats.sampleIndex = (stats.sampleIndex + 1) % SAMPLE_COUNT;
+  portEXIT_CRITICAL(&latencyMux);
+}
+
+void LEDLatency::percentiles(const SourceStats& stats, uint32_t& p50Us, uint32_t& p95Us) {
+  int n = (stats.count < (uint32_t)SAMPLE_COUNT) ? (int)stats.count : SAMPLE_COUNT;
+  if (n == 0) {
+    p50Us = 0;
+    p95Us = 0;
+    return;
+  }
+  // Tri par insertion d'une copie (32 valeurs au plus)
+  uint32_t sorted[SAMPLE_COUNT];
+  for (int i = 0; i < n; i++) {
+    uint32_t value = stats.samplesUs[i];
+    int j = i;
+    while (j > 0 && sorted[j - 1] > value) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = value;
+  }
+  p50Us = sorted[(n - 1) / 2];
+  p95Us = sorted[(n * 95 + 99) / 100 - 1];
+}
+
+const char* LEDLatency::sourceName(LEDCommandSource source) {
+  return (source < LED_SOURCE_COUNT) ? SOURCE_NAMES[source] : "?";
+}
+
+void LEDLatency::printStats(bool reset) {
+  // Copie sous verrou : la tâche LED continue d'enregistrer pendant l'affichage
+  SourceStats snapshot[LED_SOURCE_COUNT];
+  portENTER_CRITICAL(&latencyMux);
+  memcpy(snapshot, sources, sizeof(snapshot));
+  if (reset) {
+    memset(sources, 0, sizeof(sources));
+  }
+  portEXIT_CRITICAL(&latencyMux);
+
+  static const char* bucketLabels[HISTOGRAM_BUCKETS] = {
+    "<1ms", "<2ms", "<5ms", "<10ms", "<20ms", "<50ms", "<100ms", "<200ms", "<500ms", ">=500ms"
+  };
+
+  Serial.println("");
+  Serial.println("====== Latence commande -> LED ======");
+  bool any = false;
+  for (int s = 0; s < LED_SOURCE_COUNT; s++) {
+    const SourceStats& stats = snapshot[s];
+    if (stats.count == 0) {
+      continue;
+    }
+    any = true;
+    uint32_t p50Us, p95Us;
+    percentiles(stats, p50Us, p95Us);
+    Serial.printf("[LED-LAT] %s: %lu commandes, p50=%lu.%lu ms p95=%lu.%lu ms max=%lu.%lu ms\n",
+                  SOURCE_NAMES[s], (unsigned long)stats.count,
+                  (unsigned long)(p50Us / 1000), (unsigned long)(p50Us % 1000 / 100),
+                  (unsigned long)(p95Us / 1000), (unsigned long)(p95Us % 1000 / 100),
+                  (unsigned long)(stats.maxUs / 1000), (unsigned long)(stats.maxUs % 1000 / 100));
+    Serial.print("[LED-LAT]  ");
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+      if (stats.histogram[i] > 0) {
+        Serial.printf(" %s=%lu", bucketLabels[i], (unsigned long)stats.histogram[i]);
+      }
+    }
+    Serial.println("");
+  }
+  if (!any) {
+    Serial.println("[LED-LAT] Aucune commande mesuree");
+  }
+  Serial.println("[LED-LAT] Percentiles sur les 32 dernieres commandes par source");
+  Serial.println("=====================================");
+  if (reset) {
+    Serial.println("[LED-LAT] Compteurs remis a zero");
+  }
+}
+
+size_t LEDLatency::formatJson(char* buffer, size_t size) {
+  SourceStats snapshot[LED_SOURCE_COUNT];
+  portENTER_CRITICAL(&latencyMux);
+  memcpy(snapshot, sources, sizeof(snapshot));
+  portEXIT_CRITICAL(&latencyMux);
+
+  size_t len = 0;
+  int written = snprintf(buffer, size, "{");
+  if (written < 0 || (size_t)written >= size) {
+    return 0;
+  }
+  len = written;
+  bool first = true;
+  for (int s = 0; s < LED_SOURCE_COUNT; s++) {
+    const SourceStats& stats = snapshot[s];
+    if (stats.count == 0) {
+      continue;
+    }
+    uint32_t p50Us, p95Us;
+    percentiles(stats, p50Us, p95Us);
+    written = snprintf(buffer + len, size - len, "%s\"%s\":{\"n\":%lu,\"p50\":%lu,\"p95\":%lu,\"max\":%lu}",
+                       first ? "" : ",", SOURCE_NAMES[s], (unsigned long)stats.count,
+                       (unsigned long)(p50Us / 1000), (unsigned long)(p95Us / 1000),
+                       (unsigned long)(stats.maxUs / 1000));
+    if (written < 0 || (size_t)written >= size - len) {
+      return 0;
+    }
+    len += written;
+    first = false;
+  }
+  written = snprintf(buffer + len, size - len, "}");
+  if (written < 0 || (size_t)written >= size - len) {
+    return 0;
+  }
+  return len + written;
+}
@@ -0,0 +1,92 @@
+#ifndef LED_LATENCY_H
+#define LED_LATENCY_H
+
+#include <Arduino.h>
+
+/**
+ * Latence commande -> photon, par source de commande
+ *
+ * La tâche qui reçoit une commande (PubNub, BLE, série, potentiomètre) ouvre
+ * une portée LEDLatencyScope avant d'exécuter le handler : les commandes LED
+ * envoyées pendant cette portée portent l'instant de réception. LEDManager le
+ * conserve dans la boîte aux lettres puis enregistre la latence à la première
+ * trame émise après le traitement de la commande.
+ *
+ * Les commandes envoyées hors portée (routines, timers, init) ne sont pas mesurées.
+ */
+
+enum LEDCommandSource {
+  LED_SOURCE_PUBNUB,
+  LED_SOURCE_BLE,
+  LED_SOURCE_SERIAL,
+  LED_SOURCE_POTENTIOMETER,
+  LED_SOURCE_COUNT
+};
+
+class LEDLatency {
+public:
+  /**
+   * Marquer la réception d'une commande par la tâche courante
+   * Les portées imbriquées gardent la source et l'instant de la plus externe
+   * (une commande série reçue par PubNub reste attribuée à PubNub).
+   * @param receivedUs Instant de réception (micros()), 0 = maintenant
+   */
+  static void beginCommand(LEDCommandSource source, uint32_t receivedUs = 0);
+  static void endCommand();
+
+  /**
+   * Réception en cours pour la tâche appelante (appelé par LEDManager::sendCommand)
+   * @return false si la tâche n'est dans aucune portée
+   */
+  static bool currentStamp(LEDCommandSource& source, uint32_t& receivedUs);
+
+  // Enregistrer une latence mesurée (tâche LED)
+  static void record(LEDCommandSource source, uint32_t latencyUs);
+
+  // Afficher les histogrammes et percentiles par source
+  static void printStats(bool reset = false);
+
+  /**
+   * Écrire les percentiles en JSON (sources mesurées seulement), pour get-info
+   * Format : {"pubnub":{"n":12,"p50":18,"p95":41,"max":63},...} (ms)
+   * @return Longueur écrite (0 si le buffer est trop petit)
+   */
+  static size_t formatJson(char* buffer, size_t size);
+
+  static const char* sourceName(LEDCommandSource source);
+
+private:
+  static const int SAMPLE_COUNT = 32;      // Dernières mesures (percentiles)
+  static const int HISTOGRAM_BUCKETS = 10;
+
+  struct SourceStats {
+    uint32_t count;
+    uint32_t maxUs;
+    uint32_t histogram[HISTOGRAM_BUCKETS];
+    uint32_t samplesUs[SAMPLE_COUNT];
+    int sampleIndex;
+  };
+
+  // Percentiles (µs) sur les dernières mesures
+  static void percentiles(const SourceStats& stats, uint32_t& p50Us, uint32_t& p95Us);
+
+  static SourceStats sources[LED_SOURCE_COUNT];
+};
+
+/**
+ * Portée de réception d'une commande (voir LEDLatency::beginCommand)
+ */
+class LEDLatencyScope {
+public:
+  explicit LEDLatencyScope(LEDCommandSource source, uint32_t receivedUs = 0) {
+    LEDLatency::beginCommand(source, receivedUs);
+  }
+  ~LEDLatencyScope() {
+    LEDLatency::endCommand();
+  }
+
+  LEDLatencyScope(const LEDLatencyScope&) = delete;
+  LEDLatencyScope& operator=(const LEDLatencyScope&) = delete;
+};
+
+#endif // LED_LATENCY_H
@@ -1,13 +1,13 @@
 #include "led_manager.h"
 #include "../init/init_manager.h"
 #include "../sd/sd_manager.h"
+#include "../config/config_manager.h"
 #include "../../../model_config.h"
 #include "../../config/core_config.h"
-#include <math.h>
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+#include "effects/led_effect.h"
+#include "output/led_output.h"
+#include "led_fixed_math.h"
+#include "led_compositor.h"
 
 #ifdef HAS_WIFI
 #include "../wifi/wifi_manager.h"
@@ -17,53 +17,55 @@
 #include "../ble_config/ble_config_manager.h"
 #endif
 
-// Fonction utilitaire pour convertir HSV en RGB (format NeoPixel)
-static uint32_t hsvToRgb(uint8_t h, uint8_t s, uint8_t v) {
-  uint8_t r, g, b;
-  
-  if (s == 0) {
-    r = g = b = v;
-  } else {
-    uint8_t region = h / 43;
-    uint8_t remainder = (h - (region * 43)) * 6;
-    
-    uint8_t p = (v * (255 - s)) >> 8;
-    uint8_t q = (v * (255 - ((s * remainder) >> 8))) >> 8;
-    uint8_t t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
-    
-    switch (region) {
-      case 0: r = v; g = t; b = p; break;
-      case 1: r = q; g = v; b = p; break;
-      case 2: r = p; g = v; b = t; break;
-      case 3: r = p; g = q; b = v; break;
-      case 4: r = t; g = p; b = v; break;
-      default: r = v; g = p; b = q; break;
-    }
-  }
-  
-  return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
-}
-
 // Variables statiques
 bool LEDManager::initialized = false;
 TaskHandle_t LEDManager::taskHandle = nullptr;
-QueueHandle_t LEDManager::commandQueue = nullptr;
-Adafruit_NeoPixel* LEDManager::strip = nullptr;
+LEDManager::MailboxSlot LEDManager::mailbox[MAILBOX_SLOT_COUNT];
+std::atomic<uint32_t> LEDManager::mailboxGeneration(0);
+uint32_t LEDManager::mailboxSeenGeneration[MAILBOX_SLOT_COUNT];
+uint32_t LEDManager::mailboxSeenWrites[MAILBOX_SLOT_COUNT];
+uint32_t LEDManager::commandsApplied = 0;
+std::atomic<uint32_t> LEDManager::commandsCoalesced(0);
+std::atomic<uint32_t> LEDManager::commandsDropped(0);
+uint32_t LEDManager::latencyPendingUs[LED_SOURCE_COUNT] = {0};
+bool LEDManager::latencyPending[LED_SOURCE_COUNT] = {false};
+uint32_t LEDManager::frameTimeHistogram[HISTOGRAM_BUCKETS];
+uint32_t LEDManager::frameJitterHistogram[HISTOGRAM_BUCKETS];
+uint32_t LEDManager::frameTimeMaxUs = 0;
+uint32_t LEDManager::frameJitterMaxMs = 0;
+const LEDOutputDriver* LEDManager::output = nullptr;
 uint8_t LEDManager::currentBrightness = DEFAULT_LED_BRIGHTNESS;
 LEDEffect LEDManager::currentEffect = LED_EFFECT_NONE;
 uint32_t LEDManager::currentColor = 0;  // Noir par défaut
 unsigned long LEDManager::lastUpdateTime = 0;
 unsigned long LEDManager::lastActivityTime = 0;
 bool LEDManager::isSleeping = false;
-bool LEDManager::isFadingToSleep = false;
-bool LEDManager::isFadingFromSleep = false;
-unsigned long LEDManager::sleepFadeStartTime = 0;
 LEDEffect LEDManager::savedEffect = LED_EFFECT_NONE;
 unsigned long LEDManager::rotateActivationTime = 0;  // Temps d'activation de l'effet ROTATE pour désactivation automatique
 uint32_t LEDManager::sleepTimeoutMs = 0;
 bool LEDManager::sleepPrevented = false;
-bool LEDManager::pulseNeedsReset = false;
+bool LEDManager::effectNeedsRestart = false;
+const LEDEffectDescriptor* LEDManager::activeEffect = nullptr;
+LEDEffect LEDManager::activeEffectId = LED_EFFECT_NONE;
+unsigned long LEDManager::effectStartTime = 0;
+uint32_t LEDManager::nextFrameDelayMs = 0;
+uint8_t LEDManager::frameBuffer[NUM_LEDS * 3];
+volatile LEDManager::TransitionKind LEDManager::transitionKind = TRANSITION_NONE;
+volatile unsigned long LEDManager::transitionStartTime = 0;
+uint16_t LEDManager::transitionDurationMs = 0;
+uint16_t LEDManager::crossfadeDurationMs = LED_TRANSITION_DURATION_MS;
+uint8_t LEDManager::outgoingBuffer[NUM_LEDS * 3];
+const LEDEffectDescriptor* LEDManager::outgoingEffect = nullptr;
+unsigned long LEDManager::outgoingStartTime = 0;
+uint32_t LEDManager::outgoingColor = 0;
+bool LEDManager::incomingRendered = true;
+uint8_t LEDManager::outputLut[3][256];
+uint8_t LEDManager::outputBrightness = 0;
 bool LEDManager::hardwareInitialized = false;
+uint8_t LEDManager::shadowFrame[NUM_LEDS * 3];
+bool LEDManager::shadowValid = false;
+uint32_t LEDManager::framesPushed = 0;
+uint32_t LEDManager::framesSkipped = 0;
 bool LEDManager::testSequentialActive = false;
 int LEDManager::testSequentialIndex = 0;
 unsigned long LEDManager::testSequentialLastUpdate = 0;
@@ -78,38 +80,29 @@ bool LEDManager::init() {
   }
   
   // Récupérer la configuration globale
-  const SDConfig& config = InitManager::getConfig();
+  const SDConfig& config = ConfigManager::get();
   currentBrightness = config.led_brightness;
   sleepTimeoutMs = config.sleep_timeout_ms;
   lastActivityTime = millis();
   isSleeping = false;
   Serial.printf("[LED] Brightness=%d, SleepTimeout=%lu\n", currentBrightness, sleepTimeoutMs);
   
-  // Créer l'objet NeoPixel (l'initialisation matérielle sera faite dans la task)
-  // NEO_GRB pour WS2812B (ordre des couleurs GRB)
-  Serial.println("[LED] Creation objet NeoPixel...");
-  strip = new Adafruit_NeoPixel(NUM_LEDS, LED_DATA_PIN, NEO_GRB + NEO_KHZ800);
+  // Sélectionner le driver de sortie (l'initialisation matérielle sera faite dans la task)
+  // Ne PAS l'initialiser ici : cela peut nécessiter le scheduler
+  output = ledOutputDriver();
+  Serial.printf("[LED] Driver de sortie: %s (init differee dans task)\n", output->name);
   
-  if (!strip) {
-    Serial.println("[LED] ERREUR: Allocation memoire echouee!");
-    return false;
+  // Boîte aux lettres des commandes : statique, rien à allouer
+  // Les compteurs de génération repartent de zéro (aucune commande en attente)
+  for (int i = 0; i < MAILBOX_SLOT_COUNT; i++) {
+    mailbox[i].value.store(0);
+    mailbox[i].generation.store(0);
+    mailbox[i].writes.store(0);
+    mailbox[i].stamp.store(0);
+    mailboxSeenGeneration[i] = 0;
+    mailboxSeenWrites[i] = 0;
   }
-  Serial.println("[LED] Objet NeoPixel OK");
-  
-  // Ne PAS initialiser NeoPixel.begin() ici : cela peut nécessiter le scheduler
-  // L'init matérielle NeoPixel est faite dans ledTask() au premier run.
-  Serial.println("[LED] Init NeoPixel differe (dans task)...");
-  
-  // Créer la queue de commandes
-  Serial.println("[LED] Creation queue...");
-  commandQueue = xQueueCreate(QUEUE_SIZE, sizeof(LEDCommand));
-  if (commandQueue == nullptr) {
-    Serial.println("[LED] ERREUR: Creation queue echouee!");
-    delete strip;
-    strip = nullptr;
-    return false;
-  }
-  Serial.println("[LED] Queue OK");
+  mailboxGeneration.store(0);
   
   // Créer le thread de gestion des LEDs sur Core 1 (temps-réel)
   Serial.println("[LED] Creation task...");
@@ -126,10 +119,7 @@ bool LEDManager::init() {
   
   if (result != pdPASS) {
     Serial.printf("[LED] ERREUR: Creation task echouee! Code=%d\n", result);
-    vQueueDelete(commandQueue);
-    commandQueue = nullptr;
-    delete strip;
-    strip = nullptr;
+    output = nullptr;
     return false;
   }
   Serial.println("[LED] Task OK");
@@ -157,14 +147,9 @@ void LEDManager::stop() {
     taskHandle = nullptr;
   }
   
-  if (commandQueue != nullptr) {
-    vQueueDelete(commandQueue);
-    commandQueue = nullptr;
-  }
-  
-  if (strip != nullptr) {
-    delete strip;
-    strip = nullptr;
+  if (output != nullptr) {
+    output->end();
+    output = nullptr;
   }
   
   initialized = false;
@@ -173,13 +158,127 @@ void LEDManager::stop() {
 }
 
 bool LEDManager::sendCommand(const LEDCommand& cmd) {
-  if (!initialized || commandQueue == nullptr) {
+  if (!initialized) {
+    commandsDropped.fetch_add(1);
     return false;
   }
   
-  // Envoyer la commande à la queue (non-bloquant)
-  BaseType_t result = xQueueSend(commandQueue, &cmd, 0);
-  return (result == pdTRUE);
+  // Chaque type de commande a sa case : la dernière écriture remplace la précédente
+  // (pas de file pleine, pas de verrou). La génération globale conserve l'ordre
+  // relatif entre cases pour la tâche LED.
+  int slot;
+  uint32_t value = 0;
+  switch (cmd.type) {
+    case LED_CMD_SET_COLOR:
+      slot = MAILBOX_COLOR;
+      value = ((uint32_t)cmd.data.color.r << 16) | ((uint32_t)cmd.data.color.g << 8) | cmd.data.color.b;
+      break;
+    case LED_CMD_SET_BRIGHTNESS:
+      slot = MAILBOX_BRIGHTNESS;
+      value = cmd.data.brightness;
+      break;
+    case LED_CMD_SET_EFFECT:
+      slot = MAILBOX_EFFECT;
+      value = (uint32_t)cmd.data.effect;
+      break;
+    case LED_CMD_CLEAR:
+      slot = MAILBOX_CLEAR;
+      break;
+    case LED_CMD_TEST_SEQUENTIAL:
+      slot = MAILBOX_TEST;
+      break;
+    default:
+      commandsDropped.fetch_add(1);
+      return false;
+  }
+  
+  // Valeur d'abord, génération ensuite : la tâche LED relit la valeur après avoir
+  // vu la génération changer, elle converge toujours vers la dernière valeur écrite
+  mailbox[slot].value.store(value, std::memory_order_relaxed);
+  mailbox[slot].writes.fetch_add(1, std::memory_order_relaxed);
+  
+  // Commande reçue de l'extérieur (PubNub, BLE, série...) : garder l'instant de réception
+  // le plus ancien de la case, la latence mesurée est celle de la première commande fusionnée
+  LEDCommandSource source;
+  uint32_t receivedUs;
+  if (LEDLatency::currentStamp(source, receivedUs)) {
+    uint32_t expected = 0;
+    mailbox[slot].stamp.compare_exchange_strong(expected, (receivedUs & ~7u) | ((uint32_t)source + 1),
+                                               std::memory_order_relaxed);
+  }
+  mailbox[slot].generation.store(mailboxGeneration.fetch_add(1) + 1, std::memory_order_release);
+  
+  // Réveiller la tâche LED (elle dort jusqu'à sa prochaine échéance)
+  notifyTask();
+  return true;
+}
+
+void LEDManager::notifyTask() {
+  if (taskHandle != nullptr) {
+    xTaskNotifyGive(taskHandle);
+  }
+}
+
+bool LEDManager::takeCommand(LEDCommand& cmd) {
+  // Case en attente la plus ancienne (ordre des dernières écritures)
+  int slot = -1;
+  uint32_t oldest = 0;
+  for (int i = 0; i < MAILBOX_SLOT_COUNT; i++) {
+    uint32_t generation = mailbox[i].generation.load(std::memory_order_acquire);
+    if (generation != mailboxSeenGeneration[i] && (slot < 0 || generation < oldest)) {
+      slot = i;
+      oldest = generation;
+    }
+  }
+  if (slot < 0) {
+    return false;
+  }
+  
+  mailboxSeenGeneration[slot] = oldest;
+  uint32_t value = mailbox[slot].value.load(std::memory_order_relaxed);
+  
+  // Écritures remplacées avant d'avoir été traitées
+  uint32_t writes = mailbox[slot].writes.load(std::memory_order_relaxed);
+  if (writes - mailboxSeenWrites[slot] > 1) {
+    commandsCoalesced.fetch_add(writes - mailboxSeenWrites[slot] - 1);
+  }
+  mailboxSeenWrites[slot] = writes;
+  commandsApplied++;
+  
+  uint32_t stamp = mailbox[slot].stamp.exchange(0, std::memory_order_relaxed);
+  if (stamp != 0) {
+    int source = (int)(stamp & 7u) - 1;
+    uint32_t receivedUs = stamp & ~7u;
+    if (source >= 0 && source < LED_SOURCE_COUNT &&
+        (!latencyPending[source] || (int32_t)(receivedUs - latencyPendingUs[source]) < 0)) {
+      latencyPendingUs[source] = receivedUs;
+      latencyPending[source] = true;
+    }
+  }
+  
+  switch (slot) {
+    case MAILBOX_COLOR:
+      cmd.type = LED_CMD_SET_COLOR;
+      cmd.data.color.r = (value >> 16) & 0xFF;
+      cmd.data.color.g = (value >> 8) & 0xFF;
+      cmd.data.color.b = value & 0xFF;
+      break;
+    case MAILBOX_BRIGHTNESS:
+      cmd.type = LED_CMD_SET_BRIGHTNESS;
+      cmd.data.brightness = (uint8_t)value;
+      break;
+    case MAILBOX_EFFECT:
+      cmd.type = LED_CMD_SET_EFFECT;
+      cmd.data.effect = (LEDEffect)value;
+      break;
+    case MAILBOX_CLEAR:
+      cmd.type = LED_CMD_CLEAR;
+      break;
+    default:
+      cmd.type = LED_CMD_TEST_SEQUENTIAL;
+      break;
+  }
+  return true;
 }
 
 bool LEDManager::setColor(uint8_t r, uint8_t g, uint8_t b) {
@@ -221,7 +320,12 @@ bool LEDManager::setBrightness(uint8_t brightness) {
 }
 
 const char* LEDManager::getEffectName(LEDEffect effect) {
-  static const char* effectNames[] = {"NONE", "RAINBOW", "PULSE", "GLOSSY", "ROTATE", "NIGHTLIGHT", "BREATHE", "RAINBOW_SOFT"};
+  const LEDEffectDescriptor* descriptor = LEDEffectRegistry::find(effect);
+  if (descriptor != nullptr) {
+    return descriptor->name;
+  }
+  // Effet non compilé pour ce modèle (ou NONE) : nom conservé pour les logs
+  static const char* effectNames[] = {"NONE", "RAINBOW", "PULSE", "GLOSSY", "ROTATE", "NIGHTLIGHT", "BREATHE", "RAINBOW_SOFT", "ANIMATION"};
   if (effect >= 0 && effect < sizeof(effectNames) / sizeof(effectNames[0])) {
     return effectNames[effect];
   }
@@ -255,6 +359,17 @@ bool LEDManager::setEffect(LEDEffect effect) {
   return result;
 }
 
+#ifdef HAS_LED_EFFECT_ANIMATION
+bool LEDManager::playAnimation(const char* path) {
+  if (!ledAnimationSelect(path)) {
+    Serial.println("[LED] playAnimation: chemin invalide");
+    return false;
+  }
+  // Renvoyer l'effet même s'il est déjà actif : la tâche LED redémarre l'animation
+  return setEffect(LED_EFFECT_ANIMATION);
+}
+#endif
+
 bool LEDManager::clear() {
   LEDCommand cmd;
   cmd.type = LED_CMD_CLEAR;
@@ -284,33 +399,43 @@ bool LEDManager::testLEDsSequential() {
 }
 
 void LEDManager::ledTask(void* parameter) {
-  // Init matérielle NeoPixel au premier run
-  if (!hardwareInitialized) {
-    if (strip != nullptr) {
-      strip->begin();
-      strip->setBrightness(currentBrightness);
-      strip->clear();
-      strip->show();
+  // Init matérielle de la sortie LED au premier run
+  if (!hardwareInitialized && output != nullptr) {
+    if (!output->begin(NUM_LEDS, LED_DATA_PIN)) {
+      Serial.printf("[LED] ERREUR: Init sortie %s echouee!\n", output->name);
+      output = nullptr;
+    } else {
+      // La bande vient d'être effacée : trame linéaire et image de référence noires
+      memset(frameBuffer, 0, sizeof(frameBuffer));
+      memset(shadowFrame, 0, sizeof(shadowFrame));
+      rebuildOutputLut(currentBrightness);
+      shadowValid = true;
       hardwareInitialized = true;
     }
   }
 
   // Ce thread tourne en continu et ne s'arrête jamais
-  // IMPORTANT: On limite les appels à strip->show() pour ne pas interférer avec l'audio I2S
-  // strip->show() peut désactiver brièvement les interruptions, ce qui peut causer des grésillements
+  // IMPORTANT: La cadence des trames dépend du driver de sortie : le show() bloquant
+  // de NeoPixel peut désactiver brièvement les interruptions (grésillements I2S),
+  // il est donc limité à ~30 FPS ; le driver RMT asynchrone tient 60 FPS
   
   static unsigned long lastShowTime = 0;
-  static bool needsUpdate = true;  // Flag pour savoir si on doit appeler strip->show()
+  static bool needsUpdate = true;  // Flag pour savoir si une trame doit être envoyée
   
-  // Intervalle minimum entre deux strip->show() (en ms)
-  // 33ms = ~30 FPS, suffisant pour les animations et évite les conflits avec I2S
-  const unsigned long SHOW_INTERVAL_MS = 33;
+  // Intervalle minimum entre deux trames envoyées (en ms)
+  const unsigned long SHOW_INTERVAL_MS = (output != nullptr) ? output->minFrameIntervalMs : 33;
   
   while (true) {
+    // Début du travail de cette itération (durée de trame pour l'histogramme)
+    unsigned long workStartMicros = micros();
+    bool frameRendered = false;
+    
     // Traiter les commandes en attente
     LEDCommand cmd;
-    while (xQueueReceive(commandQueue, &cmd, 0) == pdTRUE) {
+    while (takeCommand(cmd)) {
       processCommand(cmd);
+      // Couleur, luminosité ou effet modifié : redessiner l'effet sans attendre sa prochaine échéance
+      nextFrameDelayMs = 0;
       // IMPORTANT: Ne pas appeler wakeUp() automatiquement ici
       // wakeUp() est appelé uniquement par les méthodes publiques (setColor, setEffect, etc.)
       // Cela évite que les commandes système automatiques (WiFi retry, etc.) réveillent les LEDs
@@ -318,10 +443,10 @@ void LEDManager::ledTask(void* parameter) {
       needsUpdate = true;
     }
     
-    // Gérer l'animation de fade depuis sleep (réveil) AVANT checkSleepMode()
-    // Cela permet de réinitialiser lastActivityTime avant que checkSleepMode() ne vérifie le timeout
-    if (isFadingFromSleep) {
-      updateWakeFade();
+    // Faire avancer la transition en cours (fondu enchaîné, sleep, réveil) AVANT checkSleepMode()
+    // La fin du réveil réinitialise lastActivityTime avant que checkSleepMode() ne vérifie le timeout
+    if (transitionKind != TRANSITION_NONE) {
+      updateTransition();
       needsUpdate = true;
     }
     
@@ -329,7 +454,6 @@ void LEDManager::ledTask(void* parameter) {
     // Cela permet au sleep mode de se déclencher normalement après le démarrage
     if (currentEffect == LED_EFFECT_ROTATE && rotateActivationTime > 0) {
       unsigned long currentTime = millis();
-      const unsigned long ROTATE_VALIDATION_TIMEOUT_MS = 8000;  // 8 secondes
       
       // Gérer le wrap-around de millis()
       unsigned long elapsed;
@@ -341,12 +465,13 @@ void LEDManager::ledTask(void* parameter) {
       
       if (elapsed >= ROTATE_VALIDATION_TIMEOUT_MS) {
         Serial.println("[LED] Desactivation automatique de l'effet ROTATE de validation");
+        beginCrossfade();
         currentEffect = LED_EFFECT_NONE;
         rotateActivationTime = 0;
-        // Éteindre les LEDs pour permettre le sleep mode
-        if (strip != nullptr) {
+        // Éteindre les LEDs (en fondu) pour permettre le sleep mode
+        if (output != nullptr) {
           for (int i = 0; i < NUM_LEDS; i++) {
-            strip->setPixelColor(i, 0);
+            setFramePixel(i, 0);
           }
         }
         needsUpdate = true;
@@ -358,9 +483,9 @@ void LEDManager::ledTask(void* parameter) {
     checkSleepMode();
     
     // Gérer le test séquentiel si actif
-    if (testSequentialActive && strip != nullptr && hardwareInitialized) {
+    if (testSequentialActive && output != nullptr && hardwareInitialized) {
       // S'assurer que la luminosité est à 100% pendant le test
-      strip->setBrightness(255);
+      setOutputBrightness(255);
       
       unsigned long currentTime = millis();
       if (currentTime - testSequentialLastUpdate >= 100) {  // 100ms entre chaque LED
@@ -368,11 +493,11 @@ void LEDManager::ledTask(void* parameter) {
           // Phase 1: Allumer chaque LED une par une
           // Éteindre la LED précédente (sauf la première)
           if (testSequentialIndex > 0) {
-            strip->setPixelColor(testSequentialIndex - 1, 0);
+            setFramePixel(testSequentialIndex - 1, 0);
           }
           // Allumer la LED actuelle en blanc
-          strip->setPixelColor(testSequentialIndex, strip->Color(255, 255, 255));
-          strip->show();
+          setFramePixel(testSequentialIndex, 0xFFFFFF);
+          pushFrame();
           Serial.printf("[LED-TEST] LED %d/%d allumee\n", testSequentialIndex + 1, NUM_LEDS);
           testSequentialIndex++;
           testSequentialLastUpdate = currentTime;
@@ -381,8 +506,8 @@ void LEDManager::ledTask(void* parameter) {
           // Phase 2: Attendre 200ms avant d'allumer toutes en rouge
           if (currentTime - testSequentialLastUpdate >= 200) {
             // Éteindre la dernière LED
-            strip->setPixelColor(NUM_LEDS - 1, 0);
-            strip->show();
+            setFramePixel(NUM_LEDS - 1, 0);
+            pushFrame();
             testSequentialIndex++;
             testSequentialLastUpdate = currentTime;
             needsUpdate = true;
@@ -390,15 +515,15 @@ void LEDManager::ledTask(void* parameter) {
         } else if (testSequentialIndex == NUM_LEDS + 1) {
           // Phase 3: Allumer toutes les LEDs en rouge
           for (int i = 0; i < NUM_LEDS; i++) {
-            strip->setPixelColor(i, strip->Color(255, 0, 0)); // Rouge pur
+            setFramePixel(i, 0xFF0000); // Rouge pur
           }
-          strip->show();
+          pushFrame();
           Serial.println("[LED-TEST] Test termine - Toutes les LEDs sont en rouge");
           Serial.println("[LED-TEST] Utilisez 'led clear' ou 'brightness 0' pour eteindre");
           testSequentialActive = false;  // Terminer le test
-          currentColor = strip->Color(255, 0, 0);  // Sauvegarder la couleur rouge
+          currentColor = 0xFF0000;  // Sauvegarder la couleur rouge
           // Restaurer la luminosité configurée
-          strip->setBrightness(currentBrightness);
+          setOutputBrightness(currentBrightness);
           needsUpdate = true;
         }
       }
@@ -409,61 +534,69 @@ void LEDManager::ledTask(void* parameter) {
     // Seulement si le test séquentiel n'est pas actif
     if (!isSleeping && !testSequentialActive) {
       unsigned long currentTime = millis();
-      if (currentTime - lastUpdateTime >= UPDATE_INTERVAL_MS) {
-        // Pendant le fade-in, on permet les effets pour qu'ils s'appliquent progressivement
-        // Mais on s'assure que les LEDs sont bien éteintes au début
-        if (isFadingFromSleep && (currentTime - sleepFadeStartTime) < 50) {
-          // Au tout début du fade-in, éteindre les LEDs pour éviter le flash
-          if (strip != nullptr) {
-            for (int i = 0; i < NUM_LEDS; i++) {
-              strip->setPixelColor(i, 0);
-            }
-          }
-        } else {
-          // Appliquer les effets normalement (y compris pendant fade-out pour fondu progressif)
-          updateEffects();
+      unsigned long sinceLastFrame = currentTime - lastUpdateTime;
+      // Trame due à l'échéance de l'effet, ou forcée (changement d'effet, redémarrage)
+      bool frameForced = (nextFrameDelayMs == 0 || currentEffect != activeEffectId || effectNeedsRestart);
+      if (frameForced || (nextFrameDelayMs != LED_EFFECT_NO_DEADLINE && sinceLastFrame >= nextFrameDelayMs)) {
+        // Retard par rapport à l'échéance prévue (gigue du planificateur)
+        if (!frameForced) {
+          recordFrameJitter(sinceLastFrame - nextFrameDelayMs);
         }
+        frameRendered = true;
+        // L'effet continue pendant les fondus : le compositeur le mélange au noir
+        // ou à l'ancien effet, la luminosité de sortie reste celle configurée
+        updateEffects();
         lastUpdateTime = currentTime;
         needsUpdate = true;
       }
       // S'assurer que la luminosité maximale configurée est toujours respectée
-      // (sauf pendant le fade-in/fade-out où on utilise la luminosité fade)
-      if (!isFadingFromSleep && !isFadingToSleep && strip != nullptr) {
-        strip->setBrightness(currentBrightness);
+      if (output != nullptr) {
+        setOutputBrightness(currentBrightness);
       }
     }
-    
-    // Gérer l'animation de fade vers sleep APRÈS la mise à jour des effets
-    // Cela permet aux effets de continuer pendant le fade-out avec luminosité réduite
-    if (isFadingToSleep) {
-      updateSleepFade();
-      needsUpdate = true;
-    }
+    // La trame (calque entrant) est à jour : un nouveau fondu enchaîné partira de l'image visible
+    incomingRendered = true;
     
     // Appliquer les changements aux LEDs SEULEMENT si nécessaire et pas trop souvent
     // Cela évite de bloquer les interruptions I2S trop fréquemment
     unsigned long currentTime = millis();
-    if (needsUpdate && (currentTime - lastShowTime >= SHOW_INTERVAL_MS)) {
+    // Une émission asynchrone encore en cours : réessayer à la prochaine itération
+    bool outputBusy = (output != nullptr && output->isBusy());
+    if (needsUpdate && !outputBusy && (currentTime - lastShowTime >= SHOW_INTERVAL_MS)) {
       // IMPORTANT: S'assurer que si on a clear() ou si l'effet est NONE avec couleur noire,
       // on éteint vraiment toutes les LEDs
-      if (currentEffect == LED_EFFECT_NONE && currentColor == 0 && strip != nullptr) {
-        // S'assurer que toutes les LEDs sont bien éteintes
+      // (trame noire : la sortie est nulle quelle que soit la luminosité, inutile de
+      // reconstruire les tables à 0 puis à currentBrightness à chaque itération)
+      if (currentEffect == LED_EFFECT_NONE && currentColor == 0 && output != nullptr) {
         for (int i = 0; i < NUM_LEDS; i++) {
-          strip->setPixelColor(i, 0);
+          setFramePixel(i, 0);
         }
-        // IMPORTANT: Mettre la luminosité à 0 pour éteindre complètement
-        // Cela garantit que même si updateEffects() tourne, les LEDs restent éteintes
-        strip->setBrightness(0);
       }
-      if (strip != nullptr) {
-        strip->show();
+      // N'envoyer la trame que si les octets ont réellement changé
+      // (couleur fixe, effet NONE, bedtime statique : aucune émission inutile)
+      if (pushFrame()) {
+        lastShowTime = currentTime;
       }
-      lastShowTime = currentTime;
       needsUpdate = false;
+      // Trame émise (ou déjà identique à l'écran) : les commandes reçues sont visibles
+      recordCommandLatency();
     }
     
-    // Pause plus longue pour laisser de la bande passante à l'audio
-    vTaskDelay(pdMS_TO_TICKS(5));
+    if (frameRendered) {
+      recordFrameTime(micros() - workStartMicros);
+    }
+    
+    // Dormir jusqu'à la prochaine échéance (trame d'effet, fondu, show différé, timers)
+    // ou jusqu'à une notification (nouvelle commande, réveil) : aucun réveil inutile
+    // quand l'affichage est statique
+    currentTime = millis();
+    uint32_t showWaitMs = MAX_WAIT_MS;
+    if (needsUpdate) {
+      unsigned long sinceShow = currentTime - lastShowTime;
+      showWaitMs = (sinceShow >= SHOW_INTERVAL_MS) ? 0 : SHOW_INTERVAL_MS - sinceShow;
+    }
+    uint32_t waitMs = computeWaitMs(currentTime, showWaitMs);
+    ulTaskNotifyTake(pdTRUE, waitMs == 0 ? 1 : pdMS_TO_TICKS(waitMs));
   }
   
   // Ne devrait jamais arriver ici
@@ -472,22 +605,20 @@ void LEDManager::ledTask(void* parameter) {
 
 void LEDManager::processCommand(const LEDCommand& cmd) {
   switch (cmd.type) {
-    case LED_CMD_SET_COLOR:
+    case LED_CMD_SET_COLOR: {
       Serial.printf("[LED] processCommand SET_COLOR: RGB(%d, %d, %d), currentEffect=%d\n", 
                     cmd.data.color.r, cmd.data.color.g, cmd.data.color.b, currentEffect);
       
       // Réinitialiser le timer d'activité lors d'un changement de couleur
       lastActivityTime = millis();
       
-      // Si on change de couleur et qu'on a un effet actif, éteindre d'abord
-      // Cela évite le flash de la couleur précédente
-      if (currentEffect != LED_EFFECT_NONE && strip != nullptr) {
-        // Éteindre toutes les LEDs avant de changer de couleur
-        for (int i = 0; i < NUM_LEDS; i++) {
-          strip->setPixelColor(i, 0);
-        }
+      // Si on change de couleur avec un effet actif, fondu enchaîné de l'effet
+      // avec l'ancienne couleur vers l'effet avec la nouvelle (pas de passage au noir)
+      uint32_t newColor = ((uint32_t)cmd.data.color.r << 16) | ((uint32_t)cmd.data.color.g << 8) | cmd.data.color.b;
+      if (currentEffect != LED_EFFECT_NONE && newColor != currentColor) {
+        beginCrossfade();
       }
-      currentColor = ((uint32_t)cmd.data.color.r << 16) | ((uint32_t)cmd.data.color.g << 8) | cmd.data.color.b;
+      currentColor = newColor;
       
       // Si on définit la couleur SUCCESS (vert: RGB(0, 255, 0)) avec l'effet ROTATE,
       // démarrer le décompte pour désactivation automatique
@@ -500,27 +631,28 @@ void LEDManager::processCommand(const LEDCommand& cmd) {
       
       // Si on change de couleur et qu'on n'a pas d'effet actif, appliquer immédiatement
       // Si on a un effet, la couleur sera appliquée par l'effet
-      if (currentEffect == LED_EFFECT_NONE && strip != nullptr) {
+      if (currentEffect == LED_EFFECT_NONE && output != nullptr) {
         // Appliquer la couleur immédiatement
         for (int i = 0; i < NUM_LEDS; i++) {
-          strip->setPixelColor(i, currentColor);
+          setFramePixel(i, currentColor);
         }
       }
       // Ne pas réinitialiser l'effet ici, il sera géré par SET_EFFECT
       // L'effet reste actif, seule la couleur change
       break;
+    }
       
     case LED_CMD_SET_BRIGHTNESS:
       // Réinitialiser le timer d'activité lors d'un changement de luminosité
       lastActivityTime = millis();
       
       currentBrightness = cmd.data.brightness;
-      if (strip != nullptr) {
-        strip->setBrightness(currentBrightness);
+      if (output != nullptr) {
+        setOutputBrightness(currentBrightness);
         // Réappliquer la couleur sur toutes les LEDs si pas d'effet actif
         if (currentEffect == LED_EFFECT_NONE) {
           for (int i = 0; i < NUM_LEDS; i++) {
-            strip->setPixelColor(i, currentColor);
+            setFramePixel(i, currentColor);
           }
         }
       }
@@ -537,12 +669,12 @@ void LEDManager::processCommand(const LEDCommand& cmd) {
         lastActivityTime = millis();
       }
       
-      // Si on change d'effet, éteindre d'abord pour transition propre
-      // Cela évite le flash de la couleur/effet précédent
-      if (currentEffect != cmd.data.effect && strip != nullptr) {
-        // Éteindre toutes les LEDs avant de changer d'effet
+      // Si on change d'effet, l'image visible devient le calque sortant et la trame
+      // repart du noir : le nouvel effet apparaît en fondu enchaîné par-dessus l'ancien
+      if (currentEffect != cmd.data.effect && output != nullptr) {
+        beginCrossfade();
         for (int i = 0; i < NUM_LEDS; i++) {
-          strip->setPixelColor(i, 0);
+          setFramePixel(i, 0);
         }
       }
       LEDEffect previousEffect = currentEffect;
@@ -554,17 +686,13 @@ void LEDManager::processCommand(const LEDCommand& cmd) {
         rotateActivationTime = 0;  // Réinitialiser si on change d'effet
       }
       // Si on change vers NONE, vérifier si on veut éteindre ou afficher une couleur fixe
-      if (currentEffect == LED_EFFECT_NONE && strip != nullptr) {
+      if (currentEffect == LED_EFFECT_NONE && output != nullptr) {
         if (previousEffect != LED_EFFECT_NONE) {
-          // Changement depuis un effet animé : éteindre visuellement pour transition propre
-          // MAIS ne pas réinitialiser currentColor à 0, car setColor() peut être appelé après
-          // pour afficher une couleur fixe avec LED_EFFECT_NONE
+          // Changement depuis un effet animé : la trame reste noire (l'ancien effet s'efface
+          // en fondu) MAIS ne pas réinitialiser currentColor à 0, car setColor() peut être
+          // appelé après pour afficher une couleur fixe avec LED_EFFECT_NONE
           // Note: On ne modifie PAS currentColor ni brightness ici
-          for (int i = 0; i < NUM_LEDS; i++) {
-            strip->setPixelColor(i, 0);
-          }
-          strip->show();
-          Serial.println("[LED] processCommand SET_EFFECT NONE - Transition depuis effet anime, LEDs eteintes temporairement (couleur preservee)");
+          Serial.println("[LED] processCommand SET_EFFECT NONE - Transition depuis effet anime, fondu vers le noir (couleur preservee)");
         }
         // Si on est déjà en mode NONE, ne pas réinitialiser la couleur
         // Cela permet d'afficher une couleur fixe avec LED_EFFECT_NONE
@@ -572,18 +700,18 @@ void LEDManager::processCommand(const LEDCommand& cmd) {
       }
       // Si on change vers PULSE, réinitialiser l'effet pour éviter le flash
       if (currentEffect == LED_EFFECT_PULSE) {
-        resetPulseEffect();
+        restartEffect();
         // IMPORTANT: S'assurer que currentColor est bien défini avant d'activer PULSE
         // Si currentColor est 0 (noir) ou contient une couleur résiduelle indésirable,
         // attendre que la couleur soit définie par setColor() avant d'activer PULSE
         // Note: Le code appelant devrait faire clear() + setColor() + delay() + setEffect()
         // pour s'assurer que la couleur est bien définie avant d'activer PULSE
-        if (currentColor == 0 && strip != nullptr) {
+        if (currentColor == 0 && output != nullptr) {
           // Couleur non définie, s'assurer que les LEDs sont éteintes
           for (int i = 0; i < NUM_LEDS; i++) {
-            strip->setPixelColor(i, 0);
+            setFramePixel(i, 0);
           }
-          strip->setBrightness(0);
+          setOutputBrightness(0);
           Serial.println("[LED] processCommand SET_EFFECT PULSE - Couleur non definie, LEDs eteintes");
         } else {
           // Couleur définie, PULSE utilisera cette couleur
@@ -591,6 +719,10 @@ void LEDManager::processCommand(const LEDCommand& cmd) {
                        (currentColor >> 16) & 0xFF, (currentColor >> 8) & 0xFF, currentColor & 0xFF);
         }
       }
+      // Animation SD : toujours repartir du début (nouveau fichier ou relecture)
+      if (currentEffect == LED_EFFECT_ANIMATION) {
+        restartEffect();
+      }
       // Les effets seront gérés par updateEffects()
       break;
     }
@@ -600,18 +732,19 @@ void LEDManager::processCommand(const LEDCommand& cmd) {
       currentColor = 0;  // Noir
       currentEffect = LED_EFFECT_NONE;
       testSequentialActive = false;  // Arrêter le test si en cours
+      transitionKind = TRANSITION_NONE;  // Extinction immédiate, sans fondu
       // IMPORTANT: Éteindre complètement toutes les LEDs
-      if (strip != nullptr) {
+      if (output != nullptr) {
         for (int i = 0; i < NUM_LEDS; i++) {
-          strip->setPixelColor(i, 0);
+          setFramePixel(i, 0);
         }
         // IMPORTANT: Mettre la luminosité à 0 pour éteindre complètement
         // Cela garantit que même si updateEffects() tourne, les LEDs restent éteintes
-        strip->setBrightness(0);
+        setOutputBrightness(0);
       }
-      // Réinitialiser l'effet PULSE si nécessaire pour éviter qu'il reprenne
-      pulseNeedsReset = false;
-      // La mise à jour sera faite par strip->show() dans la boucle principale
+      // Annuler un redémarrage d'effet en attente pour éviter qu'il reprenne
+      effectNeedsRestart = false;
+      // La mise à jour sera envoyée à la bande par la boucle principale
       // avec needsUpdate = true qui a été défini lors de la réception de la commande
       break;
       
@@ -622,18 +755,19 @@ void LEDManager::processCommand(const LEDCommand& cmd) {
       if (isSleeping) {
         wakeUp();
       }
-      // Désactiver les effets temporairement
+      // Désactiver les effets et transitions temporairement
       currentEffect = LED_EFFECT_NONE;
+      transitionKind = TRANSITION_NONE;
       // Initialiser le test séquentiel
       testSequentialActive = true;
       testSequentialIndex = 0;
       testSequentialLastUpdate = millis();
       // Éteindre toutes les LEDs au début
-      if (strip != nullptr) {
+      if (output != nullptr) {
         for (int i = 0; i < NUM_LEDS; i++) {
-          strip->setPixelColor(i, 0);
+          setFramePixel(i, 0);
         }
-        strip->show();
+        pushFrame();
       }
       Serial.println("[LED-TEST] Test sequentiel demarre");
       break;
@@ -647,13 +781,9 @@ void LEDManager::processCommand(const LEDCommand& cmd) {
 void LEDManager::checkSleepMode() {
   // Si le sleep mode est désactivé (timeout = 0), ne rien faire
   if (sleepTimeoutMs == 0) {
-    if (isSleeping || isFadingToSleep) {
+    if (isSleeping || transitionKind == TRANSITION_SLEEP) {
       // Réveiller si on était en sleep ou en fade
-      isSleeping = false;
-      isFadingToSleep = false;
-      if (strip != nullptr) {
-        strip->setBrightness(currentBrightness);
-      }
+      startWakeFade();
     }
     return;
   }
@@ -661,12 +791,8 @@ void LEDManager::checkSleepMode() {
   // IMPORTANT: Ne pas entrer en sleep mode si le sleep est empêché (bedtime, etc.)
   if (sleepPrevented) {
     // Sleep empêché, réveiller si on était en sleep
-    if (isSleeping || isFadingToSleep) {
-      isSleeping = false;
-      isFadingToSleep = false;
-      if (strip != nullptr) {
-        strip->setBrightness(currentBrightness);
-      }
+    if (isSleeping || transitionKind == TRANSITION_SLEEP) {
+      startWakeFade();
       // Restaurer l'effet si nécessaire
       if (savedEffect != LED_EFFECT_NONE) {
         currentEffect = savedEffect;
@@ -683,12 +809,8 @@ void LEDManager::checkSleepMode() {
   #ifdef HAS_BLE
   if (BLEConfigManager::isBLEEnabled()) {
     // BLE actif, réveiller si on était en sleep
-    if (isSleeping || isFadingToSleep) {
-      isSleeping = false;
-      isFadingToSleep = false;
-      if (strip != nullptr) {
-        strip->setBrightness(currentBrightness);
-      }
+    if (isSleeping || transitionKind == TRANSITION_SLEEP) {
+      startWakeFade();
       // Restaurer l'effet si nécessaire
       if (savedEffect != LED_EFFECT_NONE) {
         currentEffect = savedEffect;
@@ -713,78 +835,125 @@ void LEDManager::checkSleepMode() {
   
   // Vérifier si on doit entrer en sleep mode
   // Ne pas entrer en sleep mode si un effet animé est actif (mais LED_EFFECT_NONE peut entrer en sleep)
-  if (!isSleeping && !isFadingToSleep && !hasActiveAnimatedEffect && timeSinceActivity >= sleepTimeoutMs) {
-    // Démarrer l'animation de fade vers sleep
+  // ni pendant une autre transition (elle se termine d'abord)
+  if (!isSleeping && transitionKind == TRANSITION_NONE && !hasActiveAnimatedEffect && timeSinceActivity >= sleepTimeoutMs) {
+    // Démarrer le fondu vers le noir (compositeur : trame -> noir)
     Serial.printf("[LED] Entree en sleep mode (timeout: %lu ms, inactivite: %lu ms, lastActivityTime=%lu, currentTime=%lu)\n", 
                   sleepTimeoutMs, timeSinceActivity, lastActivityTime, currentTime);
-    isFadingToSleep = true;
-    sleepFadeStartTime = currentTime;
+    transitionDurationMs = SLEEP_FADE_DURATION_MS;
+    transitionStartTime = currentTime;
+    transitionKind = TRANSITION_SLEEP;
     // Sauvegarder l'effet actuel pour le restaurer au réveil
     savedEffect = currentEffect;
     Serial.printf("[LED] Effet sauvegarde: %d\n", savedEffect);
   }
 }
 
-void LEDManager::updateSleepFade() {
-  unsigned long currentTime = millis();
-  unsigned long elapsed = currentTime - sleepFadeStartTime;
-  
-  if (elapsed >= SLEEP_FADE_DURATION_MS) {
-    // Animation terminée, éteindre complètement
-    isFadingToSleep = false;
-    isSleeping = true;
-    if (strip != nullptr) {
-      strip->setBrightness(0);
-      // IMPORTANT: Clear les LEDs quand on atteint 0 luminosité (mode sleep)
-      // Cela évite le flash de la couleur précédente quand on réactive
-      for (int i = 0; i < NUM_LEDS; i++) {
-        strip->setPixelColor(i, 0);
-      }
+void LEDManager::beginCrossfade() {
+  // Pas de fondu enchaîné pendant un sleep / réveil : le fondu en cours
+  // s'applique déjà à la trame, qui change simplement sous lui
+  if (crossfadeDurationMs == 0 || output == nullptr || isSleeping ||
+      transitionKind == TRANSITION_SLEEP || transitionKind == TRANSITION_WAKE) {
+    return;
+  }
+  
+  unsigned long now = millis();
+  if (transitionKind == TRANSITION_CROSSFADE) {
+    if (!incomingRendered) {
+      // Plusieurs changements avant la prochaine trame (ex: setEffect + setColor) :
+      // garder le calque sortant et le départ du fondu en cours
+      return;
     }
+    // Fondu interrompu : l'image visible (mélange courant) devient le calque sortant, figé
+    uint16_t alpha = ledSmoothstepQ15(ledProgressQ15(now - transitionStartTime, transitionDurationMs));
+    ledBlendLayers(outgoingBuffer, outgoingBuffer, frameBuffer, NUM_LEDS, alpha);
+    outgoingEffect = nullptr;
   } else {
-    // Calculer le facteur de fade (1.0 -> 0.0)
-    float fadeFactor = 1.0f - ((float)elapsed / (float)SLEEP_FADE_DURATION_MS);
-    
-    // Appliquer le fondu progressif en baissant la luminosité globale
-    // Les effets continuent de s'afficher (gérés dans la boucle principale) mais avec luminosité réduite
-    uint8_t fadedBrightness = (uint8_t)(currentBrightness * fadeFactor);
-    if (strip != nullptr) {
-      strip->setBrightness(fadedBrightness);
-      // Ne pas clear les LEDs ici, laisser l'effet continuer avec luminosité réduite
-      // Cela crée un fondu progressif naturel
+    memcpy(outgoingBuffer, frameBuffer, sizeof(outgoingBuffer));
+    // Le calque sortant continue de s'animer si son effet est sans état ; un effet
+    // avec état (init) partagerait cet état avec le calque entrant : il est figé
+    outgoingEffect = (activeEffect != nullptr && activeEffect->init == nullptr &&
+                      activeEffect->render != nullptr) ? activeEffect : nullptr;
+    outgoingStartTime = effectStartTime;
+    outgoingColor = currentColor;
+  }
+  
+  incomingRendered = false;
+  transitionDurationMs = crossfadeDurationMs;
+  transitionStartTime = now;
+  transitionKind = TRANSITION_CROSSFADE;
+}
+
+void LEDManager::startWakeFade() {
+  unsigned long now = millis();
+  unsigned long startTime = now;
+  if (transitionKind == TRANSITION_SLEEP) {
+    // Réveil pendant le fondu vers sleep : repartir du niveau atteint
+    // (smoothstep est symétrique, le fondu inverse reprend au même point)
+    unsigned long elapsed = now - transitionStartTime;
+    if (elapsed < SLEEP_FADE_DURATION_MS) {
+      startTime = now - (SLEEP_FADE_DURATION_MS - elapsed);
+    }
+  }
+  isSleeping = false;
+  transitionDurationMs = SLEEP_FADE_DURATION_MS;
+  transitionStartTime = startTime;
+  transitionKind = TRANSITION_WAKE;
+}
+
+void LEDManager::updateTransition() {
+  unsigned long currentTime = millis();
+  unsigned long elapsed = currentTime - transitionStartTime;
+  
+  if (elapsed < transitionDurationMs) {
+    // Fondu enchaîné : l'ancien effet continue de s'animer dans le calque sortant
+    if (transitionKind == TRANSITION_CROSSFADE && outgoingEffect != nullptr) {
+      LEDEffectParams params;
+      params.color = outgoingColor;
+      outgoingEffect->render(outgoingBuffer, NUM_LEDS, currentTime - outgoingStartTime, params);
     }
+    return;
   }
+  
+  // Transition terminée : seule la trame (ou le noir en sleep) reste visible
+  switch (transitionKind) {
+    case TRANSITION_SLEEP:
+      isSleeping = true;
+      break;
+      
+    case TRANSITION_WAKE:
+      Serial.printf("[LED] Animation reveil terminee, effet=%s, couleur=0x%06X\n",
+                    getEffectName(currentEffect), currentColor);
+      // IMPORTANT: Réinitialiser le timer d'activité quand l'animation de réveil se termine
+      // Cela évite que le sleep mode se réactive immédiatement après le réveil
+      lastActivityTime = currentTime;
+      break;
+      
+    default:
+      break;
+  }
+  transitionKind = TRANSITION_NONE;
+  outgoingEffect = nullptr;
+}
+
+void LEDManager::setTransitionDuration(uint16_t durationMs) {
+  crossfadeDurationMs = durationMs;
 }
 
 void LEDManager::wakeUp() {
-  bool wasSleeping = (isSleeping || isFadingToSleep);
+  bool wasSleeping = (isSleeping || transitionKind == TRANSITION_SLEEP);
   
-  if (isSleeping || isFadingToSleep) {
+  if (wasSleeping) {
     Serial.printf("[LED] wakeUp() - Reveil depuis sleep (wasSleeping=%d, savedEffect=%d, currentColor=0x%06X)\n", 
                   wasSleeping ? 1 : 0, savedEffect, currentColor);
-    isSleeping = false;
-    isFadingToSleep = false;
-    
-    // IMPORTANT: Éteindre d'abord les LEDs pour éviter le flash de l'animation précédente
-    // Les LEDs peuvent encore contenir l'ancienne couleur/effet
-    if (strip != nullptr) {
-      for (int i = 0; i < NUM_LEDS; i++) {
-        strip->setPixelColor(i, 0);
-      }
-    }
     
-    // Démarrer un fade-in progressif pour le réveil
-    isFadingFromSleep = true;
-    sleepFadeStartTime = millis();
+    // Démarrer un fondu progressif depuis le noir : pas de flash de l'image précédente
+    startWakeFade();
     
     // Restaurer l'effet s'il y en avait un
     if (savedEffect != LED_EFFECT_NONE) {
       Serial.printf("[LED] wakeUp() - Restauration effet: %s\n", getEffectName(savedEffect));
       currentEffect = savedEffect;
-      // Si on restaure PULSE, réinitialiser l'effet
-      if (currentEffect == LED_EFFECT_PULSE) {
-        resetPulseEffect();
-      }
     } else {
       // Pas d'effet sauvegardé -> ne rien restaurer, garder l'état actuel
       // Cela évite les flashes inutiles quand wakeUp() est appelé sans effet sauvegardé
@@ -798,6 +967,9 @@ void LEDManager::wakeUp() {
   // et garantit que le système reste actif après un réveil explicite
   lastActivityTime = millis();
   
+  // La tâche LED peut dormir jusqu'à son échéance de sleep : la réveiller
+  notifyTask();
+  
   // NOTE: Ne pas démarrer automatiquement le WiFi retry depuis wakeUp()
   // car cela peut créer un cycle : WiFi retry -> commande LED -> wakeUp() -> WiFi retry
   // Le WiFi retry doit être géré indépendamment par le système d'initialisation
@@ -806,12 +978,8 @@ void LEDManager::wakeUp() {
 void LEDManager::preventSleep() {
   sleepPrevented = true;
   // Réveiller immédiatement si on était en sleep
-  if (isSleeping || isFadingToSleep) {
-    isSleeping = false;
-    isFadingToSleep = false;
-    if (strip != nullptr) {
-      strip->setBrightness(currentBrightness);
-    }
+  if (isSleeping || transitionKind == TRANSITION_SLEEP) {
+    startWakeFade();
     // Restaurer l'effet si nécessaire
     if (savedEffect != LED_EFFECT_NONE) {
       currentEffect = savedEffect;
@@ -819,579 +987,242 @@ void LEDManager::preventSleep() {
     }
     lastActivityTime = millis();
   }
+  notifyTask();
   Serial.println("[LED] Sleep mode empeche (bedtime actif)");
 }
 
 void LEDManager::allowSleep() {
   sleepPrevented = false;
+  notifyTask();
   Serial.println("[LED] Sleep mode reautorise");
 }
 
-void LEDManager::updateWakeFade() {
-  unsigned long currentTime = millis();
-  unsigned long elapsed = currentTime - sleepFadeStartTime;
+uint32_t LEDManager::computeWaitMs(unsigned long now, uint32_t showWaitMs) {
+  uint32_t waitMs = (showWaitMs < MAX_WAIT_MS) ? showWaitMs : MAX_WAIT_MS;
   
-  if (elapsed >= SLEEP_FADE_DURATION_MS) {
-    // Animation terminée, restaurer complètement
-    Serial.printf("[LED] updateWakeFade() - Animation reveil terminee, effet=%s, couleur=0x%06X\n",
-                  getEffectName(currentEffect), currentColor);
-    isFadingFromSleep = false;
-    
-    // IMPORTANT: Réinitialiser le timer d'activité quand l'animation de réveil se termine
-    // Cela évite que le sleep mode se réactive immédiatement après le réveil
-    lastActivityTime = millis();
-    
-    // IMPORTANT: S'assurer que les LEDs sont bien éteintes avant de restaurer l'effet
-    // Cela évite le flash de l'animation précédente
-    if (strip != nullptr) {
-      for (int i = 0; i < NUM_LEDS; i++) {
-        strip->setPixelColor(i, 0);
-      }
-      
-      // Si l'effet est PULSE, réinitialiser pour une transition fluide
-      if (currentEffect == LED_EFFECT_PULSE) {
-        resetPulseEffect();
-        // Réinitialiser lastUpdateTime pour que l'effet reprenne immédiatement
-        lastUpdateTime = millis();
-      }
-      
-      // Restaurer la luminosité complète
-      strip->setBrightness(currentBrightness);
-      
-      // S'assurer que toutes les LEDs ont la couleur si pas d'effet
-      if (currentEffect == LED_EFFECT_NONE) {
-        for (int i = 0; i < NUM_LEDS; i++) {
-          strip->setPixelColor(i, currentColor);
-        }
-      }
+  // Transitions et test séquentiel : cadence fixe
+  if (transitionKind != TRANSITION_NONE || testSequentialActive) {
+    return (waitMs < UPDATE_INTERVAL_MS) ? waitMs : UPDATE_INTERVAL_MS;
+  }
+  
+  // Prochaine trame de l'effet (0 fps si statique)
+  if (!isSleeping) {
+    if (nextFrameDelayMs == 0 || currentEffect != activeEffectId || effectNeedsRestart) {
+      return 0;
     }
-  } else {
-    // Calculer le facteur de fade (0.0 -> 1.0)
-    float fadeFactor = (float)elapsed / (float)SLEEP_FADE_DURATION_MS;
-    
-    // Simple: on remonte juste la luminosité globale
-    uint8_t fadedBrightness = (uint8_t)(currentBrightness * fadeFactor);
-    if (strip != nullptr) {
-      strip->setBrightness(fadedBrightness);
-      
-      // IMPORTANT: Pendant le fade-in, s'assurer que les LEDs sont bien éteintes au début
-      // et appliquer la nouvelle couleur/effet progressivement
-      if (fadedBrightness == 0 || elapsed < 50) {
-        // Au tout début du fade-in, s'assurer que les LEDs sont bien éteintes
-        for (int i = 0; i < NUM_LEDS; i++) {
-          strip->setPixelColor(i, 0);
-        }
-      } else {
-        // Pendant le fade-in, appliquer la couleur/effet
-        // Si on a un effet, il sera géré par updateEffects() dans la boucle principale
-        // Mais on doit s'assurer que la couleur de base est correcte
-        if (currentEffect == LED_EFFECT_NONE) {
-          for (int i = 0; i < NUM_LEDS; i++) {
-            strip->setPixelColor(i, currentColor);
-          }
-        }
-        // Si on a un effet, updateEffects() s'en chargera dans la boucle principale
-        // Mais on doit permettre à updateEffects() de s'exécuter même pendant le fade-in
-      }
+    if (nextFrameDelayMs != LED_EFFECT_NO_DEADLINE) {
+      uint32_t elapsed = now - lastUpdateTime;
+      uint32_t remaining = (elapsed >= nextFrameDelayMs) ? 0 : nextFrameDelayMs - elapsed;
+      if (remaining < waitMs) waitMs = remaining;
     }
   }
+  
+  // Désactivation automatique de ROTATE
+  if (currentEffect == LED_EFFECT_ROTATE && rotateActivationTime > 0) {
+    uint32_t elapsed = now - rotateActivationTime;
+    uint32_t remaining = (elapsed >= ROTATE_VALIDATION_TIMEOUT_MS) ? 0 : ROTATE_VALIDATION_TIMEOUT_MS - elapsed;
+    if (remaining < waitMs) waitMs = remaining;
+  }
+  
+  // Entrée en sleep mode
+  if (sleepTimeoutMs > 0 && !isSleeping && currentEffect == LED_EFFECT_NONE) {
+    uint32_t elapsed = now - lastActivityTime;
+    uint32_t remaining = (elapsed >= sleepTimeoutMs) ? 0 : sleepTimeoutMs - elapsed;
+    if (remaining < waitMs) waitMs = remaining;
+  }
+  
+  return waitMs;
+}
+
+void LEDManager::recordFrameTime(uint32_t durationUs) {
+  // Seuils (µs) : < 100, < 250, < 500, < 1000, < 2000, < 5000, >= 5000
+  static const uint32_t BOUNDS_US[HISTOGRAM_BUCKETS - 1] = {100, 250, 500, 1000, 2000, 5000};
+  int bucket = 0;
+  while (bucket < HISTOGRAM_BUCKETS - 1 && durationUs >= BOUNDS_US[bucket]) {
+    bucket++;
+  }
+  frameTimeHistogram[bucket]++;
+  if (durationUs > frameTimeMaxUs) {
+    frameTimeMaxUs = durationUs;
+  }
+}
+
+void LEDManager::recordFrameJitter(uint32_t lateMs) {
+  // Seuils (ms) : 0, 1, 2-3, 4-7, 8-15, 16-31, >= 32
+  int bucket = 0;
+  uint32_t bound = 1;
+  while (bucket < HISTOGRAM_BUCKETS - 1 && lateMs >= bound) {
+    bucket++;
+    bound <<= 1;
+  }
+  frameJitterHistogram[bucket]++;
+  if (lateMs > frameJitterMaxMs) {
+    frameJitterMaxMs = lateMs;
+  }
+}
+
+bool LEDManager::pushFrame() {
+  if (output == nullptr) {
+    return false;
+  }
+  
+  // Calques visibles : trame seule, ou mélange avec le calque sortant / le noir
+  const uint8_t* from = nullptr;
+  const uint8_t* to = frameBuffer;
+  uint16_t alpha = LED_Q15_ONE;
+  TransitionKind kind = transitionKind;
+  if (isSleeping) {
+    to = nullptr;
+  } else if (kind != TRANSITION_NONE) {
+    alpha = ledSmoothstepQ15(ledProgressQ15(millis() - transitionStartTime, transitionDurationMs));
+    if (kind == TRANSITION_CROSSFADE) {
+      from = outgoingBuffer;
+    } else if (kind == TRANSITION_SLEEP) {
+      // Trame -> noir
+      from = frameBuffer;
+      to = nullptr;
+    }
+  }
+  
+  // Passe unique de sortie : mélange des calques -> gamma × luminosité × correction
+  uint8_t frame[NUM_LEDS * 3];
+  ledCompositeFrame(frame, from, to, NUM_LEDS, alpha, outputLut);
+  
+  // N'envoyer à la bande que si les octets de sortie ont changé
+  if (shadowValid && memcmp(frame, shadowFrame, sizeof(shadowFrame)) == 0) {
+    framesSkipped++;
+    return false;
+  }
+  
+  if (!output->transmit(frame, NUM_LEDS)) {
+    return false;
+  }
+  memcpy(shadowFrame, frame, sizeof(shadowFrame));
+  shadowValid = true;
+  framesPushed++;
+  return true;
+}
+
+void LEDManager::setFramePixel(int index, uint32_t color) {
+  uint8_t* p = frameBuffer + index * 3;
+  p[0] = (color >> 16) & 0xFF;
+  p[1] = (color >> 8) & 0xFF;
+  p[2] = color & 0xFF;
+}
+
+void LEDManager::setOutputBrightness(uint8_t brightness) {
+  // Les tables ne sont reconstruites que si la luminosité effective change
+  // (une fois par trame au plus pendant les fondus sleep/réveil)
+  if (brightness != outputBrightness) {
+    rebuildOutputLut(brightness);
+  }
+}
+
+void LEDManager::rebuildOutputLut(uint8_t brightness) {
+  ledBuildOutputLut(outputLut[0], brightness, LED_COLOR_CORRECTION_R);
+  ledBuildOutputLut(outputLut[1], brightness, LED_COLOR_CORRECTION_G);
+  ledBuildOutputLut(outputLut[2], brightness, LED_COLOR_CORRECTION_B);
+  outputBrightness = brightness;
+}
+
+void LEDManager::recordCommandLatency() {
+  uint32_t now = micros();
+  for (int i = 0; i < LED_SOURCE_COUNT; i++) {
+    if (latencyPending[i]) {
+      LEDLatency::record((LEDCommandSource)i, now - latencyPendingUs[i]);
+      latencyPending[i] = false;
+    }
+  }
+}
+
+void LEDManager::printStats(bool reset) {
+  Serial.println("");
+  Serial.println("========== Statistiques LED ==========");
+  if (output != nullptr) {
+    Serial.printf("[LED] Driver de sortie: %s (%u ms min entre trames)\n", output->name, output->minFrameIntervalMs);
+  }
+  Serial.printf("[LED] Trames envoyees: %lu\n", (unsigned long)framesPushed);
+  Serial.printf("[LED] Trames ignorees (identiques): %lu\n", (unsigned long)framesSkipped);
+  uint32_t total = framesPushed + framesSkipped;
+  if (total > 0) {
+    Serial.printf("[LED] Taux d'economie: %lu%%\n", (unsigned long)((uint64_t)framesSkipped * 100 / total));
+  }
+  Serial.printf("[LED] Commandes appliquees: %lu\n", (unsigned long)commandsApplied);
+  Serial.printf("[LED] Commandes fusionnees (remplacees avant traitement): %lu\n", (unsigned long)commandsCoalesced.load());
+  Serial.printf("[LED] Commandes rejetees: %lu\n", (unsigned long)commandsDropped.load());
+  
+  static const char* frameTimeLabels[HISTOGRAM_BUCKETS] = {"<100us", "<250us", "<500us", "<1ms", "<2ms", "<5ms", ">=5ms"};
+  static const char* jitterLabels[HISTOGRAM_BUCKETS] = {"0ms", "1ms", "2-3ms", "4-7ms", "8-15ms", "16-31ms", ">=32ms"};
+  Serial.printf("[LED] Duree de trame (max %lu us):", (unsigned long)frameTimeMaxUs);
+  for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    Serial.printf(" %s=%lu", frameTimeLabels[i], (unsigned long)frameTimeHistogram[i]);
+  }
+  Serial.println("");
+  Serial.printf("[LED] Retard sur echeance (max %lu ms):", (unsigned long)frameJitterMaxMs);
+  for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    Serial.printf(" %s=%lu", jitterLabels[i], (unsigned long)frameJitterHistogram[i]);
+  }
+  Serial.println("");
+  Serial.println("======================================");
+  
+  if (reset) {
+    framesPushed = 0;
+    framesSkipped = 0;
+    commandsApplied = 0;
+    commandsCoalesced.store(0);
+    commandsDropped.store(0);
+    memset(frameTimeHistogram, 0, sizeof(frameTimeHistogram));
+    memset(frameJitterHistogram, 0, sizeof(frameJitterHistogram));
+    frameTimeMaxUs = 0;
+    frameJitterMaxMs = 0;
+    Serial.println("[LED] Compteurs remis a zero");
+  }
 }
 
 bool LEDManager::getSleepState() {
   // Retourner true si on est en sleep OU en fade vers sleep
   // Cela évite de réveiller les LEDs si elles sont en train de s'éteindre
-  return isSleeping || isFadingToSleep;
+  return isSleeping || transitionKind == TRANSITION_SLEEP;
 }
 
-void LEDManager::resetPulseEffect() {
-  // Marquer que l'effet PULSE doit être réinitialisé
-  pulseNeedsReset = true;
+void LEDManager::restartEffect() {
+  // Marquer que l'effet courant doit repartir de son début (traité dans la tâche LED)
+  effectNeedsRestart = true;
 }
 
 void LEDManager::updateEffects() {
-  static unsigned long effectTime = 0;
   unsigned long currentTime = millis();
   
-  switch (currentEffect) {
-    case LED_EFFECT_NONE:
-      // Pas d'effet, couleur unie déjà appliquée
-      break;
-      
-    case LED_EFFECT_RAINBOW: {
-      // Effet arc-en-ciel qui défile
-      static uint8_t hue = 0;
-      if (strip != nullptr) {
-        for (int i = 0; i < NUM_LEDS; i++) {
-          uint32_t color = hsvToRgb((hue + i * 2) % 256, 255, 255);
-          strip->setPixelColor(i, color);
-        }
-      }
-      hue = (hue + 2) % 256;
-      break;
-    }
-    
-    case LED_EFFECT_RAINBOW_SOFT: {
-      // Effet arc-en-ciel doux et lent pour veilleuse
-      // Animation beaucoup plus lente que RAINBOW standard
-      static unsigned long rainbowSoftStartTime = 0;
-      
-      // Initialiser le temps de départ si nécessaire
-      if (rainbowSoftStartTime == 0) {
-        rainbowSoftStartTime = currentTime;
-      }
-      
-      // Cycle complet de l'arc-en-ciel : ~30 secondes pour un tour complet (beaucoup plus lent)
-      const uint32_t RAINBOW_SOFT_CYCLE_MS = 30000;  // 30 secondes
-      
-      // Gérer le wrap-around de millis()
-      uint32_t elapsed;
-      if (currentTime >= rainbowSoftStartTime) {
-        elapsed = (currentTime - rainbowSoftStartTime) % RAINBOW_SOFT_CYCLE_MS;
-      } else {
-        elapsed = (ULONG_MAX - rainbowSoftStartTime + currentTime) % RAINBOW_SOFT_CYCLE_MS;
-      }
-      
-      // Calculer la teinte de base avec précision (0 à 255)
-      // Utiliser une précision élevée pour fluidité maximale
-      uint16_t baseHue = (elapsed * 256) / RAINBOW_SOFT_CYCLE_MS;
-      
-      if (strip != nullptr) {
-        // Répartir l'arc-en-ciel sur toute la bande LED
-        // Chaque LED a une teinte légèrement différente pour créer un dégradé
-        for (int i = 0; i < NUM_LEDS; i++) {
-          // Calculer la teinte pour cette LED (dégradé sur toute la bande)
-          // Utiliser une répartition douce pour un effet apaisant
-          uint16_t hue = (baseHue + (i * 256 / NUM_LEDS)) % 256;
-          
-          // Saturation et luminosité réduites pour un effet plus doux et apaisant
-          // Saturation: 200/255 (78%) pour des couleurs moins vives
-          // Luminosité: 180/255 (70%) pour un effet plus doux
-          uint32_t color = hsvToRgb((uint8_t)hue, 200, 180);
-          strip->setPixelColor(i, color);
-        }
-      }
-      break;
-    }
-    
-    case LED_EFFECT_PULSE: {
-      // Effet de pulsation (respiration) rapide et fluide
-      // Utiliser le temps réel pour une vitesse constante et fluide
-      static unsigned long pulseStartTime = 0;
-      
-      // Réinitialiser si nécessaire (après réveil depuis sleep)
-      if (pulseNeedsReset) {
-        pulseStartTime = currentTime;
-        pulseNeedsReset = false;
-      }
-      
-      // Cycle de respiration : ~2.5 secondes pour un cycle complet (inspiration + expiration)
-      const uint32_t PULSE_CYCLE_MS = 2500;  // 2.5 secondes
-      uint32_t elapsed = (currentTime - pulseStartTime) % PULSE_CYCLE_MS;
-      
-      // Calculer la phase normalisée (0 à 1023 pour précision)
-      uint16_t phase = (elapsed * 1024) / PULSE_CYCLE_MS;
-      
-      // Calculer la valeur de pulsation avec une courbe sinusoïdale douce
-      // Utiliser une approximation de sin pour fluidité maximale
-      // Phase 0-511 : montée (inspiration), Phase 512-1023 : descente (expiration)
-      // Minimum réduit de 50 à 30 pour un effet plus sombre en bas (~12% de luminosité)
-      const uint8_t PULSE_MIN = 30;  // Minimum de luminosité (réduit de 50 à 30)
-      const uint8_t PULSE_MAX = 255;  // Maximum de luminosité
-      const uint8_t PULSE_RANGE = PULSE_MAX - PULSE_MIN;  // 225
-      
-      uint8_t pulseValue;
-      if (phase < 512) {
-        // Montée (inspiration) : de PULSE_MIN à PULSE_MAX
-        // Courbe douce : utiliser phase² pour accélération progressive
-        uint16_t normalizedPhase = phase;  // 0-511
-        // Appliquer une courbe douce (quadratique) pour fluidité
-        uint16_t smoothPhase = (normalizedPhase * normalizedPhase) / 512;
-        pulseValue = PULSE_MIN + ((smoothPhase * PULSE_RANGE) / 512);
-      } else {
-        // Descente (expiration) : de PULSE_MAX à PULSE_MIN
-        uint16_t phaseDown = phase - 512;  // 0-511
-        // Courbe douce inverse
-        uint16_t smoothPhase = 511 - phaseDown;
-        smoothPhase = (smoothPhase * smoothPhase) / 512;
-        pulseValue = PULSE_MIN + ((smoothPhase * PULSE_RANGE) / 512);
-      }
-      
-      // Appliquer la pulsation à la couleur
-      if (strip != nullptr) {
-        // Extraire les composantes RGB de currentColor
-        uint8_t r = (currentColor >> 16) & 0xFF;
-        uint8_t g = (currentColor >> 8) & 0xFF;
-        uint8_t b = currentColor & 0xFF;
-        
-        // Appliquer la pulsation (fade)
-        r = (r * pulseValue) / 255;
-        g = (g * pulseValue) / 255;
-        b = (b * pulseValue) / 255;
-        
-        uint32_t pulseColor = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
-        for (int i = 0; i < NUM_LEDS; i++) {
-          strip->setPixelColor(i, pulseColor);
-        }
-      }
-      break;
+  // Changement d'effet : rechercher le descripteur dans le registre et repartir de zéro
+  if (activeEffectId != currentEffect) {
+    activeEffect = LEDEffectRegistry::find(currentEffect);
+    activeEffectId = currentEffect;
+    if (activeEffect == nullptr && currentEffect != LED_EFFECT_NONE) {
+      Serial.printf("[LED] Effet %s non disponible sur ce modele, ignore\n", getEffectName(currentEffect));
     }
-    
-    case LED_EFFECT_GLOSSY: {
-      // Effet glossy multicolore
-      static uint8_t offset = 0;
-      if (strip != nullptr) {
-        for (int i = 0; i < NUM_LEDS; i++) {
-          uint8_t hue = ((i * 256 / NUM_LEDS) + offset) % 256;
-          uint32_t color = hsvToRgb(hue, 200, 255);
-          strip->setPixelColor(i, color);
-        }
-      }
-      offset = (offset + 1) % 256;
-      break;
-    }
-    
-    case LED_EFFECT_ROTATE: {
-      // Effet de rotation type "serpent" avec début (tête) et fin (queue) progressifs
-      // Utiliser le temps réel pour une rotation constante et fluide
-      static unsigned long rotateStartTime = 0;
-      
-      // Initialiser le temps de départ si nécessaire
-      if (rotateStartTime == 0) {
-        rotateStartTime = currentTime;
-      }
-      
-      // Cycle de rotation : ~5 secondes pour un tour complet (ralenti pour plus de fluidité)
-      // Plus lent = chaque LED reste allumée plus longtemps = animation plus fluide
-      const uint32_t ROTATE_CYCLE_MS = 5000;  // 5 secondes (au lieu de 4)
-      uint32_t elapsed = (currentTime - rotateStartTime) % ROTATE_CYCLE_MS;
-      
-      // Calculer la position de la tête du serpent avec précision fractionnaire
-      // Utiliser une précision élevée (256x) pour fluidité maximale
-      uint32_t headPositionPrecise = (elapsed * NUM_LEDS * 256) / ROTATE_CYCLE_MS;
-      uint16_t headPosition = (headPositionPrecise >> 8) % NUM_LEDS;  // Position de la tête (LED principale)
-      uint8_t headSubPosition = headPositionPrecise & 0xFF;  // Position fractionnaire (0-255)
-      
-      // Longueur du serpent (nombre de LEDs) - queue optimale avec fade-out très progressif
-      // 30% de la bande pour queue visible mais pas trop longue
-      // Le fade-out progressif fait que les dernières LEDs restent allumées longtemps
-      const uint8_t snakeLength = (NUM_LEDS * 30) / 100;  // 30% de la bande (optimal)
-      
-      // Éteindre toutes les LEDs
-      if (strip != nullptr) {
-        for (int i = 0; i < NUM_LEDS; i++) {
-          strip->setPixelColor(i, 0);
-        }
-      }
-      
-      // Dessiner le serpent progressif avec position fractionnaire pour mouvement ultra-fluide
-      // Le serpent s'étend de (headPosition - snakeLength) à headPosition
-      // Utiliser la position fractionnaire pour créer un dégradé qui se déplace progressivement
-      
-      // Parcourir toutes les LEDs pour créer un dégradé fluide
-      for (int ledIndex = 0; ledIndex < NUM_LEDS; ledIndex++) {
-        // Calculer la position précise de cette LED (en unités fractionnaires)
-        // Utiliser le centre de la LED pour plus de précision et fluidité
-        // +128 pour centrer, cela donne une transition plus douce entre LEDs
-        int32_t ledPositionPrecise = ((int32_t)ledIndex * 256) + 128;  // Centre de la LED
-        
-        // Calculer la distance depuis la tête (en tenant compte du wrap-around)
-        int32_t distanceToHead = headPositionPrecise - ledPositionPrecise;
-        
-        // Gérer le wrap-around (distance la plus courte)
-        if (distanceToHead > (NUM_LEDS * 256) / 2) {
-          distanceToHead -= (NUM_LEDS * 256);
-        } else if (distanceToHead < -(NUM_LEDS * 256) / 2) {
-          distanceToHead += (NUM_LEDS * 256);
-        }
-        
-        // Convertir en valeur absolue et vérifier si cette LED fait partie du serpent
-        int32_t absDistance = (distanceToHead < 0) ? -distanceToHead : distanceToHead;
-        int32_t maxSnakeDistance = snakeLength * 256;
-        
-        // Si la LED est en dehors du serpent, elle est éteinte
-        if (absDistance > maxSnakeDistance) {
-          if (strip != nullptr) {
-            strip->setPixelColor(ledIndex, 0);
-          }
-          continue;
-        }
-        
-        // Calculer l'intensité avec dégradé très progressif de la queue vers la tête
-        // Queue très longue qui reste allumée longtemps avec luminosité qui diminue très doucement
-        uint8_t intensity;
-        if (absDistance == 0) {
-          // Tête : luminosité maximale (255)
-          intensity = 255;
-        } else {
-          // Queue vers tête : dégradé très progressif avec courbe exponentielle douce
-          // Utiliser la distance inverse : proche de la tête = plus élevé
-          uint32_t fadeFactor = maxSnakeDistance - absDistance;
-          
-          // Normaliser sur 0-256 pour calcul de courbe
-          uint32_t normalizedFade = (fadeFactor * 256) / maxSnakeDistance;  // 0-256
-          
-          // Courbe optimisée : queue qui s'éteint rapidement mais dernières LEDs restent visibles
-          // avec fade-out progressif pour fluidité maximale
-          uint32_t x = normalizedFade;  // 0-256
-          
-          // Courbe en 3 zones pour fade-out progressif mais queue qui s'éteint assez vite
-          // - Queue lointaine (x < 80) : s'éteint rapidement (presque invisible)
-          // - Queue moyenne (80 < x < 180) : fade-out progressif (visible mais faible)
-          // - Queue proche vers tête (x > 180) : montée rapide vers maximum
-          
-          uint32_t fadeValue;
-          
-          if (x < 80) {
-            // Queue très lointaine (x = 0-80) : s'éteint rapidement
-            // Courbe quadratique pour extinction rapide mais douce
-            uint32_t xNormalized = x;  // 0-80
-            fadeValue = (xNormalized * xNormalized) / 80;  // 0-80, extinction rapide
-          } else if (x < 180) {
-            // Queue moyenne (x = 80-180) : fade-out progressif
-            // Les dernières LEDs restent visibles avec luminosité qui diminue doucement
-            uint32_t xNormalized = x - 80;  // 0-100
-            uint32_t baseValue = 80;  // Valeur de base depuis la queue lointaine
-            // Courbe quadratique douce pour fade-out progressif
-            uint32_t increment = (xNormalized * xNormalized) / 40;  // 0-250
-            fadeValue = baseValue + increment;  // 80-330
-          } else {
-            // Queue proche et tête (x = 180-256) : montée rapide vers maximum
-            uint32_t xNormalized = x - 180;  // 0-76
-            uint32_t baseValue = 330;  // Valeur de base depuis la queue moyenne
-            // Courbe cubique pour montée rapide mais fluide vers la tête
-            uint32_t increment = (xNormalized * xNormalized * xNormalized) / 300;  // 0-76
-            fadeValue = baseValue + increment;  // 330-406
-          }
-          
-          // Limiter à 256 maximum
-          if (fadeValue > 256) fadeValue = 256;
-          
-          // Intensité optimisée : queue s'éteint assez vite mais dernières LEDs restent visibles
-          // Queue lointaine : 15 (très faible, presque éteinte)
-          // Queue moyenne : 15-150 (fade-out progressif, reste visible)
-          // Queue proche : 150-255 (montée rapide vers tête)
-          // Cela donne une queue qui s'éteint assez vite mais les dernières LEDs restent visibles
-          intensity = 15 + ((fadeValue * 240) / 256);
-          
-          // S'assurer que l'intensité minimale est respectée
-          if (intensity < 15) intensity = 15;
-        }
-        
-        // Appliquer la couleur avec l'intensité calculée
-        if (strip != nullptr) {
-          // Extraire les composantes RGB de currentColor
-          uint8_t r = (currentColor >> 16) & 0xFF;
-          uint8_t g = (currentColor >> 8) & 0xFF;
-          uint8_t b = currentColor & 0xFF;
-          
-          // Appliquer l'intensité (fade)
-          r = (r * intensity) / 255;
-          g = (g * intensity) / 255;
-          b = (b * intensity) / 255;
-          
-          uint32_t snakeColor = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
-          strip->setPixelColor(ledIndex, snakeColor);
-        }
-      }
-      break;
-    }
-    
-    case LED_EFFECT_NIGHTLIGHT: {
-      // Effet de veilleuse avec vagues bleu/blanc qui se déplacent de gauche à droite
-      // Utiliser le temps réel pour une animation constante et fluide
-      static unsigned long nightlightStartTime = 0;
-      
-      // Initialiser le temps de départ si nécessaire
-      if (nightlightStartTime == 0) {
-        nightlightStartTime = currentTime;
-      }
-      
-      // Cycle de déplacement : ~6 secondes pour traverser toute la bande
-      const uint32_t NIGHTLIGHT_CYCLE_MS = 6000;  // 6 secondes
-      
-      // Gérer le wrap-around de millis()
-      uint32_t elapsed;
-      if (currentTime >= nightlightStartTime) {
-        elapsed = (currentTime - nightlightStartTime) % NIGHTLIGHT_CYCLE_MS;
-      } else {
-        // Wrap-around détecté
-        elapsed = (ULONG_MAX - nightlightStartTime + currentTime) % NIGHTLIGHT_CYCLE_MS;
-      }
-      
-      // Calculer l'offset de déplacement (0 à NUM_LEDS * 2 pour permettre plusieurs cycles visuels)
-      float scrollOffset = ((float)elapsed / (float)NIGHTLIGHT_CYCLE_MS) * (float)(NUM_LEDS * 2);
-      
-      if (strip != nullptr) {
-        // Couleurs de base : bleu et blanc
-        const uint8_t BLUE_R = 30;
-        const uint8_t BLUE_G = 100;
-        const uint8_t BLUE_B = 255;
-        
-        const uint8_t WHITE_R = 200;
-        const uint8_t WHITE_G = 220;
-        const uint8_t WHITE_B = 255;
-        
-        // Créer plusieurs vagues qui se déplacent de gauche à droite
-        for (int i = 0; i < NUM_LEDS; i++) {
-          // Position avec décalage pour créer le mouvement de gauche à droite
-          float position = (float)i - scrollOffset;
-          
-          // Créer 3 vagues sinusoïdales avec différentes fréquences et phases
-          // Vague 1 : longue période (bleu dominant) - mouvement lent
-          float wave1 = sin((position / (float)NUM_LEDS) * 2.0 * M_PI * 1.5) * 0.5 + 0.5;
-          
-          // Vague 2 : période moyenne (blanc subtil) - mouvement moyen
-          float wave2 = sin((position / (float)NUM_LEDS) * 2.0 * M_PI * 2.5 + (M_PI / 3.0)) * 0.5 + 0.5;
-          
-          // Vague 3 : courte période (accent bleu) - mouvement rapide
-          float wave3 = sin((position / (float)NUM_LEDS) * 2.0 * M_PI * 4.0 + (M_PI / 2.0)) * 0.3 + 0.3;
-          
-          // Combiner les vagues (mélange bleu/blanc - bleu dominant)
-          // Assurer un minimum de luminosité pour éviter les zones complètement sombres
-          float blueFactor = wave1 * 0.6 + wave3 * 0.4;
-          float whiteFactor = wave2 * 0.2;
-          
-          // Ajouter un fond bleu minimal pour éviter les zones complètement éteintes
-          float baseBlue = 0.3; // Fond bleu minimal (30%)
-          blueFactor = blueFactor * 0.7 + baseBlue; // 70% de la vague + 30% de fond
-          
-          // Normaliser pour éviter la saturation, mais garder un minimum
-          float total = blueFactor + whiteFactor;
-          if (total > 1.0) {
-            blueFactor /= total;
-            whiteFactor /= total;
-          }
-          
-          // Calculer les composantes RGB finales
-          uint8_t r = (uint8_t)(BLUE_R * blueFactor + WHITE_R * whiteFactor);
-          uint8_t g = (uint8_t)(BLUE_G * blueFactor + WHITE_G * whiteFactor);
-          uint8_t b = (uint8_t)(BLUE_B * blueFactor + WHITE_B * whiteFactor);
-          
-          // Appliquer la luminosité globale
-          r = (r * currentBrightness) / 255;
-          g = (g * currentBrightness) / 255;
-          b = (b * currentBrightness) / 255;
-          
-          uint32_t color = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
-          strip->setPixelColor(i, color);
-        }
-      }
-      break;
-    }
-    
-    case LED_EFFECT_BREATHE: {
-      // Effet de respiration avec changement de couleur toutes les 30 secondes
-      static unsigned long breatheStartTime = 0;
-      static int currentColorIndex = 0;
-      static unsigned long colorChangeStartTime = 0;
-      static uint8_t previousR = 30, previousG = 100, previousB = 255;  // Couleur précédente pour transition
-      
-      // Palette de couleurs pour la respiration (définie en premier pour être accessible partout)
-      // Couleurs douces et apaisantes
-      const uint8_t colors[][3] = {
-        {30, 100, 255},   // Bleu doux
-        {100, 150, 255},  // Bleu ciel
-        {150, 100, 255},  // Violet doux
-        {255, 100, 150},  // Rose doux
-        {255, 150, 100},  // Orange doux
-        {150, 255, 150},  // Vert doux
-        {255, 200, 100}   // Jaune doux
-      };
-      const int numColors = sizeof(colors) / sizeof(colors[0]);
-      
-      // Initialiser le temps de départ si nécessaire
-      if (breatheStartTime == 0) {
-        breatheStartTime = currentTime;
-        colorChangeStartTime = currentTime;
-        // Initialiser avec la première couleur
-        previousR = colors[0][0];
-        previousG = colors[0][1];
-        previousB = colors[0][2];
-      }
-      
-      // Cycle de changement de couleur : 30 secondes
-      const uint32_t COLOR_CHANGE_INTERVAL_MS = 30000;  // 30 secondes
-      const uint32_t COLOR_TRANSITION_DURATION_MS = 2000;  // 2 secondes pour la transition
-      
-      // Gérer le wrap-around de millis()
-      uint32_t elapsed;
-      if (currentTime >= breatheStartTime) {
-        elapsed = currentTime - breatheStartTime;
-      } else {
-        // Wrap-around détecté
-        elapsed = ULONG_MAX - breatheStartTime + currentTime;
-      }
-      
-      // Changer de couleur toutes les 30 secondes
-      int newColorIndex = elapsed / COLOR_CHANGE_INTERVAL_MS;
-      if (newColorIndex != currentColorIndex) {
-        // Sauvegarder la couleur actuelle comme couleur précédente
-        previousR = colors[currentColorIndex % numColors][0];
-        previousG = colors[currentColorIndex % numColors][1];
-        previousB = colors[currentColorIndex % numColors][2];
-        currentColorIndex = newColorIndex;
-        colorChangeStartTime = currentTime;
-      }
-      
-      // Sélectionner la couleur cible (cycle infini)
-      uint8_t targetR = colors[currentColorIndex % numColors][0];
-      uint8_t targetG = colors[currentColorIndex % numColors][1];
-      uint8_t targetB = colors[currentColorIndex % numColors][2];
-      
-      // Calculer la transition progressive entre l'ancienne et la nouvelle couleur
-      uint32_t transitionElapsed;
-      if (currentTime >= colorChangeStartTime) {
-        transitionElapsed = currentTime - colorChangeStartTime;
-      } else {
-        transitionElapsed = ULONG_MAX - colorChangeStartTime + currentTime;
-      }
-      
-      uint8_t currentR, currentG, currentB;
-      if (transitionElapsed < COLOR_TRANSITION_DURATION_MS) {
-        // Transition en cours : mélanger progressivement les couleurs
-        float transitionFactor = (float)transitionElapsed / (float)COLOR_TRANSITION_DURATION_MS;
-        // Utiliser une courbe d'ease-in-out pour une transition plus douce
-        float easedFactor = transitionFactor * transitionFactor * (3.0 - 2.0 * transitionFactor);
-        
-        currentR = (uint8_t)(previousR + (targetR - previousR) * easedFactor);
-        currentG = (uint8_t)(previousG + (targetG - previousG) * easedFactor);
-        currentB = (uint8_t)(previousB + (targetB - previousB) * easedFactor);
-      } else {
-        // Transition terminée : utiliser la couleur cible
-        currentR = targetR;
-        currentG = targetG;
-        currentB = targetB;
-      }
-      
-      // Cycle de respiration : ~3 secondes pour un cycle complet (inspiration + expiration)
-      const uint32_t BREATHE_CYCLE_MS = 3000;  // 3 secondes
-      uint32_t breatheElapsed = elapsed % BREATHE_CYCLE_MS;
-      
-      // Créer l'effet de respiration avec une fonction sinusoïdale
-      // sin va de -1 à 1, on le transforme en 0.3 à 1.0 pour avoir un minimum de luminosité
-      float breatheFactor = sin((float)breatheElapsed / (float)BREATHE_CYCLE_MS * 2.0 * M_PI) * 0.35 + 0.65;
-      // breatheFactor va maintenant de 0.3 à 1.0
-      
-      if (strip != nullptr) {
-        // Calculer les composantes RGB avec l'effet de respiration
-        // Utiliser currentR/G/B qui contient la couleur avec transition progressive
-        uint8_t r = (uint8_t)(currentR * breatheFactor);
-        uint8_t g = (uint8_t)(currentG * breatheFactor);
-        uint8_t b = (uint8_t)(currentB * breatheFactor);
-        
-        // Appliquer la luminosité globale
-        r = (r * currentBrightness) / 255;
-        g = (g * currentBrightness) / 255;
-        b = (b * currentBrightness) / 255;
-        
-        uint32_t color = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
-        
-        // Appliquer la couleur à toutes les LEDs
-        for (int i = 0; i < NUM_LEDS; i++) {
-          strip->setPixelColor(i, color);
-        }
-      }
-      break;
+    effectNeedsRestart = true;
+  }
+  
+  if (effectNeedsRestart) {
+    effectNeedsRestart = false;
+    effectStartTime = currentTime;
+    if (activeEffect != nullptr && activeEffect->init != nullptr) {
+      activeEffect->init();
     }
   }
+  
+  if (activeEffect == nullptr || activeEffect->render == nullptr || output == nullptr) {
+    // Pas d'effet, couleur unie déjà appliquée : aucune trame à produire (0 fps)
+    nextFrameDelayMs = LED_EFFECT_NO_DEADLINE;
+    return;
+  }
+  
+  // L'effet dessine des valeurs linéaires dans la trame à partir du temps écoulé depuis son démarrage
+  // (soustraction non signée : pas de problème au wrap-around de millis())
+  LEDEffectParams params;
+  params.color = currentColor;
+  uint32_t nextDelay = activeEffect->render(frameBuffer, NUM_LEDS, currentTime - effectStartTime, params);
+  
+  // Ne jamais redessiner plus souvent que la cadence déclarée par l'effet
+  nextFrameDelayMs = (nextDelay < activeEffect->frameIntervalMs) ? activeEffect->frameIntervalMs : nextDelay;
 }
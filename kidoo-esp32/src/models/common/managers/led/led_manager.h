@@ -2,12 +2,12 @@
 #define LED_MANAGER_H
 
 #include <Arduino.h>
-#include <Adafruit_NeoPixel.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
-#include <freertos/queue.h>
+#include <atomic>
 #include "../../../model_config.h"
 #include "../../config/core_config.h"
+#include "led_latency.h"
 
 /**
  * Gestionnaire de LEDs dans un thread séparé (Core 1)
@@ -21,6 +21,18 @@
  * - Priorité élevée (PRIORITY_LED) pour des animations fluides
  */
 
+// Correction de couleur par canal appliquée en sortie (255 = aucune)
+// Peut être redéfinie dans la config du modèle selon la bande utilisée
+#ifndef LED_COLOR_CORRECTION_R
+#define LED_COLOR_CORRECTION_R 255
+#endif
+#ifndef LED_COLOR_CORRECTION_G
+#define LED_COLOR_CORRECTION_G 255
+#endif
+#ifndef LED_COLOR_CORRECTION_B
+#define LED_COLOR_CORRECTION_B 255
+#endif
+
 // Types de commandes pour le thread LED
 enum LEDCommandType {
   LED_CMD_SET_COLOR,        // Définir une couleur RGB
@@ -39,9 +51,16 @@ enum LEDEffect {
   LED_EFFECT_ROTATE,        // Effet de rotation (utilise la couleur définie)
   LED_EFFECT_NIGHTLIGHT,    // Effet de veilleuse (vagues bleu/blanc)
   LED_EFFECT_BREATHE,       // Effet de respiration avec changement de couleur
-  LED_EFFECT_RAINBOW_SOFT   // Arc-en-ciel doux (animation lente pour veilleuse)
+  LED_EFFECT_RAINBOW_SOFT,  // Arc-en-ciel doux (animation lente pour veilleuse)
+  LED_EFFECT_ANIMATION      // Animation keyframes lue depuis la carte SD (voir playAnimation)
 };
 
+// Descripteur d'effet (voir effects/led_effect.h)
+struct LEDEffectDescriptor;
+
+// Driver de sortie (voir output/led_output.h)
+struct LEDOutputDriver;
+
 // Structure de commande pour le thread LED
 struct LEDCommand {
   LEDCommandType type;
@@ -64,7 +83,7 @@ public:
   // Arrêter le gestionnaire (ne devrait jamais être appelé)
   static void stop();
   
-  // Envoyer une commande au thread LED
+  // Envoyer une commande au thread LED (boîte aux lettres : la dernière valeur l'emporte)
   static bool sendCommand(const LEDCommand& cmd);
   
   // Méthodes pratiques pour envoyer des commandes
@@ -73,34 +92,73 @@ public:
   static bool setEffect(LEDEffect effect);
   static bool clear();
   
+#ifdef HAS_LED_EFFECT_ANIMATION
+  // Jouer une animation keyframes depuis la carte SD (ex: "/animations/etoiles.kan")
+  // Le fichier est lu au fil de l'eau par la tâche LED (voir animation/led_animation.h)
+  static bool playAnimation(const char* path);
+#endif
+  
   // Gestion du sleep mode
   static void wakeUp();  // Réveiller les LEDs (reset du timer d'inactivité)
   static bool getSleepState();  // Vérifier si les LEDs sont en mode sleep
   static void preventSleep();  // Empêcher le sleep mode (pour bedtime, etc.)
   static void allowSleep();  // Réautoriser le sleep mode
   
+  // Durée des fondus enchaînés entre effets / couleurs (0 = changement immédiat)
+  static void setTransitionDuration(uint16_t durationMs);
+  
   // Obtenir l'état actuel
   static bool isInitialized();
   static uint8_t getCurrentBrightness();
   
   // Test des LEDs une par une
   static bool testLEDsSequential();  // Test séquentiel : allume chaque LED une par une puis toutes en rouge
+  
+  // Statistiques de rendu (trames envoyées / ignorées, commandes fusionnées / rejetées)
+  static void printStats(bool reset = false);
 
 private:
   // Thread principal de gestion des LEDs
   static void ledTask(void* parameter);
   
+  // Réveiller la tâche LED endormie jusqu'à sa prochaine échéance
+  static void notifyTask();
+  
+  // Délai avant la prochaine échéance (trame d'effet, fondu, show différé, timers)
+  static uint32_t computeWaitMs(unsigned long now, uint32_t showWaitMs);
+  
+  // Histogrammes du planificateur de trames
+  static void recordFrameTime(uint32_t durationUs);
+  static void recordFrameJitter(uint32_t lateMs);
+  
+  // Retirer la plus ancienne commande en attente de la boîte aux lettres
+  static bool takeCommand(LEDCommand& cmd);
+  
   // Traiter une commande reçue
   static void processCommand(const LEDCommand& cmd);
   
-  // Appliquer les effets animés
+  // Appliquer l'effet animé courant (rendu via le registre d'effets)
   static void updateEffects();
   
   // Gestion du sleep mode
   static void checkSleepMode();
-  static void updateSleepFade();  // Animation de fade vers sleep
-  static void updateWakeFade();  // Animation de fade depuis sleep
-  static void resetPulseEffect();  // Réinitialiser l'effet PULSE pour transition fluide
+  static void restartEffect();  // Faire repartir l'effet courant de son début (transition fluide)
+  
+  // Transitions (compositeur à deux calques, voir led_compositor.h)
+  static void beginCrossfade();  // Figer l'image visible comme calque sortant
+  static void startWakeFade();  // Fondu noir -> trame (reprend un fondu vers sleep en cours)
+  static void updateTransition();  // Rendu du calque sortant et fin de transition
+  
+  // Appliquer la table de sortie à la trame et l'envoyer au driver seulement
+  // si les pixels ont changé depuis la dernière émission
+  static bool pushFrame();
+  
+  // Écrire une couleur linéaire (0xRRGGBB) dans la trame
+  static void setFramePixel(int index, uint32_t color);
+  
+  // Luminosité effective de sortie (reconstruit les tables si elle change)
+  static void setOutputBrightness(uint8_t brightness);
+  static void rebuildOutputLut(uint8_t brightness);
   
   // Utilitaire pour obtenir le nom d'un effet
   static const char* getEffectName(LEDEffect effect);
@@ -108,8 +166,39 @@ private:
   // Variables statiques
   static bool initialized;
   static TaskHandle_t taskHandle;
-  static QueueHandle_t commandQueue;
-  static Adafruit_NeoPixel* strip;
+  
+  // Boîte aux lettres des commandes (sans verrou, la dernière valeur l'emporte)
+  // Une case par type de commande ; remplace la file de 10 commandes qui pouvait
+  // déborder et rejouer des couleurs intermédiaires déjà obsolètes
+  enum MailboxSlotIndex {
+    MAILBOX_COLOR,
+    MAILBOX_BRIGHTNESS,
+    MAILBOX_EFFECT,
+    MAILBOX_CLEAR,
+    MAILBOX_TEST,
+    MAILBOX_SLOT_COUNT
+  };
+  struct MailboxSlot {
+    std::atomic<uint32_t> value;       // Couleur 0xRRGGBB, luminosité ou effet
+    std::atomic<uint32_t> generation;  // Génération de la dernière écriture (0 = jamais)
+    std::atomic<uint32_t> writes;      // Nombre d'écritures (pour compter les fusions)
+    std::atomic<uint32_t> stamp;       // Réception de la plus ancienne commande mesurée (0 = aucune)
+  };
+  static MailboxSlot mailbox[MAILBOX_SLOT_COUNT];
+  static std::atomic<uint32_t> mailboxGeneration;
+  static uint32_t mailboxSeenGeneration[MAILBOX_SLOT_COUNT];  // Vu par la tâche LED
+  static uint32_t mailboxSeenWrites[MAILBOX_SLOT_COUNT];
+  static uint32_t commandsApplied;  // Commandes traitées par la tâche LED
+  static std::atomic<uint32_t> commandsCoalesced;  // Écritures remplacées avant traitement
+  static std::atomic<uint32_t> commandsDropped;  // Commandes rejetées (gestionnaire non initialisé)
+  
+  // Latence commande -> trame (voir led_latency.h)
+  // stamp = instant de réception (µs, 3 bits de poids faible remplacés par source + 1)
+  static uint32_t latencyPendingUs[LED_SOURCE_COUNT];  // Réception la plus ancienne non encore affichée
+  static bool latencyPending[LED_SOURCE_COUNT];
+  static void recordCommandLatency();
+  
+  static const LEDOutputDriver* output;  // Driver de sortie (RMT ou NeoPixel)
   static uint8_t currentBrightness;
   static LEDEffect currentEffect;
   static uint32_t currentColor;  // Couleur au format RGB (0xRRGGBB)
@@ -117,14 +206,52 @@ private:
   static unsigned long lastActivityTime;  // Dernière activité (pour sleep mode)
   static unsigned long rotateActivationTime;  // Temps d'activation de ROTATE pour désactivation auto
   static bool isSleeping;  // État du sleep mode
-  static bool isFadingToSleep;  // En cours d'animation de fade vers sleep
-  static bool isFadingFromSleep;  // En cours d'animation de fade depuis sleep
-  static unsigned long sleepFadeStartTime;  // Début de l'animation de fade
   static LEDEffect savedEffect;  // Effet sauvegardé avant le sleep
   static uint32_t sleepTimeoutMs;  // Timeout configuré pour le sleep mode
   static bool sleepPrevented;  // Flag pour empêcher le sleep mode (bedtime, etc.)
-  static bool pulseNeedsReset;  // Flag pour réinitialiser l'effet PULSE
-  static bool hardwareInitialized;  // Init NeoPixel faite dans la tâche LED
+  static bool effectNeedsRestart;  // Flag pour redémarrer l'effet courant
+  static bool hardwareInitialized;  // Init du driver de sortie faite dans la tâche LED
+  
+  // Effet en cours de rendu (résolu dans le registre au changement d'effet)
+  static const LEDEffectDescriptor* activeEffect;  // nullptr si NONE ou effet non compilé
+  static LEDEffect activeEffectId;
+  static unsigned long effectStartTime;  // Démarrage de l'effet (temps écoulé passé au rendu)
+  static uint32_t nextFrameDelayMs;  // Échéance de la prochaine trame indiquée par l'effet
+  static uint8_t frameBuffer[NUM_LEDS * 3];  // Trame RGB linéaire (effets, couleur unie, test)
+  
+  // Transition en cours entre le calque sortant et la trame (calque entrant)
+  enum TransitionKind {
+    TRANSITION_NONE,
+    TRANSITION_CROSSFADE,  // Ancien effet / ancienne couleur -> trame
+    TRANSITION_SLEEP,      // Trame -> noir (entrée en sleep)
+    TRANSITION_WAKE        // Noir -> trame (réveil)
+  };
+  static volatile TransitionKind transitionKind;
+  static volatile unsigned long transitionStartTime;
+  static uint16_t transitionDurationMs;  // Durée de la transition en cours
+  static uint16_t crossfadeDurationMs;  // Durée configurée des fondus enchaînés
+  static uint8_t outgoingBuffer[NUM_LEDS * 3];  // Calque sortant (RGB linéaire)
+  static const LEDEffectDescriptor* outgoingEffect;  // Effet encore animé dans le calque sortant (nullptr = figé)
+  static unsigned long outgoingStartTime;
+  static uint32_t outgoingColor;
+  static bool incomingRendered;  // Trame redessinée depuis le début du fondu enchaîné
+  
+  // Tables de sortie gamma × luminosité × correction, une par canal (R, G, B)
+  static uint8_t outputLut[3][256];
+  static uint8_t outputBrightness;  // Luminosité ayant servi à construire les tables
+  
+  // Image de la dernière trame de sortie envoyée (comparée avant chaque émission)
+  static uint8_t shadowFrame[NUM_LEDS * 3];
+  static bool shadowValid;  // false tant qu'aucune trame n'a été envoyée
+  static uint32_t framesPushed;  // Nombre de trames émises vers la bande
+  static uint32_t framesSkipped;  // Nombre de trames ignorées (pixels identiques)
+  
+  // Histogrammes du planificateur : durée de trame (µs) et retard sur l'échéance (ms)
+  static const int HISTOGRAM_BUCKETS = 7;
+  static uint32_t frameTimeHistogram[HISTOGRAM_BUCKETS];
+  static uint32_t frameJitterHistogram[HISTOGRAM_BUCKETS];
+  static uint32_t frameTimeMaxUs;
+  static uint32_t frameJitterMaxMs;
   
   // Variables pour le test séquentiel
   static bool testSequentialActive;  // Test séquentiel en cours
@@ -132,11 +259,12 @@ private:
   static unsigned long testSequentialLastUpdate;  // Dernière mise à jour du test
 
   // Paramètres du thread (centralisés dans core_config.h)
-  static const int QUEUE_SIZE = 10;
   static const int TASK_STACK_SIZE = STACK_SIZE_LED;
   static const int TASK_PRIORITY = PRIORITY_LED;
   static const int TASK_CORE = CORE_LED;  // Core 1 pour temps-réel
-  static const int UPDATE_INTERVAL_MS = 16;  // ~60 FPS pour les animations
+  static const int UPDATE_INTERVAL_MS = 16;  // Cadence des fondus et du test (les effets déclarent la leur)
+  static const uint32_t MAX_WAIT_MS = 1000;  // Attente maximale de la tâche sans notification
+  static const uint32_t ROTATE_VALIDATION_TIMEOUT_MS = 8000;  // Désactivation auto de ROTATE
 };
 
 #endif // LED_MANAGER_H
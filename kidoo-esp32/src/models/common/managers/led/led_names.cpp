@@ -0,0 +1,102 @@
+#include "led_names.h"
+#include "../../../model_config.h"
+#include "../../utils/name_table.h"
+
+// Tables triées par nom (vérifié à la compilation), alias compris
+
+static constexpr NamedEntry<LEDEffect> EFFECT_NAMES[] = {
+#ifdef HAS_LED_EFFECT_BREATHE
+  {"breathe", LED_EFFECT_BREATHE},
+#endif
+#ifdef HAS_LED_EFFECT_GLOSSY
+  {"glossy", LED_EFFECT_GLOSSY},
+#endif
+#ifdef HAS_LED_EFFECT_NIGHTLIGHT
+  {"nightlight", LED_EFFECT_NIGHTLIGHT},
+#endif
+  {"none", LED_EFFECT_NONE},
+#ifdef HAS_LED_EFFECT_PULSE
+  {"pulse", LED_EFFECT_PULSE},
+#endif
+#ifdef HAS_LED_EFFECT_RAINBOW
+  {"rainbow", LED_EFFECT_RAINBOW},
+#endif
+#ifdef HAS_LED_EFFECT_RAINBOW_SOFT
+  {"rainbow-soft", LED_EFFECT_RAINBOW_SOFT},
+#endif
+#ifdef HAS_LED_EFFECT_ROTATE
+  {"rotate", LED_EFFECT_ROTATE},
+#endif
+  {"solid", LED_EFFECT_NONE},
+};
+static_assert(isNameTableSorted(EFFECT_NAMES), "EFFECT_NAMES doit etre trie par nom");
+
+// Couleurs 0xRRGGBB
+static constexpr NamedEntry<uint32_t> COLOR_NAMES[] = {
+  {"black", 0x000000},
+  {"blue", 0x0000FF},
+  {"cyan", 0x00FFFF},
+  {"green", 0x00FF00},
+  {"magenta", 0xFF00FF},
+  {"off", 0x000000},
+  {"orange", 0xFFA500},
+  {"pink", 0xFFC0CB},
+  {"purple", 0x800080},
+  {"red", 0xFF0000},
+  {"white", 0xFFFFFF},
+  {"yellow", 0xFFFF00},
+};
+static_assert(isNameTableSorted(COLOR_NAMES), "COLOR_NAMES doit etre trie par nom");
+
+bool ledEffectFromName(const char* name, LEDEffect& effect) {
+  const NamedEntry<LEDEffect>* entry = findNamed(EFFECT_NAMES, name);
+  if (entry == nullptr) {
+    return false;
+  }
+  effect = entry->value;
+  return true;
+}
+
+bool ledColorFromName(const char* name, uint8_t& r, uint8_t& g, uint8_t& b) {
+  if (name == nullptr) {
+    return false;
+  }
+
+  uint32_t rgb;
+  if (name[0] == '#' && strlen(name) == 7) {
+    // Format hex #RRGGBB
+    char* end;
+    rgb = strtoul(name + 1, &end, 16);
+    if (*end != '\0') {
+      return false;
+    }
+  } else {
+    const NamedEntry<uint32_t>* entry = findNamed(COLOR_NAMES, name);
+    if (entry == nullptr) {
+      return false;
+    }
+    rgb = entry->value;
+  }
+
+  r = (rgb >> 16) & 0xFF;
+  g = (rgb >> 8) & 0xFF;
+  b = rgb & 0xFF;
+  return true;
+}
+
+void ledPrintEffectNames() {
+  for (const NamedEntry<LEDEffect>& entry : EFFECT_NAMES) {
+    Serial.print(entry.name);
+    Serial.print(" ");
+  }
+  Serial.println();
+}
+
+void ledPrintColorNames() {
+  Serial.print("#RRGGBB ");
+  for (const NamedEntry<uint32_t>& entry : COLOR_NAMES) {
+    Serial.print(entry.name);
+    Serial.print(" ");
+  }
+  Serial.println();
+}
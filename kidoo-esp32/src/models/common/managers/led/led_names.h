@@ -0,0 +1,31 @@
+#ifndef LED_NAMES_H
+#define LED_NAMES_H
+
+#include <Arduino.h>
+#include "led_manager.h"
+
+/**
+ * Noms d'effets et de couleurs partagés par les routes PubNub, les commandes
+ * série et les configurations (bedtime) : une seule table triée par famille,
+ * au lieu d'une chaîne de strcmp par appelant.
+ */
+
+/**
+ * Effet à partir de son nom ("pulse", "rainbow-soft", alias "solid" = "none")
+ * Seuls les effets compilés pour le modèle (HAS_LED_EFFECT_*) sont reconnus.
+ * "off" n'est pas un effet : l'appelant éteint la bande lui-même.
+ * @return false si le nom est inconnu (effect inchangé)
+ */
+bool ledEffectFromName(const char* name, LEDEffect& effect);
+
+/**
+ * Couleur à partir de "#RRGGBB" ou d'un nom ("red", "orange", "off"...)
+ * @return false si la couleur est inconnue (r, g, b inchangés)
+ */
+bool ledColorFromName(const char* name, uint8_t& r, uint8_t& g, uint8_t& b);
+
+// Lister les noms reconnus (aide des commandes série)
+void ledPrintEffectNames();
+void ledPrintColorNames();
+
+#endif // LED_NAMES_H
@@ -0,0 +1,59 @@
+#ifndef LED_OUTPUT_H
+#define LED_OUTPUT_H
+
+#include <Arduino.h>
+#include "../../../config/core_config.h"
+
+/**
+ * Interface des drivers de sortie LED
+ * 
+ * LEDManager produit une trame RGB finale (gamma et luminosité appliqués) et la
+ * confie au driver sélectionné à la compilation (LED_OUTPUT_USE_RMT, core_config.h) :
+ * - RMT : encodage de la trame en symboles RMT et émission asynchrone,
+ *   interruptions actives (n'interfère pas avec l'audio I2S), 60 FPS
+ * - NeoPixel : Adafruit NeoPixel, show() bloquant, limité à ~30 FPS pour
+ *   ne pas provoquer de grésillements audio
+ * - Mock (LED_OUTPUT_USE_MOCK, tests sur PC) : enregistre les trames émises
+ *   (voir led_output_mock.h)
+ */
+
+struct LEDOutputDriver {
+  const char* name;
+  uint16_t minFrameIntervalMs;  // Intervalle minimum entre deux trames
+  
+  // Initialiser la sortie (appelé depuis la tâche LED)
+  bool (*begin)(uint16_t count, int pin);
+  
+  // Libérer la sortie
+  void (*end)();
+  
+  // Émettre une trame RGB (count * 3 octets), copiée par le driver
+  // @return false si une émission est encore en cours (trame non prise)
+  bool (*transmit)(const uint8_t* rgb, uint16_t count);
+  
+  // Une émission asynchrone est-elle encore en cours ?
+  bool (*isBusy)();
+};
+
+extern const LEDOutputDriver LED_OUTPUT_NEOPIXEL_DRIVER;
+#if LED_OUTPUT_USE_RMT
+extern const LEDOutputDriver LED_OUTPUT_RMT_DRIVER;
+#endif
+#if LED_OUTPUT_USE_MOCK
+extern const LEDOutputDriver LED_OUTPUT_MOCK_DRIVER;
+#endif
+
+/**
+ * Driver de sortie sélectionné pour ce firmware
+ */
+inline const LEDOutputDriver* ledOutputDriver() {
+#if LED_OUTPUT_USE_MOCK
+  return &LED_OUTPUT_MOCK_DRIVER;
+#elif LED_OUTPUT_USE_RMT
+  return &LED_OUTPUT_RMT_DRIVER;
+#else
+  return &LED_OUTPUT_NEOPIXEL_DRIVER;
+#endif
+}
+
+#endif // LED_OUTPUT_H
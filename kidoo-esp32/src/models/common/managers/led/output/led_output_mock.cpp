@@ -0,0 +1,117 @@
+#include "led_output_mock.h"
+#include "../../../../model_config.h"
+
+#if LED_OUTPUT_USE_MOCK
+
+// Durée d'une trame WS2812B : 24 bits de 1,25 us par LED + reset de 50 us
+static const unsigned long WS2812_LED_US = 30;
+static const unsigned long WS2812_RESET_US = 50;
+
+static uint8_t history[LEDOutputMock::HISTORY_SIZE][NUM_LEDS * 3];
+static unsigned long historyTimeUs[LEDOutputMock::HISTORY_SIZE];
+static uint32_t frameCount = 0;
+static uint32_t rejectedCount = 0;
+static uint16_t ledCount = 0;
+static bool wireTiming = true;
+static bool transmitting = false;
+static unsigned long transmitStartUs = 0;
+static unsigned long transmitDurationUs = 0;
+
+static bool mockIsBusy() {
+  if (transmitting && micros() - transmitStartUs >= transmitDurationUs) {
+    transmitting = false;
+  }
+  return transmitting;
+}
+
+static bool mockBegin(uint16_t count, int pin) {
+  (void)pin;
+  if (count > NUM_LEDS) {
+    return false;
+  }
+  ledCount = count;
+  transmitting = false;
+  return true;
+}
+
+static void mockEnd() {
+  ledCount = 0;
+  transmitting = false;
+}
+
+static bool mockTransmit(const uint8_t* rgb, uint16_t count) {
+  if (ledCount == 0 || count > NUM_LEDS) {
+    return false;
+  }
+  if (mockIsBusy()) {
+    rejectedCount++;
+    return false;
+  }
+  
+  uint16_t slot = frameCount % LEDOutputMock::HISTORY_SIZE;
+  memcpy(history[slot], rgb, count * 3);
+  historyTimeUs[slot] = micros();
+  frameCount++;
+  
+  if (wireTiming) {
+    transmitting = true;
+    transmitStartUs = historyTimeUs[slot];
+    transmitDurationUs = count * WS2812_LED_US + WS2812_RESET_US;
+  }
+  return true;
+}
+
+const LEDOutputDriver LED_OUTPUT_MOCK_DRIVER = {
+  "Mock",
+  16,  // Même cadence que le driver RMT
+  mockBegin,
+  mockEnd,
+  mockTransmit,
+  mockIsBusy
+};
+
+void LEDOutputMock::reset() {
+  frameCount = 0;
+  rejectedCount = 0;
+  transmitting = false;
+  memset(history, 0, sizeof(history));
+}
+
+uint32_t LEDOutputMock::getFrameCount() {
+  return frameCount;
+}
+
+uint32_t LEDOutputMock::getRejectedCount() {
+  return rejectedCount;
+}
+
+const uint8_t* LEDOutputMock::getFrame(uint32_t index) {
+  if (index >= frameCount || frameCount - index > HISTORY_SIZE) {
+    return nullptr;
+  }
+  return history[index % HISTORY_SIZE];
+}
+
+const uint8_t* LEDOutputMock::getLastFrame() {
+  return frameCount == 0 ? nullptr : getFrame(frameCount - 1);
+}
+
+unsigned long LEDOutputMock::getFrameTimeUs(uint32_t index) {
+  if (getFrame(index) == nullptr) {
+    return 0;
+  }
+  return historyTimeUs[index % HISTORY_SIZE];
+}
+
+uint16_t LEDOutputMock::getLedCount() {
+  return ledCount;
+}
+
+void LEDOutputMock::setWireTiming(bool enabled) {
+  wireTiming = enabled;
+  if (!enabled) {
+    transmitting = false;
+  }
+}
+
+#endif // LED_OUTPUT_USE_MOCK
@@ -0,0 +1,50 @@
+#ifndef LED_OUTPUT_MOCK_H
+#define LED_OUTPUT_MOCK_H
+
+#include "led_output.h"
+
+#if LED_OUTPUT_USE_MOCK
+
+/**
+ * Sortie LED simulée (tests sur PC, env native)
+ * 
+ * Le driver LED_OUTPUT_MOCK_DRIVER enregistre les dernières trames émises au lieu
+ * de piloter une bande. Une émission occupe la sortie pendant la durée réelle
+ * d'une trame WS2812B (30 us par LED + reset), comme le driver RMT asynchrone :
+ * isBusy() et les trames refusées se comportent comme sur la carte.
+ */
+
+class LEDOutputMock {
+public:
+  // Nombre de trames conservées (les plus anciennes sont écrasées)
+  static const uint16_t HISTORY_SIZE = 64;
+  
+  // Vider l'historique et les compteurs (sortie libre)
+  static void reset();
+  
+  // Trames acceptées / refusées (émission en cours) depuis reset()
+  static uint32_t getFrameCount();
+  static uint32_t getRejectedCount();
+  
+  /**
+   * Trame acceptée numéro index (0 = première depuis reset())
+   * @return Octets RGB tels que transmis au driver, nullptr si sortie de l'historique
+   */
+  static const uint8_t* getFrame(uint32_t index);
+  
+  // Dernière trame acceptée (nullptr si aucune)
+  static const uint8_t* getLastFrame();
+  
+  // Instant d'émission (micros()) de la trame numéro index
+  static unsigned long getFrameTimeUs(uint32_t index);
+  
+  // Nombre de LEDs passé à begin() (0 si la sortie n'est pas initialisée)
+  static uint16_t getLedCount();
+  
+  // Simuler la durée d'émission WS2812B (désactiver pour des tests sans attente)
+  static void setWireTiming(bool enabled);
+};
+
+#endif // LED_OUTPUT_USE_MOCK
+
+#endif // LED_OUTPUT_MOCK_H
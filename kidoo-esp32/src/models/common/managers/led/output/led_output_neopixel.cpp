@@ -0,0 +1,51 @@
+#include "led_output.h"
+#include <Adafruit_NeoPixel.h>
+
+// Driver Adafruit NeoPixel : show() bloquant pendant toute la trame
+static Adafruit_NeoPixel* strip = nullptr;
+
+static bool neopixelBegin(uint16_t count, int pin) {
+  if (strip == nullptr) {
+    // NEO_GRB pour WS2812B (ordre des couleurs GRB)
+    strip = new Adafruit_NeoPixel(count, pin, NEO_GRB + NEO_KHZ800);
+    if (strip == nullptr) {
+      Serial.println("[LED] ERREUR: Allocation NeoPixel echouee!");
+      return false;
+    }
+  }
+  strip->begin();
+  strip->clear();
+  strip->show();
+  return true;
+}
+
+static void neopixelEnd() {
+  if (strip != nullptr) {
+    delete strip;
+    strip = nullptr;
+  }
+}
+
+static bool neopixelTransmit(const uint8_t* rgb, uint16_t count) {
+  if (strip == nullptr) {
+    return false;
+  }
+  for (uint16_t i = 0; i < count; i++) {
+    strip->setPixelColor(i, rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+  }
+  strip->show();
+  return true;
+}
+
+static bool neopixelIsBusy() {
+  return false;
+}
+
+const LEDOutputDriver LED_OUTPUT_NEOPIXEL_DRIVER = {
+  "NeoPixel",
+  33,  // ~30 FPS : show() peut désactiver brièvement les interruptions (conflit I2S)
+  neopixelBegin,
+  neopixelEnd,
+  neopixelTransmit,
+  neopixelIsBusy
+};
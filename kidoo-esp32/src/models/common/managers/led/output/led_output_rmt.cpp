@@ -0,0 +1,162 @@
+#include "led_output.h"
+#include "../../../../model_config.h"
+#include "../../../config/core_config.h"
+
+#if LED_OUTPUT_USE_RMT
+
+#include <driver/rmt.h>
+#include <esp_intr_alloc.h>
+#include <soc/soc_caps.h>
+
+// Driver RMT (API legacy ESP-IDF 4.x) : la trame est convertie en symboles WS2812
+// au fil de l'eau par le translator, dans l'interruption RMT. L'émission est
+// asynchrone et ne masque pas les interruptions : l'audio I2S n'est pas perturbé.
+
+static const rmt_channel_t LED_RMT_CHANNEL = RMT_CHANNEL_0;
+static const uint8_t LED_RMT_CLK_DIV = 2;  // APB 80 MHz / 2 = 40 MHz (25 ns par tick)
+
+// Mémoire du canal : 2 blocs (pris au canal 1, inutilisé) divisent par deux les
+// interruptions de remplissage pendant une trame, si la puce a au moins 2 canaux TX
+#if (defined(SOC_RMT_TX_CANDIDATES_PER_GROUP) && SOC_RMT_TX_CANDIDATES_PER_GROUP >= 2) || \
+    (defined(SOC_RMT_TX_CHANNELS_NUM) && SOC_RMT_TX_CHANNELS_NUM >= 2)
+static const uint8_t LED_RMT_MEM_BLOCKS = 2;
+#else
+static const uint8_t LED_RMT_MEM_BLOCKS = 1;
+#endif
+
+// Timings WS2812B (ns)
+static const uint32_t WS2812_T0H_NS = 400;
+static const uint32_t WS2812_T0L_NS = 850;
+static const uint32_t WS2812_T1H_NS = 800;
+static const uint32_t WS2812_T1L_NS = 450;
+
+// Symboles d'un bit 0 / 1, calculés au begin() selon l'horloge du canal
+static uint32_t rmtBit0 = 0;
+static uint32_t rmtBit1 = 0;
+
+// Trame en cours d'émission (ordre GRB), doit rester valide pendant l'émission
+static uint8_t txBuffer[NUM_LEDS * 3];
+static uint16_t txCount = 0;
+static bool rmtInstalled = false;
+
+// Conversion octets -> symboles RMT (appelée depuis l'interruption RMT)
+static void IRAM_ATTR ws2812Translate(const void* src, rmt_item32_t* dest, size_t srcSize,
+                                      size_t wantedNum, size_t* translatedSize, size_t* itemNum) {
+  if (src == nullptr || dest == nullptr) {
+    *translatedSize = 0;
+    *itemNum = 0;
+    return;
+  }
+  
+  const uint8_t* psrc = (const uint8_t*)src;
+  size_t size = 0;
+  size_t num = 0;
+  while (size < srcSize && num + 8 <= wantedNum) {
+    uint8_t value = *psrc;
+    for (int bit = 7; bit >= 0; bit--) {
+      dest->val = (value & (1 << bit)) ? rmtBit1 : rmtBit0;
+      dest++;
+    }
+    num += 8;
+    size++;
+    psrc++;
+  }
+  *translatedSize = size;
+  *itemNum = num;
+}
+
+static uint32_t makeSymbol(uint32_t highNs, uint32_t lowNs, uint32_t clockHz) {
+  rmt_item32_t item;
+  item.val = 0;
+  item.level0 = 1;
+  item.duration0 = (uint32_t)(((uint64_t)highNs * clockHz + 500000000ULL) / 1000000000ULL);
+  item.level1 = 0;
+  item.duration1 = (uint32_t)(((uint64_t)lowNs * clockHz + 500000000ULL) / 1000000000ULL);
+  return item.val;
+}
+
+static bool rmtBegin(uint16_t count, int pin) {
+  if (count > NUM_LEDS) {
+    return false;
+  }
+  
+  if (!rmtInstalled) {
+    rmt_config_t config = {};
+    config.rmt_mode = RMT_MODE_TX;
+    config.channel = LED_RMT_CHANNEL;
+    config.gpio_num = pin;
+    config.clk_div = LED_RMT_CLK_DIV;
+    config.mem_block_num = LED_RMT_MEM_BLOCKS;
+    config.tx_config.carrier_en = false;
+    config.tx_config.loop_en = false;
+    config.tx_config.idle_output_en = true;
+    config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+    
+    // Interruption en IRAM : le remplissage continue pendant les écritures flash
+    // interne (NVS, OTA), sinon la trame s'interrompt et la bande affiche des parasites
+    if (rmt_config(&config) != ESP_OK ||
+        rmt_driver_install(LED_RMT_CHANNEL, 0, ESP_INTR_FLAG_IRAM) != ESP_OK) {
+      Serial.println("[LED] ERREUR: Init RMT echouee!");
+      return false;
+    }
+    if (rmt_translator_init(LED_RMT_CHANNEL, ws2812Translate) != ESP_OK) {
+      Serial.println("[LED] ERREUR: Init translator RMT echouee!");
+      rmt_driver_uninstall(LED_RMT_CHANNEL);
+      return false;
+    }
+    
+    uint32_t clockHz = 0;
+    if (rmt_get_counter_clock(LED_RMT_CHANNEL, &clockHz) != ESP_OK || clockHz == 0) {
+      clockHz = 80000000UL / LED_RMT_CLK_DIV;
+    }
+    rmtBit0 = makeSymbol(WS2812_T0H_NS, WS2812_T0L_NS, clockHz);
+    rmtBit1 = makeSymbol(WS2812_T1H_NS, WS2812_T1L_NS, clockHz);
+    rmtInstalled = true;
+  }
+  
+  // Éteindre la bande (émission bloquante, une seule fois au démarrage)
+  txCount = count;
+  memset(txBuffer, 0, sizeof(txBuffer));
+  rmt_write_sample(LED_RMT_CHANNEL, txBuffer, txCount * 3, true);
+  return true;
+}
+
+static void rmtEnd() {
+  if (rmtInstalled) {
+    rmt_wait_tx_done(LED_RMT_CHANNEL, portMAX_DELAY);
+    rmt_driver_uninstall(LED_RMT_CHANNEL);
+    rmtInstalled = false;
+  }
+}
+
+static bool rmtIsBusy() {
+  // Timeout nul : ESP_OK seulement si aucune émission n'est en cours
+  return rmtInstalled && rmt_wait_tx_done(LED_RMT_CHANNEL, 0) != ESP_OK;
+}
+
+static bool rmtTransmit(const uint8_t* rgb, uint16_t count) {
+  if (!rmtInstalled || count > NUM_LEDS || rmtIsBusy()) {
+    return false;
+  }
+  
+  // Copier la trame en ordre GRB (WS2812B) : le buffer source peut changer
+  // pendant que l'interruption RMT émet
+  for (uint16_t i = 0; i < count; i++) {
+    txBuffer[i * 3] = rgb[i * 3 + 1];
+    txBuffer[i * 3 + 1] = rgb[i * 3];
+    txBuffer[i * 3 + 2] = rgb[i * 3 + 2];
+  }
+  txCount = count;
+  return rmt_write_sample(LED_RMT_CHANNEL, txBuffer, txCount * 3, false) == ESP_OK;
+}
+
+const LEDOutputDriver LED_OUTPUT_RMT_DRIVER = {
+  "RMT",
+  16,  // ~60 FPS : émission asynchrone, interruptions actives
+  rmtBegin,
+  rmtEnd,
+  rmtTransmit,
+  rmtIsBusy
+};
+
+#endif // LED_OUTPUT_USE_RMT
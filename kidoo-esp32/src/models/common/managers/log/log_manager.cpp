@@ -1,5 +1,6 @@
 #include "log_manager.h"
 #include "../sd/sd_manager.h"
+#include "../../config/core_config.h"
 #include <SD.h>
 #include <cstdarg>
 #include <ctime>
@@ -10,6 +11,26 @@ LogLevel LogManager::currentLogLevel = LOG_LEVEL_INFO;
 bool LogManager::sdLoggingEnabled = true;
 const char* LogManager::ERROR_LOG_FILE = "/error_log.txt";
 const size_t LogManager::MAX_LOG_LINE_SIZE = 512;
+TaskHandle_t LogManager::writerTaskHandle = nullptr;
+SemaphoreHandle_t LogManager::drainMutex = nullptr;
+uint32_t LogManager::records = 0;
+uint32_t LogManager::overflows = 0;
+uint32_t LogManager::discardedBytes = 0;
+uint32_t LogManager::blockWrites = 0;
+uint32_t LogManager::bytesWritten = 0;
+uint32_t LogManager::rotations = 0;
+size_t LogManager::ringHighWater = 0;
+
+// Tampon circulaire des lignes en attente : plusieurs producteurs (section
+// critique de la durée d'un memcpy), un seul consommateur (drainMutex)
+static uint8_t logRing[LogManager::RING_SIZE];
+static size_t ringHead = 0;   // Prochaine écriture
+static size_t ringTail = 0;   // Prochaine lecture
+static size_t ringUsed = 0;
+static portMUX_TYPE logMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Bloc écrit sur la SD (tâche d'écriture ou flush, sous drainMutex)
+static uint8_t logBlock[1024];
 
 void LogManager::init() {
   if (initialized) {
@@ -20,11 +41,21 @@ void LogManager::init() {
   currentLogLevel = LOG_LEVEL_INFO;
   sdLoggingEnabled = true;
   
-  // Vérifier si la SD est disponible pour le logging
-  if (!SDManager::isAvailable()) {
-    sdLoggingEnabled = false;
+  // La SD est initialisée après le LogManager : sa disponibilité est vérifiée
+  // à chaque écriture par la tâche (lignes écartées sans SD)
+  drainMutex = xSemaphoreCreateMutex();
+  BaseType_t result = xTaskCreatePinnedToCore(
+      writerTask,
+      "LogWriter",
+      STACK_SIZE_LOG_WRITER,
+      nullptr,
+      PRIORITY_LOG_WRITER,
+      &writerTaskHandle,
+      CORE_LOG_WRITER);
+  if (result != pdPASS) {
+    writerTaskHandle = nullptr;
     if (Serial) {
-      Serial.println("[LOG] SD non disponible, logging sur SD desactive");
+      Serial.println("[LOG] ERREUR: Impossible de creer la tache d'ecriture, logs SD ecrits au flush()");
     }
   }
 }
@@ -115,30 +146,191 @@ void LogManager::log(LogLevel level, const char* prefix, const char* format, va_
 }
 
 void LogManager::writeErrorToSD(const char* message) {
-  if (!SDManager::isAvailable()) {
+  // Ligne complète formatée ici (aucune E/S), écrite plus tard par la tâche
+  char line[MAX_LOG_LINE_SIZE + 48];
+  char timestamp[32];
+  formatTimestamp(timestamp, sizeof(timestamp));
+  int length = snprintf(line, sizeof(line), "%s [ERROR] %s\r\n", timestamp, message);
+  if (length <= 0) {
     return;
   }
+  if ((size_t)length >= sizeof(line)) {
+    length = sizeof(line) - 1;
+    line[length - 2] = '\r';
+    line[length - 1] = '\n';
+  }
   
-  // Ouvrir le fichier en mode append
-  File logFile = SD.open(ERROR_LOG_FILE, FILE_APPEND);
-  if (!logFile) {
-    // Si le fichier n'existe pas, le créer
-    logFile = SD.open(ERROR_LOG_FILE, FILE_WRITE);
-    if (!logFile) {
-      return; // Impossible d'écrire
+  bool wake = false;
+  portENTER_CRITICAL(&logMux);
+  if ((size_t)length > RING_SIZE - ringUsed) {
+    overflows++;  // Tampon plein : ligne perdue (jamais d'attente)
+  } else {
+    size_t first = RING_SIZE - ringHead;
+    if (first > (size_t)length) {
+      first = length;
     }
+    memcpy(logRing + ringHead, line, first);
+    memcpy(logRing, line + first, length - first);
+    ringHead = (ringHead + length) % RING_SIZE;
+    size_t before = ringUsed;
+    ringUsed += length;
+    if (ringUsed > ringHighWater) {
+      ringHighWater = ringUsed;
+    }
+    records++;
+    // Réveiller la tâche à la première ligne, puis quand le tampon se remplit
+    wake = (before == 0) || (before < FLUSH_THRESHOLD && ringUsed >= FLUSH_THRESHOLD);
   }
+  portEXIT_CRITICAL(&logMux);
   
-  // Formater le timestamp
-  char timestamp[32];
-  formatTimestamp(timestamp, sizeof(timestamp));
+  if (wake && writerTaskHandle != nullptr) {
+    xTaskNotifyGive(writerTaskHandle);
+  }
+}
+
+void LogManager::writerTask(void* parameter) {
+  (void)parameter;
+  while (true) {
+    portENTER_CRITICAL(&logMux);
+    size_t used = ringUsed;
+    portEXIT_CRITICAL(&logMux);
+    
+    if (used == 0) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);  // Première ligne
+      used = FLUSH_THRESHOLD - 1;
+    }
+    // Laisser les lignes s'accumuler pour écrire un gros bloc (réveil anticipé si le tampon se remplit)
+    if (used < FLUSH_THRESHOLD) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FLUSH_INTERVAL_MS));
+    }
+    flush();
+  }
+}
+
+void LogManager::flush() {
+  if (drainMutex == nullptr) {
+    return;
+  }
+  xSemaphoreTake(drainMutex, portMAX_DELAY);
+  drainLocked();
+  xSemaphoreGive(drainMutex);
+}
+
+void LogManager::drainLocked() {
+  portENTER_CRITICAL(&logMux);
+  size_t used = ringUsed;
+  portEXIT_CRITICAL(&logMux);
+  if (used == 0) {
+    return;
+  }
   
-  // Écrire la ligne de log
-  logFile.print(timestamp);
-  logFile.print(" [ERROR] ");
-  logFile.println(message);
+  // Pas de SD : écarter les lignes plutôt que de remplir le tampon
+  if (!sdLoggingEnabled || !SDManager::isAvailable()) {
+    portENTER_CRITICAL(&logMux);
+    ringTail = (ringTail + used) % RING_SIZE;
+    ringUsed -= used;
+    discardedBytes += used;
+    portEXIT_CRITICAL(&logMux);
+    return;
+  }
   
-  logFile.close();
+  File logFile;
+  uint32_t fileSize = 0;
+  while (true) {
+    portENTER_CRITICAL(&logMux);
+    used = ringUsed;
+    portEXIT_CRITICAL(&logMux);
+    if (used == 0) {
+      break;
+    }
+    
+    // Un seul consommateur : les octets [ringTail, ringTail + used) ne bougent
+    // pas pendant la copie (les producteurs n'écrivent qu'après ringHead)
+    size_t count = (used < sizeof(logBlock)) ? used : sizeof(logBlock);
+    size_t first = RING_SIZE - ringTail;
+    if (first > count) {
+      first = count;
+    }
+    memcpy(logBlock, logRing + ringTail, first);
+    memcpy(logBlock + first, logRing, count - first);
+    
+    // Bloc plein : s'arrêter à la dernière ligne complète (rotation entre deux lignes)
+    if (count < used) {
+      size_t end = count;
+      while (end > 0 && logBlock[end - 1] != '\n') {
+        end--;
+      }
+      if (end > 0) {
+        count = end;
+      }
+    }
+    
+    if (!logFile) {
+      logFile = SD.open(ERROR_LOG_FILE, FILE_APPEND);
+      if (!logFile) {
+        logFile = SD.open(ERROR_LOG_FILE, FILE_WRITE);
+        if (!logFile) {
+          return;  // Nouvel essai au prochain passage, les lignes restent en attente
+        }
+      }
+      fileSize = logFile.size();
+    }
+    if (fileSize > 0 && fileSize + count > FILE_MAX) {
+      logFile.close();
+      rotate();
+      logFile = SD.open(ERROR_LOG_FILE, FILE_WRITE);
+      if (!logFile) {
+        return;
+      }
+      fileSize = 0;
+    }
+    
+    size_t written = logFile.write(logBlock, count);
+    fileSize += written;
+    blockWrites++;
+    bytesWritten += written;
+    
+    // Seuls les octets écrits quittent le tampon : après une écriture partielle,
+    // le reste du bloc est repris au prochain passage
+    portENTER_CRITICAL(&logMux);
+    ringTail = (ringTail + written) % RING_SIZE;
+    ringUsed -= written;
+    portEXIT_CRITICAL(&logMux);
+    
+    if (written != count) {
+      break;  // SD pleine ou retirée : la suite au prochain passage
+    }
+  }
+  if (logFile) {
+    logFile.close();
+  }
+}
+
+void LogManager::generationPath(int generation, char* buffer, size_t bufferSize) {
+  if (generation == 0) {
+    snprintf(buffer, bufferSize, "%s", ERROR_LOG_FILE);
+  } else {
+    snprintf(buffer, bufferSize, "/error_log.%d.txt", generation);
+  }
+}
+
+void LogManager::rotate() {
+  char from[32];
+  char to[32];
+  
+  // La plus ancienne génération est supprimée, les autres décalées d'un cran
+  generationPath(GENERATIONS - 1, to, sizeof(to));
+  if (SD.exists(to)) {
+    SD.remove(to);
+  }
+  for (int generation = GENERATIONS - 2; generation >= 0; generation--) {
+    generationPath(generation, from, sizeof(from));
+    generationPath(generation + 1, to, sizeof(to));
+    if (SD.exists(from)) {
+      SD.rename(from, to);
+    }
+  }
+  rotations++;
 }
 
 void LogManager::formatTimestamp(char* buffer, size_t bufferSize) {
@@ -156,12 +348,23 @@ bool LogManager::clearErrorLog() {
     return false;
   }
   
-  // Supprimer le fichier s'il existe
-  if (SD.exists(ERROR_LOG_FILE)) {
-    return SD.remove(ERROR_LOG_FILE);
+  if (drainMutex != nullptr) {
+    xSemaphoreTake(drainMutex, portMAX_DELAY);
+  }
+  // Supprimer le fichier courant et les anciennes générations
+  bool success = true;
+  char path[32];
+  for (int generation = 0; generation < GENERATIONS; generation++) {
+    generationPath(generation, path, sizeof(path));
+    if (SD.exists(path) && !SD.remove(path)) {
+      success = false;
+    }
+  }
+  if (drainMutex != nullptr) {
+    xSemaphoreGive(drainMutex);
   }
   
-  return true; // Fichier n'existait pas, considéré comme réussi
+  return success;
 }
 
 size_t LogManager::getErrorLogSize() {
@@ -183,3 +386,21 @@ size_t LogManager::getErrorLogSize() {
   
   return size;
 }
+
+void LogManager::printStats() {
+  portENTER_CRITICAL(&logMux);
+  size_t used = ringUsed;
+  portEXIT_CRITICAL(&logMux);
+  
+  Serial.println("");
+  Serial.println("========== Logs d'erreur (SD) ==========");
+  Serial.printf("[LOG] Tampon: %u/%u octets en attente (max %u)\n",
+                (unsigned)used, (unsigned)RING_SIZE, (unsigned)ringHighWater);
+  Serial.printf("[LOG] Lignes: %lu, perdues (tampon plein): %lu\n",
+                (unsigned long)records, (unsigned long)overflows);
+  Serial.printf("[LOG] Ecritures SD: %lu blocs, %lu octets, %lu octets ecartes (SD absente)\n",
+                (unsigned long)blockWrites, (unsigned long)bytesWritten, (unsigned long)discardedBytes);
+  Serial.printf("[LOG] Rotations: %lu (%s, %d generations de %lu octets max)\n",
+                (unsigned long)rotations, ERROR_LOG_FILE, GENERATIONS, (unsigned long)FILE_MAX);
+  Serial.println("========================================");
+}
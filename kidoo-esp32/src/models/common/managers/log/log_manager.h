@@ -2,6 +2,9 @@
 #define LOG_MANAGER_H
 
 #include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 
 /**
  * Gestionnaire de logs avec écriture sur Serial et SD
@@ -10,6 +13,15 @@
  * - INFO : Affiché sur Serial uniquement
  * - DEBUG : Affiché sur Serial uniquement (si activé)
  * - ERROR : Affiché sur Serial ET écrit dans un fichier sur la SD
+ * 
+ * Écriture SD asynchrone : error() copie la ligne dans un tampon circulaire
+ * en RAM et retourne sans jamais attendre la SD (il peut être appelé depuis
+ * les tâches LED ou PubNub). Une tâche de basse priorité vide le tampon par
+ * gros blocs. Tampon plein : la ligne est perdue et comptée (overflow).
+ * 
+ * Rotation : au-delà de FILE_MAX octets, error_log.txt devient
+ * error_log.1.txt (les générations plus anciennes sont décalées, la plus
+ * ancienne supprimée) ; GENERATIONS fichiers au plus.
  */
 
 // Niveaux de log
@@ -68,7 +80,12 @@ public:
   static void error(const char* format, ...);
   
   /**
-   * Vider le fichier de logs d'erreur sur la SD
+   * Écrire tout de suite les logs en attente (bloquant, ex. avant un redémarrage)
+   */
+  static void flush();
+  
+  /**
+   * Vider le fichier de logs d'erreur sur la SD (et ses anciennes générations)
    * @return true si réussi, false sinon
    */
   static bool clearErrorLog();
@@ -78,6 +95,15 @@ public:
    * @return Taille en octets, 0 si erreur
    */
   static size_t getErrorLogSize();
+  
+  // Afficher les compteurs (lignes, octets écrits, pertes, rotations)
+  static void printStats();
+  
+  static const size_t RING_SIZE = 4096;            // Tampon RAM des lignes en attente
+  static const size_t FLUSH_THRESHOLD = RING_SIZE / 2;  // Écriture anticipée au-delà
+  static const uint32_t FLUSH_INTERVAL_MS = 2000;  // Regroupement des lignes avant écriture
+  static const uint32_t FILE_MAX = 32768;          // Rotation au-delà (octets)
+  static const int GENERATIONS = 3;                // error_log.txt + 2 anciens fichiers
 
 private:
   /**
@@ -90,11 +116,23 @@ private:
   static void log(LogLevel level, const char* prefix, const char* format, va_list args);
   
   /**
-   * Écrire un message d'erreur dans le fichier sur la SD
+   * Mettre une ligne de log d'erreur en attente d'écriture sur la SD (sans attente)
    * @param message Message à écrire
    */
   static void writeErrorToSD(const char* message);
   
+  // Tâche d'écriture : vide le tampon par blocs
+  static void writerTask(void* parameter);
+  
+  // Vider le tampon dans le fichier (drainMutex pris par l'appelant)
+  static void drainLocked();
+  
+  // Décaler les générations (error_log.txt -> error_log.1.txt...)
+  static void rotate();
+  
+  // Nom du fichier d'une génération (0 = fichier courant)
+  static void generationPath(int generation, char* buffer, size_t bufferSize);
+  
   /**
    * Formater un timestamp pour les logs
    * @param buffer Buffer pour stocker le timestamp
@@ -107,6 +145,17 @@ private:
   static bool sdLoggingEnabled;
   static const char* ERROR_LOG_FILE;
   static const size_t MAX_LOG_LINE_SIZE;
+  
+  static TaskHandle_t writerTaskHandle;
+  static SemaphoreHandle_t drainMutex;     // Tâche d'écriture, flush(), clearErrorLog()
+  
+  static uint32_t records;                 // Lignes mises en attente
+  static uint32_t overflows;               // Lignes perdues (tampon plein)
+  static uint32_t discardedBytes;          // Octets non écrits (SD absente ou désactivée)
+  static uint32_t blockWrites;             // Écritures SD
+  static uint32_t bytesWritten;
+  static uint32_t rotations;
+  static size_t ringHighWater;             // Remplissage maximal du tampon
 };
 
 #endif // LOG_MANAGER_H
@@ -1,5 +1,6 @@
 #include "potentiometer_manager.h"
 #include "../../../model_config.h"
+#include "../led/led_latency.h"
 
 // ============================================
 // Classe Potentiometer (instance)
@@ -100,7 +101,9 @@ bool Potentiometer::update() {
     _lastValue = currentValue;
     
     // Appeler le callback si défini
+    // (les commandes LED qu'il envoie sont datées de cette lecture)
     if (_callback != nullptr) {
+      LEDLatencyScope latencyScope(LED_SOURCE_POTENTIOMETER);
       _callback(currentValue, oldValue);
     }
     
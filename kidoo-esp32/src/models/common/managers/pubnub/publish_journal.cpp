@@ -0,0 +1,287 @@
+#include "publish_journal.h"
+#include "publish_ring.h"
+#include "pubnub_manager.h"
+#include "../sd/sd_manager.h"
+#include <SD.h>
+
+bool PublishJournal::useSD = false;
+uint32_t PublishJournal::fileSize = 0;
+uint32_t PublishJournal::fileReadOffset = 0;
+uint32_t PublishJournal::batchEnd = 0;
+int PublishJournal::batchCount = 0;
+uint32_t PublishJournal::batchDroppedMark = 0;
+bool PublishJournal::needsNewline = false;
+SemaphoreHandle_t PublishJournal::fileMutex = nullptr;
+uint32_t PublishJournal::appended = 0;
+uint32_t PublishJournal::committed = 0;
+uint32_t PublishJournal::dropped = 0;
+uint32_t PublishJournal::corrupted = 0;
+const char* PublishJournal::FILE_PATH = "/pubnub_journal.log";
+
+// Tampon RAM : rempli par append() (n'importe quelle tâche), vidé par service()
+static uint8_t journalStorage[PublishJournal::RAM_SIZE];
+static PublishRing journalRing(journalStorage, sizeof(journalStorage));
+static portMUX_TYPE journalMux = portMUX_INITIALIZER_UNLOCKED;
+static bool journalMoving = false;  // Événement retiré du tampon RAM, pas encore écrit sur la SD
+
+// Une ligne du journal (un caractère de plus que le plus gros message : ligne trop longue détectée)
+static char journalLine[PubNubManager::PUBLISH_MESSAGE_MAX + 2];
+
+void PublishJournal::init() {
+  if (fileMutex == nullptr) {
+    fileMutex = xSemaphoreCreateMutex();
+  }
+  useSD = SDManager::isAvailable() && fileMutex != nullptr;
+  if (!useSD || !SD.exists(FILE_PATH)) {
+    return;
+  }
+
+  File file = SD.open(FILE_PATH, FILE_READ);
+  if (!file) {
+    return;
+  }
+  fileSize = file.size();
+  fileReadOffset = 0;
+  // Coupure pendant une écriture : la prochaine ligne ne doit pas prolonger la ligne tronquée
+  if (fileSize > 0 && file.seek(fileSize - 1) && file.read() != '\n') {
+    needsNewline = true;
+  }
+  file.close();
+
+  if (fileSize > 0) {
+    Serial.printf("[PUBNUB] Journal hors ligne repris (%lu octets a publier)\n", (unsigned long)fileSize);
+  }
+}
+
+bool PublishJournal::append(const char* message) {
+  size_t length = strlen(message);
+  // Une ligne par événement : objet JSON sans retour à la ligne
+  if (length == 0 || length > PubNubManager::PUBLISH_MESSAGE_MAX ||
+      message[0] != '{' || strchr(message, '\n') != nullptr) {
+    return false;
+  }
+
+  uint32_t discarded = 0;
+  portENTER_CRITICAL(&journalMux);
+  // Tampon plein : écarter les plus anciens (sans SD, ou SD en retard)
+  while (!journalRing.push(message, length) && journalRing.discard()) {
+    discarded++;
+  }
+  appended++;
+  dropped += discarded;
+  portEXIT_CRITICAL(&journalMux);
+
+  if (discarded > 0) {
+    Serial.printf("[PUBNUB] Journal plein, %lu evenement(s) ancien(s) perdu(s)\n", (unsigned long)discarded);
+  }
+  return true;
+}
+
+void PublishJournal::service() {
+  if (!useSD) {
+    return;
+  }
+  portENTER_CRITICAL(&journalMux);
+  bool pending = journalRing.count() > 0;
+  portEXIT_CRITICAL(&journalMux);
+  if (!pending) {
+    return;
+  }
+
+  // Fichier déjà utilisé par l'autre appelant : les événements attendent en RAM
+  if (xSemaphoreTake(fileMutex, 0) != pdTRUE) {
+    return;
+  }
+  serviceLocked();
+  xSemaphoreGive(fileMutex);
+}
+
+void PublishJournal::serviceLocked() {
+
+  // Une seule ouverture pour tous les événements en attente
+  File file = SD.open(FILE_PATH, FILE_APPEND);
+  if (!file) {
+    file = SD.open(FILE_PATH, FILE_WRITE);
+    if (!file) {
+      return;  // Nouvel essai au prochain passage, les événements restent en RAM
+    }
+  }
+
+  while (true) {
+    portENTER_CRITICAL(&journalMux);
+    size_t length = journalRing.pop(journalLine, sizeof(journalLine));
+    journalMoving = (length > 0);
+    portEXIT_CRITICAL(&journalMux);
+    if (length == 0) {
+      break;
+    }
+
+    if (fileSize + length + 2 > FILE_MAX) {
+      dropped++;
+    } else {
+      if (needsNewline) {
+        fileSize += file.write((const uint8_t*)"\n", 1);
+        needsNewline = false;
+      }
+      journalLine[length] = '\n';
+      size_t written = file.write((const uint8_t*)journalLine, length + 1);
+      fileSize += written;
+      if (written != length + 1) {
+        needsNewline = true;
+        dropped++;
+      }
+    }
+
+    portENTER_CRITICAL(&journalMux);
+    journalMoving = false;
+    portEXIT_CRITICAL(&journalMux);
+  }
+  file.close();
+}
+
+bool PublishJournal::isEmpty() {
+  portENTER_CRITICAL(&journalMux);
+  bool empty = journalRing.count() == 0 && !journalMoving && fileReadOffset >= fileSize;
+  portEXIT_CRITICAL(&journalMux);
+  return empty;
+}
+
+int PublishJournal::readBatch(char* out, size_t outSize, size_t& length) {
+  length = 0;
+  int count = 0;
+  out[0] = '\0';
+
+  if (!useSD) {
+    // Journal en RAM : parcourir le tampon sans retirer les événements
+    size_t cursor = 0;
+    portENTER_CRITICAL(&journalMux);
+    while (true) {
+      size_t next = cursor;
+      size_t lineLength = journalRing.peekAt(next, nullptr, 0);
+      size_t separator = (count > 0) ? 1 : 0;
+      if (lineLength == 0 || length + separator + lineLength + 1 > outSize) {
+        break;
+      }
+      if (separator) {
+        out[length++] = ',';
+      }
+      journalRing.peekAt(cursor, out + length, outSize - length);
+      length += lineLength;
+      count++;
+    }
+    batchDroppedMark = dropped;
+    portEXIT_CRITICAL(&journalMux);
+    batchCount = count;
+    return count;
+  }
+
+  xSemaphoreTake(fileMutex, portMAX_DELAY);
+  count = readFileBatch(out, outSize, length);
+  xSemaphoreGive(fileMutex);
+
+  // Uniquement des lignes illisibles : les passer tout de suite
+  if (count == 0 && batchEnd > fileReadOffset) {
+    commitBatch();
+  }
+  return count;
+}
+
+int PublishJournal::readFileBatch(char* out, size_t outSize, size_t& length) {
+  int count = 0;
+  batchEnd = fileReadOffset;
+  batchCount = 0;
+  if (fileReadOffset >= fileSize) {
+    return 0;
+  }
+  File file = SD.open(FILE_PATH, FILE_READ);
+  if (!file || !file.seek(fileReadOffset)) {
+    return 0;
+  }
+
+  while (batchEnd < fileSize) {
+    size_t lineLength = file.readBytesUntil('\n', journalLine, sizeof(journalLine) - 1);
+    uint32_t lineEnd = file.position();
+
+    // Ligne illisible (tronquée ou trop longue) : ignorée
+    bool tooLong = lineLength > PubNubManager::PUBLISH_MESSAGE_MAX;
+    if (tooLong) {
+      while (file.available() > 0 && file.read() != '\n') {
+      }
+      lineEnd = file.position();
+    }
+    if (tooLong || lineLength < 2 || journalLine[0] != '{' || journalLine[lineLength - 1] != '}') {
+      if (lineLength > 0) {
+        corrupted++;
+      }
+      batchEnd = lineEnd;
+      continue;
+    }
+
+    size_t separator = (count > 0) ? 1 : 0;
+    if (length + separator + lineLength + 1 > outSize) {
+      break;
+    }
+    if (separator) {
+      out[length++] = ',';
+    }
+    memcpy(out + length, journalLine, lineLength);
+    length += lineLength;
+    out[length] = '\0';
+    count++;
+    batchEnd = lineEnd;
+  }
+  file.close();
+  batchCount = count;
+  return count;
+}
+
+void PublishJournal::commitBatch() {
+  if (!useSD) {
+    portENTER_CRITICAL(&journalMux);
+    // Les événements du lot déjà écartés par append() (tampon plein) ne sont plus là
+    uint32_t alreadyDropped = dropped - batchDroppedMark;
+    for (uint32_t i = alreadyDropped; i < (uint32_t)batchCount && journalRing.discard(); i++) {
+    }
+    portEXIT_CRITICAL(&journalMux);
+    committed += batchCount;
+    batchCount = 0;
+    return;
+  }
+
+  if (batchEnd <= fileReadOffset) {
+    return;
+  }
+  xSemaphoreTake(fileMutex, portMAX_DELAY);
+  committed += batchCount;
+  batchCount = 0;
+  fileReadOffset = batchEnd;
+  // Tout est publié : repartir d'un fichier vide
+  if (fileReadOffset >= fileSize) {
+    SD.remove(FILE_PATH);
+    portENTER_CRITICAL(&journalMux);
+    fileSize = 0;
+    fileReadOffset = 0;
+    portEXIT_CRITICAL(&journalMux);
+    batchEnd = 0;
+    needsNewline = false;
+  }
+  xSemaphoreGive(fileMutex);
+}
+
+void PublishJournal::printInfo() {
+  portENTER_CRITICAL(&journalMux);
+  size_t ramCount = journalRing.count();
+  size_t ramBytes = journalRing.used();
+  portEXIT_CRITICAL(&journalMux);
+
+  Serial.printf("[PUBNUB] Journal hors ligne: %s, %u en RAM (%u/%u octets)",
+                useSD ? "SD" : "RAM seule", (unsigned)ramCount, (unsigned)ramBytes, (unsigned)RAM_SIZE);
+  if (useSD) {
+    Serial.printf(", %lu/%lu octets a publier sur la SD",
+                  (unsigned long)(fileSize - fileReadOffset), (unsigned long)FILE_MAX);
+  }
+  Serial.println("");
+  Serial.printf("[PUBNUB] Journal: %lu ajoutes, %lu publies, %lu perdus (plein), %lu lignes illisibles\n",
+                (unsigned long)appended, (unsigned long)committed, (unsigned long)dropped,
+                (unsigned long)corrupted);
+}
@@ -0,0 +1,88 @@
+#ifndef PUBLISH_JOURNAL_H
+#define PUBLISH_JOURNAL_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/**
+ * Journal des événements à publier hors ligne
+ *
+ * Les événements qui ne doivent pas être perdus (début/fin de routine...) sont
+ * tous écrits ici et n'en sortent qu'une fois acceptés par le serveur (HTTP 200),
+ * envoyés par lots par le thread PubNub (voir PubNubManager::publishEvent).
+ *
+ * - append() copie l'événement dans un tampon RAM : aucune écriture SD, il
+ *   peut être appelé depuis le loop sans le bloquer
+ * - service() vide ce tampon à la fin du fichier journal sur la SD, une ligne
+ *   JSON par événement : le journal survit à un redémarrage. Appelé par le
+ *   thread PubNub, et par PubNubManager::loop() tant que le thread ne tourne
+ *   pas (appareil démarré hors ligne)
+ * - Sans carte SD, le tampon RAM est le journal (le plus ancien événement est
+ *   écarté quand il est plein)
+ *
+ * readBatch() et commitBatch() ne sont appelés que depuis le thread PubNub.
+ * Le fichier n'est touché que sous fileMutex.
+ */
+
+class PublishJournal {
+public:
+  /**
+   * Reprendre le journal laissé sur la SD (événements d'avant un redémarrage)
+   * À appeler après l'init de la SD
+   */
+  static void init();
+
+  /**
+   * Ajouter un événement (objet JSON sur une ligne, thread-safe)
+   * @return false si l'événement est invalide ou trop long
+   */
+  static bool append(const char* message);
+
+  // Écrire sur la SD les événements en attente dans le tampon RAM
+  // (ne fait rien si une autre tâche utilise déjà le fichier)
+  static void service();
+
+  // Aucun événement en attente (RAM et SD)
+  static bool isEmpty();
+
+  /**
+   * Lire les plus anciens événements, séparés par des virgules, sans les retirer
+   * @param out Destination (terminée par '\0')
+   * @param outSize Taille de out
+   * @param length Longueur écrite dans out
+   * @return Nombre d'événements lus (0 si le journal est vide)
+   */
+  static int readBatch(char* out, size_t outSize, size_t& length);
+
+  // Retirer les événements du dernier readBatch (publiés avec succès)
+  static void commitBatch();
+
+  static void printInfo();
+
+private:
+  static bool useSD;
+  static uint32_t fileSize;        // Octets du fichier journal
+  static uint32_t fileReadOffset;  // Début du premier événement non publié
+  static uint32_t batchEnd;        // Fin du dernier readBatch (SD)
+  static int batchCount;           // Événements du dernier readBatch
+  static uint32_t batchDroppedMark;  // Compteur dropped au dernier readBatch (RAM)
+  static bool needsNewline;        // Dernière ligne incomplète (coupure pendant une écriture)
+  static SemaphoreHandle_t fileMutex;  // Accès au fichier journal (service / lots)
+
+  static uint32_t appended;
+  static uint32_t committed;
+  static uint32_t dropped;         // Journal plein
+  static uint32_t corrupted;       // Lignes illisibles ignorées
+
+  static const char* FILE_PATH;
+
+  static void serviceLocked();
+  static int readFileBatch(char* out, size_t outSize, size_t& length);
+
+public:
+  static const size_t RAM_SIZE = 2048;          // Tampon RAM (octets, en-têtes compris)
+  static const uint32_t FILE_MAX = 65536;       // Taille maximale du fichier journal
+};
+
+#endif // PUBLISH_JOURNAL_H
@@ -0,0 +1,108 @@
+#include "publish_ring.h"
+#include <string.h>
+
+PublishRing::PublishRing(uint8_t* storage, size_t capacity)
+  : storage(storage), size(capacity), head(0), usedBytes(0), messages(0) {
+}
+
+bool PublishRing::push(const char* message, size_t length) {
+  if (length == 0 || length > maxMessageLength() || HEADER_SIZE + length > size - usedBytes) {
+    return false;
+  }
+  uint8_t header[HEADER_SIZE] = { (uint8_t)(length & 0xFF), (uint8_t)(length >> 8) };
+  write(header, HEADER_SIZE);
+  write((const uint8_t*)message, length);
+  messages++;
+  return true;
+}
+
+size_t PublishRing::pop(char* out, size_t outSize) {
+  size_t length = peekLength();
+  if (length == 0 || length + 1 > outSize) {
+    return 0;
+  }
+  read((uint8_t*)out, length, (head + HEADER_SIZE) % size);
+  out[length] = '\0';
+
+  head = (head + HEADER_SIZE + length) % size;
+  usedBytes -= HEADER_SIZE + length;
+  messages--;
+  if (messages == 0) {
+    head = 0;  // Tampon vide : le prochain message repart du début (pas de coupure)
+  }
+  return length;
+}
+
+size_t PublishRing::peekLength() const {
+  if (messages == 0) {
+    return 0;
+  }
+  uint8_t header[HEADER_SIZE];
+  read(header, HEADER_SIZE, head);
+  return (size_t)header[0] | ((size_t)header[1] << 8);
+}
+
+size_t PublishRing::peekAt(size_t& cursor, char* out, size_t outSize) const {
+  if (cursor >= usedBytes) {
+    return 0;
+  }
+  uint8_t header[HEADER_SIZE];
+  size_t from = (head + cursor) % size;
+  read(header, HEADER_SIZE, from);
+  size_t length = (size_t)header[0] | ((size_t)header[1] << 8);
+  if (out != nullptr) {
+    if (length + 1 > outSize) {
+      return 0;
+    }
+    read((uint8_t*)out, length, (from + HEADER_SIZE) % size);
+    out[length] = '\0';
+  }
+  cursor += HEADER_SIZE + length;
+  return length;
+}
+
+bool PublishRing::discard() {
+  size_t length = peekLength();
+  if (length == 0) {
+    return false;
+  }
+  head = (head + HEADER_SIZE + length) % size;
+  usedBytes -= HEADER_SIZE + length;
+  messages--;
+  if (messages == 0) {
+    head = 0;
+  }
+  return true;
+}
+
+size_t PublishRing::maxMessageLength() const {
+  size_t max = size - HEADER_SIZE;
+  return max > 0xFFFF ? 0xFFFF : max;
+}
+
+void PublishRing::clear() {
+  head = 0;
+  usedBytes = 0;
+  messages = 0;
+}
+
+// Écrire à la suite des données (en deux morceaux si la fin du tampon est atteinte)
+void PublishRing::write(const uint8_t* data, size_t length) {
+  size_t tail = (head + usedBytes) % size;
+  size_t first = size - tail;
+  if (first > length) {
+    first = length;
+  }
+  memcpy(storage + tail, data, first);
+  memcpy(storage, data + first, length - first);
+  usedBytes += length;
+}
+
+void PublishRing::read(uint8_t* data, size_t length, size_t from) const {
+  size_t first = size - from;
+  if (first > length) {
+    first = length;
+  }
+  memcpy(data, storage + from, first);
+  memcpy(data + first, storage, length - first);
+}
@@ -0,0 +1,74 @@
+#ifndef PUBLISH_RING_H
+#define PUBLISH_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Tampon circulaire d'octets pour les messages à publier
+ *
+ * Chaque message est rangé avec sa longueur (2 octets) devant lui, à la suite
+ * du précédent : un petit message n'occupe que sa taille, un gros message
+ * (get-info) n'est pas tronqué tant qu'il tient dans le tampon.
+ * Le stockage est fourni par l'appelant (aucune allocation).
+ *
+ * Pas de verrou : l'appelant protège push/pop s'ils sont appelés depuis
+ * plusieurs tâches. Aucune dépendance Arduino : compilable sur l'hôte.
+ */
+
+class PublishRing {
+public:
+  static const size_t HEADER_SIZE = 2;
+
+  PublishRing(uint8_t* storage, size_t capacity);
+
+  /**
+   * Ajouter un message (copié dans le tampon)
+   * @return false si la place libre ne suffit pas (tampon inchangé)
+   */
+  bool push(const char* message, size_t length);
+
+  /**
+   * Retirer le plus ancien message
+   * @param out Destination (le message y est terminé par '\0')
+   * @param outSize Taille de out, au moins la longueur du message + 1
+   * @return Longueur du message, 0 si le tampon est vide
+   */
+  size_t pop(char* out, size_t outSize);
+
+  // Longueur du plus ancien message (0 si vide)
+  size_t peekLength() const;
+  
+  /**
+   * Lire un message sans le retirer, en parcourant le tampon du plus ancien au plus récent
+   * @param cursor Position de lecture (0 = plus ancien message), avancée au message suivant
+   * @param out Destination (terminée par '\0'), nullptr pour seulement connaître la longueur
+   * @return Longueur du message, 0 à la fin du tampon ou si out est trop petit (curseur inchangé)
+   */
+  size_t peekAt(size_t& cursor, char* out, size_t outSize) const;
+  
+  // Retirer le plus ancien message sans le copier
+  // @return false si le tampon est vide
+  bool discard();
+
+  size_t count() const { return messages; }
+  size_t used() const { return usedBytes; }
+  size_t capacity() const { return size; }
+
+  // Plus gros message acceptable (tampon vide)
+  size_t maxMessageLength() const;
+
+  void clear();
+
+private:
+  void write(const uint8_t* data, size_t length);
+  void read(uint8_t* data, size_t length, size_t from) const;
+
+  uint8_t* storage;
+  size_t size;
+  size_t head;        // Prochain octet lu
+  size_t usedBytes;   // En-têtes compris
+  size_t messages;
+};
+
+#endif // PUBLISH_RING_H
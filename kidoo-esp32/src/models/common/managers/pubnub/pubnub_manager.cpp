@@ -8,10 +8,19 @@
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <esp_mac.h>  // Pour esp_read_mac() et ESP_MAC_WIFI_STA
+#include <sys/time.h>  // Pour gettimeofday() (latence de livraison)
+#include <sys/socket.h>
+#include <sys/select.h>  // Attente du socket subscribe
+#include <netinet/in.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "../wifi/wifi_manager.h"
 #include "../serial/serial_commands.h"
 #include "../init/init_manager.h"
 #include "../../../model_pubnub_routes.h"
+#include "publish_ring.h"
+#include "publish_journal.h"
+#include "../led/led_latency.h"
 
 // Variables statiques
 bool PubNubManager::initialized = false;
@@ -20,16 +29,330 @@ bool PubNubManager::threadRunning = false;
 char PubNubManager::channel[64] = "";
 char PubNubManager::timeToken[32] = "0";
 TaskHandle_t PubNubManager::taskHandle = nullptr;
-QueueHandle_t PubNubManager::publishQueue = nullptr;
+uint32_t PubNubManager::publishQueued = 0;
+uint32_t PubNubManager::publishQueueFull = 0;
+uint32_t PubNubManager::publishTooLarge = 0;
+uint32_t PubNubManager::publishFailed = 0;
+size_t PubNubManager::publishRingPeak = 0;
+uint32_t PubNubManager::publishBatches = 0;
+uint32_t PubNubManager::publishSent = 0;
+unsigned long PubNubManager::publishDeadline = 0;
+unsigned long PubNubManager::nextJournalFlush = 0;
+PubNubManager::ConnectionStats PubNubManager::subscribeStats = {};
+PubNubManager::ConnectionStats PubNubManager::publishStats = {};
+uint32_t PubNubManager::lastPollJsonPeak = 0;
+uint32_t PubNubManager::maxPollJsonPeak = 0;
+bool PubNubManager::subscribePending = false;
+bool PubNubManager::subscribeReused = false;
+bool PubNubManager::subscribeHandshake = false;
+unsigned long PubNubManager::subscribeSentTime = 0;
+unsigned long PubNubManager::nextSubscribeTime = 0;
+uint32_t PubNubManager::retryDelayMs = 0;
+uint32_t PubNubManager::subscribeErrors = 0;
+uint32_t PubNubManager::emptyPolls = 0;
+uint32_t PubNubManager::threadWakeups = 0;
+unsigned long PubNubManager::metricsStartTime = 0;
+uint32_t PubNubManager::latencySamples[LATENCY_SAMPLE_COUNT] = {};
+int PubNubManager::latencyCount = 0;
+int PubNubManager::latencyIndex = 0;
 
-// URLs PubNub
-static const char* PUBNUB_ORIGIN = "ps.pndsn.com";
+// Serveur PubNub (surchargeable à la compilation, ex. -DPUBNUB_ORIGIN_HOST=\"192.168.1.10:8090\"
+// pour un serveur local de test)
+#ifndef PUBNUB_ORIGIN_HOST
+#define PUBNUB_ORIGIN_HOST "ps.pndsn.com"
+#endif
+static const char* PUBNUB_ORIGIN = PUBNUB_ORIGIN_HOST;
+static char originHost[64] = "";
+static uint16_t originPort = 80;
 
-// Structure pour les messages à publier
-struct PublishMessage {
-  char message[512];  // Augmenté pour supporter get-info
+// Connexions persistantes, utilisées uniquement par le thread PubNub
+static WiFiClient subscribeClient;
+static WiFiClient publishClient;
+static HTTPClient publishHttp;
+
+// Réveil du thread pendant select() : un datagramme sur un socket UDP local
+// (même principe que le socket de contrôle d'esp_http_server). Le thread lit
+// wakeSocket, les autres tâches écrivent par wakeSender.
+static int wakeSocket = -1;
+static int wakeSender = -1;
+static struct sockaddr_in wakeAddress;
+
+static void openWakeSockets() {
+  if (wakeSocket >= 0) {
+    return;
+  }
+  int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+  int sender = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;  // Port choisi par la pile
+  socklen_t length = sizeof(address);
+  if (receiver < 0 || sender < 0 ||
+      bind(receiver, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+      getsockname(receiver, (struct sockaddr*)&address, &length) != 0) {
+    // Sans socket de réveil, publish() ne réveille le thread qu'en dehors du long poll
+    Serial.println("[PUBNUB] Socket de reveil indisponible");
+    if (receiver >= 0) {
+      close(receiver);
+    }
+    if (sender >= 0) {
+      close(sender);
+    }
+    return;
+  }
+  fcntl(receiver, F_SETFL, fcntl(receiver, F_GETFL, 0) | O_NONBLOCK);
+  fcntl(sender, F_SETFL, fcntl(sender, F_GETFL, 0) | O_NONBLOCK);
+  wakeAddress = address;
+  wakeSender = sender;
+  wakeSocket = receiver;
+}
+
+// Tampon de publication : rempli par publish() (n'importe quelle tâche),
+// vidé par le thread PubNub
+static uint8_t publishStorage[PubNubManager::PUBLISH_RING_SIZE];
+static PublishRing publishRing(publishStorage, sizeof(publishStorage));
+static portMUX_TYPE publishMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Buffers réutilisés par le thread : URL (fixe, construite à l'init) et corps
+// (messages regroupés dans l'enveloppe, guillemets autour des textes)
+static char publishUrl[256] = "";
+static const char BATCH_PREFIX[] = "{\"type\":\"batch\",\"messages\":[";
+static const char BATCH_SUFFIX[] = "]}";
+static const size_t BATCH_PREFIX_LENGTH = sizeof(BATCH_PREFIX) - 1;
+static const size_t BATCH_SUFFIX_LENGTH = sizeof(BATCH_SUFFIX) - 1;
+static char publishBody[BATCH_PREFIX_LENGTH + PubNubManager::PUBLISH_BATCH_MAX + BATCH_SUFFIX_LENGTH + 1];
+
+// Un message seul (guillemets compris) doit toujours tenir dans le corps
+static_assert(PubNubManager::PUBLISH_BATCH_MAX >= PubNubManager::PUBLISH_MESSAGE_MAX + 2,
+              "PUBLISH_BATCH_MAX trop petit pour PUBLISH_MESSAGE_MAX");
+
+/**
+ * Lecteur de réponse subscribe (lecteur personnalisé ArduinoJson)
+ * Lit le socket avec un caractère d'avance, pour découper le tableau de messages
+ * élément par élément. Une réponse "Transfer-Encoding: chunked" est décodée au
+ * fil de la lecture (octets restants du chunk courant), sans copie du corps.
+ */
+class PubNubResponseReader {
+public:
+  PubNubResponseReader(Stream* stream, bool chunked)
+      : stream(stream), chunked(chunked), chunkStarted(false), bodyEnded(false),
+        chunkRemaining(0), pending(-1) {}
+  
+  // Interface lecteur ArduinoJson
+  int read() {
+    if (pending >= 0) {
+      int c = pending;
+      pending = -1;
+      return c;
+    }
+    if (!chunked) {
+      return readRaw();
+    }
+    if (chunkRemaining == 0 && !nextChunk()) {
+      return -1;
+    }
+    int c = readRaw();
+    if (c < 0) {
+      bodyEnded = true;
+      return -1;
+    }
+    chunkRemaining--;
+    return c;
+  }
+  
+  size_t readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      int c = read();
+      if (c < 0) {
+        break;
+      }
+      buffer[count++] = (char)c;
+    }
+    return count;
+  }
+  
+  // Prochain caractère hors espaces, sans le consommer
+  int peekToken() {
+    int c;
+    do {
+      c = read();
+    } while (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+    pending = c;
+    return c;
+  }
+  
+  // Prochain caractère hors espaces
+  int nextToken() {
+    int c = peekToken();
+    pending = -1;
+    return c;
+  }
+  
+  // Consommer la fin d'un corps chunked (reste du chunk, chunk final, trailers) :
+  // la connexion reste propre pour le poll suivant
+  void finish() {
+    pending = -1;
+    while (chunked && !bodyEnded) {
+      while (chunkRemaining > 0 && readRaw() >= 0) {
+        chunkRemaining--;
+      }
+      if (chunkRemaining > 0 || !nextChunk()) {
+        bodyEnded = true;
+      }
+    }
+  }
+  
+private:
+  // readBytes() respecte le timeout du socket, contrairement à read()
+  int readRaw() {
+    char c;
+    return (stream->readBytes(&c, 1) == 1) ? (uint8_t)c : -1;
+  }
+  
+  // Ligne suivante ignorée ; false si vide ("\r\n") ou socket fermé
+  bool skipLine() {
+    int length = 0;
+    int c;
+    while ((c = readRaw()) >= 0 && c != '\n') {
+      if (c != '\r') {
+        length++;
+      }
+    }
+    return c >= 0 && length > 0;
+  }
+  
+  // En-tête du chunk suivant : "<taille hex>[;extensions]\r\n"
+  // @return false à la fin du corps (chunk de taille 0) ou sur erreur
+  bool nextChunk() {
+    if (bodyEnded) {
+      return false;
+    }
+    if (chunkStarted) {
+      skipLine();  // "\r\n" qui termine les données du chunk précédent
+    }
+    chunkStarted = true;
+    
+    long size = 0;
+    bool digits = false;
+    bool extension = false;
+    int c;
+    while ((c = readRaw()) >= 0 && c != '\n') {
+      if (extension || c == '\r') {
+        continue;
+      }
+      int value = -1;
+      if (c >= '0' && c <= '9') {
+        value = c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        value = c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        value = c - 'A' + 10;
+      } else if (c == ';') {
+        extension = true;
+      }
+      if (value >= 0 && size < 0x1000000L) {
+        size = size * 16 + value;
+        digits = true;
+      }
+    }
+    if (c < 0 || !digits || size == 0) {
+      // Chunk final : trailers éventuels jusqu'à la ligne vide
+      if (c >= 0 && digits) {
+        while (skipLine()) {
+        }
+      }
+      bodyEnded = true;
+      return false;
+    }
+    chunkRemaining = size;
+    return true;
+  }
+  
+  Stream* stream;
+  bool chunked;
+  bool chunkStarted;   // Au moins un en-tête de chunk lu
+  bool bodyEnded;      // Chunk final atteint (ou socket fermé)
+  long chunkRemaining; // Octets de données restants dans le chunk courant
+  int pending;
+};
+
+/**
+ * Allocateur ArduinoJson qui mesure la mémoire occupée par le document d'un poll
+ * (taille de chaque bloc conservée devant le bloc)
+ */
+class PollJsonAllocator : public ArduinoJson::Allocator {
+public:
+  void* allocate(size_t size) override {
+    size_t* block = (size_t*)malloc(size + sizeof(size_t));
+    if (block == nullptr) {
+      return nullptr;
+    }
+    *block = size;
+    track(size, 0);
+    return block + 1;
+  }
+  
+  void deallocate(void* ptr) override {
+    if (ptr == nullptr) {
+      return;
+    }
+    size_t* block = (size_t*)ptr - 1;
+    current -= *block;
+    free(block);
+  }
+  
+  void* reallocate(void* ptr, size_t newSize) override {
+    if (ptr == nullptr) {
+      return allocate(newSize);
+    }
+    size_t* block = (size_t*)ptr - 1;
+    size_t oldSize = *block;
+    block = (size_t*)realloc(block, newSize + sizeof(size_t));
+    if (block == nullptr) {
+      return nullptr;
+    }
+    *block = newSize;
+    track(newSize, oldSize);
+    return block + 1;
+  }
+  
+  size_t current = 0;
+  size_t peak = 0;
+  
+private:
+  void track(size_t added, size_t removed) {
+    current = current + added - removed;
+    if (current > peak) {
+      peak = current;
+    }
+  }
 };
 
+// Champs conservés pour un message JSON (tout le reste est ignoré pendant la lecture)
+// Une route qui lit un nouveau champ racine doit l'ajouter ici
+static const char* const MESSAGE_FIELDS[] = {
+  "action", "params", "cmd",
+  "status", "response", "type",  // Nos propres messages (ignorés)
+  // Ancien format : paramètres à la racine du message
+  "value", "delay", "timestamp", "timeout", "enabled",
+  "color", "effect", "animation", "colorR", "colorG", "colorB",
+  "brightness", "allNight", "weekdaySchedule"
+};
+
+static JsonDocument messageFilter;
+
+// Observateur des commandes traitées (setCommandObserver)
+static PubNubManager::CommandObserver commandObserver = nullptr;
+
+static void buildMessageFilter() {
+  for (const char* field : MESSAGE_FIELDS) {
+    messageFilter[field] = true;
+  }
+}
+
 bool PubNubManager::init() {
   if (initialized) {
     return true;
@@ -60,13 +383,28 @@ bool PubNubManager::init() {
   Serial.print("[PUBNUB] Channel construit avec MAC: ");
   Serial.println(channel);
   
-  // Créer la file d'attente pour les publications
-  publishQueue = xQueueCreate(PUBLISH_QUEUE_SIZE, sizeof(PublishMessage));
-  if (publishQueue == nullptr) {
-    Serial.println("[PUBNUB] Erreur creation queue");
+  // URL de publication (POST, le message est dans le corps) : ne change pas
+  // pour un appareil donné
+  int urlLength = snprintf(publishUrl, sizeof(publishUrl), "http://%s/publish/%s/%s/0/%s/0",
+                           PUBNUB_ORIGIN, DEFAULT_PUBNUB_PUBLISH_KEY, DEFAULT_PUBNUB_SUBSCRIBE_KEY, channel);
+  if (urlLength < 0 || urlLength >= (int)sizeof(publishUrl)) {
+    Serial.println("[PUBNUB] URL de publication trop longue");
     return false;
   }
   
+  buildMessageFilter();
+  
+  // Événements restés dans le journal avant un redémarrage
+  PublishJournal::init();
+  
+  // Hôte et port du serveur pour la connexion subscribe ("hote" ou "hote:port")
+  strncpy(originHost, PUBNUB_ORIGIN, sizeof(originHost) - 1);
+  char* portSeparator = strchr(originHost, ':');
+  if (portSeparator != nullptr) {
+    *portSeparator = '\0';
+    originPort = (uint16_t)atoi(portSeparator + 1);
+  }
+  
   initialized = true;
   Serial.println("[PUBNUB] Initialisation OK");
   Serial.print("[PUBNUB] Channel: ");
@@ -111,6 +449,12 @@ bool PubNubManager::connect() {
   
   // Reset le timetoken pour commencer fresh
   strcpy(timeToken, "0");
+  subscribePending = false;
+  retryDelayMs = 0;
+  nextSubscribeTime = millis();
+  metricsStartTime = millis();
+  emptyPolls = 0;
+  threadWakeups = 0;
   
   // Créer le thread FreeRTOS sur Core 0 (même core que WiFi stack)
   Serial.printf("[PUBNUB] Core=%d, Priority=%d, Stack=%d\n", TASK_CORE, TASK_PRIORITY, STACK_SIZE);
@@ -154,14 +498,16 @@ void PubNubManager::disconnect() {
     return;
   }
   
-  // Arrêter le thread
+  // Arrêter le thread (réveillé s'il attend le socket)
   if (taskHandle != nullptr) {
     threadRunning = false;
+    wakeThread();
     vTaskDelay(pdMS_TO_TICKS(100)); // Laisser le temps au thread de s'arrêter
     vTaskDelete(taskHandle);
     taskHandle = nullptr;
   }
   
+  closeConnections();
   connected = false;
   strcpy(timeToken, "0");
   Serial.println("[PUBNUB] Deconnecte");
@@ -182,30 +528,39 @@ bool PubNubManager::isAvailable() {
 }
 
 void PubNubManager::loop() {
-  // Le thread gère tout, cette fonction ne fait rien
-  // Gardée pour compatibilité avec le code existant
+  // Le thread gère tout le réseau. Tant qu'il ne tourne pas (démarrage hors
+  // ligne), les événements du journal passent quand même de la RAM à la SD.
+  if (initialized && !threadRunning) {
+    PublishJournal::service();
+  }
 }
 
 void PubNubManager::threadFunction(void* parameter) {
   Serial.println("[PUBNUB] Thread actif - entrée dans threadFunction");
   
-  int loopCount = 0;
+  // Créé ici : la pile réseau est démarrée (le thread ne tourne qu'avec le WiFi)
+  openWakeSockets();
+  
   while (threadRunning) {
-    loopCount++;
+    threadWakeups++;
     
-    // Log périodique pour vérifier que la boucle tourne (toutes les 500 itérations = ~50 secondes)
-    if (loopCount == 1) {
+    // Log périodique pour vérifier que la boucle tourne (au repos : au plus un tour par WAIT_MAX_MS)
+    if (threadWakeups == 1) {
       Serial.println("[PUBNUB] Première itération de la boucle");
-    } else if (loopCount % 500 == 0) {
+    } else if (threadWakeups % 3600 == 0) {
       Serial.print("[PUBNUB] Boucle active (iteration ");
-      Serial.print(loopCount);
+      Serial.print(threadWakeups);
       Serial.println(")");
     }
     
+    // Événements hors ligne : écrits sur la SD ici, jamais dans la tâche qui les publie
+    PublishJournal::service();
+    
     // Vérifier la connexion WiFi
     if (!WiFiManager::isConnected()) {
       if (connected) {
         connected = false;
+        closeConnections();
         Serial.println("[PUBNUB] WiFi perdu");
       }
       vTaskDelay(pdMS_TO_TICKS(1000));
@@ -216,139 +571,358 @@ void PubNubManager::threadFunction(void* parameter) {
     if (!connected) {
       connected = true;
       strcpy(timeToken, "0");
+      nextSubscribeTime = millis();
       Serial.println("[PUBNUB] WiFi retrouve, reconnexion...");
     }
     
-    // Traiter les messages à publier en attente
-    if (publishQueue != nullptr) {
-      PublishMessage pubMsg;
-      while (xQueueReceive(publishQueue, &pubMsg, 0) == pdTRUE) {
-        publishInternal(pubMsg.message);
-      }
-    }
+    // Envoyer les messages à publier dont la fenêtre est écoulée (la publication
+    // a sa propre connexion : elle n'attend pas la fin du subscribe en cours)
+    flushPublishRing();
+    flushJournal();
     
-    // Subscribe (long polling)
-    bool subscribeResult = subscribe();
-    if (!subscribeResult) {
-      // Ne pas logger à chaque fois pour éviter le spam
-      // Serial.println("[PUBNUB] Subscribe a échoué");
+    // Subscribe (long polling) : une seule requête à la fois, gardée ouverte
+    // par le serveur jusqu'à un message ou ~280 s
+    if (subscribePending) {
+      pollSubscribe();
+    } else if ((long)(millis() - nextSubscribeTime) >= 0) {
+      startSubscribe();
     }
     
-    // Petit délai entre les polls
-    vTaskDelay(pdMS_TO_TICKS(SUBSCRIBE_INTERVAL_MS));
+    // Attente bloquante jusqu'à la réponse du subscribe, un réveil par publish()
+    // ou la prochaine échéance
+    waitForActivity(nextWakeDelay());
   }
   
   Serial.println("[PUBNUB] Thread arrete (threadRunning=false)");
   vTaskDelete(nullptr);
 }
 
-bool PubNubManager::subscribe() {
-  if (!WiFiManager::isConnected()) {
-    Serial.println("[PUBNUB] Subscribe: WiFi non connecté");
-    return false;
-  }
-  
+void PubNubManager::startSubscribe() {
   if (strlen(channel) == 0) {
-    Serial.println("[PUBNUB] Subscribe: Channel vide!");
-    return false;
+    subscribeFailed("channel vide");
+    return;
   }
   
   if (strlen(DEFAULT_PUBNUB_SUBSCRIBE_KEY) == 0) {
-    Serial.println("[PUBNUB] Subscribe: Subscribe key vide!");
-    return false;
+    subscribeFailed("subscribe key vide");
+    return;
   }
   
-  HTTPClient http;
+  // Réutiliser la connexion du poll précédent si le serveur l'a gardée ouverte
+  subscribeReused = subscribeClient.connected();
+  if (subscribeReused) {
+    subscribeStats.reused++;
+  } else {
+    if (!subscribeClient.connect(originHost, originPort, 2000)) {
+      subscribeFailed("connexion impossible");
+      return;
+    }
+    subscribeStats.opened++;
+  }
+  subscribeStats.requests++;
   
-  // Construire l'URL de subscribe
-  char url[256];
-  snprintf(url, sizeof(url),
-    "http://%s/subscribe/%s/%s/0/%s",
-    PUBNUB_ORIGIN,
+  // Premier subscribe (timetoken 0) : le serveur répond tout de suite avec le timetoken courant
+  subscribeHandshake = (strcmp(timeToken, "0") == 0);
+  size_t written = subscribeClient.printf(
+    "GET /subscribe/%s/%s/0/%s HTTP/1.1\r\nHost: %s\r\nConnection: keep-alive\r\n\r\n",
     DEFAULT_PUBNUB_SUBSCRIBE_KEY,
     channel,
-    timeToken
+    timeToken,
+    PUBNUB_ORIGIN
   );
+  if (written == 0) {
+    subscribeClient.stop();
+    subscribeFailed("envoi de la requete impossible");
+    return;
+  }
+  
+  subscribeSentTime = millis();
+  subscribePending = true;
+}
+
+void PubNubManager::pollSubscribe() {
+  if (subscribeClient.available() > 0) {
+    // Le serveur répond : message(s) reçu(s) ou fin du long poll
+    subscribePending = false;
+    subscribeStats.lastRequestMs = millis() - subscribeSentTime;
+    // Les commandes LED envoyées pendant le traitement de la réponse sont datées
+    // de sa réception (latence commande -> LED)
+    LEDLatencyScope latencyScope(LED_SOURCE_PUBNUB);
+    int messageCount = readSubscribeResponse();
+    if (messageCount < 0) {
+      // Fin de réponse non lue : la connexion ne peut pas être réutilisée
+      subscribeClient.stop();
+      subscribeFailed("reponse invalide");
+      return;
+    }
+    
+    if (messageCount == 0 && !subscribeHandshake) {
+      emptyPolls++;
+    }
+    retryDelayMs = 0;
+    nextSubscribeTime = millis();
+    return;
+  }
   
-  http.begin(url);
-  http.setConnectTimeout(2000);
-  http.setTimeout(5000); // 5 secondes - PubNub garde la connexion ouverte
+  if (!subscribeClient.connected()) {
+    subscribePending = false;
+    subscribeClient.stop();
+    if (subscribeReused) {
+      // Connexion inactive fermée par le serveur entre deux polls : renvoyer tout de suite
+      subscribeStats.retried++;
+      nextSubscribeTime = millis();
+    } else {
+      subscribeFailed("connexion fermee par le serveur");
+    }
+    return;
+  }
   
-  int httpCode = http.GET();
+  if (millis() - subscribeSentTime >= SUBSCRIBE_TIMEOUT_MS) {
+    subscribeClient.stop();
+    subscribeFailed("aucune reponse du serveur");
+  }
+}
+
+int PubNubManager::readSubscribeResponse() {
+  // Ligne de statut : "HTTP/1.1 200 OK"
+  String line = subscribeClient.readStringUntil('\n');
+  int space = line.indexOf(' ');
+  int status = (space > 0) ? line.substring(space + 1).toInt() : 0;
   
-  if (httpCode == HTTP_CODE_OK) {
-    String payload = http.getString();
-    http.end();
-    
-    // Log pour debug : afficher la taille de la réponse
-    if (payload.length() > 0) {
-      Serial.print("[PUBNUB] Réponse reçue (");
-      Serial.print(payload.length());
-      Serial.println(" bytes)");
+  // En-têtes, jusqu'à la ligne vide
+  bool chunked = false;
+  bool closeAfter = false;
+  while (true) {
+    line = subscribeClient.readStringUntil('\n');
+    line.trim();
+    if (line.length() == 0) {
+      break;
     }
-    
-    processMessages(payload.c_str());
-    return true;
+    line.toLowerCase();
+    if (line.startsWith("transfer-encoding:") && line.indexOf("chunked") > 0) {
+      chunked = true;
+    } else if (line.startsWith("connection:") && line.indexOf("close") > 0) {
+      closeAfter = true;
+    }
+  }
+  
+  if (status != HTTP_CODE_OK) {
+    Serial.print("[PUBNUB] Erreur subscribe HTTP: ");
+    Serial.println(status);
+    return -1;
+  }
+  
+  // Lecture directe depuis le socket, sans copie de la réponse (chunked ou non)
+  PubNubResponseReader reader(&subscribeClient, chunked);
+  int messageCount = processMessages(reader);
+  reader.finish();
+  
+  if (closeAfter) {
+    subscribeClient.stop();
   } else {
-    // Les erreurs -11 (HTTPC_ERROR_CONNECTION_LOST) et -1 (HTTPC_ERROR_CONNECTION_REFUSED/timeout)
-    // sont normales avec PubNub en long polling
-    // -11 : connexion fermée entre deux requêtes (normal)
-    // -1 : timeout de connexion ou refus temporaire (peut arriver avec PubNub)
-    // Ne logger que les autres erreurs pour éviter le spam
-    if (httpCode != -11 && httpCode != -1) {
-      Serial.print("[PUBNUB] Erreur subscribe HTTP: ");
-      Serial.println(httpCode);
+    // Octets restants après le JSON (fin de ligne) : la connexion reste propre pour le poll suivant
+    while (subscribeClient.available() > 0) {
+      subscribeClient.read();
     }
-    http.end();
-    return false;
   }
+  return messageCount;
 }
 
-void PubNubManager::processMessages(const char* json) {
-  // Log pour debug : afficher le JSON brut reçu
-  if (json != nullptr && strlen(json) > 0) {
-    Serial.print("[PUBNUB] JSON brut reçu: ");
-    // Limiter la taille du log pour éviter les problèmes de mémoire
-    int len = strlen(json);
-    if (len > 200) {
-      Serial.print("(tronqué, ");
-      Serial.print(len);
-      Serial.print(" bytes) ");
-      char truncated[201];
-      strncpy(truncated, json, 200);
-      truncated[200] = '\0';
-      Serial.println(truncated);
-    } else {
-      Serial.println(json);
-    }
+void PubNubManager::subscribeFailed(const char* reason) {
+  subscribePending = false;
+  subscribeErrors++;
+  
+  // Backoff exponentiel (1 s, 2 s, 4 s ... 60 s) avec jitter : moitié fixe,
+  // moitié aléatoire, pour que les appareils ne se reconnectent pas tous ensemble
+  if (retryDelayMs == 0) {
+    retryDelayMs = BACKOFF_MIN_MS;
+  } else if (retryDelayMs < BACKOFF_MAX_MS / 2) {
+    retryDelayMs *= 2;
+  } else {
+    retryDelayMs = BACKOFF_MAX_MS;
   }
+  uint32_t delayMs = retryDelayMs / 2 + random(retryDelayMs / 2 + 1);
+  nextSubscribeTime = millis() + delayMs;
   
-  JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, json);
+  Serial.printf("[PUBNUB] Subscribe: %s, nouvel essai dans %lu ms\n", reason, (unsigned long)delayMs);
+}
+
+uint32_t PubNubManager::nextWakeDelay() {
+  unsigned long now = millis();
+  long delayMs = WAIT_MAX_MS;
   
-  if (error) {
-    Serial.print("[PUBNUB] Erreur parsing JSON: ");
-    Serial.println(error.c_str());
+  // Subscribe : timeout de la requête en cours, ou envoi de la suivante
+  unsigned long subscribeDeadline = subscribePending ? subscribeSentTime + SUBSCRIBE_TIMEOUT_MS : nextSubscribeTime;
+  if ((long)(subscribeDeadline - now) < delayMs) {
+    delayMs = (long)(subscribeDeadline - now);
+  }
+  
+  // Fenêtre de publication du message le plus pressé
+  portENTER_CRITICAL(&publishMux);
+  bool queued = publishRing.count() > 0;
+  unsigned long deadline = publishDeadline;
+  portEXIT_CRITICAL(&publishMux);
+  if (queued && (long)(deadline - now) < delayMs) {
+    delayMs = (long)(deadline - now);
+  }
+  
+  // Prochain lot du journal (rien tant que le subscribe est en erreur, cf. flushJournal)
+  if (retryDelayMs == 0 && !PublishJournal::isEmpty() && (long)(nextJournalFlush - now) < delayMs) {
+    delayMs = (long)(nextJournalFlush - now);
+  }
+  
+  return delayMs > 0 ? (uint32_t)delayMs : 0;
+}
+
+void PubNubManager::waitForActivity(uint32_t timeoutMs) {
+  int fd = subscribePending ? subscribeClient.fd() : -1;
+  if (fd < 0 || wakeSocket < 0) {
+    // Pas de requête en cours : seule une notification peut avancer l'échéance
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
     return;
   }
   
-  // Extraire le nouveau timetoken
-  if (doc[1].is<const char*>()) {
-    strncpy(timeToken, doc[1].as<const char*>(), sizeof(timeToken) - 1);
-    timeToken[sizeof(timeToken) - 1] = '\0';
+  // Réponse déjà dans le tampon du client, ou réveil demandé avant l'attente
+  if (subscribeClient.available() > 0 || ulTaskNotifyTake(pdTRUE, 0) > 0) {
+    return;
   }
   
-  // Traiter les messages
-  if (!doc[0].is<JsonArray>()) {
+  fd_set readSet;
+  FD_ZERO(&readSet);
+  FD_SET(fd, &readSet);
+  FD_SET(wakeSocket, &readSet);
+  struct timeval timeout;
+  timeout.tv_sec = timeoutMs / 1000;
+  timeout.tv_usec = (timeoutMs % 1000) * 1000;
+  select((fd > wakeSocket ? fd : wakeSocket) + 1, &readSet, nullptr, nullptr, &timeout);
+  
+  // Signaux de réveil consommés (la notification envoyée avec eux aussi)
+  if (FD_ISSET(wakeSocket, &readSet)) {
+    uint8_t signal[16];
+    while (recv(wakeSocket, signal, sizeof(signal), 0) > 0) {
+    }
+    ulTaskNotifyTake(pdTRUE, 0);
+  }
+}
+
+void PubNubManager::wakeThread() {
+  if (taskHandle == nullptr) {
+    return;
+  }
+  xTaskNotifyGive(taskHandle);
+  if (wakeSender >= 0) {
+    uint8_t signal = 0;
+    sendto(wakeSender, &signal, 1, 0, (struct sockaddr*)&wakeAddress, sizeof(wakeAddress));
+  }
+}
+
+void PubNubManager::recordDeliveryLatency() {
+  // Heure UTC système (disponible après une synchro NTP)
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  if (now.tv_sec < MIN_VALID_UNIX_TIME) {
     return;
   }
   
-  JsonArray messages = doc[0].as<JsonArray>();
+  // Timetoken PubNub : date de publication du dernier message, en unités de 100 ns
+  uint64_t publishedMs = strtoull(timeToken, nullptr, 10) / 10000ULL;
+  uint64_t nowMs = (uint64_t)now.tv_sec * 1000ULL + now.tv_usec / 1000;
+  if (publishedMs == 0 || nowMs < publishedMs || nowMs - publishedMs > MAX_LATENCY_SAMPLE_MS) {
+    return;  // Horloges trop décalées : mesure ignorée
+  }
   
-  // Compter les messages de manière sûre
+  latencySamples[latencyIndex] = (uint32_t)(nowMs - publishedMs);
+  latencyIndex = (latencyIndex + 1) % LATENCY_SAMPLE_COUNT;
+  if (latencyCount < LATENCY_SAMPLE_COUNT) {
+    latencyCount++;
+  }
+}
+
+uint32_t PubNubManager::getMedianDeliveryLatency() {
+  if (latencyCount == 0) {
+    return 0;
+  }
+  uint32_t sorted[LATENCY_SAMPLE_COUNT];
+  for (int i = 0; i < latencyCount; i++) {
+    // Tri par insertion (quelques échantillons)
+    uint32_t value = latencySamples[i];
+    int j = i;
+    while (j > 0 && sorted[j - 1] > value) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = value;
+  }
+  return sorted[latencyCount / 2];
+}
+
+int PubNubManager::processMessages(PubNubResponseReader& reader) {
+  PollJsonAllocator allocator;
+  JsonDocument doc(&allocator);
+  JsonDocument skipAll;  // Filtre vide : valeur lue puis ignorée
+  DeserializationError error;
+  bool valid = true;
   int messageCount = 0;
-  for (JsonVariant msg : messages) {
-    messageCount++;
+  
+  if (reader.nextToken() != '[' || reader.nextToken() != '[') {
+    Serial.println("[PUBNUB] Erreur parsing JSON: format de reponse inattendu");
+    return -1;
+  }
+  
+  // Messages lus et traités un par un : un seul message en mémoire à la fois
+  if (reader.peekToken() == ']') {
+    reader.nextToken();
+  } else {
+    while (true) {
+      int first = reader.peekToken();
+      if (first == '{') {
+        error = deserializeJson(doc, reader, DeserializationOption::Filter(messageFilter));
+      } else if (first == '"') {
+        error = deserializeJson(doc, reader);
+      } else if (first == '[') {
+        error = deserializeJson(doc, reader, DeserializationOption::Filter(skipAll));
+      } else {
+        // Nombre, booléen ou null : ignoré jusqu'au séparateur
+        int c;
+        do {
+          c = reader.read();
+        } while (c >= 0 && c != ',' && c != ']');
+        reader.peekToken();  // Le séparateur redevient le prochain caractère
+        doc.clear();
+        error = (c < 0) ? DeserializationError(DeserializationError::IncompleteInput) : DeserializationError();
+      }
+      if (error) {
+        valid = false;
+        break;
+      }
+      
+      messageCount++;
+      dispatchMessage(doc.as<JsonVariant>());
+      doc.clear();
+      
+      int separator = reader.nextToken();
+      if (separator == ']') {
+        break;
+      }
+      if (separator != ',') {
+        error = DeserializationError::InvalidInput;
+        valid = false;
+        break;
+      }
+    }
+  }
+  
+  // Timetoken après les messages : ["...", "timetoken"]
+  if (valid && reader.nextToken() == ',') {
+    error = deserializeJson(doc, reader);
+    if (!error && doc.is<const char*>()) {
+      strncpy(timeToken, doc.as<const char*>(), sizeof(timeToken) - 1);
+      timeToken[sizeof(timeToken) - 1] = '\0';
+    } else {
+      valid = false;
+    }
+  } else {
+    valid = false;
   }
   
   if (messageCount > 0) {
@@ -356,85 +930,101 @@ void PubNubManager::processMessages(const char* json) {
     Serial.print(messageCount);
     Serial.println(" message(s) reçu(s)");
   }
+  if (!valid) {
+    Serial.print("[PUBNUB] Erreur parsing JSON: ");
+    Serial.println(error ? error.c_str() : "reponse incomplete");
+  } else if (messageCount > 0) {
+    recordDeliveryLatency();
+  }
   
-  for (JsonVariant msg : messages) {
-    if (msg.is<const char*>()) {
-      // Message texte simple = commande série
-      const char* textMsg = msg.as<const char*>();
-      if (textMsg != nullptr) {
-        Serial.print("[PUBNUB] Message texte reçu: ");
-        Serial.println(textMsg);
-        executeCommand(textMsg);
+  lastPollJsonPeak = allocator.peak;
+  if (lastPollJsonPeak > maxPollJsonPeak) {
+    maxPollJsonPeak = lastPollJsonPeak;
+  }
+  return valid ? messageCount : -1;
+}
+
+void PubNubManager::dispatchMessage(JsonVariant msg) {
+  if (msg.is<const char*>()) {
+    // Message texte simple = commande série
+    const char* textMsg = msg.as<const char*>();
+    if (textMsg != nullptr) {
+      Serial.print("[PUBNUB] Message texte reçu: ");
+      Serial.println(textMsg);
+      executeCommand(textMsg);
+    }
+  } else if (msg.is<JsonObject>()) {
+    JsonObject obj = msg.as<JsonObject>();
+    
+    // Ignorer nos propres messages (status, response, type)
+    if (obj["status"].is<const char*>() || obj["response"].is<const char*>() || obj["type"].is<const char*>()) {
+      return;
+    }
+    
+    // Si c'est une action, utiliser les routes
+    // Gérer le cas où action est une string ou un objet (format incorrect)
+    JsonObject actionObj = obj;
+    const char* action = nullptr;
+    
+    if (obj["action"].is<const char*>()) {
+      // Format normal : action est une string
+      action = obj["action"].as<const char*>();
+    } else if (obj["action"].is<JsonObject>()) {
+      // Format incorrect : action est un objet, extraire l'action depuis l'objet
+      JsonObject nestedAction = obj["action"].as<JsonObject>();
+      if (nestedAction["action"].is<const char*>()) {
+        action = nestedAction["action"].as<const char*>();
+        // Utiliser l'objet imbriqué comme message principal
+        actionObj = nestedAction;
+        Serial.println("[PUBNUB] WARNING: Format de message incorrect detecte (action est un objet)");
       }
-    } else if (msg.is<JsonObject>()) {
-      JsonObject obj = msg.as<JsonObject>();
+    }
+    
+    if (action != nullptr) {
+      Serial.print("[PUBNUB] Commande reçue - Action: ");
+      Serial.print(action);
       
-      // Ignorer nos propres messages (status, response, type)
-      if (obj["status"].is<const char*>() || obj["response"].is<const char*>() || obj["type"].is<const char*>()) {
-        continue;
+      // Log des paramètres si présents (de manière sûre)
+      if (actionObj["params"].is<JsonObject>()) {
+        Serial.print(" (avec params)");
+      } else if (actionObj["value"].is<int>()) {
+        Serial.print(" - value: ");
+        Serial.print(actionObj["value"].as<int>());
+      } else if (actionObj["value"].is<float>()) {
+        Serial.print(" - value: ");
+        Serial.print(actionObj["value"].as<float>());
+      } else if (actionObj["delay"].is<int>()) {
+        Serial.print(" - delay: ");
+        Serial.print(actionObj["delay"].as<int>());
+        Serial.print("ms");
       }
       
-      // Si c'est une action, utiliser les routes
-      // Gérer le cas où action est une string ou un objet (format incorrect)
-      JsonObject actionObj = obj;
-      const char* action = nullptr;
-      
-      if (obj["action"].is<const char*>()) {
-        // Format normal : action est une string
-        action = obj["action"].as<const char*>();
-      } else if (obj["action"].is<JsonObject>()) {
-        // Format incorrect : action est un objet, extraire l'action depuis l'objet
-        JsonObject nestedAction = obj["action"].as<JsonObject>();
-        if (nestedAction["action"].is<const char*>()) {
-          action = nestedAction["action"].as<const char*>();
-          // Utiliser l'objet imbriqué comme message principal
-          actionObj = nestedAction;
-          Serial.println("[PUBNUB] WARNING: Format de message incorrect detecte (action est un objet)");
-        }
+      // Log du timestamp si présent
+      if (actionObj["timestamp"].is<unsigned long>() || actionObj["timestamp"].is<long>()) {
+        Serial.print(" - timestamp: ");
+        Serial.print(actionObj["timestamp"].as<unsigned long>());
       }
+      Serial.println();
       
-      if (action != nullptr) {
-        Serial.print("[PUBNUB] Commande reçue - Action: ");
-        Serial.print(action);
-        
-        // Log des paramètres si présents (de manière sûre)
-        if (actionObj["params"].is<JsonObject>()) {
-          Serial.print(" (avec params)");
-        } else if (actionObj["value"].is<int>()) {
-          Serial.print(" - value: ");
-          Serial.print(actionObj["value"].as<int>());
-        } else if (actionObj["value"].is<float>()) {
-          Serial.print(" - value: ");
-          Serial.print(actionObj["value"].as<float>());
-        } else if (actionObj["delay"].is<int>()) {
-          Serial.print(" - delay: ");
-          Serial.print(actionObj["delay"].as<int>());
-          Serial.print("ms");
-        }
-        
-        // Log du timestamp si présent
-        if (actionObj["timestamp"].is<unsigned long>() || actionObj["timestamp"].is<long>()) {
-          Serial.print(" - timestamp: ");
-          Serial.print(actionObj["timestamp"].as<unsigned long>());
-        }
-        Serial.println();
-        
-        ModelPubNubRoutes::processMessage(actionObj);
-      }
-      // Si c'est une commande série (legacy)
-      else if (obj["cmd"].is<const char*>()) {
-        const char* cmd = obj["cmd"].as<const char*>();
-        if (cmd != nullptr) {
-          Serial.print("[PUBNUB] Commande série (legacy) reçue: ");
-          Serial.println(cmd);
-          executeCommand(cmd);
-        }
+      unsigned long handlerStart = micros();
+      ModelPubNubRoutes::processMessage(actionObj);
+      if (commandObserver != nullptr) {
+        commandObserver(obj, micros() - handlerStart);
       }
-      // Message JSON sans action reconnue - log minimal pour éviter les problèmes de mémoire
-      else {
-        Serial.println("[PUBNUB] Message JSON reçu (format non reconnu)");
+    }
+    // Si c'est une commande série (legacy)
+    else if (obj["cmd"].is<const char*>()) {
+      const char* cmd = obj["cmd"].as<const char*>();
+      if (cmd != nullptr) {
+        Serial.print("[PUBNUB] Commande série (legacy) reçue: ");
+        Serial.println(cmd);
+        executeCommand(cmd);
       }
     }
+    // Message JSON sans action reconnue - log minimal pour éviter les problèmes de mémoire
+    else {
+      Serial.println("[PUBNUB] Message JSON reçu (format non reconnu)");
+    }
   }
 }
 
@@ -465,71 +1055,273 @@ void PubNubManager::executeCommand(const char* command) {
   // Si besoin, utiliser un channel séparé pour les réponses
 }
 
-bool PubNubManager::publish(const char* message) {
-  if (!initialized || publishQueue == nullptr) {
+bool PubNubManager::publish(const char* message, PublishPriority priority) {
+  if (!initialized || message == nullptr) {
+    return false;
+  }
+  
+  size_t length = strlen(message);
+  if (length == 0) {
+    return false;
+  }
+  if (length > PUBLISH_MESSAGE_MAX) {
+    publishTooLarge++;
+    Serial.printf("[PUBNUB] Message trop long (%u octets, max %u), ignore\n",
+                  (unsigned)length, (unsigned)PUBLISH_MESSAGE_MAX);
     return false;
   }
   
-  // Ajouter à la file d'attente (thread-safe)
-  PublishMessage pubMsg;
-  strncpy(pubMsg.message, message, sizeof(pubMsg.message) - 1);
-  pubMsg.message[sizeof(pubMsg.message) - 1] = '\0';
+  uint32_t window = 0;
+  if (priority == PUBLISH_PRIORITY_NORMAL) {
+    window = PUBLISH_WINDOW_NORMAL_MS;
+  } else if (priority == PUBLISH_PRIORITY_BACKGROUND) {
+    window = PUBLISH_WINDOW_BACKGROUND_MS;
+  }
+  unsigned long deadline = millis() + window;
+  
+  // Copier dans le tampon circulaire (thread-safe, aucune allocation)
+  // L'échéance de la fenêtre est celle du message le plus pressé
+  portENTER_CRITICAL(&publishMux);
+  bool wasEmpty = publishRing.count() == 0;
+  bool queued = publishRing.push(message, length);
+  bool earlier = false;
+  if (queued) {
+    publishQueued++;
+    if (publishRing.used() > publishRingPeak) {
+      publishRingPeak = publishRing.used();
+    }
+    earlier = wasEmpty || (long)(deadline - publishDeadline) < 0;
+    if (earlier) {
+      publishDeadline = deadline;
+    }
+  } else {
+    publishQueueFull++;
+  }
+  portEXIT_CRITICAL(&publishMux);
   
-  if (xQueueSend(publishQueue, &pubMsg, 0) != pdTRUE) {
-    Serial.println("[PUBNUB] Queue pleine, message ignore");
+  if (!queued) {
+    Serial.println("[PUBNUB] Tampon de publication plein, message ignore");
     return false;
   }
   
+  // Échéance avancée (message critique, ou premier message de la fenêtre) :
+  // réveiller le thread, qui attend peut-être la réponse d'un long poll.
+  // Les messages suivants partent avec le lot déjà programmé.
+  if (earlier) {
+    wakeThread();
+  }
+  
   return true;
 }
 
-bool PubNubManager::publishInternal(const char* message) {
-  if (!WiFiManager::isConnected()) {
+void PubNubManager::flushPublishRing() {
+  unsigned long now = millis();
+  portENTER_CRITICAL(&publishMux);
+  bool due = publishRing.count() > 0 && (long)(now - publishDeadline) >= 0;
+  portEXIT_CRITICAL(&publishMux);
+  if (!due) {
+    return;
+  }
+  
+  // Tout ce qui attend part maintenant, même les messages dont la fenêtre
+  // n'est pas écoulée (ils profitent de la requête)
+  const char* body = nullptr;
+  int count;
+  while ((count = buildPublishBatch(body)) > 0) {
+    if (count > 1) {
+      publishBatches++;
+    }
+    if (publishInternal(body) == HTTP_CODE_OK) {
+      publishSent += count;
+    } else {
+      publishFailed += count;
+    }
+  }
+}
+
+bool PubNubManager::publishEvent(const char* message) {
+  if (!initialized || message == nullptr) {
     return false;
   }
   
-  if (strlen(DEFAULT_PUBNUB_PUBLISH_KEY) == 0) {
+  // Toujours journalisé : l'événement n'en sort qu'après un HTTP 200 (flushJournal),
+  // même si l'envoi échoue alors que l'appareil semblait en ligne
+  if (!PublishJournal::append(message)) {
+    Serial.println("[PUBNUB] Evenement invalide (objet JSON sur une ligne attendu), ignore");
     return false;
   }
   
-  HTTPClient http;
+  // En ligne : réveiller le thread pour envoyer le lot sans attendre
+  wakeThread();
+  return true;
+}
+
+void PubNubManager::flushJournal() {
+  // Pas de lot tant que le subscribe est en erreur (serveur injoignable)
+  if (retryDelayMs != 0 || (long)(millis() - nextJournalFlush) < 0 || PublishJournal::isEmpty()) {
+    return;
+  }
   
-  // Préparer le message JSON
-  String jsonMessage;
-  if (message[0] == '{' || message[0] == '[') {
-    jsonMessage = message;
-  } else {
-    jsonMessage = "\"";
-    jsonMessage += message;
-    jsonMessage += "\"";
-  }
-  
-  // Construire l'URL (sans le message - on utilise POST)
-  String url = "http://";
-  url += PUBNUB_ORIGIN;
-  url += "/publish/";
-  url += DEFAULT_PUBNUB_PUBLISH_KEY;
-  url += "/";
-  url += DEFAULT_PUBNUB_SUBSCRIBE_KEY;
-  url += "/0/";
-  url += channel;
-  url += "/0";
-  
-  http.begin(url);
-  http.setTimeout(5000);
-  http.addHeader("Content-Type", "application/json");
-  
-  // Utiliser POST pour envoyer le message dans le body (pas de limite URL)
-  int httpCode = http.POST(jsonMessage);
-  http.end();
-  
-  if (httpCode == HTTP_CODE_OK) {
-    return true;
+  // Même enveloppe que les lots de publish() (le tampon sert aux deux, depuis ce thread)
+  char* messages = publishBody + BATCH_PREFIX_LENGTH;
+  size_t length = 0;
+  int count = PublishJournal::readBatch(messages, PUBLISH_BATCH_MAX + 1, length);
+  if (count == 0) {
+    return;
+  }
+  const char* body = messages;
+  if (count > 1) {
+    memcpy(publishBody, BATCH_PREFIX, BATCH_PREFIX_LENGTH);
+    memcpy(messages + length, BATCH_SUFFIX, BATCH_SUFFIX_LENGTH + 1);
+    body = publishBody;
+  }
+  
+  int httpCode = publishInternal(body);
+  if (httpCode == HTTP_CODE_OK || httpCode == 400 || httpCode == 413) {
+    // Lot refusé comme invalide (400, 413) : il ne passera jamais, ne pas bloquer
+    // le journal. Tout autre échec (réseau, 403, 429, 5xx) garde le lot.
+    PublishJournal::commitBatch();
+    if (httpCode == HTTP_CODE_OK) {
+      publishSent += count;
+      if (count > 1) {
+        publishBatches++;
+      }
+    } else {
+      publishFailed += count;
+    }
+    nextJournalFlush = millis() + JOURNAL_FLUSH_INTERVAL_MS;
   } else {
+    nextJournalFlush = millis() + JOURNAL_RETRY_MS;
+  }
+}
+
+int PubNubManager::buildPublishBatch(const char*& body) {
+  // Les messages sont copiés après la place réservée au préfixe de l'enveloppe
+  char* messages = publishBody + BATCH_PREFIX_LENGTH;
+  size_t position = 0;
+  int count = 0;
+  
+  while (true) {
+    size_t length = 0;
+    portENTER_CRITICAL(&publishMux);
+    size_t next = publishRing.peekLength();
+    // Séparateur et guillemets éventuels compris
+    if (next > 0 && position + (count > 0 ? 1 : 0) + next + 2 <= PUBLISH_BATCH_MAX) {
+      if (count > 0) {
+        messages[position++] = ',';
+      }
+      length = publishRing.pop(messages + position, PUBLISH_BATCH_MAX + 1 - position);
+    }
+    portEXIT_CRITICAL(&publishMux);
+    if (length == 0) {
+      break;
+    }
+    
+    // Message JSON tel quel, texte entre guillemets
+    char* message = messages + position;
+    if (message[0] != '{' && message[0] != '[') {
+      memmove(message + 1, message, length);
+      message[0] = '"';
+      message[length + 1] = '"';
+      length += 2;
+    }
+    position += length;
+    count++;
+  }
+  
+  if (count == 0) {
+    return 0;
+  }
+  
+  // Un seul message : envoyé tel quel, sans enveloppe
+  if (count == 1) {
+    messages[position] = '\0';
+    body = messages;
+    return 1;
+  }
+  
+  memcpy(publishBody, BATCH_PREFIX, BATCH_PREFIX_LENGTH);
+  memcpy(messages + position, BATCH_SUFFIX, BATCH_SUFFIX_LENGTH + 1);
+  body = publishBody;
+  return count;
+}
+
+int PubNubManager::publishInternal(const char* body) {
+  if (!WiFiManager::isConnected() || strlen(DEFAULT_PUBNUB_PUBLISH_KEY) == 0) {
+    return HTTPC_ERROR_NOT_CONNECTED;
+  }
+  
+  // POST : le message est dans le corps (pas de limite d'URL)
+  int httpCode = sendRequest(publishHttp, publishClient, publishUrl, body, 5000, publishStats);
+  publishHttp.end();
+  
+  if (httpCode != HTTP_CODE_OK) {
     Serial.print("[PUBNUB] Erreur publish: ");
     Serial.println(httpCode);
-    return false;
   }
+  return httpCode;
+}
+
+int PubNubManager::sendRequest(HTTPClient& http, WiFiClient& client, const char* url,
+                               const char* body, uint16_t timeoutMs, ConnectionStats& stats) {
+  unsigned long startTime = millis();
+  int httpCode = 0;
+  
+  for (int attempt = 0; attempt < 2; attempt++) {
+    bool reusing = client.connected();
+    
+    // begin() doit être rappelé à chaque requête (les en-têtes sont remis à zéro)
+    http.begin(client, url);
+    http.setReuse(true);  // Connection: keep-alive, le socket n'est pas fermé par end()
+    http.setConnectTimeout(2000);
+    http.setTimeout(timeoutMs);
+    if (body != nullptr) {
+      http.addHeader("Content-Type", "application/json");
+      httpCode = http.POST((uint8_t*)body, strlen(body));  // Sans copie dans un String
+    } else {
+      httpCode = http.GET();
+    }
+    
+    // Connexion impossible : aucune requête n'est partie
+    if (httpCode != HTTPC_ERROR_CONNECTION_REFUSED) {
+      stats.requests++;
+      if (reusing) {
+        stats.reused++;
+      } else {
+        stats.opened++;
+      }
+    }
+    
+    // Le serveur a fermé la connexion inactive entre deux requêtes : la requête
+    // n'a pas été traitée, la renvoyer sur une nouvelle connexion
+    bool staleConnection = reusing && (httpCode == HTTPC_ERROR_CONNECTION_LOST ||
+                                       httpCode == HTTPC_ERROR_SEND_HEADER_FAILED ||
+                                       httpCode == HTTPC_ERROR_SEND_PAYLOAD_FAILED ||
+                                       httpCode == HTTPC_ERROR_NOT_CONNECTED);
+    if (!staleConnection) {
+      break;
+    }
+    http.end();
+    client.stop();
+    stats.retried++;
+  }
+  
+  stats.lastRequestMs = millis() - startTime;
+  return httpCode;
+}
+
+void PubNubManager::closeConnections() {
+  subscribePending = false;
+  subscribeClient.stop();
+  publishClient.stop();
+}
+
+void PubNubManager::printConnectionStats(const char* label, const ConnectionStats& stats) {
+  Serial.printf("[PUBNUB] %s: %lu requetes, %lu sur connexion reutilisee, %lu connexions ouvertes, %lu renvois, derniere %lu ms\n",
+                label,
+                (unsigned long)stats.requests, (unsigned long)stats.reused,
+                (unsigned long)stats.opened, (unsigned long)stats.retried,
+                (unsigned long)stats.lastRequestMs);
 }
 
 bool PubNubManager::publishStatus() {
@@ -540,7 +1332,7 @@ bool PubNubManager::publishStatus() {
     WiFiManager::getLocalIP().c_str()
   );
   
-  return publish(statusJson);
+  return publish(statusJson, PUBLISH_PRIORITY_BACKGROUND);
 }
 
 void PubNubManager::printInfo() {
@@ -574,6 +1366,52 @@ void PubNubManager::printInfo() {
     Serial.println(" bytes");
   }
   
+  // Long poll
+  Serial.print("[PUBNUB] Subscribe en attente: ");
+  if (subscribePending) {
+    Serial.printf("Oui (depuis %lu s)\n", (millis() - subscribeSentTime) / 1000);
+  } else {
+    Serial.println("Non");
+  }
+  unsigned long metricsElapsed = millis() - metricsStartTime;
+  Serial.printf("[PUBNUB] Reveils du thread: %lu (%lu/heure)\n", (unsigned long)threadWakeups,
+                metricsElapsed > 0 ? (unsigned long)((uint64_t)threadWakeups * 3600000ULL / metricsElapsed) : 0UL);
+  Serial.printf("[PUBNUB] Long polls sans message: %lu (%lu/heure)\n", (unsigned long)emptyPolls,
+                metricsElapsed > 0 ? (unsigned long)((uint64_t)emptyPolls * 3600000ULL / metricsElapsed) : 0UL);
+  Serial.printf("[PUBNUB] Erreurs subscribe: %lu (backoff actuel %lu ms)\n",
+                (unsigned long)subscribeErrors, (unsigned long)retryDelayMs);
+  if (latencyCount > 0) {
+    Serial.printf("[PUBNUB] Latence de livraison mediane: %lu ms (%d mesures)\n",
+                  (unsigned long)getMedianDeliveryLatency(), latencyCount);
+  } else {
+    Serial.println("[PUBNUB] Latence de livraison: non mesuree (aucun message ou heure non synchronisee)");
+  }
+  
+  Serial.printf("[PUBNUB] Memoire JSON par poll: %lu octets (max %lu)\n",
+                (unsigned long)lastPollJsonPeak, (unsigned long)maxPollJsonPeak);
+  
+  // Connexions persistantes (keep-alive)
+  Serial.print("[PUBNUB] Serveur: ");
+  Serial.println(PUBNUB_ORIGIN);
+  printConnectionStats("Subscribe", subscribeStats);
+  printConnectionStats("Publish", publishStats);
+  
+  // Tampon de publication
+  portENTER_CRITICAL(&publishMux);
+  size_t pendingMessages = publishRing.count();
+  size_t pendingBytes = publishRing.used();
+  portEXIT_CRITICAL(&publishMux);
+  Serial.printf("[PUBNUB] Tampon de publication: %u messages en attente, %u/%u octets (max %u)\n",
+                (unsigned)pendingMessages, (unsigned)pendingBytes,
+                (unsigned)PUBLISH_RING_SIZE, (unsigned)publishRingPeak);
+  Serial.printf("[PUBNUB] Publications: %lu en file, %lu refusees (tampon plein), %lu trop longues, %lu en erreur\n",
+                (unsigned long)publishQueued, (unsigned long)publishQueueFull,
+                (unsigned long)publishTooLarge, (unsigned long)publishFailed);
+  Serial.printf("[PUBNUB] Regroupement: %lu messages envoyes en %lu requetes (%lu regroupees)\n",
+                (unsigned long)publishSent, (unsigned long)publishStats.requests,
+                (unsigned long)publishBatches);
+  PublishJournal::printInfo();
+  
   Serial.println("=================================");
 }
 
@@ -581,6 +1419,22 @@ const char* PubNubManager::getChannel() {
   return channel;
 }
 
+PubNubManager::ConnectionStats PubNubManager::getSubscribeStats() {
+  return subscribeStats;
+}
+
+PubNubManager::ConnectionStats PubNubManager::getPublishStats() {
+  return publishStats;
+}
+
+void PubNubManager::setCommandObserver(CommandObserver observer) {
+  commandObserver = observer;
+}
+
+void PubNubManager::keepMessageField(const char* field) {
+  messageFilter[field] = true;
+}
+
 #else // !HAS_PUBNUB
 
 // Implémentation vide si PubNub n'est pas disponible
@@ -591,12 +1445,17 @@ bool PubNubManager::isConnected() { return false; }
 bool PubNubManager::isInitialized() { return false; }
 bool PubNubManager::isAvailable() { return false; }
 void PubNubManager::loop() {}
-bool PubNubManager::publish(const char*) { return false; }
+bool PubNubManager::publish(const char*, PublishPriority) { return false; }
+bool PubNubManager::publishEvent(const char*) { return false; }
 bool PubNubManager::publishStatus() { return false; }
 void PubNubManager::printInfo() {
   Serial.println("[PUBNUB] PubNub non disponible sur ce modele");
 }
 const char* PubNubManager::getChannel() { return ""; }
+PubNubManager::ConnectionStats PubNubManager::getSubscribeStats() { return {}; }
+PubNubManager::ConnectionStats PubNubManager::getPublishStats() { return {}; }
+void PubNubManager::setCommandObserver(CommandObserver) {}
+void PubNubManager::keepMessageField(const char*) {}
 
 // Variables statiques
 bool PubNubManager::initialized = false;
@@ -605,6 +1464,5 @@ bool PubNubManager::threadRunning = false;
 char PubNubManager::channel[64] = "";
 char PubNubManager::timeToken[32] = "0";
 TaskHandle_t PubNubManager::taskHandle = nullptr;
-QueueHandle_t PubNubManager::publishQueue = nullptr;
 
 #endif // HAS_PUBNUB
@@ -2,8 +2,23 @@
 #define PUBNUB_MANAGER_H
 
 #include <Arduino.h>
+#include <ArduinoJson.h>
 #include "../../config/core_config.h"
 
+class HTTPClient;
+class WiFiClient;
+class PubNubResponseReader;
+
+/**
+ * Priorité d'une publication : délai maximal avant l'envoi
+ * Les messages publiés dans ce délai partent dans la même requête HTTP.
+ */
+enum PublishPriority {
+  PUBLISH_PRIORITY_CRITICAL,    // Réponse attendue par l'app : envoi immédiat
+  PUBLISH_PRIORITY_NORMAL,      // Groupé avec les messages des ~100 ms suivantes
+  PUBLISH_PRIORITY_BACKGROUND   // Statut périodique : peut attendre ~1 s
+};
+
 /**
  * Gestionnaire PubNub (Thread séparé sur Core 0)
  * 
@@ -15,6 +30,23 @@
  * - Tourne sur Core 0 (CORE_PUBNUB) avec le WiFi stack
  * - Priorité basse (PRIORITY_PUBNUB) car non critique en temps-réel
  * - Partage Core 0 avec WiFi pour minimiser les context switches réseau
+ * - Une connexion HTTP/1.1 persistante (keep-alive) par sens : subscribe et
+ *   publish réutilisent leur socket d'une requête à l'autre et ne rouvrent
+ *   une connexion (DNS + TCP) que lorsque le serveur l'a fermée
+ * - Subscribe en vrai long poll : le serveur garde la requête ouverte jusqu'à
+ *   un message ou ~280 s ; en cas d'erreur, nouvel essai avec backoff
+ *   exponentiel et jitter
+ * - Les réponses de subscribe sont analysées directement depuis le socket,
+ *   message par message, avec un filtre ArduinoJson : la mémoire d'un poll
+ *   est bornée par le plus gros message, pas par la taille du lot
+ * - Les messages à publier attendent dans un tampon circulaire d'octets
+ *   (longueur + message) ; l'URL et le corps sont construits dans des buffers
+ *   statiques : publish() n'alloue rien sur le tas
+ * - Les messages publiés dans une même fenêtre (selon leur priorité) partent
+ *   en une seule requête : {"type":"batch","messages":[...]} à partir de deux
+ * - Les événements (publishEvent) passent par un journal (SD, ou RAM sans
+ *   carte) et y restent jusqu'à leur acceptation par le serveur : envoyés par
+ *   lots, à débit limité, en ligne comme au retour de la connexion
  */
 
 class PubNubManager {
@@ -55,17 +87,30 @@ public:
   static bool isAvailable();
   
   /**
-   * Boucle de maintenance PubNub (appelée automatiquement par le thread)
-   * Ne fait rien si appelée manuellement - le thread gère tout
+   * Boucle de maintenance PubNub (loop principal)
+   * Le thread gère le réseau ; tant qu'il ne tourne pas, écrit sur la SD les
+   * événements du journal en attente en RAM
    */
   static void loop();
   
   /**
    * Publier un message sur le channel (thread-safe)
-   * @param message Le message à publier
-   * @return true si la publication réussit
+   * Le message est copié dans le tampon de publication, envoyé par le thread.
+   * @param message Le message à publier (PUBLISH_MESSAGE_MAX octets au plus)
+   * @param priority Délai maximal avant l'envoi (regroupement avec les suivants)
+   * @return true si le message a été mis en file, false si le tampon est plein
    */
-  static bool publish(const char* message);
+  static bool publish(const char* message, PublishPriority priority = PUBLISH_PRIORITY_NORMAL);
+  
+  /**
+   * Publier un événement qui ne doit pas être perdu (début/fin de routine...)
+   * L'événement est ajouté au journal et n'en sort qu'une fois accepté par le
+   * serveur (HTTP 200) : envoyé tout de suite en ligne, au retour de la
+   * connexion sinon, dans l'ordre.
+   * @param message Objet JSON sur une ligne, avec son heure : il peut partir bien plus tard
+   * @return false si le message est invalide
+   */
+  static bool publishEvent(const char* message);
   
   /**
    * Publier le statut du device
@@ -83,22 +128,114 @@ public:
    * @return Le nom du channel
    */
   static const char* getChannel();
+  
+  // Compteurs d'une connexion persistante
+  struct ConnectionStats {
+    uint32_t requests;       // Requêtes envoyées
+    uint32_t reused;         // Requêtes envoyées sur la connexion déjà ouverte
+    uint32_t opened;         // Connexions TCP ouvertes (DNS + handshake)
+    uint32_t retried;        // Connexion fermée par le serveur : requête renvoyée sur une nouvelle
+    uint32_t lastRequestMs;  // Durée de la dernière requête (envoi -> réponse)
+  };
+  
+  /**
+   * Compteurs des connexions subscribe et publish (réutilisation keep-alive)
+   * @return Copie des compteurs depuis le démarrage
+   */
+  static ConnectionStats getSubscribeStats();
+  static ConnectionStats getPublishStats();
+  
+  // Appelé après chaque commande JSON traitée par les routes : message reçu
+  // (champs racine conservés par le filtre) et durée du handler
+  typedef void (*CommandObserver)(JsonObject message, unsigned long handlerUs);
+  
+  /**
+   * Observer les commandes traitées (mesures, banc de test), nullptr pour arrêter
+   * Appelé depuis le thread PubNub : ne doit pas bloquer.
+   */
+  static void setCommandObserver(CommandObserver observer);
+  
+  /**
+   * Conserver un champ racine de plus dans les messages reçus (les champs
+   * inconnus des routes sont ignorés à la lecture), pour un observateur
+   * À appeler avant connect().
+   */
+  static void keepMessageField(const char* field);
 
 private:
   // Fonction du thread FreeRTOS
   static void threadFunction(void* parameter);
   
-  // Effectuer un subscribe (long polling)
-  static bool subscribe();
+  // Envoyer la requête de subscribe (long polling) sans attendre la réponse
+  static void startSubscribe();
+  
+  // Vérifier la requête en cours : réponse, fermeture ou timeout
+  static void pollSubscribe();
+  
+  // Lire la réponse HTTP du subscribe et traiter les messages
+  // @return Nombre de messages, -1 si la réponse est invalide
+  static int readSubscribeResponse();
   
-  // Traiter les messages reçus
-  static void processMessages(const char* json);
+  // Erreur de subscribe : prochain essai après backoff
+  static void subscribeFailed(const char* reason);
+  
+  // Délai jusqu'à la prochaine échéance (fenêtre de publication, lot du
+  // journal, subscribe), borné par WAIT_MAX_MS
+  static uint32_t nextWakeDelay();
+  
+  // Attendre une réponse du subscribe (select sur le socket), un réveil par
+  // publish() ou l'échéance
+  static void waitForActivity(uint32_t timeoutMs);
+  
+  // Réveiller le thread : notification et, s'il attend dans select(), signal local
+  static void wakeThread();
+  
+  // Latence de livraison (publication -> traitement) d'après le timetoken reçu
+  static void recordDeliveryLatency();
+  static uint32_t getMedianDeliveryLatency();
+  
+  /**
+   * Lire une réponse de subscribe ([[messages...],"timetoken"]) et traiter
+   * chaque message dès qu'il est lu
+   * @return Nombre de messages, -1 si la réponse est mal formée ou tronquée (timetoken inchangé)
+   */
+  static int processMessages(PubNubResponseReader& reader);
+  
+  // Traiter un message reçu (commande texte ou action JSON)
+  static void dispatchMessage(JsonVariant msg);
   
   // Exécuter une commande reçue
   static void executeCommand(const char* command);
   
   // Publication interne (appelée depuis le thread)
-  static bool publishInternal(const char* message);
+  // @param body Corps JSON à envoyer
+  // @return Code HTTP ou erreur HTTPC_ERROR_*
+  static int publishInternal(const char* body);
+  
+  // Envoyer les messages en attente dès que l'échéance de la fenêtre est atteinte
+  static void flushPublishRing();
+  
+  // Regrouper les messages en attente dans publishBody (autant que la taille le permet)
+  // @return Nombre de messages du corps, 0 si le tampon est vide
+  static int buildPublishBatch(const char*& body);
+  
+  // Publier un lot du journal (au plus une requête par JOURNAL_FLUSH_INTERVAL_MS)
+  static void flushJournal();
+  
+  /**
+   * Envoyer une requête sur une connexion persistante
+   * Si la connexion réutilisée a été fermée par le serveur entre deux requêtes,
+   * la requête est renvoyée une fois sur une nouvelle connexion.
+   * @param body Corps du POST, nullptr pour un GET
+   * @return Code HTTP ou erreur HTTPC_ERROR_*
+   */
+  static int sendRequest(HTTPClient& http, WiFiClient& client, const char* url,
+                         const char* body, uint16_t timeoutMs, ConnectionStats& stats);
+  
+  // Fermer les connexions persistantes (WiFi perdu, déconnexion)
+  static void closeConnections();
+  
+  static void printConnectionStats(const char* label, const ConnectionStats& stats);
   
   // Variables statiques
   static bool initialized;
@@ -108,15 +245,61 @@ private:
   static char timeToken[32];
   static TaskHandle_t taskHandle;
   
-  // File d'attente pour les messages à publier
-  static QueueHandle_t publishQueue;
+  // Tampon de publication : compteurs (messages refusés, occupation maximale)
+  static uint32_t publishQueued;
+  static uint32_t publishQueueFull;   // Tampon plein : message ignoré
+  static uint32_t publishTooLarge;    // Message plus long que PUBLISH_MESSAGE_MAX
+  static uint32_t publishFailed;      // Erreur HTTP à l'envoi
+  static size_t publishRingPeak;      // Octets occupés au maximum
+  static uint32_t publishBatches;     // Requêtes regroupant plusieurs messages
+  static uint32_t publishSent;        // Messages envoyés (toutes requêtes confondues)
+  static unsigned long publishDeadline;  // Envoi au plus tard (millis), si des messages attendent
+  static unsigned long nextJournalFlush; // Prochain lot du journal (millis)
+  
+  static ConnectionStats subscribeStats;
+  static ConnectionStats publishStats;
+  
+  // Mémoire JSON maximale d'un poll (octets) : dernier poll et maximum observé
+  static uint32_t lastPollJsonPeak;
+  static uint32_t maxPollJsonPeak;
+  
+  // Long poll en cours
+  static bool subscribePending;
+  static bool subscribeReused;        // Requête envoyée sur une connexion réutilisée
+  static bool subscribeHandshake;     // Timetoken 0 : réponse immédiate attendue
+  static unsigned long subscribeSentTime;
+  static unsigned long nextSubscribeTime;
+  static uint32_t retryDelayMs;       // Backoff courant (0 = pas d'erreur)
+  
+  // Métriques
+  static uint32_t subscribeErrors;
+  static uint32_t emptyPolls;         // Réponses sans message (fin du long poll)
+  static uint32_t threadWakeups;      // Tours de boucle du thread (réveils)
+  static unsigned long metricsStartTime;
+  static const int LATENCY_SAMPLE_COUNT = 15;
+  static uint32_t latencySamples[LATENCY_SAMPLE_COUNT];
+  static int latencyCount;
+  static int latencyIndex;
   
   // Configuration (centralisée dans core_config.h)
-  static const int SUBSCRIBE_INTERVAL_MS = 100;  // Intervalle entre les polls (le serveur garde la connexion)
+  static const uint32_t SUBSCRIBE_TIMEOUT_MS = 310000;  // Le serveur répond au plus tard après ~280 s
+  static const uint32_t WAIT_MAX_MS = 1000;             // Attente maximale (WiFi perdu, arrêt du thread)
+  static const uint32_t BACKOFF_MIN_MS = 1000;
+  static const uint32_t BACKOFF_MAX_MS = 60000;
+  static const long MIN_VALID_UNIX_TIME = 1600000000;     // Heure système synchronisée (NTP)
+  static const uint32_t MAX_LATENCY_SAMPLE_MS = 600000;   // Au-delà : horloges décalées
   static const int STACK_SIZE = STACK_SIZE_PUBNUB;
   static const int TASK_PRIORITY = PRIORITY_PUBNUB;
   static const int TASK_CORE = CORE_PUBNUB;      // Core 0 avec WiFi stack
-  static const int PUBLISH_QUEUE_SIZE = 5;       // Taille de la file de publication
+  
+public:
+  static const size_t PUBLISH_RING_SIZE = 2048;    // Tampon de publication (octets, en-têtes compris)
+  static const size_t PUBLISH_MESSAGE_MAX = 1024;  // Plus gros message publiable
+  static const size_t PUBLISH_BATCH_MAX = 1536;    // Corps d'une requête regroupée
+  static const uint32_t PUBLISH_WINDOW_NORMAL_MS = 100;
+  static const uint32_t PUBLISH_WINDOW_BACKGROUND_MS = 1000;
+  static const uint32_t JOURNAL_FLUSH_INTERVAL_MS = 500;   // Entre deux lots du journal
+  static const uint32_t JOURNAL_RETRY_MS = 10000;          // Après un échec d'envoi d'un lot
 };
 
 #endif // PUBNUB_MANAGER_H
@@ -0,0 +1,68 @@
+#include "pubnub_routes.h"
+
+// Nombre de passes sur toutes les actions de la table
+static const uint32_t BENCH_PASSES = 1000;
+static const size_t BENCH_MAX_ROUTES = 32;
+
+// Action absente : pire cas des deux recherches (toute la chaîne parcourue)
+static const char* BENCH_UNKNOWN_ACTION = "unknown-action";
+
+// Référence : parcours linéaire, comme l'ancienne chaîne de strcmp
+static const PubNubRoute* findLinear(const PubNubRoute* routes, size_t count, const char* name) {
+  for (size_t i = 0; i < count; i++) {
+    if (strcmp(routes[i].name, name) == 0) {
+      return &routes[i];
+    }
+  }
+  return nullptr;
+}
+
+void pubnubBenchmarkRoutes(const PubNubRoute* routes, size_t count) {
+  if (routes == nullptr || count == 0) {
+    Serial.println("[PUBNUB-BENCH] Table de routes vide");
+    return;
+  }
+  if (count > BENCH_MAX_ROUTES) {
+    count = BENCH_MAX_ROUTES;
+  }
+
+  // Les noms sont recopiés en RAM : la comparaison porte sur le contenu, pas sur le pointeur
+  static char names[BENCH_MAX_ROUTES + 1][32];
+  size_t namesBytes = 0;
+  for (size_t i = 0; i < count; i++) {
+    strncpy(names[i], routes[i].name, sizeof(names[i]) - 1);
+    names[i][sizeof(names[i]) - 1] = '\0';
+    namesBytes += strlen(routes[i].name) + 1;
+  }
+  strcpy(names[count], BENCH_UNKNOWN_ACTION);
+
+  uint32_t lookups = BENCH_PASSES * (count + 1);
+  volatile uintptr_t sink = 0;
+
+  unsigned long start = micros();
+  for (uint32_t pass = 0; pass < BENCH_PASSES; pass++) {
+    for (size_t i = 0; i <= count; i++) {
+      sink += (uintptr_t)findNamed(routes, count, names[i]);
+    }
+  }
+  unsigned long tableUs = micros() - start;
+
+  start = micros();
+  for (uint32_t pass = 0; pass < BENCH_PASSES; pass++) {
+    for (size_t i = 0; i <= count; i++) {
+      sink += (uintptr_t)findLinear(routes, count, names[i]);
+    }
+  }
+  unsigned long linearUs = micros() - start;
+  (void)sink;
+
+  Serial.printf("[PUBNUB-BENCH] %u actions (alias compris), %lu recherches\n",
+                (unsigned)count, (unsigned long)lookups);
+  Serial.printf("[PUBNUB-BENCH] Table triee (dichotomie): %lu ns/recherche\n",
+                (unsigned long)((uint64_t)tableUs * 1000 / lookups));
+  Serial.printf("[PUBNUB-BENCH] Chaine strcmp (lineaire): %lu ns/recherche\n",
+                (unsigned long)((uint64_t)linearUs * 1000 / lookups));
+  Serial.printf("[PUBNUB-BENCH] Empreinte flash de la table: %u octets (%u entrees + %u noms)\n",
+                (unsigned)(count * sizeof(PubNubRoute) + namesBytes),
+                (unsigned)(count * sizeof(PubNubRoute)), (unsigned)namesBytes);
+}
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "../../utils/name_table.h"
 
 /**
  * Interface pour les routes PubNub
@@ -15,7 +16,22 @@
  *   "action": "nom_action",
  *   "params": { ... }
  * }
+ * 
+ * Chaque modèle déclare ses actions dans une table constexpr triée par nom
+ * (alias compris) : le dispatch est une recherche dichotomique au lieu d'une
+ * chaîne de strcmp.
+ */
+
+// Handler d'une action : message complet en paramètre
+typedef bool (*PubNubRouteHandler)(const JsonObject& json);
+typedef NamedEntry<PubNubRouteHandler> PubNubRoute;
+
+/**
+ * Mesurer le coût du dispatch d'une table de routes (commande "pubnub-routes bench")
+ * Compare la recherche dichotomique au parcours linéaire équivalent à une
+ * chaîne de strcmp, et affiche l'empreinte de la table (entrées + noms).
  */
+void pubnubBenchmarkRoutes(const PubNubRoute* routes, size_t count);
 
 class PubNubRoutes {
 public:
@@ -2,6 +2,7 @@
 #include <SPI.h>
 #include <SD.h>
 #include <ArduinoJson.h>
+#include "../../utils/crc_utils.h"
 #include "../../../model_config.h"
 #include "../../config/core_config.h"
 
@@ -27,13 +28,16 @@ void SDManager::initDefaultConfig(SDConfig* config) {
   config->bedtime_brightness = 50;
   config->bedtime_allNight = false;
   strcpy(config->bedtime_effect, "none"); // Par défaut, couleur fixe
-  strcpy(config->bedtime_weekdaySchedule, "{}"); // JSON vide par défaut
+  scheduleReset(config->bedtime_schedule, DEFAULT_BEDTIME_HOUR); // Aucun jour activé
   // Valeurs par défaut pour wakeup (modèle Dream)
   config->wakeup_colorR = 255;
   config->wakeup_colorG = 200;
   config->wakeup_colorB = 100;
   config->wakeup_brightness = 50;
-  strcpy(config->wakeup_weekdaySchedule, "{}"); // JSON vide par défaut
+  scheduleReset(config->wakeup_schedule, DEFAULT_WAKEUP_HOUR); // Aucun jour activé
+  // Aucune synchronisation connue : la prochaine réponse de l'API sera appliquée
+  config->sync_etag[0] = '\0';
+  config->sync_hash = 0;
 }
 
 bool SDManager::init() {
@@ -54,6 +58,11 @@ bool SDManager::init() {
     }
   }
   
+  // Sauvegarde de config.json interrompue au dernier arrêt
+  if (cardAvailable) {
+    recoverAtomicWrite(CONFIG_FILE_PATH);
+  }
+  
   return cardAvailable;
 }
 
@@ -165,7 +174,7 @@ bool SDManager::configFileExists() {
   return SD.exists(CONFIG_FILE_PATH);
 }
 
-SDConfig SDManager::getConfig() {
+SDConfig SDManager::loadConfig() {
   // Initialiser avec les valeurs par défaut
   SDConfig config;
   SDManager::initDefaultConfig(&config);
@@ -192,8 +201,8 @@ SDConfig SDManager::getConfig() {
   }
   
   // Allouer un buffer pour lire le fichier
-  // Taille augmentée pour inclure weekdaySchedule (peut être volumineux avec 7 jours)
-  const size_t maxSize = 1536;
+  // Taille augmentée pour inclure weekdaySchedule (les 7 jours sont toujours écrits, ~400 octets par routine)
+  const size_t maxSize = 2048;
   if (fileSize > maxSize) {
     fileSize = maxSize;
   }
@@ -306,17 +315,9 @@ SDConfig SDManager::getConfig() {
     strcpy(config.bedtime_effect, "none");
   }
   
-  // Lire weekdaySchedule (JSON sérialisé)
-  if (doc["bedtime_weekdaySchedule"].is<String>()) {
-    String scheduleStr = doc["bedtime_weekdaySchedule"] | "{}";
-    strncpy(config.bedtime_weekdaySchedule, scheduleStr.c_str(), sizeof(config.bedtime_weekdaySchedule) - 1);
-    config.bedtime_weekdaySchedule[sizeof(config.bedtime_weekdaySchedule) - 1] = '\0';
-  } else if (doc["bedtime_weekdaySchedule"].is<JsonObject>()) {
-    // Si c'est un objet JSON, le sérialiser en string
-    String scheduleStr;
-    serializeJson(doc["bedtime_weekdaySchedule"], scheduleStr);
-    strncpy(config.bedtime_weekdaySchedule, scheduleStr.c_str(), sizeof(config.bedtime_weekdaySchedule) - 1);
-    config.bedtime_weekdaySchedule[sizeof(config.bedtime_weekdaySchedule) - 1] = '\0';
+  // Lire weekdaySchedule (objet JSON, ou string dans les anciens fichiers)
+  if (!scheduleFromJson(doc["bedtime_weekdaySchedule"], config.bedtime_schedule, DEFAULT_BEDTIME_HOUR)) {
+    Serial.println("[SD] bedtime_weekdaySchedule invalide, aucun jour active");
   }
   
   // Configuration wakeup (modèle Dream)
@@ -345,24 +346,25 @@ SDConfig SDManager::getConfig() {
     }
   }
   
-  // Lire weekdaySchedule wakeup (JSON sérialisé)
-  if (doc["wakeup_weekdaySchedule"].is<String>()) {
-    String scheduleStr = doc["wakeup_weekdaySchedule"] | "{}";
-    strncpy(config.wakeup_weekdaySchedule, scheduleStr.c_str(), sizeof(config.wakeup_weekdaySchedule) - 1);
-    config.wakeup_weekdaySchedule[sizeof(config.wakeup_weekdaySchedule) - 1] = '\0';
-  } else if (doc["wakeup_weekdaySchedule"].is<JsonObject>()) {
-    // Si c'est un objet JSON, le sérialiser en string
-    String scheduleStr;
-    serializeJson(doc["wakeup_weekdaySchedule"], scheduleStr);
-    strncpy(config.wakeup_weekdaySchedule, scheduleStr.c_str(), sizeof(config.wakeup_weekdaySchedule) - 1);
-    config.wakeup_weekdaySchedule[sizeof(config.wakeup_weekdaySchedule) - 1] = '\0';
+  // Lire weekdaySchedule wakeup (objet JSON, ou string dans les anciens fichiers)
+  if (!scheduleFromJson(doc["wakeup_weekdaySchedule"], config.wakeup_schedule, DEFAULT_WAKEUP_HOUR)) {
+    Serial.println("[SD] wakeup_weekdaySchedule invalide, aucun jour active");
+  }
+  
+  // Version de la dernière configuration reçue de l'API
+  if (doc["sync_etag"].is<const char*>()) {
+    strncpy(config.sync_etag, doc["sync_etag"] | "", sizeof(config.sync_etag) - 1);
+    config.sync_etag[sizeof(config.sync_etag) - 1] = '\0';
+  }
+  if (doc["sync_hash"].is<uint32_t>()) {
+    config.sync_hash = doc["sync_hash"].as<uint32_t>();
   }
   
   config.valid = true;
   return config;
 }
 
-bool SDManager::saveConfig(const SDConfig& config) {
+bool SDManager::saveConfig(const SDConfig& config, size_t* bytesWritten) {
   if (!isAvailable()) {
     return false;
   }
@@ -399,26 +401,8 @@ bool SDManager::saveConfig(const SDConfig& config) {
   doc["bedtime_allNight"] = config.bedtime_allNight;
   doc["bedtime_effect"] = config.bedtime_effect;
   
-  // Sauvegarder weekdaySchedule (JSON sérialisé)
-  // Essayer de parser le JSON pour valider qu'il est valide avant de le sauvegarder
-  if (strlen(config.bedtime_weekdaySchedule) > 0) {
-    // Parser le JSON pour valider qu'il est valide
-    #pragma GCC diagnostic push
-    #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-    StaticJsonDocument<512> scheduleDoc;
-    #pragma GCC diagnostic pop
-    DeserializationError error = deserializeJson(scheduleDoc, config.bedtime_weekdaySchedule);
-    if (!error) {
-      // JSON valide, le sauvegarder comme objet JSON dans le document
-      doc["bedtime_weekdaySchedule"] = scheduleDoc;
-    } else {
-      // JSON invalide, sauvegarder comme string brute
-      doc["bedtime_weekdaySchedule"] = config.bedtime_weekdaySchedule;
-    }
-  } else {
-    // Vide, sauvegarder un objet vide
-    doc["bedtime_weekdaySchedule"] = "{}";
-  }
+  // Sauvegarder weekdaySchedule (objet JSON, 7 jours)
+  scheduleToJson(config.bedtime_schedule, doc["bedtime_weekdaySchedule"].to<JsonObject>());
   
   // Configuration wakeup (modèle Dream)
   doc["wakeup_colorR"] = config.wakeup_colorR;
@@ -426,35 +410,146 @@ bool SDManager::saveConfig(const SDConfig& config) {
   doc["wakeup_colorB"] = config.wakeup_colorB;
   doc["wakeup_brightness"] = config.wakeup_brightness;
   
-  // Sauvegarder weekdaySchedule wakeup (JSON sérialisé)
-  if (strlen(config.wakeup_weekdaySchedule) > 0) {
-    // Parser le JSON pour valider qu'il est valide
-    #pragma GCC diagnostic push
-    #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-    StaticJsonDocument<512> scheduleDoc;
-    #pragma GCC diagnostic pop
-    DeserializationError error = deserializeJson(scheduleDoc, config.wakeup_weekdaySchedule);
-    if (!error) {
-      // JSON valide, le sauvegarder comme objet JSON dans le document
-      doc["wakeup_weekdaySchedule"] = scheduleDoc;
-    } else {
-      // JSON invalide, sauvegarder comme string brute
-      doc["wakeup_weekdaySchedule"] = config.wakeup_weekdaySchedule;
-    }
-  } else {
-    // Vide, sauvegarder un objet vide
-    doc["wakeup_weekdaySchedule"] = "{}";
+  // Sauvegarder weekdaySchedule wakeup (objet JSON, 7 jours)
+  scheduleToJson(config.wakeup_schedule, doc["wakeup_weekdaySchedule"].to<JsonObject>());
+  
+  // Version de la dernière configuration reçue de l'API
+  if (strlen(config.sync_etag) > 0) {
+    doc["sync_etag"] = config.sync_etag;
+  }
+  if (config.sync_hash != 0) {
+    doc["sync_hash"] = config.sync_hash;
   }
   
-  // Ouvrir le fichier en mode écriture (crée le fichier s'il n'existe pas)
-  File configFile = SD.open(CONFIG_FILE_PATH, FILE_WRITE);
-  if (!configFile) {
+  // Sérialiser en RAM puis remplacer config.json d'un coup (jamais de fichier à moitié écrit)
+  String json;
+  serializeJson(doc, json);
+  if (bytesWritten != nullptr) {
+    *bytesWritten = json.length();
+  }
+  
+  return writeFileAtomic(CONFIG_FILE_PATH, (const uint8_t*)json.c_str(), json.length());
+}
+
+// Taille et CRC32 du contenu d'un fichier
+static bool readFileCrc(const char* path, size_t& length, uint32_t& crc) {
+  File file = SD.open(path, FILE_READ);
+  if (!file) {
+    return false;
+  }
+  uint8_t chunk[128];
+  size_t count;
+  length = 0;
+  crc = 0;
+  while ((count = file.read(chunk, sizeof(chunk))) > 0) {
+    crc = crc32Update(crc, chunk, count);
+    length += count;
+  }
+  file.close();
+  return true;
+}
+
+// Empreinte du fichier temporaire vérifié, écrite à côté (<path>.crc)
+struct AtomicWriteCheck {
+  uint32_t length;
+  uint32_t crc;
+};
+
+bool SDManager::writeFileAtomic(const char* path, const uint8_t* data, size_t length) {
+  if (!isAvailable() || length == 0) {
     return false;
   }
   
-  // Sérialiser le JSON dans le fichier
-  size_t bytesWritten = serializeJson(doc, configFile);
-  configFile.close();
+  char tmpPath[64];
+  char crcPath[64];
+  snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+  snprintf(crcPath, sizeof(crcPath), "%s.crc", path);
+  
+  File file = SD.open(tmpPath, FILE_WRITE);
+  if (!file) {
+    return false;
+  }
+  size_t written = file.write(data, length);
+  file.flush();
+  file.close();
+  if (written != length) {
+    SD.remove(tmpPath);
+    return false;
+  }
+  
+  // Relire le fichier temporaire : il doit être identique aux données (CRC32)
+  AtomicWriteCheck check = {(uint32_t)length, crc32Update(0, data, length)};
+  size_t total;
+  uint32_t crc;
+  if (!readFileCrc(tmpPath, total, crc) || total != length || crc != check.crc) {
+    Serial.printf("[SD] Verification de %s echouee, ancien fichier conserve\n", tmpPath);
+    SD.remove(tmpPath);
+    return false;
+  }
   
-  return (bytesWritten > 0);
+  // Empreinte du fichier vérifié : au démarrage, seul un fichier temporaire
+  // qui lui correspond peut remplacer un fichier manquant
+  file = SD.open(crcPath, FILE_WRITE);
+  if (!file) {
+    SD.remove(tmpPath);
+    return false;
+  }
+  written = file.write((const uint8_t*)&check, sizeof(check));
+  file.flush();
+  file.close();
+  if (written != sizeof(check)) {
+    SD.remove(crcPath);
+    SD.remove(tmpPath);
+    return false;
+  }
+  
+  // Remplacer l'ancien fichier (FAT : rename ne remplace pas un fichier existant)
+  // Une coupure entre remove et rename laisse le fichier temporaire vérifié, repris au démarrage
+  if (SD.exists(path) && !SD.remove(path)) {
+    SD.remove(crcPath);
+    SD.remove(tmpPath);
+    return false;
+  }
+  bool renamed = SD.rename(tmpPath, path);
+  SD.remove(crcPath);
+  return renamed;
+}
+
+void SDManager::recoverAtomicWrite(const char* path) {
+  char tmpPath[64];
+  char crcPath[64];
+  snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+  snprintf(crcPath, sizeof(crcPath), "%s.crc", path);
+  if (!SD.exists(tmpPath)) {
+    SD.remove(crcPath);
+    return;
+  }
+  
+  if (SD.exists(path)) {
+    // Coupure avant le remplacement : l'ancien fichier est intact
+    SD.remove(tmpPath);
+    SD.remove(crcPath);
+    Serial.printf("[SD] Ecriture de %s interrompue, ancien fichier conserve\n", path);
+    return;
+  }
+  
+  // Pas d'ancien fichier (coupure entre remove et rename, ou première écriture
+  // sur une carte neuve) : le fichier temporaire n'est repris que s'il
+  // correspond à l'empreinte écrite après sa vérification
+  AtomicWriteCheck check = {0, 0};
+  File file = SD.open(crcPath, FILE_READ);
+  bool checked = file && file.read((uint8_t*)&check, sizeof(check)) == sizeof(check);
+  if (file) {
+    file.close();
+  }
+  size_t length;
+  uint32_t crc;
+  if (checked && readFileCrc(tmpPath, length, crc) && length == check.length && crc == check.crc &&
+      SD.rename(tmpPath, path)) {
+    Serial.printf("[SD] Ecriture de %s terminee au demarrage\n", path);
+  } else {
+    SD.remove(tmpPath);
+    Serial.printf("[SD] Fichier temporaire de %s invalide (ecriture interrompue), ignore\n", path);
+  }
+  SD.remove(crcPath);
 }
@@ -2,6 +2,7 @@
 #define SD_MANAGER_H
 
 #include <Arduino.h>
+#include "../../utils/schedule_utils.h"
 
 /**
  * Gestionnaire de carte SD
@@ -24,13 +25,16 @@ struct SDConfig {
   uint8_t bedtime_brightness; // Luminosité pour bedtime (0-100)
   bool bedtime_allNight;    // Veilleuse toute la nuit
   char bedtime_effect[32];  // Effet LED pour bedtime ("none", "pulse", "rainbow-soft", "breathe", "nightlight", etc.)
-  char bedtime_weekdaySchedule[512]; // Schedule par jour (JSON sérialisé: {"monday":{"hour":20,"minute":0,"activated":true},...})
+  WeekdaySchedule bedtime_schedule; // Horaire par jour (JSON "bedtime_weekdaySchedule" dans config.json)
   // Configuration wakeup (modèle Dream uniquement)
   uint8_t wakeup_colorR;    // Couleur R pour wakeup (0-255)
   uint8_t wakeup_colorG;   // Couleur G pour wakeup (0-255)
   uint8_t wakeup_colorB;   // Couleur B pour wakeup (0-255)
   uint8_t wakeup_brightness; // Luminosité pour wakeup (0-100)
-  char wakeup_weekdaySchedule[512]; // Schedule par jour (JSON sérialisé: {"monday":{"hour":7,"minute":30,"activated":true},...})
+  WeekdaySchedule wakeup_schedule;  // Horaire par jour (JSON "wakeup_weekdaySchedule" dans config.json)
+  // Synchronisation avec l'API (modèle Dream) : version de la dernière réponse appliquée
+  char sync_etag[64];       // ETag renvoyé par l'API ("" = inconnu)
+  uint32_t sync_hash;       // CRC32 du corps de la réponse (0 = inconnu)
   // Note: MQTT est configuré dans default_config.h (pas sur SD)
 };
 
@@ -54,8 +58,8 @@ public:
   // Obtenir l'espace utilisé (en octets)
   static uint64_t getUsedSpace();
   
-  // Lire la configuration depuis config.json
-  static SDConfig getConfig();
+  // Lire la configuration depuis config.json (au démarrage, voir ConfigManager)
+  static SDConfig loadConfig();
   
   // Vérifier si le fichier config.json existe
   static bool configFileExists();
@@ -63,12 +67,30 @@ public:
   // Initialiser une configuration avec les valeurs par défaut
   static void initDefaultConfig(SDConfig* config);
   
-  // Sauvegarder la configuration dans config.json
-  static bool saveConfig(const SDConfig& config);
+  /**
+   * Sauvegarder la configuration dans config.json (écriture atomique, voir writeFileAtomic)
+   * @param bytesWritten Taille du fichier écrit (optionnel)
+   */
+  static bool saveConfig(const SDConfig& config, size_t* bytesWritten = nullptr);
+
+  /**
+   * Remplacer un fichier sans risque de le corrompre en cas de coupure
+   * Les données sont écrites dans <path>.tmp, relues et vérifiées (CRC32),
+   * l'empreinte vérifiée est écrite dans <path>.crc, puis le fichier
+   * temporaire remplace l'ancien (rename).
+   * Une coupure laisse soit l'ancien fichier, soit le nouveau (repris au
+   * démarrage par recoverAtomicWrite s'il correspond à son empreinte).
+   * @return false si l'écriture ou la vérification échoue (ancien fichier intact)
+   */
+  static bool writeFileAtomic(const char* path, const uint8_t* data, size_t length);
 
 private:
   // Initialiser la carte SD avec les pins configurés
   static bool initSDCard();
+
+  // Terminer ou annuler un writeFileAtomic interrompu par une coupure
+  // (un fichier temporaire sans empreinte valide est supprimé)
+  static void recoverAtomicWrite(const char* path);
   
   // Variables statiques
   static bool initialized;
@@ -1,8 +1,16 @@
 #include "serial_commands.h"
 #include "serial_manager.h"
 #include "../led/led_manager.h"
+#include "../led/led_names.h"
+#include "../led/led_latency.h"
+#ifdef HAS_LED
+#include "../led/effects/led_effect_bench.h"
+#endif
 #include "../init/init_manager.h"
 #include "../sd/sd_manager.h"
+#include "../config/config_manager.h"
+#include "../config/config_snapshot.h"
+#include "../log/log_manager.h"
 #include <SD.h>
 #include <ArduinoJson.h>
 #include "../ble/ble_manager.h"
@@ -54,6 +62,7 @@ void SerialCommands::update() {
     
     if (c == '\n' || c == '\r') {
       if (inputBuffer.length() > 0) {
+        LEDLatencyScope latencyScope(LED_SOURCE_SERIAL);
         processCommand(inputBuffer);
         inputBuffer = "";
       }
@@ -127,7 +136,7 @@ void SerialCommands::processCommand(const String& command) {
   } else if (cmd == "pubnub-publish" || cmd == "pubnub-pub") {
     cmdPubNubPublish(args);
   } else if (cmd == "pubnub-routes" || cmd == "routes") {
-    cmdPubNubRoutes();
+    cmdPubNubRoutes(args);
   #endif
   } else if (cmd == "rtc" || cmd == "time" || cmd == "date") {
     cmdRTC();
@@ -149,9 +158,25 @@ void SerialCommands::processCommand(const String& command) {
     cmdConfigSet(args);
   } else if (cmd == "config-list" || cmd == "cfg-list" || cmd == "config") {
     cmdConfigList();
+  } else if (cmd == "config-stats" || cmd == "cfg-stats") {
+    cmdConfigStats();
+  } else if (cmd == "log-stats" || cmd == "logstats") {
+    cmdLogStats();
   #ifdef HAS_LED
   } else if (cmd == "led-test" || cmd == "test-led" || cmd == "testleds") {
     cmdLEDTest();
+  } else if (cmd == "led-stats" || cmd == "ledstats") {
+    cmdLEDStats(args);
+  } else if (cmd == "led-latency" || cmd == "latency") {
+    cmdLEDLatency(args);
+  } else if (cmd == "led-bench" || cmd == "ledbench") {
+    cmdLEDBench(args);
+  } else if (cmd == "led-anim" || cmd == "ledanim") {
+    cmdLEDAnimation(args);
+  } else if (cmd == "led-effect" || cmd == "effect") {
+    cmdLEDEffect(args);
+  } else if (cmd == "led-color" || cmd == "color") {
+    cmdLEDColor(args);
   #endif
   #ifdef HAS_AUDIO
   } else if (cmd == "audio" || cmd == "audio-status") {
@@ -197,6 +222,14 @@ void SerialCommands::printHelp() {
     Serial.println("  brightness [%]   - Afficher ou definir la luminosite (0-100%)");
     Serial.println("  sleep [timeout]  - Afficher ou definir le timeout sleep mode (ms, min: 5000, 0=desactive)");
     Serial.println("  led-test         - Tester les LEDs une par une puis toutes en rouge");
+    Serial.println("  led-stats [reset] - Statistiques LED (trames, commandes fusionnees, histogrammes duree/gigue)");
+    Serial.println("  led-latency [reset] - Latence commande -> LED par source (pubnub, ble, serie, potentiometre)");
+    Serial.println("  led-bench [n]    - Mesurer le rendu des effets (ns/trame, 16-300 LEDs) et verifier les trames de reference");
+    Serial.println("  led-effect <nom|off> - Appliquer un effet LED par son nom");
+    Serial.println("  led-color <nom|#RRGGBB> - Appliquer une couleur LED par son nom ou en hexa");
+    #ifdef HAS_LED_EFFECT_ANIMATION
+    Serial.println("  led-anim <chemin> - Jouer une animation keyframes depuis la SD (ex: /animations/etoiles.kan)");
+    #endif
   }
   #endif
   
@@ -221,7 +254,7 @@ void SerialCommands::printHelp() {
     Serial.println("  pubnub-connect   - Se connecter a PubNub");
     Serial.println("  pubnub-disconnect - Se deconnecter de PubNub");
     Serial.println("  pubnub-pub <msg> - Publier un message");
-    Serial.println("  pubnub-routes    - Afficher les routes PubNub disponibles");
+    Serial.println("  pubnub-routes [bench] - Afficher les routes PubNub (bench: mesurer la recherche d'action)");
   }
   #endif
   
@@ -249,6 +282,8 @@ void SerialCommands::printHelp() {
   Serial.println("  config-list, config - Afficher toutes les cles de config.json");
   Serial.println("  config-get <key>   - Lire une cle de config.json");
   Serial.println("  config-set <key> <value> - Definir une cle dans config.json");
+  Serial.println("  config-stats       - Configuration en RAM (generation, sauvegardes, duree SD)");
+  Serial.println("  log-stats          - Logs d'erreur SD (tampon, ecritures, rotations)");
   
   #ifdef HAS_AUDIO
   if (HAS_AUDIO) {
@@ -328,10 +363,11 @@ void SerialCommands::cmdBrightness(const String& args) {
     
     if (LEDManager::setBrightness(brightness)) {
       // Mettre à jour et sauvegarder la configuration
-      SDConfig config = InitManager::getConfig();
-      config.led_brightness = brightness;
+      bool saved = ConfigManager::update([brightness](SDConfig& config) {
+        config.led_brightness = brightness;
+      });
       
-      if (SDManager::isAvailable() && InitManager::updateConfig(config)) {
+      if (saved) {
         Serial.print("[SERIAL] Luminosite definie a: ");
         Serial.print(percent);
         Serial.println("% (sauvegarde dans config.json)");
@@ -359,7 +395,7 @@ void SerialCommands::cmdSleep(const String& args) {
   
   if (args.length() == 0) {
     // Afficher le timeout actuel du sleep mode
-    const SDConfig& config = InitManager::getConfig();
+    const SDConfig& config = ConfigManager::get();
     uint32_t timeout = config.sleep_timeout_ms;
     
     Serial.print("[SERIAL] Sleep mode timeout: ");
@@ -392,12 +428,13 @@ void SerialCommands::cmdSleep(const String& args) {
     }
     
     // Mettre à jour le sleep timeout dans la configuration
-    SDConfig config = InitManager::getConfig();
-    config.sleep_timeout_ms = (uint32_t)timeout;
+    bool saved = ConfigManager::update([timeout](SDConfig& config) {
+      config.sleep_timeout_ms = (uint32_t)timeout;
+    });
     
-    if (SDManager::isAvailable() && InitManager::updateConfig(config)) {
+    if (saved) {
       // Mettre à jour le timeout dans LEDManager
-      // Note: LEDManager lit sleepTimeoutMs depuis InitManager::getConfig() au démarrage
+      // Note: LEDManager lit sleepTimeoutMs depuis ConfigManager::get() au démarrage
       // Pour le runtime, on devrait ajouter une méthode setSleepTimeout() dans LEDManager
       // Pour l'instant, il faudra redémarrer pour que le changement prenne effet
       Serial.print("[SERIAL] Sleep timeout defini a: ");
@@ -515,14 +552,15 @@ void SerialCommands::cmdWiFiSet(const String& args) {
   }
   
   // Mettre à jour la configuration
-  SDConfig config = InitManager::getConfig();
-  strncpy(config.wifi_ssid, ssid.c_str(), sizeof(config.wifi_ssid) - 1);
-  config.wifi_ssid[sizeof(config.wifi_ssid) - 1] = '\0';
-  strncpy(config.wifi_password, password.c_str(), sizeof(config.wifi_password) - 1);
-  config.wifi_password[sizeof(config.wifi_password) - 1] = '\0';
-  
-  // Sauvegarder
-  if (SDManager::isAvailable() && InitManager::updateConfig(config)) {
+  bool saved = ConfigManager::update([&ssid, &password](SDConfig& config) {
+    strncpy(config.wifi_ssid, ssid.c_str(), sizeof(config.wifi_ssid) - 1);
+    config.wifi_ssid[sizeof(config.wifi_ssid) - 1] = '\0';
+    strncpy(config.wifi_password, password.c_str(), sizeof(config.wifi_password) - 1);
+    config.wifi_password[sizeof(config.wifi_password) - 1] = '\0';
+  });
+  
+  // Sauvegardée sur la SD
+  if (saved) {
     Serial.println("[WIFI] Configuration WiFi sauvegardee:");
     Serial.print("[WIFI]   SSID: ");
     Serial.println(ssid);
@@ -663,12 +701,16 @@ void SerialCommands::cmdPubNubPublish(const String& args) {
 #endif
 }
 
-void SerialCommands::cmdPubNubRoutes() {
+void SerialCommands::cmdPubNubRoutes(const String& args) {
 #ifndef HAS_PUBNUB
   Serial.println("[PUBNUB] PubNub non disponible sur ce modele");
   return;
 #else
-  ModelPubNubRoutes::printRoutes();
+  if (args == "bench") {
+    ModelPubNubRoutes::benchmarkRoutes();
+  } else {
+    ModelPubNubRoutes::printRoutes();
+  }
 #endif
 }
 
@@ -1152,6 +1194,9 @@ void SerialCommands::cmdConfigList() {
     return;
   }
   
+  // Lire le fichier à jour (sauvegarde différée en attente écrite d'abord)
+  ConfigManager::flush();
+  
   if (!SDManager::configFileExists()) {
     Serial.println("[CONFIG] Fichier config.json non trouve");
     return;
@@ -1236,6 +1281,9 @@ void SerialCommands::cmdConfigGet(const String& args) {
     return;
   }
   
+  // Lire le fichier à jour (sauvegarde différée en attente écrite d'abord)
+  ConfigManager::flush();
+  
   if (args.length() == 0) {
     Serial.println("[CONFIG] Usage: config-get <key>");
     #ifdef HAS_PUBNUB
@@ -1325,6 +1373,9 @@ void SerialCommands::cmdConfigSet(const String& args) {
     return;
   }
   
+  // Lire le fichier à jour (sauvegarde différée en attente écrite d'abord)
+  ConfigManager::flush();
+  
   if (args.length() == 0) {
     Serial.println("[CONFIG] Usage: config-set <key> <value>");
     Serial.println("[CONFIG] Exemples:");
@@ -1441,23 +1492,30 @@ void SerialCommands::cmdConfigSet(const String& args) {
     Serial.println(" (string)");
   }
   
-  // Sauvegarder le fichier
-  File configFile = SD.open("/config.json", FILE_WRITE);
-  if (!configFile) {
-    Serial.println("[CONFIG] Erreur: impossible d'ouvrir config.json en ecriture");
-    return;
-  }
+  // Sauvegarder le fichier (image binaire supprimée avant : réimport si coupure)
+  ConfigSnapshot::invalidate();
+  String json;
+  serializeJson(doc, json);
   
-  size_t bytesWritten = serializeJson(doc, configFile);
-  configFile.close();
-  
-  if (bytesWritten > 0) {
+  if (SDManager::writeFileAtomic("/config.json", (const uint8_t*)json.c_str(), json.length())) {
     Serial.println("[CONFIG] Sauvegarde OK");
+    // Fichier modifié directement : mettre à jour la configuration en RAM
+    ConfigManager::reload();
   } else {
     Serial.println("[CONFIG] Erreur lors de la sauvegarde");
   }
 }
 
+void SerialCommands::cmdConfigStats() {
+  ConfigManager::printStats();
+  Serial.printf("[CONFIG] Pile libre (tache courante): %u octets\n",
+                (unsigned)uxTaskGetStackHighWaterMark(nullptr));
+}
+
+void SerialCommands::cmdLogStats() {
+  LogManager::printStats();
+}
+
 // ============================================
 // Commandes Audio
 // ============================================
@@ -1638,3 +1696,113 @@ void SerialCommands::cmdLEDTest() {
   Serial.println("[LED-TEST] LEDs non disponibles sur ce modele");
 #endif
 }
+
+void SerialCommands::cmdLEDStats(const String& args) {
+#ifdef HAS_LED
+  if (!LEDManager::isInitialized()) {
+    Serial.println("[LED] LED Manager non initialise");
+    return;
+  }
+  
+  LEDManager::printStats(args == "reset");
+#else
+  Serial.println("[LED] LEDs non disponibles sur ce modele");
+#endif
+}
+
+void SerialCommands::cmdLEDLatency(const String& args) {
+#ifdef HAS_LED
+  LEDLatency::printStats(args == "reset");
+#else
+  Serial.println("[LED] LEDs non disponibles sur ce modele");
+#endif
+}
+
+void SerialCommands::cmdLEDBench(const String& args) {
+#ifdef HAS_LED
+  // Nombre de trames par taille de bande (200 par défaut)
+  long frames = 200;
+  if (args.length() > 0) {
+    frames = args.toInt();
+    if (frames <= 0 || frames > 10000) {
+      Serial.println("[LED-BENCH] Nombre de trames invalide (1-10000)");
+      return;
+    }
+  }
+  
+  LEDEffectBench::run((uint32_t)frames);
+#else
+  Serial.println("[LED-BENCH] LEDs non disponibles sur ce modele");
+#endif
+}
+
+void SerialCommands::cmdLEDAnimation(const String& args) {
+#ifdef HAS_LED_EFFECT_ANIMATION
+  if (!LEDManager::isInitialized()) {
+    Serial.println("[LED] LED Manager non initialise");
+    return;
+  }
+  if (args.length() == 0) {
+    Serial.println("[LED-ANIM] Usage: led-anim <chemin>");
+    return;
+  }
+  
+  if (LEDManager::playAnimation(args.c_str())) {
+    Serial.printf("[LED-ANIM] Lecture de %s\n", args.c_str());
+  }
+#else
+  Serial.println("[LED-ANIM] Animations non disponibles sur ce modele");
+#endif
+}
+
+void SerialCommands::cmdLEDEffect(const String& args) {
+#ifdef HAS_LED
+  if (!LEDManager::isInitialized()) {
+    Serial.println("[LED] LED Manager non initialise");
+    return;
+  }
+  if (args.length() == 0) {
+    Serial.println("[LED] Usage: led-effect <nom|off>");
+    ledPrintEffectNames();
+    return;
+  }
+  
+  if (args == "off") {
+    LEDManager::clear();
+    Serial.println("[LED] LEDs eteintes");
+    return;
+  }
+  
+  LEDEffect effect;
+  if (!ledEffectFromName(args.c_str(), effect)) {
+    Serial.printf("[LED] Effet inconnu: %s\n", args.c_str());
+    ledPrintEffectNames();
+    return;
+  }
+  LEDManager::setEffect(effect);
+  Serial.printf("[LED] Effet applique: %s\n", args.c_str());
+#endif
+}
+
+void SerialCommands::cmdLEDColor(const String& args) {
+#ifdef HAS_LED
+  if (!LEDManager::isInitialized()) {
+    Serial.println("[LED] LED Manager non initialise");
+    return;
+  }
+  if (args.length() == 0) {
+    Serial.println("[LED] Usage: led-color <nom|#RRGGBB>");
+    ledPrintColorNames();
+    return;
+  }
+  
+  uint8_t r, g, b;
+  if (!ledColorFromName(args.c_str(), r, g, b)) {
+    Serial.printf("[LED] Couleur inconnue: %s\n", args.c_str());
+    ledPrintColorNames();
+    return;
+  }
+  LEDManager::setColor(r, g, b);
+  Serial.printf("[LED] Couleur appliquee: RGB(%d, %d, %d)\n", r, g, b);
+#endif
+}
@@ -52,7 +52,7 @@ private:
   static void cmdPubNubConnect();
   static void cmdPubNubDisconnect();
   static void cmdPubNubPublish(const String& args);
-  static void cmdPubNubRoutes();
+  static void cmdPubNubRoutes(const String& args);
   static void cmdRTC();
   static void cmdRTCSet(const String& args);
   static void cmdRTCSync();
@@ -63,7 +63,15 @@ private:
   static void cmdConfigGet(const String& args);
   static void cmdConfigSet(const String& args);
   static void cmdConfigList();
+  static void cmdConfigStats();
+  static void cmdLogStats();
   static void cmdLEDTest();
+  static void cmdLEDStats(const String& args);
+  static void cmdLEDLatency(const String& args);
+  static void cmdLEDBench(const String& args);
+  static void cmdLEDAnimation(const String& args);
+  static void cmdLEDEffect(const String& args);
+  static void cmdLEDColor(const String& args);
   
   // Commandes audio
   static void cmdAudio();
@@ -1,5 +1,6 @@
 #include "serial_manager.h"
 #include "../log/log_manager.h"
+#include "../config/config_manager.h"
 #include <esp_system.h>
 #include <esp_heap_caps.h>
 #include <cstdarg>
@@ -33,6 +34,10 @@ void SerialManager::reboot(uint32_t delayMs) {
   Serial.println("[SERIAL] Redemarrage de l'ESP32...");
   Serial.flush();
   
+  // Sauvegarde de configuration et logs d'erreur encore en attente (écriture différée)
+  ConfigManager::flush();
+  LogManager::flush();
+  
   // Redémarrer l'ESP32
   esp_restart();
 }
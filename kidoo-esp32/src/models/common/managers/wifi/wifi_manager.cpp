@@ -3,6 +3,7 @@
 #include "../../config/core_config.h"
 #include "../init/init_manager.h"
 #include "../sd/sd_manager.h"
+#include "../config/config_manager.h"
 
 #ifdef HAS_WIFI
 #include <WiFi.h>
@@ -32,6 +33,18 @@ TaskHandle_t WiFiManager::retryTaskHandle = nullptr;
 bool WiFiManager::retryThreadRunning = false;
 unsigned long WiFiManager::retryStartTime = 0;
 
+#ifdef HAS_WIFI
+// Copier SSID et mot de passe de la configuration (tampons de la taille de SDConfig)
+static void copyCredentials(char* ssid, char* password) {
+  ConfigManager::read([&](const SDConfig& config) {
+    strncpy(ssid, config.wifi_ssid, sizeof(config.wifi_ssid) - 1);
+    ssid[sizeof(config.wifi_ssid) - 1] = '\0';
+    strncpy(password, config.wifi_password, sizeof(config.wifi_password) - 1);
+    password[sizeof(config.wifi_password) - 1] = '\0';
+  });
+}
+#endif
+
 bool WiFiManager::init() {
   if (initialized) {
     return available;
@@ -77,20 +90,22 @@ bool WiFiManager::connect() {
     return false;
   }
   
-  // Récupérer la config depuis InitManager
-  const SDConfig& config = InitManager::getConfig();
+  // Copier les identifiants : la connexion bloque jusqu'au timeout
+  char ssid[sizeof(SDConfig::wifi_ssid)];
+  char password[sizeof(SDConfig::wifi_password)];
+  copyCredentials(ssid, password);
   
   // Vérifier si les identifiants WiFi sont configurés
-  if (strlen(config.wifi_ssid) == 0) {
+  if (strlen(ssid) == 0) {
     Serial.println("[WIFI] Aucun SSID configure dans config.json");
     connectionStatus = WIFI_STATUS_DISCONNECTED;
     return false;
   }
   
   Serial.print("[WIFI] Connexion au reseau: ");
-  Serial.println(config.wifi_ssid);
+  Serial.println(ssid);
   
-  return connect(config.wifi_ssid, config.wifi_password, DEFAULT_CONNECT_TIMEOUT_MS);
+  return connect(ssid, password, DEFAULT_CONNECT_TIMEOUT_MS);
 #endif
 }
 
@@ -324,7 +339,7 @@ void WiFiManager::startRetryThread() {
   }
   
   // Vérifier qu'il y a un SSID configuré
-  const SDConfig& config = InitManager::getConfig();
+  const SDConfig& config = ConfigManager::get();
   if (strlen(config.wifi_ssid) == 0) {
     Serial.println("[WIFI] Pas de SSID configure, retry impossible");
     return;
@@ -384,7 +399,8 @@ void WiFiManager::retryThreadFunction(void* parameter) {
 #ifdef HAS_WIFI
   Serial.println("[WIFI-RETRY] Thread actif");
   
-  const SDConfig& config = InitManager::getConfig();
+  char ssid[sizeof(SDConfig::wifi_ssid)];
+  char password[sizeof(SDConfig::wifi_password)];
   uint32_t retryDelay = RETRY_INITIAL_DELAY_MS; // Commence à 5 secondes
   int attemptCount = 0;
   
@@ -428,9 +444,11 @@ void WiFiManager::retryThreadFunction(void* parameter) {
     Serial.print(retryDelay / 1000);
     Serial.println("s)");
     
-    // Utiliser connect() avec les paramètres de la config
+    // Utiliser connect() avec les paramètres de la config, relus à chaque tentative
+    // (BLE peut les changer entre deux essais)
     // Cette méthode va bloquer jusqu'à 15 secondes (timeout)
-    if (WiFiManager::connect(config.wifi_ssid, config.wifi_password, DEFAULT_CONNECT_TIMEOUT_MS)) {
+    copyCredentials(ssid, password);
+    if (WiFiManager::connect(ssid, password, DEFAULT_CONNECT_TIMEOUT_MS)) {
       Serial.println("[WIFI-RETRY] Connexion reussie !");
       
       // Synchroniser l'heure RTC via NTP
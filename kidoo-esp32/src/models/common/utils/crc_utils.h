@@ -0,0 +1,25 @@
+/**
+ * Utilitaires CRC
+ * CRC32 (polynôme IEEE 802.3, comme zlib) pour les empreintes de contenu et
+ * les fichiers de configuration. Aucune dépendance Arduino.
+ */
+
+#ifndef CRC_UTILS_H
+#define CRC_UTILS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Mettre à jour un CRC32 avec un bloc de données
+ * Un calcul commence à 0 ; les blocs successifs s'enchaînent :
+ * crc32Update(crc32Update(0, a, n), b, m) == CRC32 de a puis b
+ * 
+ * @param crc CRC des blocs précédents (0 pour le premier)
+ * @param data Données
+ * @param length Nombre d'octets
+ * @return CRC32 mis à jour
+ */
+uint32_t crc32Update(uint32_t crc, const void* data, size_t length);
+
+#endif // CRC_UTILS_H
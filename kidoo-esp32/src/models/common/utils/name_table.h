@@ -0,0 +1,62 @@
+/**
+ * Tables de correspondance nom -> valeur
+ * Tables constantes triées par nom (alias compris), recherche dichotomique.
+ * L'ordre de tri est vérifié à la compilation : déclarer la table constexpr et
+ * ajouter static_assert(isNameTableSorted(table), "...") à côté.
+ */
+
+#ifndef NAME_TABLE_H
+#define NAME_TABLE_H
+
+#include <stddef.h>
+#include <string.h>
+
+template <typename T>
+struct NamedEntry {
+  const char* name;
+  T value;
+};
+
+// strcmp évaluable à la compilation
+constexpr int nameCompare(const char* a, const char* b) {
+  return (*a != *b || *a == '\0') ? (int)(unsigned char)*a - (int)(unsigned char)*b : nameCompare(a + 1, b + 1);
+}
+
+// Noms strictement croissants (pas de doublon)
+template <typename T, size_t N>
+constexpr bool isNameTableSorted(const NamedEntry<T> (&table)[N], size_t index = 1) {
+  return index >= N || (nameCompare(table[index - 1].name, table[index].name) < 0 && isNameTableSorted(table, index + 1));
+}
+
+/**
+ * Chercher un nom dans une table triée
+ * @return L'entrée trouvée, nullptr si le nom est inconnu
+ */
+template <typename T>
+const NamedEntry<T>* findNamed(const NamedEntry<T>* table, size_t count, const char* name) {
+  if (name == nullptr) {
+    return nullptr;
+  }
+  size_t low = 0;
+  size_t high = count;
+  while (low < high) {
+    size_t middle = (low + high) / 2;
+    int order = strcmp(name, table[middle].name);
+    if (order == 0) {
+      return &table[middle];
+    }
+    if (order < 0) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+  return nullptr;
+}
+
+template <typename T, size_t N>
+const NamedEntry<T>* findNamed(const NamedEntry<T> (&table)[N], const char* name) {
+  return findNamed(table, N, name);
+}
+
+#endif // NAME_TABLE_H
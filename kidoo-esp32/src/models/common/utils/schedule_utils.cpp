@@ -0,0 +1,80 @@
+#include "schedule_utils.h"
+
+const char* const WEEKDAY_NAMES[7] = {
+  "monday", "tuesday", "wednesday", "thursday", "friday", "saturday", "sunday"
+};
+
+void scheduleReset(WeekdaySchedule& schedule, uint8_t defaultHour) {
+  for (int i = 0; i < 7; i++) {
+    schedule.days[i].hour = defaultHour;
+    schedule.days[i].minute = 0;
+    schedule.days[i].activated = false;
+  }
+}
+
+bool scheduleFromJson(JsonVariantConst json, WeekdaySchedule& schedule, uint8_t defaultHour) {
+  scheduleReset(schedule, defaultHour);
+
+  // Ancien format : objet sérialisé dans une string
+  JsonDocument parsed;
+  JsonObjectConst days;
+  if (json.is<const char*>()) {
+    if (deserializeJson(parsed, json.as<const char*>())) {
+      return false;
+    }
+    days = parsed.as<JsonObjectConst>();
+  } else {
+    days = json.as<JsonObjectConst>();
+  }
+  if (days.isNull()) {
+    return json.isNull();  // Absent = aucun jour activé
+  }
+
+  for (int i = 0; i < 7; i++) {
+    JsonObjectConst day = days[WEEKDAY_NAMES[i]].as<JsonObjectConst>();
+    if (day.isNull()) {
+      continue;
+    }
+
+    bool hasHour = day["hour"].is<int>();
+    bool hasMinute = day["minute"].is<int>();
+    if (hasHour) {
+      int hour = day["hour"].as<int>();
+      if (hour >= 0 && hour <= 23) {
+        schedule.days[i].hour = (uint8_t)hour;
+      }
+    }
+    if (hasMinute) {
+      int minute = day["minute"].as<int>();
+      if (minute >= 0 && minute <= 59) {
+        schedule.days[i].minute = (uint8_t)minute;
+      }
+    }
+    if (day["activated"].is<bool>()) {
+      schedule.days[i].activated = day["activated"].as<bool>();
+    } else {
+      // Si activated n'est pas présent, considérer comme activé si hour/minute sont présents
+      schedule.days[i].activated = hasHour && hasMinute;
+    }
+  }
+  return true;
+}
+
+void scheduleToJson(const WeekdaySchedule& schedule, JsonObject out) {
+  for (int i = 0; i < 7; i++) {
+    JsonObject day = out[WEEKDAY_NAMES[i]].to<JsonObject>();
+    day["hour"] = schedule.days[i].hour;
+    day["minute"] = schedule.days[i].minute;
+    day["activated"] = schedule.days[i].activated;
+  }
+}
+
+uint8_t scheduleActiveDays(const WeekdaySchedule& schedule) {
+  uint8_t count = 0;
+  for (int i = 0; i < 7; i++) {
+    if (schedule.days[i].activated) {
+      count++;
+    }
+  }
+  return count;
+}
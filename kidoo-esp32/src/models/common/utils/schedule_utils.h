@@ -0,0 +1,55 @@
+/**
+ * Utilitaires pour les horaires de la semaine (coucher, réveil)
+ * Les horaires sont gardés sous forme de tableau de 7 jours ; le JSON
+ * {"monday":{"hour":20,"minute":0,"activated":true},...} n'est utilisé
+ * qu'aux frontières (config.json, API, PubNub).
+ */
+
+#ifndef SCHEDULE_UTILS_H
+#define SCHEDULE_UTILS_H
+
+#include <stdint.h>
+#include <ArduinoJson.h>
+
+// Horaire d'un jour
+struct DaySchedule {
+  uint8_t hour;      // Heure (0-23)
+  uint8_t minute;    // Minute (0-59)
+  bool activated;    // Si true, le jour est activé
+};
+
+// Horaires de la semaine (0=monday, 6=sunday)
+struct WeekdaySchedule {
+  DaySchedule days[7];
+};
+
+// Noms des jours dans le JSON (index 0=monday, 6=sunday)
+extern const char* const WEEKDAY_NAMES[7];
+
+/**
+ * Désactiver les 7 jours
+ * @param defaultHour Heure gardée pour les jours désactivés (minute 0)
+ */
+void scheduleReset(WeekdaySchedule& schedule, uint8_t defaultHour);
+
+/**
+ * Lire les horaires depuis le JSON (objet, ou objet sérialisé en string
+ * comme dans les anciens config.json). Les jours absents sont désactivés,
+ * un jour sans "activated" est activé s'il a une heure et une minute.
+ *
+ * @param json Objet {"monday":{...},...} ou string JSON
+ * @param schedule Horaires lus
+ * @param defaultHour Heure des jours absents
+ * @return false si le JSON est invalide (tous les jours désactivés)
+ */
+bool scheduleFromJson(JsonVariantConst json, WeekdaySchedule& schedule, uint8_t defaultHour);
+
+/**
+ * Écrire les 7 jours dans un objet JSON (même format que scheduleFromJson)
+ */
+void scheduleToJson(const WeekdaySchedule& schedule, JsonObject out);
+
+// Nombre de jours activés
+uint8_t scheduleActiveDays(const WeekdaySchedule& schedule);
+
+#endif // SCHEDULE_UTILS_H
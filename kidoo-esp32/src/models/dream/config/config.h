@@ -32,6 +32,17 @@
 // La plupart des WS2812B utilisent GRB
 #define COLOR_ORDER GRB
 
+// Effets LED compilés dans le firmware (registre compile-time)
+// Les effets non listés ne sont pas liés ; LED_EFFECT_NONE est toujours disponible
+#define HAS_LED_EFFECT_RAINBOW true
+#define HAS_LED_EFFECT_PULSE true
+#define HAS_LED_EFFECT_GLOSSY true
+#define HAS_LED_EFFECT_ROTATE true
+#define HAS_LED_EFFECT_NIGHTLIGHT true
+#define HAS_LED_EFFECT_BREATHE true
+#define HAS_LED_EFFECT_RAINBOW_SOFT true
+#define HAS_LED_EFFECT_ANIMATION true  // Animations keyframes envoyées par l'app (carte SD)
+
 // ============================================
 // Configuration de la carte SD (SPI)
 // ============================================
@@ -1,8 +1,10 @@
 #include "model_config_sync_routes.h"
 #include "../../common/managers/wifi/wifi_manager.h"
 #include "../../common/managers/sd/sd_manager.h"
+#include "../../common/managers/config/config_manager.h"
 #include "../../common/config/default_config.h"
 #include "../../common/utils/mac_utils.h"
+#include "../../common/utils/crc_utils.h"
 #include "../managers/bedtime/bedtime_manager.h"
 #include "../managers/wakeup/wakeup_manager.h"
 
@@ -10,6 +12,104 @@
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <esp_mac.h>  // Pour ESP_MAC_WIFI_STA
+
+// Corps de la réponse, lu dans un buffer statique (pas de String sur le tas)
+static const size_t SYNC_BODY_MAX = 2048;
+static char syncBody[SYNC_BODY_MAX + 1];
+
+/**
+ * Flux d'écriture vers syncBody, pour HTTPClient::writeToStream()
+ * (qui gère Content-Length et chunked)
+ */
+class SyncBodyStream : public Stream {
+public:
+  size_t length = 0;
+  bool overflow = false;
+  
+  size_t write(uint8_t c) override {
+    return write(&c, 1);
+  }
+  
+  size_t write(const uint8_t* buffer, size_t size) override {
+    if (length + size > SYNC_BODY_MAX) {
+      overflow = true;
+      return 0;
+    }
+    memcpy(syncBody + length, buffer, size);
+    length += size;
+    return size;
+  }
+  
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+#endif
+
+#ifdef HAS_WIFI
+/**
+ * Appliquer les champs bedtime/wakeup reçus de l'API à la configuration
+ */
+static void applySyncedConfig(JsonObject data, SDConfig& config) {
+  // Mettre à jour la configuration bedtime si présente
+  if (data["bedtime"].is<JsonObject>()) {
+    JsonObject bedtime = data["bedtime"];
+
+    if (bedtime["colorR"].is<int>()) {
+      config.bedtime_colorR = (uint8_t)bedtime["colorR"].as<int>();
+    }
+    if (bedtime["colorG"].is<int>()) {
+      config.bedtime_colorG = (uint8_t)bedtime["colorG"].as<int>();
+    }
+    if (bedtime["colorB"].is<int>()) {
+      config.bedtime_colorB = (uint8_t)bedtime["colorB"].as<int>();
+    }
+    if (bedtime["brightness"].is<int>()) {
+      int brightness = bedtime["brightness"].as<int>();
+      if (brightness >= 0 && brightness <= 100) {
+        config.bedtime_brightness = (uint8_t)brightness;
+      }
+    }
+    if (bedtime["nightlightAllNight"].is<bool>()) {
+      config.bedtime_allNight = bedtime["nightlightAllNight"].as<bool>();
+    }
+
+    // Mettre à jour weekdaySchedule (absent = aucun jour activé)
+    if (bedtime["weekdaySchedule"].is<JsonObject>() || bedtime["weekdaySchedule"].isNull()) {
+      scheduleFromJson(bedtime["weekdaySchedule"], config.bedtime_schedule, DEFAULT_BEDTIME_HOUR);
+    }
+
+    Serial.println("[CONFIG-SYNC] Configuration bedtime mise a jour");
+  }
+
+  // Mettre à jour la configuration wakeup si présente
+  if (data["wakeup"].is<JsonObject>()) {
+    JsonObject wakeup = data["wakeup"];
+
+    if (wakeup["colorR"].is<int>()) {
+      config.wakeup_colorR = (uint8_t)wakeup["colorR"].as<int>();
+    }
+    if (wakeup["colorG"].is<int>()) {
+      config.wakeup_colorG = (uint8_t)wakeup["colorG"].as<int>();
+    }
+    if (wakeup["colorB"].is<int>()) {
+      config.wakeup_colorB = (uint8_t)wakeup["colorB"].as<int>();
+    }
+    if (wakeup["brightness"].is<int>()) {
+      int brightness = wakeup["brightness"].as<int>();
+      if (brightness >= 0 && brightness <= 100) {
+        config.wakeup_brightness = (uint8_t)brightness;
+      }
+    }
+
+    // Mettre à jour weekdaySchedule (absent = aucun jour activé)
+    if (wakeup["weekdaySchedule"].is<JsonObject>() || wakeup["weekdaySchedule"].isNull()) {
+      scheduleFromJson(wakeup["weekdaySchedule"], config.wakeup_schedule, DEFAULT_WAKEUP_HOUR);
+    }
+
+    Serial.println("[CONFIG-SYNC] Configuration wakeup mise a jour");
+  }
+}
 #endif
 
 void ModelDreamConfigSyncRoutes::onWiFiConnected() {
@@ -41,13 +141,38 @@ bool ModelDreamConfigSyncRoutes::fetchConfigFromAPI() {
   Serial.print("[CONFIG-SYNC] URL: ");
   Serial.println(url);
 
+  // Version de la configuration déjà appliquée (ETag et empreinte seulement :
+  // la configuration elle-même est relue après la requête, qui peut durer ~15 s)
+  char previousEtag[sizeof(SDConfig::sync_etag)];
+  uint32_t previousHash;
+  {
+    SDConfig current;
+    ConfigManager::snapshot(current);
+    strcpy(previousEtag, current.sync_etag);
+    previousHash = current.sync_hash;
+  }
+
   HTTPClient http;
   http.begin(url);
   http.setConnectTimeout(5000);
   http.setTimeout(10000);
 
+  // Requête conditionnelle : le serveur répond 304 sans corps si rien n'a changé
+  static const char* HEADER_KEYS[] = {"ETag"};
+  http.collectHeaders(HEADER_KEYS, 1);
+  if (previousEtag[0] != '\0') {
+    http.addHeader("If-None-Match", previousEtag);
+  }
+
+  unsigned long startTime = millis();
   int httpCode = http.GET();
 
+  if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+    http.end();
+    Serial.printf("[CONFIG-SYNC] Configuration inchangee (304, %lu ms)\n", millis() - startTime);
+    return true;
+  }
+
   if (httpCode != HTTP_CODE_OK) {
     Serial.print("[CONFIG-SYNC] Erreur HTTP: ");
     Serial.println(httpCode);
@@ -55,18 +180,42 @@ bool ModelDreamConfigSyncRoutes::fetchConfigFromAPI() {
     return false;
   }
 
-  String payload = http.getString();
+  char etag[sizeof(previousEtag)];
+  strncpy(etag, http.header("ETag").c_str(), sizeof(etag) - 1);
+  etag[sizeof(etag) - 1] = '\0';
+
+  SyncBodyStream body;
+  int written = http.writeToStream(&body);
   http.end();
 
-  if (payload.length() == 0) {
+  if (body.overflow) {
+    Serial.printf("[CONFIG-SYNC] Reponse trop grande (max %u octets)\n", (unsigned)SYNC_BODY_MAX);
+    return false;
+  }
+  if (written <= 0 || body.length == 0) {
     Serial.println("[CONFIG-SYNC] Reponse vide");
     return false;
   }
+  syncBody[body.length] = '\0';
 
   Serial.print("[CONFIG-SYNC] Reponse recue (");
-  Serial.print(payload.length());
+  Serial.print(body.length);
   Serial.println(" bytes)");
 
+  // Même contenu que la configuration déjà appliquée (serveur sans ETag, ou
+  // ETag changé pour un contenu identique) : ni parsing ni écriture SD
+  uint32_t hash = crc32Update(0, syncBody, body.length);
+  if (hash == previousHash) {
+    // Nouvel ETag retenu : les prochaines requêtes pourront recevoir un 304
+    if (etag[0] != '\0' && strcmp(etag, previousEtag) != 0) {
+      ConfigManager::update([&](SDConfig& config) {
+        strcpy(config.sync_etag, etag);
+      });
+    }
+    Serial.printf("[CONFIG-SYNC] Configuration inchangee (empreinte identique, %lu ms)\n", millis() - startTime);
+    return true;
+  }
+
   // Parser le JSON de la réponse
   // Format attendu: {"success": true, "data": {"bedtime": {...}, "wakeup": {...}}}
   #pragma GCC diagnostic push
@@ -74,7 +223,7 @@ bool ModelDreamConfigSyncRoutes::fetchConfigFromAPI() {
   StaticJsonDocument<2048> doc;
   #pragma GCC diagnostic pop
 
-  DeserializationError error = deserializeJson(doc, payload);
+  DeserializationError error = deserializeJson(doc, syncBody, body.length);
   if (error) {
     Serial.print("[CONFIG-SYNC] Erreur parsing JSON: ");
     Serial.println(error.c_str());
@@ -93,86 +242,22 @@ bool ModelDreamConfigSyncRoutes::fetchConfigFromAPI() {
     return false;
   }
 
-  // Charger la configuration actuelle depuis la SD
-  SDConfig config = SDManager::getConfig();
-
-  // Mettre à jour la configuration bedtime si présente
-  if (data["bedtime"].is<JsonObject>()) {
-    JsonObject bedtime = data["bedtime"];
+  // Champs reçus appliqués à la configuration courante, relue sous le verrou
+  // des écrivains : les modifications faites pendant la requête (PubNub, BLE)
+  // sont conservées
+  bool saved = ConfigManager::update([&](SDConfig& config) {
+    applySyncedConfig(data, config);
+    // Version appliquée, sauvegardée avec la configuration
+    strcpy(config.sync_etag, etag);
+    config.sync_hash = hash;
+  });
 
-    if (bedtime["colorR"].is<int>()) {
-      config.bedtime_colorR = (uint8_t)bedtime["colorR"].as<int>();
-    }
-    if (bedtime["colorG"].is<int>()) {
-      config.bedtime_colorG = (uint8_t)bedtime["colorG"].as<int>();
-    }
-    if (bedtime["colorB"].is<int>()) {
-      config.bedtime_colorB = (uint8_t)bedtime["colorB"].as<int>();
-    }
-    if (bedtime["brightness"].is<int>()) {
-      int brightness = bedtime["brightness"].as<int>();
-      if (brightness >= 0 && brightness <= 100) {
-        config.bedtime_brightness = (uint8_t)brightness;
-      }
-    }
-    if (bedtime["nightlightAllNight"].is<bool>()) {
-      config.bedtime_allNight = bedtime["nightlightAllNight"].as<bool>();
-    }
+  // Recharger les configurations dans les managers (la RAM est à jour même sans SD)
+  BedtimeManager::reloadConfig();
+  WakeupManager::reloadConfig();
 
-    // Mettre à jour weekdaySchedule
-    if (bedtime["weekdaySchedule"].is<JsonObject>()) {
-      String scheduleStr;
-      serializeJson(bedtime["weekdaySchedule"], scheduleStr);
-      strncpy(config.bedtime_weekdaySchedule, scheduleStr.c_str(), sizeof(config.bedtime_weekdaySchedule) - 1);
-      config.bedtime_weekdaySchedule[sizeof(config.bedtime_weekdaySchedule) - 1] = '\0';
-    } else if (bedtime["weekdaySchedule"].isNull()) {
-      strcpy(config.bedtime_weekdaySchedule, "{}");
-    }
-
-    Serial.println("[CONFIG-SYNC] Configuration bedtime mise a jour");
-  }
-
-  // Mettre à jour la configuration wakeup si présente
-  if (data["wakeup"].is<JsonObject>()) {
-    JsonObject wakeup = data["wakeup"];
-
-    if (wakeup["colorR"].is<int>()) {
-      config.wakeup_colorR = (uint8_t)wakeup["colorR"].as<int>();
-    }
-    if (wakeup["colorG"].is<int>()) {
-      config.wakeup_colorG = (uint8_t)wakeup["colorG"].as<int>();
-    }
-    if (wakeup["colorB"].is<int>()) {
-      config.wakeup_colorB = (uint8_t)wakeup["colorB"].as<int>();
-    }
-    if (wakeup["brightness"].is<int>()) {
-      int brightness = wakeup["brightness"].as<int>();
-      if (brightness >= 0 && brightness <= 100) {
-        config.wakeup_brightness = (uint8_t)brightness;
-      }
-    }
-
-    // Mettre à jour weekdaySchedule
-    if (wakeup["weekdaySchedule"].is<JsonObject>()) {
-      String scheduleStr;
-      serializeJson(wakeup["weekdaySchedule"], scheduleStr);
-      strncpy(config.wakeup_weekdaySchedule, scheduleStr.c_str(), sizeof(config.wakeup_weekdaySchedule) - 1);
-      config.wakeup_weekdaySchedule[sizeof(config.wakeup_weekdaySchedule) - 1] = '\0';
-    } else if (wakeup["weekdaySchedule"].isNull()) {
-      strcpy(config.wakeup_weekdaySchedule, "{}");
-    }
-
-    Serial.println("[CONFIG-SYNC] Configuration wakeup mise a jour");
-  }
-
-  // Sauvegarder la configuration mise à jour dans la SD
-  if (SDManager::saveConfig(config)) {
+  if (saved) {
     Serial.println("[CONFIG-SYNC] Configuration sauvegardee dans la SD");
-
-    // Recharger les configurations dans les managers
-    BedtimeManager::reloadConfig();
-    WakeupManager::reloadConfig();
-
     return true;
   } else {
     Serial.println("[CONFIG-SYNC] Erreur lors de la sauvegarde de la configuration");
@@ -1,4 +1,7 @@
 #include "bedtime_manager.h"
+#include "../../../common/managers/led/led_names.h"
+#include "../../../common/managers/config/config_manager.h"
+#include "../../../common/managers/pubnub/pubnub_manager.h"
 #include <ArduinoJson.h>
 #include <limits.h>  // Pour ULONG_MAX
 
@@ -27,6 +30,15 @@ static const unsigned long CHECK_INTERVAL_3H_MS = 10800000;  // 3 heures (quand
 static const unsigned long CHECK_INTERVAL_1H_MS = 3600000;   // 1 heure (quand loin)
 static const unsigned long CHECK_INTERVAL_30M_MS = 1800000;  // 30 minutes (quand proche)
 
+// Début/fin de routine : gardé dans le journal PubNub si l'appareil est hors ligne
+static void publishRoutineEvent(const char* state) {
+  char event[128];
+  snprintf(event, sizeof(event),
+           "{\"type\":\"routine\",\"routine\":\"bedtime\",\"state\":\"%s\",\"time\":%lu}",
+           state, (unsigned long)RTCManager::getUnixTime());
+  PubNubManager::publishEvent(event);
+}
+
 bool BedtimeManager::init() {
   if (initialized) {
     return true;
@@ -79,7 +91,7 @@ bool BedtimeManager::loadConfig() {
   lastConfig = config;
   
   // Charger la configuration depuis la SD
-  SDConfig sdConfig = SDManager::getConfig();
+  const SDConfig& sdConfig = ConfigManager::get();
   
   // Copier les paramètres généraux
   config.colorR = sdConfig.bedtime_colorR;
@@ -96,16 +108,13 @@ bool BedtimeManager::loadConfig() {
     strcpy(config.effect, "none");
   }
   
-  // Initialiser tous les schedules à désactivés par défaut
+  // Horaires de la semaine (déjà décodés dans la configuration)
   for (int i = 0; i < 7; i++) {
-    config.schedules[i].hour = 20;
-    config.schedules[i].minute = 0;
-    config.schedules[i].activated = false;
-  }
-  
-  // Parser le weekdaySchedule JSON
-  if (strlen(sdConfig.bedtime_weekdaySchedule) > 0) {
-    parseWeekdaySchedule(sdConfig.bedtime_weekdaySchedule);
+    config.schedules[i] = sdConfig.bedtime_schedule.days[i];
+    if (config.schedules[i].activated) {
+      Serial.printf("[BEDTIME] %s: %02d:%02d (active)\n", indexToWeekday(i),
+                    config.schedules[i].hour, config.schedules[i].minute);
+    }
   }
   
   Serial.println("[BEDTIME] Configuration chargee depuis la SD");
@@ -169,53 +178,6 @@ void BedtimeManager::checkNow() {
   checkBedtimeTrigger();
 }
 
-void BedtimeManager::parseWeekdaySchedule(const char* jsonStr) {
-  if (!jsonStr || strlen(jsonStr) == 0) {
-    return;
-  }
-  
-  // Parser le JSON
-  #pragma GCC diagnostic push
-  #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-  StaticJsonDocument<512> doc;
-  #pragma GCC diagnostic pop
-  
-  DeserializationError error = deserializeJson(doc, jsonStr);
-  if (error) {
-    Serial.print("[BEDTIME] Erreur parsing weekdaySchedule: ");
-    Serial.println(error.c_str());
-    return;
-  }
-  
-  // Mapping des jours de la semaine
-  const char* weekdays[] = {"monday", "tuesday", "wednesday", "thursday", "friday", "saturday", "sunday"};
-  
-  // Parser chaque jour
-  for (int i = 0; i < 7; i++) {
-    if (doc[weekdays[i]].is<JsonObject>()) {
-      JsonObject daySchedule = doc[weekdays[i]].as<JsonObject>();
-      
-      if (daySchedule["hour"].is<int>()) {
-        config.schedules[i].hour = daySchedule["hour"].as<int>();
-      }
-      if (daySchedule["minute"].is<int>()) {
-        config.schedules[i].minute = daySchedule["minute"].as<int>();
-      }
-      if (daySchedule["activated"].is<bool>()) {
-        config.schedules[i].activated = daySchedule["activated"].as<bool>();
-      } else {
-        // Si activated n'est pas présent, considérer comme activé si hour/minute sont présents
-        config.schedules[i].activated = daySchedule["hour"].is<int>() && daySchedule["minute"].is<int>();
-      }
-      
-      if (config.schedules[i].activated) {
-        Serial.printf("[BEDTIME] %s: %02d:%02d (active)\n", weekdays[i], 
-                      config.schedules[i].hour, config.schedules[i].minute);
-      }
-    }
-  }
-}
-
 uint8_t BedtimeManager::weekdayToIndex(uint8_t dayOfWeek) {
   // RTC dayOfWeek: 1=Lundi, 7=Dimanche
   // Notre index: 0=Lundi, 6=Dimanche
@@ -478,6 +440,7 @@ void BedtimeManager::startBedtime() {
   fadeInActive = true;
   fadeOutActive = false;
   fadeStartTime = millis();
+  publishRoutineEvent("started");
   
   // Convertir brightness de 0-100 vers 0-255
   uint8_t brightnessValue = (config.brightness * 255 + 50) / 100;
@@ -494,20 +457,11 @@ void BedtimeManager::startBedtime() {
   
   // Vérifier si un effet est configuré (et n'est pas "none")
   if (strlen(config.effect) > 0 && strcmp(config.effect, "none") != 0) {
-    useEffect = true;
-    
-    // Convertir le nom de l'effet en enum
-    if (strcmp(config.effect, "pulse") == 0) {
-      effect = LED_EFFECT_PULSE;
-    } else if (strcmp(config.effect, "rainbow-soft") == 0) {
-      effect = LED_EFFECT_RAINBOW_SOFT;
-    } else if (strcmp(config.effect, "breathe") == 0) {
-      effect = LED_EFFECT_BREATHE;
-    } else if (strcmp(config.effect, "nightlight") == 0) {
-      effect = LED_EFFECT_NIGHTLIGHT;
+    // Convertir le nom de l'effet en enum (table partagée avec les routes PubNub)
+    if (ledEffectFromName(config.effect, effect)) {
+      useEffect = (effect != LED_EFFECT_NONE);  // "solid" = couleur fixe
     } else {
       // Effet inconnu, utiliser couleur fixe
-      useEffect = false;
       effect = LED_EFFECT_NONE;
       Serial.printf("[BEDTIME] Effet inconnu: %s, utilisation de la couleur fixe\n", config.effect);
     }
@@ -561,6 +515,7 @@ void BedtimeManager::updateFadeOut() {
     bedtimeActive = false; // Arrêter le bedtime après le fade-out
     manuallyStarted = false; // Réinitialiser le flag manuel
     Serial.println("[BEDTIME] Fade-out termine, LEDs eteintes, bedtime arrete");
+    publishRoutineEvent("ended");
   } else {
     // Interpolation linéaire de la brightness vers 0
     float progress = (float)elapsed / (float)FADE_OUT_DURATION_MS;
@@ -574,6 +529,9 @@ void BedtimeManager::updateFadeOut() {
 void BedtimeManager::stopBedtime() {
   Serial.println("[BEDTIME] Arrêt du bedtime");
   
+  if (bedtimeActive) {
+    publishRoutineEvent("stopped");
+  }
   bedtimeActive = false;
   fadeInActive = false;
   fadeOutActive = false;
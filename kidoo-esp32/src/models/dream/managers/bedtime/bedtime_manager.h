@@ -15,19 +15,15 @@
  * 
  * Fonctionnalités:
  * - Charge la configuration depuis la SD
- * - Parse le weekdaySchedule (JSON)
+ * - Lit l'horaire de chaque jour (tableau de 7 jours, voir ConfigManager)
  * - Vérifie l'heure toutes les minutes
  * - Déclenche l'effet bedtime automatiquement à l'heure configurée
  * - Gère les transitions de fade-in (30 secondes)
  * - Gère l'extinction progressive si timer activé (5 minutes)
  */
 
-// Structure pour un horaire de coucher
-struct BedtimeSchedule {
-  uint8_t hour;      // Heure (0-23)
-  uint8_t minute;    // Minute (0-59)
-  bool activated;    // Si true, le jour est activé
-};
+// Structure pour un horaire de coucher (même format que la configuration)
+typedef DaySchedule BedtimeSchedule;
 
 // Structure pour la configuration bedtime complète
 struct BedtimeConfig {
@@ -122,7 +118,6 @@ private:
   static unsigned long fadeStartTime;
   
   // Fonctions privées
-  static void parseWeekdaySchedule(const char* jsonStr);
   static uint8_t weekdayToIndex(uint8_t dayOfWeek); // Convertir RTC dayOfWeek (1-7) vers index (0-6)
   static const char* indexToWeekday(uint8_t index); // Convertir index (0-6) vers weekday string
   static void checkBedtimeTrigger();
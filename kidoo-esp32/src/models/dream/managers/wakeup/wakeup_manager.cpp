@@ -2,6 +2,8 @@
 #include <ArduinoJson.h>
 #include <limits.h>  // Pour ULONG_MAX
 #include "../bedtime/bedtime_manager.h"
+#include "../../../common/managers/config/config_manager.h"
+#include "../../../common/managers/pubnub/pubnub_manager.h"
 
 // Variables statiques
 bool WakeupManager::initialized = false;
@@ -38,6 +40,15 @@ static const unsigned long CHECK_INTERVAL_30M_MS = 1800000;  // 30 minutes (quan
 static const unsigned long FADE_UPDATE_INTERVAL_MS = 100;     // Mettre à jour le fade toutes les 100ms (10 fois par seconde)
 static const int WAKEUP_TRIGGER_MINUTES_BEFORE = 15;         // Déclencher 15 minutes avant
 
+// Début/fin de routine : gardé dans le journal PubNub si l'appareil est hors ligne
+static void publishRoutineEvent(const char* state) {
+  char event[128];
+  snprintf(event, sizeof(event),
+           "{\"type\":\"routine\",\"routine\":\"wakeup\",\"state\":\"%s\",\"time\":%lu}",
+           state, (unsigned long)RTCManager::getUnixTime());
+  PubNubManager::publishEvent(event);
+}
+
 bool WakeupManager::init() {
   if (initialized) {
     return true;
@@ -90,7 +101,7 @@ bool WakeupManager::loadConfig() {
   lastConfig = config;
   
   // Charger la configuration depuis la SD
-  SDConfig sdConfig = SDManager::getConfig();
+  const SDConfig& sdConfig = ConfigManager::get();
   
   // Copier les paramètres généraux
   config.colorR = sdConfig.wakeup_colorR;
@@ -98,16 +109,13 @@ bool WakeupManager::loadConfig() {
   config.colorB = sdConfig.wakeup_colorB;
   config.brightness = sdConfig.wakeup_brightness;
   
-  // Initialiser tous les schedules à désactivés par défaut
+  // Horaires de la semaine (déjà décodés dans la configuration)
   for (int i = 0; i < 7; i++) {
-    config.schedules[i].hour = 7;
-    config.schedules[i].minute = 0;
-    config.schedules[i].activated = false;
-  }
-  
-  // Parser le weekdaySchedule JSON
-  if (strlen(sdConfig.wakeup_weekdaySchedule) > 0) {
-    parseWeekdaySchedule(sdConfig.wakeup_weekdaySchedule);
+    config.schedules[i] = sdConfig.wakeup_schedule.days[i];
+    if (config.schedules[i].activated) {
+      Serial.printf("[WAKEUP] %s: %02d:%02d (active)\n", indexToWeekday(i),
+                    config.schedules[i].hour, config.schedules[i].minute);
+    }
   }
   
   // Charger la couleur de coucher depuis la config bedtime
@@ -186,53 +194,6 @@ void WakeupManager::checkNow() {
   checkWakeupTrigger();
 }
 
-void WakeupManager::parseWeekdaySchedule(const char* jsonStr) {
-  if (!jsonStr || strlen(jsonStr) == 0) {
-    return;
-  }
-  
-  // Parser le JSON
-  #pragma GCC diagnostic push
-  #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-  StaticJsonDocument<512> doc;
-  #pragma GCC diagnostic pop
-  
-  DeserializationError error = deserializeJson(doc, jsonStr);
-  if (error) {
-    Serial.print("[WAKEUP] Erreur parsing weekdaySchedule: ");
-    Serial.println(error.c_str());
-    return;
-  }
-  
-  // Mapping des jours de la semaine
-  const char* weekdays[] = {"monday", "tuesday", "wednesday", "thursday", "friday", "saturday", "sunday"};
-  
-  // Parser chaque jour
-  for (int i = 0; i < 7; i++) {
-    if (doc[weekdays[i]].is<JsonObject>()) {
-      JsonObject daySchedule = doc[weekdays[i]].as<JsonObject>();
-      
-      if (daySchedule["hour"].is<int>()) {
-        config.schedules[i].hour = daySchedule["hour"].as<int>();
-      }
-      if (daySchedule["minute"].is<int>()) {
-        config.schedules[i].minute = daySchedule["minute"].as<int>();
-      }
-      if (daySchedule["activated"].is<bool>()) {
-        config.schedules[i].activated = daySchedule["activated"].as<bool>();
-      } else {
-        // Si activated n'est pas présent, considérer comme activé si hour/minute sont présents
-        config.schedules[i].activated = daySchedule["hour"].is<int>() && daySchedule["minute"].is<int>();
-      }
-      
-      if (config.schedules[i].activated) {
-        Serial.printf("[WAKEUP] %s: %02d:%02d (active)\n", weekdays[i], 
-                      config.schedules[i].hour, config.schedules[i].minute);
-      }
-    }
-  }
-}
-
 uint8_t WakeupManager::weekdayToIndex(uint8_t dayOfWeek) {
   // RTC dayOfWeek: 1=Lundi, 7=Dimanche
   // Notre index: 0=Lundi, 6=Dimanche
@@ -535,6 +496,7 @@ void WakeupManager::startWakeup() {
   fadeInActive = true;
   fadeOutActive = false;
   fadeStartTime = millis();
+  publishRoutineEvent("started");
   
   // Recharger la couleur de coucher au cas où elle aurait changé
   loadBedtimeColor();
@@ -642,6 +604,7 @@ void WakeupManager::updateFadeOut() {
     LEDManager::clear();
     wakeupActive = false; // Arrêter le wake-up après le fade-out
     Serial.println("[WAKEUP] Fade-out termine, LEDs eteintes, wake-up arrete");
+    publishRoutineEvent("ended");
   } else {
     // Interpolation linéaire de la brightness vers 0
     float progress = (float)elapsed / (float)FADE_OUT_DURATION_MS;
@@ -655,6 +618,9 @@ void WakeupManager::updateFadeOut() {
 void WakeupManager::stopWakeup() {
   Serial.println("[WAKEUP] Arrêt du wake-up");
   
+  if (wakeupActive) {
+    publishRoutineEvent("stopped");
+  }
   wakeupActive = false;
   fadeInActive = false;
   fadeOutActive = false;
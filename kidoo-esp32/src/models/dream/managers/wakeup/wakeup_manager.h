@@ -15,7 +15,7 @@
  * 
  * Fonctionnalités:
  * - Charge la configuration depuis la SD
- * - Parse le weekdaySchedule (JSON)
+ * - Lit l'horaire de chaque jour (tableau de 7 jours, voir ConfigManager)
  * - Vérifie l'heure toutes les minutes
  * - Déclenche l'effet wake-up automatiquement 15 minutes avant l'heure configurée
  * - Gère les transitions de fade-in (1 minute) avec transition de couleur
@@ -23,12 +23,8 @@
  * - Brightness part de la valeur actuelle vers la brightness cible (ne repart pas de 0)
  */
 
-// Structure pour un horaire de réveil
-struct WakeupSchedule {
-  uint8_t hour;      // Heure (0-23)
-  uint8_t minute;    // Minute (0-59)
-  bool activated;    // Si true, le jour est activé
-};
+// Structure pour un horaire de réveil (même format que la configuration)
+typedef DaySchedule WakeupSchedule;
 
 // Structure pour la configuration wake-up complète
 struct WakeupConfig {
@@ -129,7 +125,6 @@ private:
   static uint8_t lastBrightness;
   
   // Fonctions privées
-  static void parseWeekdaySchedule(const char* jsonStr);
   static uint8_t weekdayToIndex(uint8_t dayOfWeek); // Convertir RTC dayOfWeek (1-7) vers index (0-6)
   static const char* indexToWeekday(uint8_t index); // Convertir index (0-6) vers weekday string
   static void checkWakeupTrigger();
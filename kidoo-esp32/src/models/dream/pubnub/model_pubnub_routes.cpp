@@ -1,11 +1,16 @@
 #include "model_pubnub_routes.h"
 #include "../../common/managers/led/led_manager.h"
+#include "../../common/managers/led/led_names.h"
+#include "../../common/managers/led/led_latency.h"
 #include "../../common/managers/init/init_manager.h"
 #include "../../common/managers/wifi/wifi_manager.h"
 #include "../../common/managers/pubnub/pubnub_manager.h"
 #include "../../common/managers/sd/sd_manager.h"
+#include "../../common/managers/config/config_manager.h"
+#include "../../common/managers/log/log_manager.h"
 #include "../../common/managers/nfc/nfc_manager.h"
 #include "../../common/utils/mac_utils.h"
+#include "../../common/config/default_config.h"
 #include "../managers/bedtime/bedtime_manager.h"
 #include "../managers/wakeup/wakeup_manager.h"
 #include <limits.h>   // Pour ULONG_MAX
@@ -14,6 +19,10 @@
  * Routes PubNub spécifiques au modèle Kidoo Dream
  */
 
+// Table des actions (voir le header)
+constexpr PubNubRoute ModelDreamPubNubRoutes::ROUTES[];
+const size_t ModelDreamPubNubRoutes::ROUTE_COUNT;
+
 bool ModelDreamPubNubRoutes::processMessage(const JsonObject& json) {
   // Vérifier que l'action est présente
   if (!json["action"].is<const char*>()) {
@@ -30,48 +39,10 @@ bool ModelDreamPubNubRoutes::processMessage(const JsonObject& json) {
   Serial.print("[PUBNUB-ROUTE] Traitement de l'action: ");
   Serial.println(action);
   
-  // Router vers le bon handler
-  if (strcmp(action, "get-info") == 0 || strcmp(action, "getinfo") == 0) {
-    return handleGetInfo(json);
-  }
-  else if (strcmp(action, "brightness") == 0) {
-    return handleBrightness(json);
-  }
-  else if (strcmp(action, "sleep-timeout") == 0 || strcmp(action, "sleeptimeout") == 0 || strcmp(action, "sleep") == 0) {
-    return handleSleepTimeout(json);
-  }
-  else if (strcmp(action, "reboot") == 0 || strcmp(action, "restart") == 0) {
-    return handleReboot(json);
-  }
-  else if (strcmp(action, "led") == 0) {
-    return handleLed(json);
-  }
-  else if (strcmp(action, "start-test-bedtime") == 0) {
-    return handleStartTestBedtime(json);
-  }
-  else if (strcmp(action, "stop-test-bedtime") == 0) {
-    return handleStopTestBedtime(json);
-  }
-  else if (strcmp(action, "start-bedtime") == 0) {
-    return handleStartBedtime(json);
-  }
-  else if (strcmp(action, "stop-bedtime") == 0) {
-    return handleStopBedtime(json);
-  }
-  else if (strcmp(action, "stop-routine") == 0) {
-    return handleStopRoutine(json);
-  }
-  else if (strcmp(action, "set-bedtime-config") == 0) {
-    return handleSetBedtimeConfig(json);
-  }
-  else if (strcmp(action, "start-test-wakeup") == 0) {
-    return handleStartTestWakeup(json);
-  }
-  else if (strcmp(action, "stop-test-wakeup") == 0) {
-    return handleStopTestWakeup(json);
-  }
-  else if (strcmp(action, "set-wakeup-config") == 0) {
-    return handleSetWakeupConfig(json);
+  // Router vers le bon handler (recherche dichotomique dans la table triée)
+  const PubNubRoute* route = findNamed(ROUTES, ROUTE_COUNT, action);
+  if (route != nullptr) {
+    return route->value(json);
   }
   
   Serial.print("[PUBNUB-ROUTE] Action inconnue: ");
@@ -85,7 +56,16 @@ bool ModelDreamPubNubRoutes::handleGetInfo(const JsonObject& json) {
   
   Serial.println("[PUBNUB-ROUTE] get-info: Préparation des informations du Kidoo...");
   
-  SDConfig config = SDManager::getConfig();
+  // Champs copiés : les lectures SD qui suivent peuvent durer
+  char wifiSsid[sizeof(SDConfig::wifi_ssid)];
+  uint8_t ledBrightness;
+  uint32_t sleepTimeoutMs;
+  ConfigManager::read([&](const SDConfig& config) {
+    strncpy(wifiSsid, config.wifi_ssid, sizeof(wifiSsid) - 1);
+    wifiSsid[sizeof(wifiSsid) - 1] = '\0';
+    ledBrightness = config.led_brightness;
+    sleepTimeoutMs = config.sleep_timeout_ms;
+  });
   
   // Récupérer les infos de stockage
   uint64_t totalBytes = 0;
@@ -105,9 +85,15 @@ bool ModelDreamPubNubRoutes::handleGetInfo(const JsonObject& json) {
     strcpy(macStr, "00:00:00:00:00:00"); // Valeur par défaut en cas d'erreur
   }
   
+  // Latence commande -> LED par source (ms), objet vide si rien n'a été mesuré
+  char latencyJson[256];
+  if (LEDLatency::formatJson(latencyJson, sizeof(latencyJson)) == 0) {
+    strcpy(latencyJson, "{}");
+  }
+  
   // Construire le JSON de réponse
   // Note: On utilise un buffer assez grand pour toutes les infos
-  char infoJson[512];
+  char infoJson[768];
   snprintf(infoJson, sizeof(infoJson),
     "{"
       "\"type\":\"info\","
@@ -130,24 +116,26 @@ bool ModelDreamPubNubRoutes::handleGetInfo(const JsonObject& json) {
       "},"
       "\"nfc\":{"
         "\"available\":%s"
-      "}"
+      "},"
+      "\"latency\":%s"
     "}",
     DEFAULT_DEVICE_NAME,
     macStr,
     WiFiManager::getLocalIP().c_str(),
     millis() / 1000,  // uptime en secondes
     ESP.getFreeHeap(),
-    config.wifi_ssid,
+    wifiSsid,
     WiFiManager::getRSSI(),
-    (config.led_brightness * 100 + 127) / 255,  // brightness en % avec arrondi correct
-    config.sleep_timeout_ms,
+    (ledBrightness * 100 + 127) / 255,  // brightness en % avec arrondi correct
+    (unsigned long)sleepTimeoutMs,
     totalBytes,
     freeBytes,
     usedBytes,
-    NFCManager::isAvailable() ? "true" : "false"
+    NFCManager::isAvailable() ? "true" : "false",
+    latencyJson
   );
   
-  if (PubNubManager::publish(infoJson)) {
+  if (PubNubManager::publish(infoJson, PUBLISH_PRIORITY_CRITICAL)) {
     Serial.println("[PUBNUB-ROUTE] get-info: Informations publiees avec succes");
   } else {
     Serial.println("[PUBNUB-ROUTE] get-info: Erreur lors de la publication des informations");
@@ -194,9 +182,7 @@ bool ModelDreamPubNubRoutes::handleBrightness(const JsonObject& json) {
     Serial.println("%");
     
     // Sauvegarder dans la config
-    SDConfig config = SDManager::getConfig();
-    config.led_brightness = brightness;
-    SDManager::saveConfig(config);
+    ConfigManager::update([&](SDConfig& config) { config.led_brightness = brightness; });
     
     return true;
   }
@@ -242,9 +228,7 @@ bool ModelDreamPubNubRoutes::handleSleepTimeout(const JsonObject& json) {
     timeout = 300000;
   }
   
-  SDConfig config = SDManager::getConfig();
-  config.sleep_timeout_ms = timeout;
-  SDManager::saveConfig(config);
+  ConfigManager::update([&](SDConfig& config) { config.sleep_timeout_ms = timeout; });
   
   if (timeout == 0) {
     Serial.println("[PUBNUB-ROUTE] Sleep mode desactive");
@@ -284,6 +268,9 @@ bool ModelDreamPubNubRoutes::handleReboot(const JsonObject& json) {
     Serial.println("[PUBNUB-ROUTE] Redemarrage immediat");
   }
   
+  // Sauvegarde de configuration et logs d'erreur encore en attente (écriture différée)
+  ConfigManager::flush();
+  LogManager::flush();
   ESP.restart();
   
   return true;  // Ne sera jamais atteint
@@ -291,6 +278,7 @@ bool ModelDreamPubNubRoutes::handleReboot(const JsonObject& json) {
 
 bool ModelDreamPubNubRoutes::handleLed(const JsonObject& json) {
   // Format: { "action": "led", "color": "#FF0000", "effect": "solid" }
+  //      ou { "action": "led", "animation": "/animations/nom.kan" }
   // color: hex string (#RRGGBB) ou nom (red, green, blue, etc.)
   // effect: none, pulse, rotate, rainbow, glossy
   
@@ -301,24 +289,11 @@ bool ModelDreamPubNubRoutes::handleLed(const JsonObject& json) {
     const char* colorStr = json["color"].as<const char*>();
     uint8_t r = 0, g = 0, b = 0;
     
-    if (colorStr[0] == '#' && strlen(colorStr) == 7) {
-      // Format hex #RRGGBB
-      long hexColor = strtol(colorStr + 1, nullptr, 16);
-      r = (hexColor >> 16) & 0xFF;
-      g = (hexColor >> 8) & 0xFF;
-      b = hexColor & 0xFF;
+    // Format hex #RRGGBB ou nom (red, green, blue, etc.) ; couleur inconnue = éteint
+    if (!ledColorFromName(colorStr, r, g, b)) {
+      Serial.print("[PUBNUB-ROUTE] Couleur inconnue: ");
+      Serial.println(colorStr);
     }
-    else if (strcmp(colorStr, "red") == 0) { r = 255; g = 0; b = 0; }
-    else if (strcmp(colorStr, "green") == 0) { r = 0; g = 255; b = 0; }
-    else if (strcmp(colorStr, "blue") == 0) { r = 0; g = 0; b = 255; }
-    else if (strcmp(colorStr, "white") == 0) { r = 255; g = 255; b = 255; }
-    else if (strcmp(colorStr, "yellow") == 0) { r = 255; g = 255; b = 0; }
-    else if (strcmp(colorStr, "cyan") == 0) { r = 0; g = 255; b = 255; }
-    else if (strcmp(colorStr, "magenta") == 0) { r = 255; g = 0; b = 255; }
-    else if (strcmp(colorStr, "orange") == 0) { r = 255; g = 165; b = 0; }
-    else if (strcmp(colorStr, "purple") == 0) { r = 128; g = 0; b = 128; }
-    else if (strcmp(colorStr, "pink") == 0) { r = 255; g = 192; b = 203; }
-    // off/black = 0,0,0 (déjà initialisé)
     
     LEDManager::setColor(r, g, b);
     Serial.print("[PUBNUB-ROUTE] Couleur: ");
@@ -331,17 +306,16 @@ bool ModelDreamPubNubRoutes::handleLed(const JsonObject& json) {
     const char* effectStr = json["effect"].as<const char*>();
     LEDEffect effect = LED_EFFECT_NONE;
     
-    if (strcmp(effectStr, "none") == 0 || strcmp(effectStr, "solid") == 0) effect = LED_EFFECT_NONE;
-    else if (strcmp(effectStr, "pulse") == 0) effect = LED_EFFECT_PULSE;
-    else if (strcmp(effectStr, "rotate") == 0) effect = LED_EFFECT_ROTATE;
-    else if (strcmp(effectStr, "rainbow") == 0) effect = LED_EFFECT_RAINBOW;
-    else if (strcmp(effectStr, "glossy") == 0) effect = LED_EFFECT_GLOSSY;
-    else if (strcmp(effectStr, "off") == 0) {
+    if (strcmp(effectStr, "off") == 0) {
       // Éteindre les LEDs
       LEDManager::clear();
       Serial.println("[PUBNUB-ROUTE] LEDs eteintes");
       return true;
     }
+    if (!ledEffectFromName(effectStr, effect)) {
+      Serial.print("[PUBNUB-ROUTE] Effet inconnu: ");
+      Serial.println(effectStr);
+    }
     
     LEDManager::setEffect(effect);
     Serial.print("[PUBNUB-ROUTE] Effet: ");
@@ -349,8 +323,18 @@ bool ModelDreamPubNubRoutes::handleLed(const JsonObject& json) {
     handled = true;
   }
   
+  // Traiter l'animation keyframes (fichier .kan déposé sur la SD par l'app)
+  if (json["animation"].is<const char*>()) {
+    const char* animationPath = json["animation"].as<const char*>();
+    if (LEDManager::playAnimation(animationPath)) {
+      Serial.print("[PUBNUB-ROUTE] Animation: ");
+      Serial.println(animationPath);
+      handled = true;
+    }
+  }
+  
   if (!handled) {
-    Serial.println("[PUBNUB-ROUTE] led: parametre 'color' ou 'effect' manquant");
+    Serial.println("[PUBNUB-ROUTE] led: parametre 'color', 'effect' ou 'animation' manquant");
   }
   
   return handled;
@@ -440,23 +424,7 @@ bool ModelDreamPubNubRoutes::handleStartTestBedtime(const JsonObject& json) {
   // Convertir l'effet string en enum LEDEffect si fourni
   LEDEffect effect = LED_EFFECT_NONE;
   if (hasEffect && effectStr != nullptr) {
-    if (strcmp(effectStr, "none") == 0 || strcmp(effectStr, "") == 0) {
-      effect = LED_EFFECT_NONE;
-    } else if (strcmp(effectStr, "pulse") == 0) {
-      effect = LED_EFFECT_PULSE;
-    } else if (strcmp(effectStr, "rotate") == 0) {
-      effect = LED_EFFECT_ROTATE;
-    } else if (strcmp(effectStr, "rainbow") == 0) {
-      effect = LED_EFFECT_RAINBOW;
-    } else if (strcmp(effectStr, "rainbow-soft") == 0) {
-      effect = LED_EFFECT_RAINBOW_SOFT;
-    } else if (strcmp(effectStr, "glossy") == 0) {
-      effect = LED_EFFECT_GLOSSY;
-    } else if (strcmp(effectStr, "breathe") == 0) {
-      effect = LED_EFFECT_BREATHE;
-    } else if (strcmp(effectStr, "nightlight") == 0) {
-      effect = LED_EFFECT_NIGHTLIGHT;
-    } else {
+    if (effectStr[0] != '\0' && !ledEffectFromName(effectStr, effect)) {
       Serial.printf("[PUBNUB-ROUTE] start-test-bedtime: Effet inconnu '%s', utilisation de NONE\n", effectStr);
       effect = LED_EFFECT_NONE;
     }
@@ -745,8 +713,9 @@ bool ModelDreamPubNubRoutes::handleSetBedtimeConfig(const JsonObject& json) {
     return false;
   }
   
-  // Charger la configuration actuelle depuis la SD
-  SDConfig config = SDManager::getConfig();
+  // Copie de la configuration courante (RAM)
+  SDConfig config;
+  ConfigManager::snapshot(config);
   
   // Mettre à jour les champs bedtime
   // Si une couleur est fournie, l'utiliser (même si un effet est aussi fourni, pour l'effet ROTATE)
@@ -769,32 +738,13 @@ bool ModelDreamPubNubRoutes::handleSetBedtimeConfig(const JsonObject& json) {
     strcpy(config.bedtime_effect, "none");
   }
   
-  // Sauvegarder weekdaySchedule si présent
+  // Remplacer les horaires si weekdaySchedule est présent (sinon garder les horaires existants)
   if (hasWeekdaySchedule) {
-    // Sérialiser le weekdaySchedule en JSON string
-    String scheduleStr;
-    serializeJson(weekdayScheduleObj, scheduleStr);
-    
-    // Vérifier que la taille ne dépasse pas la limite
-    if (scheduleStr.length() < sizeof(config.bedtime_weekdaySchedule)) {
-      strncpy(config.bedtime_weekdaySchedule, scheduleStr.c_str(), sizeof(config.bedtime_weekdaySchedule) - 1);
-      config.bedtime_weekdaySchedule[sizeof(config.bedtime_weekdaySchedule) - 1] = '\0';
-      Serial.print("[PUBNUB-ROUTE] set-bedtime-config: weekdaySchedule sauvegardé: ");
-      Serial.println(scheduleStr);
-    } else {
-      Serial.println("[PUBNUB-ROUTE] set-bedtime-config: weekdaySchedule trop grand, tronqué");
-      strncpy(config.bedtime_weekdaySchedule, scheduleStr.c_str(), sizeof(config.bedtime_weekdaySchedule) - 1);
-      config.bedtime_weekdaySchedule[sizeof(config.bedtime_weekdaySchedule) - 1] = '\0';
-    }
-  } else {
-    // Pas de weekdaySchedule, garder la valeur existante ou mettre un objet vide
-    if (strlen(config.bedtime_weekdaySchedule) == 0) {
-      strcpy(config.bedtime_weekdaySchedule, "{}");
-    }
+    scheduleFromJson(weekdayScheduleObj, config.bedtime_schedule, DEFAULT_BEDTIME_HOUR);
   }
   
   // Sauvegarder sur la SD
-  if (SDManager::saveConfig(config)) {
+  if (ConfigManager::save(config)) {
     Serial.print("[PUBNUB-ROUTE] set-bedtime-config: Configuration sauvegardée - RGB(");
     Serial.print(config.bedtime_colorR);
     Serial.print(",");
@@ -809,7 +759,8 @@ bool ModelDreamPubNubRoutes::handleSetBedtimeConfig(const JsonObject& json) {
     Serial.print(config.bedtime_effect);
     if (hasWeekdaySchedule) {
       Serial.print(", weekdaySchedule: ");
-      Serial.println(config.bedtime_weekdaySchedule);
+      Serial.print(scheduleActiveDays(config.bedtime_schedule));
+      Serial.println(" jour(s) active(s)");
     } else {
       Serial.println();
     }
@@ -1025,8 +976,9 @@ bool ModelDreamPubNubRoutes::handleSetWakeupConfig(const JsonObject& json) {
     return false;
   }
   
-  // Charger la configuration actuelle depuis la SD
-  SDConfig config = SDManager::getConfig();
+  // Copie de la configuration courante (RAM)
+  SDConfig config;
+  ConfigManager::snapshot(config);
   
   // Mettre à jour les champs wakeup
   config.wakeup_colorR = (uint8_t)colorR;
@@ -1034,32 +986,13 @@ bool ModelDreamPubNubRoutes::handleSetWakeupConfig(const JsonObject& json) {
   config.wakeup_colorB = (uint8_t)colorB;
   config.wakeup_brightness = (uint8_t)brightness;
   
-  // Sauvegarder weekdaySchedule si présent
+  // Remplacer les horaires si weekdaySchedule est présent (sinon garder les horaires existants)
   if (hasWeekdaySchedule) {
-    // Sérialiser le weekdaySchedule en JSON string
-    String scheduleStr;
-    serializeJson(weekdayScheduleObj, scheduleStr);
-    
-    // Vérifier que la taille ne dépasse pas la limite
-    if (scheduleStr.length() < sizeof(config.wakeup_weekdaySchedule)) {
-      strncpy(config.wakeup_weekdaySchedule, scheduleStr.c_str(), sizeof(config.wakeup_weekdaySchedule) - 1);
-      config.wakeup_weekdaySchedule[sizeof(config.wakeup_weekdaySchedule) - 1] = '\0';
-      Serial.print("[PUBNUB-ROUTE] set-wakeup-config: weekdaySchedule sauvegardé: ");
-      Serial.println(scheduleStr);
-    } else {
-      Serial.println("[PUBNUB-ROUTE] set-wakeup-config: weekdaySchedule trop grand, tronqué");
-      strncpy(config.wakeup_weekdaySchedule, scheduleStr.c_str(), sizeof(config.wakeup_weekdaySchedule) - 1);
-      config.wakeup_weekdaySchedule[sizeof(config.wakeup_weekdaySchedule) - 1] = '\0';
-    }
-  } else {
-    // Pas de weekdaySchedule, garder la valeur existante ou mettre un objet vide
-    if (strlen(config.wakeup_weekdaySchedule) == 0) {
-      strcpy(config.wakeup_weekdaySchedule, "{}");
-    }
+    scheduleFromJson(weekdayScheduleObj, config.wakeup_schedule, DEFAULT_WAKEUP_HOUR);
   }
   
   // Sauvegarder sur la SD
-  if (SDManager::saveConfig(config)) {
+  if (ConfigManager::save(config)) {
     Serial.print("[PUBNUB-ROUTE] set-wakeup-config: Configuration sauvegardée - RGB(");
     Serial.print(colorR);
     Serial.print(",");
@@ -1071,7 +1004,8 @@ bool ModelDreamPubNubRoutes::handleSetWakeupConfig(const JsonObject& json) {
     Serial.print("%");
     if (hasWeekdaySchedule) {
       Serial.print(", weekdaySchedule: ");
-      Serial.println(config.wakeup_weekdaySchedule);
+      Serial.print(scheduleActiveDays(config.wakeup_schedule));
+      Serial.println(" jour(s) active(s)");
     } else {
       Serial.println();
     }
@@ -1116,6 +1050,7 @@ void ModelDreamPubNubRoutes::printRoutes() {
   Serial.println("{ \"action\": \"reboot\", \"params\": { \"delay\": ms } }");
   Serial.println("{ \"action\": \"led\", \"color\": \"#RRGGBB\" }");
   Serial.println("{ \"action\": \"led\", \"effect\": \"none|pulse|rotate|rainbow|glossy|off\" }");
+  Serial.println("{ \"action\": \"led\", \"animation\": \"/animations/nom.kan\" }");
   Serial.println("{ \"action\": \"start-test-bedtime\", \"params\": { \"colorR\": 0-255, \"colorG\": 0-255, \"colorB\": 0-255, \"brightness\": 0-100 } }");
   Serial.println("{ \"action\": \"stop-test-bedtime\" }");
   Serial.println("{ \"action\": \"start-bedtime\" }");
@@ -1127,3 +1062,7 @@ void ModelDreamPubNubRoutes::printRoutes() {
   Serial.println("{ \"action\": \"set-wakeup-config\", \"params\": { \"colorR\": 0-255, \"colorG\": 0-255, \"colorB\": 0-255, \"brightness\": 0-100, \"weekdaySchedule\": {...} } }");
   Serial.println("==========================================");
 }
+
+void ModelDreamPubNubRoutes::benchmarkRoutes() {
+  pubnubBenchmarkRoutes(ROUTES, ROUTE_COUNT);
+}
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "../../common/managers/pubnub/pubnub_routes.h"
 
 /**
  * Routes PubNub spécifiques au modèle Kidoo Dream
@@ -53,6 +54,11 @@ public:
    */
   static void printRoutes();
   
+  /**
+   * Mesurer le coût du dispatch des actions (commande "pubnub-routes bench")
+   */
+  static void benchmarkRoutes();
+  
   /**
    * Vérifier le timeout du test de bedtime (à appeler périodiquement)
    */
@@ -89,6 +95,30 @@ private:
   static bool handleStartTestWakeup(const JsonObject& json);
   static bool handleStopTestWakeup(const JsonObject& json);
   static bool handleSetWakeupConfig(const JsonObject& json);
+  
+  // Actions -> handlers, triées par nom (alias compris)
+  static constexpr PubNubRoute ROUTES[] = {
+    {"brightness",          handleBrightness},
+    {"get-info",            handleGetInfo},
+    {"getinfo",             handleGetInfo},
+    {"led",                 handleLed},
+    {"reboot",              handleReboot},
+    {"restart",             handleReboot},
+    {"set-bedtime-config",  handleSetBedtimeConfig},
+    {"set-wakeup-config",   handleSetWakeupConfig},
+    {"sleep",               handleSleepTimeout},
+    {"sleep-timeout",       handleSleepTimeout},
+    {"sleeptimeout",        handleSleepTimeout},
+    {"start-bedtime",       handleStartBedtime},
+    {"start-test-bedtime",  handleStartTestBedtime},
+    {"start-test-wakeup",   handleStartTestWakeup},
+    {"stop-bedtime",        handleStopBedtime},
+    {"stop-routine",        handleStopRoutine},
+    {"stop-test-bedtime",   handleStopTestBedtime},
+    {"stop-test-wakeup",    handleStopTestWakeup},
+  };
+  static const size_t ROUTE_COUNT = sizeof(ROUTES) / sizeof(ROUTES[0]);
+  static_assert(isNameTableSorted(ROUTES), "ROUTES doit etre trie par nom");
 };
 
 #endif // MODEL_DREAM_PUBNUB_ROUTES_H
@@ -1,14 +1,20 @@
 #include "model_pubnub_routes.h"
 #include "../../common/managers/led/led_manager.h"
+#include "../../common/managers/led/led_names.h"
 #include "../../common/managers/init/init_manager.h"
 #include "../../common/managers/wifi/wifi_manager.h"
 #include "../../common/managers/pubnub/pubnub_manager.h"
 #include "../../common/managers/sd/sd_manager.h"
+#include "../../common/managers/config/config_manager.h"
 
 /**
  * Routes PubNub spécifiques au modèle Kidoo Mini
  */
 
+// Table des actions (voir le header)
+constexpr PubNubRoute ModelMiniPubNubRoutes::ROUTES[];
+const size_t ModelMiniPubNubRoutes::ROUTE_COUNT;
+
 bool ModelMiniPubNubRoutes::processMessage(const JsonObject& json) {
   if (!json["action"].is<const char*>()) {
     return false;
@@ -22,17 +28,9 @@ bool ModelMiniPubNubRoutes::processMessage(const JsonObject& json) {
   Serial.print("[PUBNUB-ROUTE] Action: ");
   Serial.println(action);
   
-  if (strcmp(action, "brightness") == 0) {
-    return handleBrightness(json);
-  }
-  else if (strcmp(action, "sleep") == 0) {
-    return handleSleep(json);
-  }
-  else if (strcmp(action, "led") == 0) {
-    return handleLed(json);
-  }
-  else if (strcmp(action, "status") == 0) {
-    return handleStatus(json);
+  const PubNubRoute* route = findNamed(ROUTES, ROUTE_COUNT, action);
+  if (route != nullptr) {
+    return route->value(json);
   }
   
   return false;
@@ -50,9 +48,7 @@ bool ModelMiniPubNubRoutes::handleBrightness(const JsonObject& json) {
   uint8_t brightness = (value * 255) / 100;
   
   if (LEDManager::setBrightness(brightness)) {
-    SDConfig config = SDManager::getConfig();
-    config.led_brightness = brightness;
-    SDManager::saveConfig(config);
+    ConfigManager::update([&](SDConfig& config) { config.led_brightness = brightness; });
     Serial.print("[PUBNUB-ROUTE] Luminosite: ");
     Serial.print(value);
     Serial.println("%");
@@ -64,9 +60,7 @@ bool ModelMiniPubNubRoutes::handleBrightness(const JsonObject& json) {
 
 bool ModelMiniPubNubRoutes::handleSleep(const JsonObject& json) {
   if (json["enabled"].is<bool>() && !json["enabled"].as<bool>()) {
-    SDConfig config = SDManager::getConfig();
-    config.sleep_timeout_ms = 0;
-    SDManager::saveConfig(config);
+    ConfigManager::update([&](SDConfig& config) { config.sleep_timeout_ms = 0; });
     Serial.println("[PUBNUB-ROUTE] Sleep mode desactive");
     return true;
   }
@@ -75,9 +69,7 @@ bool ModelMiniPubNubRoutes::handleSleep(const JsonObject& json) {
     uint32_t timeout = json["timeout"].as<uint32_t>();
     if (timeout > 0 && timeout < 5000) timeout = 5000;
     
-    SDConfig config = SDManager::getConfig();
-    config.sleep_timeout_ms = timeout;
-    SDManager::saveConfig(config);
+    ConfigManager::update([&](SDConfig& config) { config.sleep_timeout_ms = timeout; });
     
     Serial.print("[PUBNUB-ROUTE] Sleep timeout: ");
     Serial.println(timeout);
@@ -94,17 +86,7 @@ bool ModelMiniPubNubRoutes::handleLed(const JsonObject& json) {
     const char* colorStr = json["color"].as<const char*>();
     uint8_t r = 0, g = 0, b = 0;
     
-    if (colorStr[0] == '#' && strlen(colorStr) == 7) {
-      long hexColor = strtol(colorStr + 1, nullptr, 16);
-      r = (hexColor >> 16) & 0xFF;
-      g = (hexColor >> 8) & 0xFF;
-      b = hexColor & 0xFF;
-    }
-    else if (strcmp(colorStr, "red") == 0) { r = 255; g = 0; b = 0; }
-    else if (strcmp(colorStr, "green") == 0) { r = 0; g = 255; b = 0; }
-    else if (strcmp(colorStr, "blue") == 0) { r = 0; g = 0; b = 255; }
-    else if (strcmp(colorStr, "white") == 0) { r = 255; g = 255; b = 255; }
-    else if (strcmp(colorStr, "off") == 0) { r = 0; g = 0; b = 0; }
+    ledColorFromName(colorStr, r, g, b);  // Couleur inconnue = éteint
     
     LEDManager::setColor(r, g, b);
     handled = true;
@@ -114,15 +96,11 @@ bool ModelMiniPubNubRoutes::handleLed(const JsonObject& json) {
     const char* effectStr = json["effect"].as<const char*>();
     LEDEffect effect = LED_EFFECT_NONE;
     
-    if (strcmp(effectStr, "none") == 0 || strcmp(effectStr, "solid") == 0) effect = LED_EFFECT_NONE;
-    else if (strcmp(effectStr, "pulse") == 0) effect = LED_EFFECT_PULSE;
-    else if (strcmp(effectStr, "rotate") == 0) effect = LED_EFFECT_ROTATE;
-    else if (strcmp(effectStr, "rainbow") == 0) effect = LED_EFFECT_RAINBOW;
-    else if (strcmp(effectStr, "glossy") == 0) effect = LED_EFFECT_GLOSSY;
-    else if (strcmp(effectStr, "off") == 0) {
+    if (strcmp(effectStr, "off") == 0) {
       LEDManager::clear();
       return true;
     }
+    ledEffectFromName(effectStr, effect);  // Effet inconnu = couleur unie
     
     LEDManager::setEffect(effect);
     handled = true;
@@ -132,8 +110,6 @@ bool ModelMiniPubNubRoutes::handleLed(const JsonObject& json) {
 }
 
 bool ModelMiniPubNubRoutes::handleStatus(const JsonObject& json) {
-  SDConfig config = SDManager::getConfig();
-  
   char statusJson[256];
   snprintf(statusJson, sizeof(statusJson),
     "{\"type\":\"status\",\"device\":\"%s\",\"ip\":\"%s\",\"brightness\":%d}",
@@ -142,7 +118,7 @@ bool ModelMiniPubNubRoutes::handleStatus(const JsonObject& json) {
     (LEDManager::getCurrentBrightness() * 100) / 255
   );
   
-  PubNubManager::publish(statusJson);
+  PubNubManager::publish(statusJson, PUBLISH_PRIORITY_CRITICAL);
   return true;
 }
 
@@ -156,3 +132,7 @@ void ModelMiniPubNubRoutes::printRoutes() {
   Serial.println("{ \"action\": \"status\" }");
   Serial.println("=========================================");
 }
+
+void ModelMiniPubNubRoutes::benchmarkRoutes() {
+  pubnubBenchmarkRoutes(ROUTES, ROUTE_COUNT);
+}
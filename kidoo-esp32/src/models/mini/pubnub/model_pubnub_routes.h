@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "../../common/managers/pubnub/pubnub_routes.h"
 
 /**
  * Routes PubNub spécifiques au modèle Kidoo Mini
@@ -27,12 +28,27 @@ public:
    * Afficher les routes disponibles
    */
   static void printRoutes();
+  
+  /**
+   * Mesurer le coût du dispatch des actions (commande "pubnub-routes bench")
+   */
+  static void benchmarkRoutes();
 
 private:
   static bool handleBrightness(const JsonObject& json);
   static bool handleSleep(const JsonObject& json);
   static bool handleLed(const JsonObject& json);
   static bool handleStatus(const JsonObject& json);
+  
+  // Actions -> handlers, triées par nom (alias compris)
+  static constexpr PubNubRoute ROUTES[] = {
+    {"brightness",  handleBrightness},
+    {"led",         handleLed},
+    {"sleep",       handleSleep},
+    {"status",      handleStatus},
+  };
+  static const size_t ROUTE_COUNT = sizeof(ROUTES) / sizeof(ROUTES[0]);
+  static_assert(isNameTableSorted(ROUTES), "ROUTES doit etre trie par nom");
 };
 
 #endif // MODEL_MINI_PUBNUB_ROUTES_H
@@ -0,0 +1,58 @@
+#ifndef KIDOO_TEST_ADAFRUIT_NEOPIXEL_H
+#define KIDOO_TEST_ADAFRUIT_NEOPIXEL_H
+
+#include <Arduino.h>
+
+#define NEO_GRB 0x52
+#define NEO_KHZ800 0x0000
+
+// Bande NeoPixel en RAM : show() ne fait que compter les trames
+class Adafruit_NeoPixel {
+public:
+  Adafruit_NeoPixel(uint16_t count, int16_t pin, uint16_t type)
+      : count(count), pixels(new uint8_t[count * 3]()) {
+    (void)pin;
+    (void)type;
+  }
+  ~Adafruit_NeoPixel() { delete[] pixels; }
+
+  void begin() {}
+  void show() { shows++; }
+  bool canShow() { return true; }
+  void clear() { memset(pixels, 0, count * 3); }
+  void setBrightness(uint8_t value) { brightness = value; }
+  uint8_t getBrightness() const { return brightness; }
+
+  void setPixelColor(uint16_t index, uint8_t r, uint8_t g, uint8_t b) {
+    if (index < count) {
+      pixels[index * 3] = r;
+      pixels[index * 3 + 1] = g;
+      pixels[index * 3 + 2] = b;
+    }
+  }
+  void setPixelColor(uint16_t index, uint32_t color) {
+    setPixelColor(index, (uint8_t)(color >> 16), (uint8_t)(color >> 8), (uint8_t)color);
+  }
+  uint32_t getPixelColor(uint16_t index) const {
+    if (index >= count) {
+      return 0;
+    }
+    return Color(pixels[index * 3], pixels[index * 3 + 1], pixels[index * 3 + 2]);
+  }
+
+  static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+  }
+
+  uint8_t* getPixels() const { return pixels; }
+  uint16_t numPixels() const { return count; }
+  uint32_t showCount() const { return shows; }
+
+private:
+  uint16_t count;
+  uint8_t* pixels;
+  uint8_t brightness = 255;
+  uint32_t shows = 0;
+};
+
+#endif // KIDOO_TEST_ADAFRUIT_NEOPIXEL_H
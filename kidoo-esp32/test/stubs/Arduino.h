@@ -0,0 +1,392 @@
+#ifndef KIDOO_TEST_ARDUINO_H
+#define KIDOO_TEST_ARDUINO_H
+
+/**
+ * Arduino minimal pour l'environnement natif (pio test -e native)
+ *
+ * Juste ce que les sources compilées sur PC utilisent : String, Print/Stream,
+ * Serial (sortie standard), millis()/micros() (horloge monotone), delay().
+ * Les tâches FreeRTOS sont des threads (voir freertos/).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <freertos/queue.h>
+#include <esp_heap_caps.h>
+
+using std::min;
+using std::max;
+
+#define IRAM_ATTR
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define DEC 10
+#define HEX 16
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// ============================================
+// Temps
+// ============================================
+
+inline std::chrono::steady_clock::time_point hostStartTime() {
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return start;
+}
+
+inline unsigned long micros() {
+  return (unsigned long)(uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - hostStartTime()).count();
+}
+
+inline unsigned long millis() {
+  return (unsigned long)(uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - hostStartTime()).count();
+}
+
+inline void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void delayMicroseconds(unsigned int us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+inline void yield() {
+  std::this_thread::yield();
+}
+
+inline int64_t esp_timer_get_time() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - hostStartTime()).count();
+}
+
+// ============================================
+// Divers
+// ============================================
+
+inline long random(long howBig) {
+  return howBig > 0 ? rand() % howBig : 0;
+}
+
+inline long random(long howSmall, long howBig) {
+  return howSmall >= howBig ? howSmall : howSmall + random(howBig - howSmall);
+}
+
+inline void randomSeed(unsigned long seed) {
+  srand((unsigned)seed);
+}
+
+inline uint32_t esp_random() {
+  return ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+}
+
+template <class T>
+inline T constrain(T value, T low, T high) {
+  return value < low ? low : (value > high ? high : value);
+}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+inline uint16_t analogRead(uint8_t) { return 0; }
+
+inline bool psramFound() { return false; }
+inline void* ps_malloc(size_t size) { return malloc(size); }
+
+// ============================================
+// String
+// ============================================
+
+class String {
+public:
+  String() {}
+  String(const char* text) : value(text != nullptr ? text : "") {}
+  String(const char* text, unsigned int length) : value(text, length) {}
+  String(const std::string& text) : value(text) {}
+  explicit String(char c) : value(1, c) {}
+  String(int number, unsigned char base = 10) : value(formatInteger((long long)number, base)) {}
+  String(unsigned int number, unsigned char base = 10) : value(formatInteger((long long)number, base)) {}
+  String(long number, unsigned char base = 10) : value(formatInteger((long long)number, base)) {}
+  String(unsigned long number, unsigned char base = 10) : value(formatInteger((long long)number, base)) {}
+  String(long long number, unsigned char base = 10) : value(formatInteger(number, base)) {}
+  String(unsigned long long number, unsigned char base = 10) : value(formatInteger((long long)number, base)) {}
+  String(float number, unsigned int decimals = 2) : value(formatFloat(number, decimals)) {}
+  String(double number, unsigned int decimals = 2) : value(formatFloat(number, decimals)) {}
+
+  const char* c_str() const { return value.c_str(); }
+  unsigned int length() const { return (unsigned int)value.size(); }
+  bool isEmpty() const { return value.empty(); }
+  bool reserve(unsigned int size) { value.reserve(size); return true; }
+  void clear() { value.clear(); }
+
+  bool concat(const String& other) { value += other.value; return true; }
+  bool concat(const char* text) { if (text != nullptr) value += text; return true; }
+  bool concat(const char* text, unsigned int length) { value.append(text, length); return true; }
+  bool concat(char c) { value += c; return true; }
+
+  String& operator+=(const String& other) { value += other.value; return *this; }
+  String& operator+=(const char* text) { concat(text); return *this; }
+  String& operator+=(char c) { value += c; return *this; }
+  String& operator+=(int number) { value += formatInteger(number, 10); return *this; }
+  String& operator+=(unsigned int number) { value += formatInteger(number, 10); return *this; }
+  String& operator+=(long number) { value += formatInteger(number, 10); return *this; }
+  String& operator+=(unsigned long number) { value += formatInteger((long long)number, 10); return *this; }
+
+  bool operator==(const String& other) const { return value == other.value; }
+  bool operator==(const char* text) const { return value == (text != nullptr ? text : ""); }
+  bool operator!=(const String& other) const { return !(*this == other); }
+  bool operator!=(const char* text) const { return !(*this == text); }
+  bool operator<(const String& other) const { return value < other.value; }
+  char operator[](unsigned int index) const { return index < value.size() ? value[index] : 0; }
+  char& operator[](unsigned int index) { return value[index]; }
+
+  bool equals(const String& other) const { return value == other.value; }
+  bool equalsIgnoreCase(const String& other) const {
+    return value.size() == other.value.size() && strcasecmp(value.c_str(), other.value.c_str()) == 0;
+  }
+  bool startsWith(const String& prefix) const { return value.compare(0, prefix.value.size(), prefix.value) == 0; }
+  bool endsWith(const String& suffix) const {
+    return value.size() >= suffix.value.size() &&
+           value.compare(value.size() - suffix.value.size(), suffix.value.size(), suffix.value) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const { return toIndex(value.find(c, from)); }
+  int indexOf(const String& text, unsigned int from = 0) const { return toIndex(value.find(text.value, from)); }
+  int lastIndexOf(char c) const { return toIndex(value.rfind(c)); }
+  int lastIndexOf(const String& text) const { return toIndex(value.rfind(text.value)); }
+  char charAt(unsigned int index) const { return (*this)[index]; }
+
+  String substring(unsigned int from) const { return from < value.size() ? String(value.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= value.size()) return String();
+    return String(value.substr(from, to - from));
+  }
+
+  void remove(unsigned int index) { if (index < value.size()) value.erase(index); }
+  void remove(unsigned int index, unsigned int count) { if (index < value.size()) value.erase(index, count); }
+  void replace(const String& from, const String& to) {
+    if (from.value.empty()) return;
+    size_t pos = 0;
+    while ((pos = value.find(from.value, pos)) != std::string::npos) {
+      value.replace(pos, from.value.size(), to.value);
+      pos += to.value.size();
+    }
+  }
+  void replace(char from, char to) { std::replace(value.begin(), value.end(), from, to); }
+  void toLowerCase() { for (char& c : value) c = (char)tolower((unsigned char)c); }
+  void toUpperCase() { for (char& c : value) c = (char)toupper((unsigned char)c); }
+  void trim() {
+    size_t start = 0;
+    while (start < value.size() && isspace((unsigned char)value[start])) start++;
+    size_t end = value.size();
+    while (end > start && isspace((unsigned char)value[end - 1])) end--;
+    value = value.substr(start, end - start);
+  }
+
+  long toInt() const { return atol(value.c_str()); }
+  float toFloat() const { return (float)atof(value.c_str()); }
+
+private:
+  static int toIndex(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+
+  static std::string formatInteger(long long number, unsigned char base) {
+    char buffer[72];
+    if (base == 16) {
+      snprintf(buffer, sizeof(buffer), "%llx", (unsigned long long)number);
+    } else {
+      snprintf(buffer, sizeof(buffer), "%lld", number);
+    }
+    return buffer;
+  }
+
+  static std::string formatFloat(double number, unsigned int decimals) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, number);
+    return buffer;
+  }
+
+  std::string value;
+};
+
+inline String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+inline String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, char b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, int b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, unsigned int b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, long b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, unsigned long b) { String r(a); r += b; return r; }
+
+// ============================================
+// Print / Stream
+// ============================================
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (n < size && write(buffer[n])) n++;
+    return n;
+  }
+  size_t write(const char* text) { return text != nullptr ? write((const uint8_t*)text, strlen(text)) : 0; }
+  size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+  virtual void flush() {}
+
+  size_t print(const char* text) { return write(text); }
+  size_t print(const String& text) { return write((const uint8_t*)text.c_str(), text.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int number, int base = DEC) { return print(String(number, (unsigned char)base)); }
+  size_t print(unsigned int number, int base = DEC) { return print(String(number, (unsigned char)base)); }
+  size_t print(long number, int base = DEC) { return print(String(number, (unsigned char)base)); }
+  size_t print(unsigned long number, int base = DEC) { return print(String(number, (unsigned char)base)); }
+  size_t print(long long number, int base = DEC) { return print(String(number, (unsigned char)base)); }
+  size_t print(unsigned long long number, int base = DEC) { return print(String(number, (unsigned char)base)); }
+  size_t print(unsigned char number, int base = DEC) { return print((unsigned int)number, base); }
+  size_t print(double number, int decimals = 2) { return print(String(number, (unsigned int)decimals)); }
+
+  size_t println() { return write("\r\n"); }
+  template <class T>
+  size_t println(const T& value) { size_t n = print(value); return n + println(); }
+  template <class T>
+  size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length <= 0) {
+      return 0;
+    }
+    return write((const uint8_t*)buffer, std::min((size_t)length, sizeof(buffer) - 1));
+  }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long timeoutMs) { timeout = timeoutMs; }
+
+  size_t readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      int c = timedRead();
+      if (c < 0) break;
+      buffer[count++] = (char)c;
+    }
+    return count;
+  }
+  size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+
+  size_t readBytesUntil(char terminator, char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      int c = timedRead();
+      if (c < 0 || c == terminator) break;
+      buffer[count++] = (char)c;
+    }
+    return count;
+  }
+
+  String readStringUntil(char terminator) {
+    String result;
+    int c = timedRead();
+    while (c >= 0 && c != terminator) {
+      result += (char)c;
+      c = timedRead();
+    }
+    return result;
+  }
+  String readString() {
+    String result;
+    int c = timedRead();
+    while (c >= 0) {
+      result += (char)c;
+      c = timedRead();
+    }
+    return result;
+  }
+
+protected:
+  virtual int timedRead() {
+    unsigned long start = millis();
+    do {
+      int c = read();
+      if (c >= 0) return c;
+      yield();
+    } while (millis() - start < timeout);
+    return -1;
+  }
+
+  unsigned long timeout = 1000;
+};
+
+// Serial : sortie standard, aucune entrée
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  void end() {}
+  operator bool() const { return true; }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  int availableForWrite() { return 4096; }
+  size_t write(uint8_t c) override { fputc(c, stdout); return 1; }
+  size_t write(const uint8_t* buffer, size_t size) override { return fwrite(buffer, 1, size, stdout); }
+  using Print::write;
+  void flush() override { fflush(stdout); }
+};
+
+inline HardwareSerial Serial;
+
+// ============================================
+// ESP
+// ============================================
+
+class EspClass {
+public:
+  uint32_t getHeapSize() { return 320 * 1024; }
+  uint32_t getFreeHeap() { return 200 * 1024; }
+  uint32_t getMinFreeHeap() { return 200 * 1024; }
+  uint32_t getMaxAllocHeap() { return 100 * 1024; }
+  uint32_t getPsramSize() { return 0; }
+  uint32_t getFreePsram() { return 0; }
+  uint32_t getCpuFreqMHz() { return 160; }
+  uint64_t getEfuseMac() { return 0x0000A1B2C3D4E5F6ULL; }
+  void restart() { exit(0); }
+};
+
+inline EspClass ESP;
+
+#endif // KIDOO_TEST_ARDUINO_H
@@ -0,0 +1,175 @@
+#ifndef KIDOO_TEST_FS_H
+#define KIDOO_TEST_FS_H
+
+/**
+ * Système de fichiers en RAM (carte SD simulée)
+ * Les fichiers restent en mémoire pendant toute l'exécution des tests.
+ */
+
+#include <Arduino.h>
+#include <map>
+#include <mutex>
+#include <memory>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+struct HostFileData {
+  std::string content;
+  time_t lastWrite = 0;
+};
+
+class File : public Stream {
+public:
+  File() {}
+  File(std::shared_ptr<HostFileData> data, const std::string& path, bool writable)
+      : data(std::move(data)), filePath(path), writable(writable) {}
+
+  explicit operator bool() const { return data != nullptr; }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    if (data == nullptr || !writable) {
+      return 0;
+    }
+    if (cursor > data->content.size()) {
+      cursor = data->content.size();
+    }
+    data->content.replace(cursor, std::min(size, data->content.size() - cursor), (const char*)buffer, size);
+    cursor += size;
+    data->lastWrite = time(nullptr);
+    return size;
+  }
+  using Print::write;
+
+  int available() override {
+    return data != nullptr && cursor < data->content.size() ? (int)(data->content.size() - cursor) : 0;
+  }
+  int read() override {
+    return available() > 0 ? (uint8_t)data->content[cursor++] : -1;
+  }
+  int peek() override {
+    return available() > 0 ? (uint8_t)data->content[cursor] : -1;
+  }
+  size_t readBytes(char* buffer, size_t size) { return read((uint8_t*)buffer, size); }
+  size_t read(uint8_t* buffer, size_t size) {
+    size_t count = std::min(size, (size_t)available());
+    if (count > 0) {
+      memcpy(buffer, data->content.data() + cursor, count);
+      cursor += count;
+    }
+    return count;
+  }
+
+  bool seek(uint32_t offset) {
+    if (data == nullptr || offset > data->content.size()) {
+      return false;
+    }
+    cursor = offset;
+    return true;
+  }
+  size_t position() const { return cursor; }
+  size_t size() const { return data != nullptr ? data->content.size() : 0; }
+  void flush() override {}
+  void close() { data.reset(); }
+
+  time_t getLastWrite() { return data != nullptr ? data->lastWrite : 0; }
+  const char* path() const { return filePath.c_str(); }
+  const char* name() const {
+    size_t slash = filePath.rfind('/');
+    return filePath.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+  }
+  bool isDirectory() { return false; }
+  File openNextFile() { return File(); }
+
+protected:
+  // Fin de fichier : pas d'attente de données (contrairement à un socket)
+  int timedRead() override { return read(); }
+
+private:
+  std::shared_ptr<HostFileData> data;
+  std::string filePath;
+  bool writable = false;
+  size_t cursor = 0;
+};
+
+class FS {
+public:
+  File open(const char* path, const char* mode = FILE_READ, bool create = false) {
+    (void)create;
+    if (!mounted || path == nullptr) {
+      return File();
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = files.find(path);
+    if (mode[0] == 'r') {
+      return it != files.end() ? File(it->second, path, false) : File();
+    }
+    if (it == files.end() || mode[0] == 'w') {
+      auto data = std::make_shared<HostFileData>();
+      data->lastWrite = time(nullptr);
+      files[path] = data;
+      return File(data, path, true);
+    }
+    File file(it->second, path, true);
+    file.seek(it->second->content.size());  // Mode append
+    return file;
+  }
+  File open(const String& path, const char* mode = FILE_READ) { return open(path.c_str(), mode); }
+
+  bool exists(const char* path) {
+    std::lock_guard<std::mutex> guard(lock);
+    return mounted && files.count(path) > 0;
+  }
+  bool exists(const String& path) { return exists(path.c_str()); }
+
+  bool remove(const char* path) {
+    std::lock_guard<std::mutex> guard(lock);
+    return mounted && files.erase(path) > 0;
+  }
+  bool remove(const String& path) { return remove(path.c_str()); }
+
+  bool rename(const char* from, const char* to) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = files.find(from);
+    if (!mounted || it == files.end() || files.count(to) > 0) {
+      return false;
+    }
+    files[to] = it->second;
+    files.erase(it);
+    return true;
+  }
+
+  bool mkdir(const char*) { return mounted; }
+  bool rmdir(const char*) { return mounted; }
+
+  // Contenu de la carte pour les tests
+  void hostClear() {
+    std::lock_guard<std::mutex> guard(lock);
+    files.clear();
+  }
+  size_t hostUsedBytes() {
+    std::lock_guard<std::mutex> guard(lock);
+    size_t used = 0;
+    for (const auto& entry : files) {
+      used += entry.second->content.size();
+    }
+    return used;
+  }
+
+protected:
+  bool mounted = false;
+
+private:
+  std::mutex lock;
+  std::map<std::string, std::shared_ptr<HostFileData>> files;
+};
+
+}  // namespace fs
+
+using fs::File;
+
+#endif // KIDOO_TEST_FS_H
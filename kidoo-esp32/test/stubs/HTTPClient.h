@@ -0,0 +1,201 @@
+#ifndef KIDOO_TEST_HTTP_CLIENT_H
+#define KIDOO_TEST_HTTP_CLIENT_H
+
+/**
+ * HTTPClient minimal sur WiFiClient (sockets POSIX)
+ * Reprend le comportement de la bibliothèque ESP32 utilisé par le firmware :
+ * réutilisation de la connexion (setReuse), "Connection: close" du serveur,
+ * codes d'erreur HTTPC_ERROR_*. Le corps de la réponse est lu avec les en-têtes.
+ */
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+#include "WiFiClient.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED  (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED  (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED       (-4)
+#define HTTPC_ERROR_CONNECTION_LOST     (-5)
+#define HTTPC_ERROR_NO_STREAM           (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER      (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM        (-8)
+#define HTTPC_ERROR_ENCODING            (-9)
+#define HTTPC_ERROR_STREAM_WRITE        (-10)
+#define HTTPC_ERROR_READ_TIMEOUT        (-11)
+
+typedef enum {
+  HTTP_CODE_OK = 200,
+  HTTP_CODE_NO_CONTENT = 204,
+  HTTP_CODE_NOT_MODIFIED = 304,
+  HTTP_CODE_BAD_REQUEST = 400,
+  HTTP_CODE_NOT_FOUND = 404,
+  HTTP_CODE_INTERNAL_SERVER_ERROR = 500
+} t_http_codes;
+
+class HTTPClient {
+public:
+  bool begin(WiFiClient& wifiClient, const char* url) {
+    client = &wifiClient;
+    headers.clear();
+    response.clear();
+    canReuse = true;
+    std::string text(url);
+    size_t scheme = text.find("://");
+    if (scheme != std::string::npos) {
+      text = text.substr(scheme + 3);
+    }
+    size_t slash = text.find('/');
+    std::string hostPort = text.substr(0, slash);
+    path = (slash == std::string::npos) ? "/" : text.substr(slash);
+    size_t colon = hostPort.find(':');
+    host = hostPort.substr(0, colon);
+    port = (colon == std::string::npos) ? 80 : (uint16_t)atoi(hostPort.c_str() + colon + 1);
+    return true;
+  }
+  bool begin(WiFiClient& wifiClient, const String& url) { return begin(wifiClient, url.c_str()); }
+
+  void end() {
+    if (client == nullptr) {
+      return;
+    }
+    if (!reuse || !canReuse) {
+      client->stop();
+    } else {
+      while (client->available() > 0) {
+        client->read();
+      }
+    }
+  }
+
+  void setReuse(bool enabled) { reuse = enabled; }
+  void setConnectTimeout(int32_t timeoutMs) { connectTimeoutMs = timeoutMs; }
+  void setTimeout(uint16_t timeoutMs) { readTimeoutMs = timeoutMs; }
+  void addHeader(const String& name, const String& value) {
+    headers += name.c_str();
+    headers += ": ";
+    headers += value.c_str();
+    headers += "\r\n";
+  }
+
+  int GET() { return sendRequest("GET", nullptr, 0); }
+  int POST(uint8_t* payload, size_t size) { return sendRequest("POST", payload, size); }
+  int POST(const String& payload) { return POST((uint8_t*)payload.c_str(), payload.length()); }
+
+  String getString() { return String(response.c_str()); }
+  int getSize() { return (int)response.size(); }
+  bool connected() { return client != nullptr && client->connected(); }
+
+  static String errorToString(int error) {
+    char text[32];
+    snprintf(text, sizeof(text), "HTTPC_ERROR %d", error);
+    return String(text);
+  }
+
+private:
+  int sendRequest(const char* method, const uint8_t* payload, size_t size) {
+    if (client == nullptr) {
+      return HTTPC_ERROR_NOT_CONNECTED;
+    }
+    response.clear();
+    if (!client->connected() && !client->connect(host.c_str(), port, connectTimeoutMs)) {
+      return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+
+    char header[512];
+    int length = snprintf(header, sizeof(header),
+                          "%s %s HTTP/1.1\r\nHost: %s:%u\r\nUser-Agent: ESP32HTTPClient\r\n"
+                          "Connection: %s\r\nContent-Length: %u\r\n%s\r\n",
+                          method, path.c_str(), host.c_str(), port, reuse ? "keep-alive" : "close",
+                          (unsigned)size, headers.c_str());
+    if (length <= 0 || client->write((const uint8_t*)header, length) != (size_t)length) {
+      return HTTPC_ERROR_SEND_HEADER_FAILED;
+    }
+    if (size > 0 && client->write(payload, size) != size) {
+      return HTTPC_ERROR_SEND_PAYLOAD_FAILED;
+    }
+    return readResponse();
+  }
+
+  int readResponse() {
+    // Attente de la ligne de statut : connexion perdue si le serveur ferme sans répondre
+    unsigned long start = millis();
+    while (client->available() == 0) {
+      if (!client->connected()) {
+        return HTTPC_ERROR_CONNECTION_LOST;
+      }
+      if (millis() - start >= readTimeoutMs) {
+        return HTTPC_ERROR_READ_TIMEOUT;
+      }
+      delay(1);
+    }
+
+    client->setTimeout(readTimeoutMs);
+    String line = client->readStringUntil('\n');
+    int space = line.indexOf(' ');
+    int status = (space > 0) ? line.substring(space + 1).toInt() : 0;
+    if (status <= 0) {
+      return HTTPC_ERROR_NO_HTTP_SERVER;
+    }
+
+    long contentLength = -1;
+    bool chunked = false;
+    while (true) {
+      line = client->readStringUntil('\n');
+      line.trim();
+      if (line.length() == 0) {
+        break;
+      }
+      line.toLowerCase();
+      if (line.startsWith("content-length:")) {
+        contentLength = line.substring(15).toInt();
+      } else if (line.startsWith("transfer-encoding:") && line.indexOf("chunked") > 0) {
+        chunked = true;
+      } else if (line.startsWith("connection:") && line.indexOf("close") > 0) {
+        canReuse = false;
+      }
+    }
+
+    if (chunked) {
+      while (true) {
+        long chunkSize = strtol(client->readStringUntil('\n').c_str(), nullptr, 16);
+        if (chunkSize <= 0) {
+          client->readStringUntil('\n');
+          break;
+        }
+        readBody(chunkSize);
+        client->readStringUntil('\n');
+      }
+    } else if (contentLength > 0) {
+      readBody(contentLength);
+    }
+    return status;
+  }
+
+  void readBody(long size) {
+    char buffer[256];
+    while (size > 0) {
+      size_t count = client->readBytes(buffer, std::min((size_t)size, sizeof(buffer)));
+      if (count == 0) {
+        canReuse = false;
+        return;
+      }
+      response.append(buffer, count);
+      size -= count;
+    }
+  }
+
+  WiFiClient* client = nullptr;
+  std::string host;
+  std::string path;
+  uint16_t port = 80;
+  std::string headers;
+  std::string response;
+  bool reuse = false;
+  bool canReuse = true;
+  int32_t connectTimeoutMs = 5000;
+  uint16_t readTimeoutMs = 5000;
+};
+
+#endif // KIDOO_TEST_HTTP_CLIENT_H
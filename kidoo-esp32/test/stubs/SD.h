@@ -0,0 +1,42 @@
+#ifndef KIDOO_TEST_SD_H
+#define KIDOO_TEST_SD_H
+
+#include <FS.h>
+#include <SPI.h>
+
+#define CARD_NONE 0
+#define CARD_MMC 1
+#define CARD_SD 2
+#define CARD_SDHC 3
+
+// Carte SD simulée : présente par défaut, retirable par les tests
+class SDFS : public fs::FS {
+public:
+  bool begin(uint8_t csPin = 0, SPIClass& spi = SPI, uint32_t frequency = 4000000) {
+    (void)csPin;
+    (void)spi;
+    (void)frequency;
+    mounted = inserted;
+    return mounted;
+  }
+  void end() { mounted = false; }
+
+  uint8_t cardType() { return mounted ? CARD_SDHC : CARD_NONE; }
+  uint64_t cardSize() { return mounted ? 4ULL * 1024 * 1024 * 1024 : 0; }
+  uint64_t totalBytes() { return cardSize(); }
+  uint64_t usedBytes() { return hostUsedBytes(); }
+
+  void hostSetInserted(bool present) {
+    inserted = present;
+    if (!present) {
+      mounted = false;
+    }
+  }
+
+private:
+  bool inserted = true;
+};
+
+inline SDFS SD;
+
+#endif // KIDOO_TEST_SD_H
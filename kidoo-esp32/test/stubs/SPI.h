@@ -0,0 +1,19 @@
+#ifndef KIDOO_TEST_SPI_H
+#define KIDOO_TEST_SPI_H
+
+#include <Arduino.h>
+
+class SPIClass {
+public:
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {
+    (void)sck;
+    (void)miso;
+    (void)mosi;
+    (void)ss;
+  }
+  void end() {}
+};
+
+inline SPIClass SPI;
+
+#endif // KIDOO_TEST_SPI_H
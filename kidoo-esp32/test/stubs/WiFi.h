@@ -0,0 +1,46 @@
+#ifndef KIDOO_TEST_WIFI_H
+#define KIDOO_TEST_WIFI_H
+
+/**
+ * WiFi sur PC : toujours connecté (la machine hôte a le réseau),
+ * les sockets passent par WiFiClient (sockets POSIX)
+ */
+
+#include <Arduino.h>
+#include "WiFiClient.h"
+#include "esp_mac.h"
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+class WiFiClass {
+public:
+  wl_status_t status() { return WL_CONNECTED; }
+  bool isConnected() { return true; }
+  IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+  int8_t RSSI() { return -50; }
+  String SSID() { return String("host"); }
+
+  uint8_t* macAddress(uint8_t* mac) {
+    esp_read_mac(mac, ESP_MAC_WIFI_STA);
+    return mac;
+  }
+  String macAddress() {
+    uint8_t mac[6];
+    macAddress(mac);
+    char text[18];
+    snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    return String(text);
+  }
+};
+
+inline WiFiClass WiFi;
+
+#endif // KIDOO_TEST_WIFI_H
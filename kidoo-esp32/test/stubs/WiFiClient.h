@@ -0,0 +1,210 @@
+#ifndef KIDOO_TEST_WIFI_CLIENT_H
+#define KIDOO_TEST_WIFI_CLIENT_H
+
+/**
+ * WiFiClient sur sockets POSIX (TCP réel vers un serveur local)
+ * Même comportement que le client lwIP de l'ESP32 pour ce que le firmware utilise :
+ * connect() avec timeout, available() non bloquant, lectures bufferisées,
+ * connected() vrai tant que des octets restent à lire.
+ */
+
+#include <Arduino.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+class IPAddress {
+public:
+  IPAddress() : value(0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+      : value((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+  explicit IPAddress(uint32_t address) : value(address) {}
+
+  operator uint32_t() const { return value; }
+  uint8_t operator[](int index) const { return (uint8_t)(value >> (index * 8)); }
+
+  String toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(text);
+  }
+
+private:
+  uint32_t value;  // Ordre réseau, comme lwIP
+};
+
+class WiFiClient : public Stream {
+public:
+  WiFiClient() {}
+  ~WiFiClient() override { stop(); }
+
+  WiFiClient(const WiFiClient&) = delete;
+  WiFiClient& operator=(const WiFiClient&) = delete;
+
+  int connect(const char* host, uint16_t port, int32_t timeoutMs = 3000) {
+    stop();
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* result = nullptr;
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    if (getaddrinfo(host, service, &hints, &result) != 0 || result == nullptr) {
+      return 0;
+    }
+
+    int socketFd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (socketFd < 0) {
+      freeaddrinfo(result);
+      return 0;
+    }
+    // Connexion non bloquante pour respecter le timeout
+    fcntl(socketFd, F_SETFL, fcntl(socketFd, F_GETFL, 0) | O_NONBLOCK);
+    int status = ::connect(socketFd, result->ai_addr, result->ai_addrlen);
+    freeaddrinfo(result);
+    if (status < 0 && errno == EINPROGRESS) {
+      struct pollfd waitFd = {socketFd, POLLOUT, 0};
+      int error = 0;
+      socklen_t length = sizeof(error);
+      if (poll(&waitFd, 1, timeoutMs) == 1 &&
+          getsockopt(socketFd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0) {
+        status = 0;
+      }
+    }
+    if (status < 0) {
+      ::close(socketFd);
+      return 0;
+    }
+    fcntl(socketFd, F_SETFL, fcntl(socketFd, F_GETFL, 0) & ~O_NONBLOCK);
+    sockFd = socketFd;
+    return 1;
+  }
+  int connect(IPAddress ip, uint16_t port, int32_t timeoutMs = 3000) {
+    return connect(ip.toString().c_str(), port, timeoutMs);
+  }
+
+  void stop() {
+    if (sockFd >= 0) {
+      ::close(sockFd);
+      sockFd = -1;
+    }
+    rxStart = 0;
+    rxEnd = 0;
+  }
+
+  uint8_t connected() {
+    if (sockFd < 0) {
+      return 0;
+    }
+    if (rxEnd > rxStart) {
+      return 1;
+    }
+    char c;
+    ssize_t result = recv(sockFd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (result > 0 || (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))) {
+      return 1;
+    }
+    // Fermée par le serveur (0) ou erreur : plus rien à lire
+    return 0;
+  }
+  explicit operator bool() { return connected(); }
+
+  // Descripteur du socket (-1 si fermé), pour select()
+  int fd() const { return sockFd; }
+
+  int setNoDelay(bool noDelay) {
+    int value = noDelay ? 1 : 0;
+    return sockFd >= 0 ? setsockopt(sockFd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value)) : -1;
+  }
+
+  // Print
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    size_t sent = 0;
+    while (sockFd >= 0 && sent < size) {
+      ssize_t result = send(sockFd, buffer + sent, size - sent, MSG_NOSIGNAL);
+      if (result <= 0) {
+        if (result < 0 && errno == EINTR) {
+          continue;
+        }
+        break;
+      }
+      sent += result;
+    }
+    return sent;
+  }
+  using Print::write;
+
+  // Stream
+  int available() override {
+    if (rxEnd > rxStart) {
+      return (int)(rxEnd - rxStart);
+    }
+    fill(0);
+    return (int)(rxEnd - rxStart);
+  }
+  int read() override {
+    if (rxEnd == rxStart && !fill(0)) {
+      return -1;
+    }
+    return (uint8_t)rx[rxStart++];
+  }
+  int read(uint8_t* buffer, size_t size) {
+    size_t count = 0;
+    while (count < size && (rxEnd > rxStart || fill(0))) {
+      size_t chunk = std::min(size - count, rxEnd - rxStart);
+      memcpy(buffer + count, rx + rxStart, chunk);
+      rxStart += chunk;
+      count += chunk;
+    }
+    return (int)count;
+  }
+  int peek() override {
+    if (rxEnd == rxStart && !fill(0)) {
+      return -1;
+    }
+    return (uint8_t)rx[rxStart];
+  }
+  void flush() override {}
+
+protected:
+  // Attente des données jusqu'au timeout du Stream (readBytes, readStringUntil)
+  int timedRead() override {
+    if (rxEnd == rxStart && !fill((int)timeout)) {
+      return -1;
+    }
+    return (uint8_t)rx[rxStart++];
+  }
+
+private:
+  // Remplir le tampon de réception (attente max waitMs, 0 = non bloquant)
+  bool fill(int waitMs) {
+    if (sockFd < 0) {
+      return false;
+    }
+    struct pollfd waitFd = {sockFd, POLLIN, 0};
+    if (poll(&waitFd, 1, waitMs) <= 0) {
+      return false;
+    }
+    ssize_t result = recv(sockFd, rx, sizeof(rx), 0);
+    if (result <= 0) {
+      return false;
+    }
+    rxStart = 0;
+    rxEnd = (size_t)result;
+    return true;
+  }
+
+  int sockFd = -1;
+  char rx[1436];  // Un segment TCP, comme le tampon lwIP
+  size_t rxStart = 0;
+  size_t rxEnd = 0;
+};
+
+#endif // KIDOO_TEST_WIFI_CLIENT_H
@@ -0,0 +1,36 @@
+#ifndef KIDOO_TEST_ESP_HEAP_CAPS_H
+#define KIDOO_TEST_ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+inline void* heap_caps_malloc(size_t size, unsigned int caps) {
+  (void)caps;
+  return malloc(size);
+}
+
+inline void* heap_caps_aligned_alloc(size_t alignment, size_t size, unsigned int caps) {
+  (void)caps;
+  return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+inline void heap_caps_free(void* ptr) {
+  free(ptr);
+}
+
+inline size_t heap_caps_get_free_size(unsigned int caps) {
+  (void)caps;
+  return 200 * 1024;
+}
+
+inline size_t heap_caps_get_largest_free_block(unsigned int caps) {
+  (void)caps;
+  return 100 * 1024;
+}
+
+#endif // KIDOO_TEST_ESP_HEAP_CAPS_H
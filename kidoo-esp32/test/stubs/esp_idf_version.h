@@ -0,0 +1,9 @@
+#ifndef KIDOO_TEST_ESP_IDF_VERSION_H
+#define KIDOO_TEST_ESP_IDF_VERSION_H
+
+// Pas de driver RMT sur PC : core_config.h choisit la sortie NeoPixel
+#define ESP_IDF_VERSION_MAJOR 5
+#define ESP_IDF_VERSION_MINOR 0
+#define ESP_IDF_VERSION_PATCH 0
+
+#endif // KIDOO_TEST_ESP_IDF_VERSION_H
@@ -0,0 +1,23 @@
+#ifndef KIDOO_TEST_ESP_MAC_H
+#define KIDOO_TEST_ESP_MAC_H
+
+#include <stdint.h>
+#include <string.h>
+#include "esp_err.h"
+
+typedef enum {
+  ESP_MAC_WIFI_STA,
+  ESP_MAC_WIFI_SOFTAP,
+  ESP_MAC_BT,
+  ESP_MAC_ETH,
+} esp_mac_type_t;
+
+// Adresse fixe sur PC (le channel PubNub en dépend)
+inline esp_err_t esp_read_mac(uint8_t* mac, esp_mac_type_t type) {
+  static const uint8_t HOST_MAC[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+  memcpy(mac, HOST_MAC, 6);
+  mac[5] += (uint8_t)type;
+  return ESP_OK;
+}
+
+#endif // KIDOO_TEST_ESP_MAC_H
@@ -0,0 +1,44 @@
+#ifndef KIDOO_TEST_FREERTOS_H
+#define KIDOO_TEST_FREERTOS_H
+
+/**
+ * FreeRTOS minimal pour l'environnement natif : tâches = threads,
+ * sections critiques = un verrou global (équivalent d'un seul cœur)
+ */
+
+#include <stdint.h>
+#include <mutex>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define portTICK_PERIOD_MS 1
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 25
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+typedef struct {
+  int unused;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+inline std::recursive_mutex& hostCriticalLock() {
+  static std::recursive_mutex lock;
+  return lock;
+}
+
+inline void portENTER_CRITICAL(portMUX_TYPE*) { hostCriticalLock().lock(); }
+inline void portEXIT_CRITICAL(portMUX_TYPE*) { hostCriticalLock().unlock(); }
+inline void portENTER_CRITICAL_ISR(portMUX_TYPE* mux) { portENTER_CRITICAL(mux); }
+inline void portEXIT_CRITICAL_ISR(portMUX_TYPE* mux) { portEXIT_CRITICAL(mux); }
+
+inline BaseType_t xPortGetCoreID() { return 0; }
+
+#endif // KIDOO_TEST_FREERTOS_H
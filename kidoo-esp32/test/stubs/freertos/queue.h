@@ -0,0 +1,61 @@
+#ifndef KIDOO_TEST_FREERTOS_QUEUE_H
+#define KIDOO_TEST_FREERTOS_QUEUE_H
+
+#include "FreeRTOS.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <string.h>
+#include <string>
+
+// File de messages de taille fixe (copie des éléments)
+struct HostQueue {
+  std::mutex lock;
+  std::condition_variable changed;
+  std::deque<std::string> items;
+  UBaseType_t length;
+  UBaseType_t itemSize;
+};
+
+typedef HostQueue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  HostQueue* queue = new HostQueue();
+  queue->length = length;
+  queue->itemSize = itemSize;
+  return queue;
+}
+
+inline void vQueueDelete(QueueHandle_t queue) {
+  delete queue;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+  std::unique_lock<std::mutex> guard(queue->lock);
+  auto hasRoom = [queue]() { return queue->items.size() < queue->length; };
+  if (!queue->changed.wait_for(guard, std::chrono::milliseconds(ticksToWait), hasRoom)) {
+    return pdFALSE;
+  }
+  queue->items.emplace_back((const char*)item, queue->itemSize);
+  queue->changed.notify_all();
+  return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticksToWait) {
+  std::unique_lock<std::mutex> guard(queue->lock);
+  auto hasItem = [queue]() { return !queue->items.empty(); };
+  if (!queue->changed.wait_for(guard, std::chrono::milliseconds(ticksToWait), hasItem)) {
+    return pdFALSE;
+  }
+  memcpy(item, queue->items.front().data(), queue->itemSize);
+  queue->items.pop_front();
+  queue->changed.notify_all();
+  return pdTRUE;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> guard(queue->lock);
+  return (UBaseType_t)queue->items.size();
+}
+
+#endif // KIDOO_TEST_FREERTOS_QUEUE_H
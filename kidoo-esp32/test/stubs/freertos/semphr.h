@@ -0,0 +1,32 @@
+#ifndef KIDOO_TEST_FREERTOS_SEMPHR_H
+#define KIDOO_TEST_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+#include <chrono>
+#include <mutex>
+
+// Mutex FreeRTOS (xSemaphoreCreateMutex uniquement)
+typedef std::timed_mutex* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return new std::timed_mutex();
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticksToWait) {
+  if (ticksToWait == portMAX_DELAY) {
+    mutex->lock();
+    return pdTRUE;
+  }
+  return mutex->try_lock_for(std::chrono::milliseconds(ticksToWait)) ? pdTRUE : pdFALSE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+  mutex->unlock();
+  return pdTRUE;
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t mutex) {
+  delete mutex;
+}
+
+#endif // KIDOO_TEST_FREERTOS_SEMPHR_H
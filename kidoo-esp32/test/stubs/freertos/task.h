@@ -0,0 +1,102 @@
+#ifndef KIDOO_TEST_FREERTOS_TASK_H
+#define KIDOO_TEST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+
+// Une tâche = un thread détaché et son compteur de notifications
+struct HostTask {
+  std::mutex lock;
+  std::condition_variable notified;
+  uint32_t notifyCount = 0;
+  UBaseType_t priority = 0;
+};
+
+typedef HostTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+inline HostTask*& hostCurrentTask() {
+  thread_local HostTask* current = nullptr;
+  return current;
+}
+
+inline TickType_t xTaskGetTickCount() {
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return (TickType_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackSize,
+                                          void* parameter, UBaseType_t priority, TaskHandle_t* handle,
+                                          BaseType_t core) {
+  (void)name;
+  (void)stackSize;
+  (void)core;
+  HostTask* task = new HostTask();
+  task->priority = priority;
+  if (handle != nullptr) {
+    *handle = task;  // Visible avant le démarrage de la tâche, comme sur FreeRTOS
+  }
+  std::thread([function, parameter, task]() {
+    hostCurrentTask() = task;
+    function(parameter);
+  }).detach();
+  return pdPASS;
+}
+
+inline BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackSize,
+                              void* parameter, UBaseType_t priority, TaskHandle_t* handle) {
+  return xTaskCreatePinnedToCore(function, name, stackSize, parameter, priority, handle, 0);
+}
+
+// Un thread ne peut pas être tué : les tâches du firmware sortent d'elles-mêmes
+// (flag d'arrêt) avant vTaskDelete, qui n'a donc rien à faire ici
+inline void vTaskDelete(TaskHandle_t) {}
+
+inline void vTaskDelay(TickType_t ticks) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+  // Le thread principal (setup/loop, test) a aussi un handle
+  HostTask*& current = hostCurrentTask();
+  if (current == nullptr) {
+    current = new HostTask();
+  }
+  return current;
+}
+
+inline UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+  return (task != nullptr ? task : xTaskGetCurrentTaskHandle())->priority;
+}
+
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) {
+  return 0;
+}
+
+inline BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  {
+    std::lock_guard<std::mutex> guard(task->lock);
+    task->notifyCount++;
+  }
+  task->notified.notify_one();
+  return pdPASS;
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+  HostTask* task = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> guard(task->lock);
+  auto ready = [task]() { return task->notifyCount > 0; };
+  if (ticksToWait == portMAX_DELAY) {
+    task->notified.wait(guard, ready);
+  } else if (!task->notified.wait_for(guard, std::chrono::milliseconds(ticksToWait), ready)) {
+    return 0;
+  }
+  uint32_t count = task->notifyCount;
+  task->notifyCount = clearOnExit ? 0 : count - 1;
+  return count;
+}
+
+#endif // KIDOO_TEST_FREERTOS_TASK_H
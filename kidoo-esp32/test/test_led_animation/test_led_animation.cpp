@@ -0,0 +1,61 @@
+/**
+ * Décodeur d'animations keyframes (.kan) sur PC : trames de référence et débit
+ *
+ *   pio test -e native -f test_led_animation -v
+ *
+ * Le fichier synthétique de LEDEffectBench (16 couleurs, 60 LEDs, 32 keyframes,
+ * toutes les courbes) est décodé en flux depuis la RAM, sans carte SD.
+ */
+
+#include <unity.h>
+#include "models/common/managers/led/effects/led_effect_bench.h"
+
+// Trames décodées par taille de bande pour la mesure
+static const uint32_t BENCH_FRAMES = 2000;
+
+static uint8_t pixels[LEDEffectBench::MAX_LEDS * 3];
+
+void setUp() {}
+void tearDown() {}
+
+static void test_golden_frames() {
+  uint32_t crc = LEDEffectBench::animationChecksum(pixels);
+  TEST_ASSERT_NOT_EQUAL_MESSAGE(0, crc, "decodage en echec");
+  TEST_ASSERT_EQUAL_HEX32(LEDEffectBench::ANIMATION_GOLDEN_CHECKSUM, crc);
+}
+
+static void test_golden_frames_are_repeatable() {
+  uint32_t first = LEDEffectBench::animationChecksum(pixels);
+  LEDEffectBench::measureAnimation(LEDEffectBench::MAX_LEDS, 100, pixels, nullptr);
+  TEST_ASSERT_EQUAL_HEX32(first, LEDEffectBench::animationChecksum(pixels));
+}
+
+static void test_decoder_throughput() {
+  char line[96];
+  for (size_t s = 0; s < LEDEffectBench::SIZE_COUNT; s++) {
+    uint16_t count = LEDEffectBench::SIZES[s];
+    uint32_t bytesRead = 0;
+    uint32_t ns = LEDEffectBench::measureAnimation(count, BENCH_FRAMES, pixels, &bytesRead);
+    TEST_ASSERT_NOT_EQUAL_MESSAGE(0, ns, "decodage en echec");
+
+    // Les keyframes sont lues au fil de l'eau : 2000 trames à 60 FPS bouclent plusieurs fois
+    TEST_ASSERT_GREATER_THAN_UINT32(0, bytesRead);
+
+    uint64_t totalNs = (uint64_t)ns * BENCH_FRAMES;
+    snprintf(line, sizeof(line), "%3u LEDs: %6lu ns/trame, %7lu octets lus, %lu Ko/s",
+             count, (unsigned long)ns, (unsigned long)bytesRead,
+             (unsigned long)((uint64_t)bytesRead * 1000000000ULL / 1024 / totalNs));
+    // Débit affiché sans seuil : il dépend de la machine et de sa charge
+    TEST_MESSAGE(line);
+  }
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_golden_frames);
+  RUN_TEST(test_golden_frames_are_repeatable);
+  RUN_TEST(test_decoder_throughput);
+  return UNITY_END();
+}
@@ -0,0 +1,78 @@
+/**
+ * Compositeur de transitions sur PC : trames de référence et durée par trame
+ *
+ *   pio test -e native -f test_led_compositor -v
+ *
+ * Une trame de transition rend deux calques, les mélange puis applique les
+ * tables de sortie. Sa durée sur le PC est affichée sans seuil (elle dépend de
+ * la machine et de sa charge) ; led-bench mesure la vraie marge sur la carte
+ * face à LED_TRANSITION_FRAME_BUDGET_US.
+ */
+
+#include <unity.h>
+#include "models/common/managers/led/effects/led_effect_bench.h"
+#include "models/common/managers/led/led_compositor.h"
+#include "models/common/managers/led/led_fixed_math.h"
+
+// Trames de transition rendues par taille de bande pour la mesure
+static const uint32_t BENCH_FRAMES = 2000;
+
+static uint8_t pixels[LEDEffectBench::MAX_LEDS * 3];
+
+void setUp() {}
+void tearDown() {}
+
+static void test_golden_frames() {
+  TEST_ASSERT_EQUAL_HEX32(LEDEffectBench::COMPOSITE_GOLDEN_CHECKSUM, LEDEffectBench::compositeChecksum(pixels));
+}
+
+static void test_fade_endpoints() {
+  // alpha = 0 : calque de départ seul ; alpha = 1.0 : calque d'arrivée seul
+  static uint8_t from[LEDEffectBench::MAX_LEDS * 3];
+  static uint8_t to[LEDEffectBench::MAX_LEDS * 3];
+  static uint8_t expected[LEDEffectBench::MAX_LEDS * 3];
+  uint8_t lut[3][256];
+  for (int c = 0; c < 3; c++) {
+    ledBuildOutputLut(lut[c], 255, 255);
+  }
+  const uint16_t count = 60;
+  for (uint16_t i = 0; i < count * 3; i++) {
+    from[i] = (uint8_t)(i * 7 + 13);
+    to[i] = (uint8_t)(255 - i * 3);
+  }
+
+  for (uint16_t i = 0; i < count * 3; i++) {
+    expected[i] = lut[i % 3][from[i]];
+  }
+  ledCompositeFrame(pixels, from, to, count, 0, lut);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, pixels, count * 3);
+
+  for (uint16_t i = 0; i < count * 3; i++) {
+    expected[i] = lut[i % 3][to[i]];
+  }
+  ledCompositeFrame(pixels, from, to, count, LED_Q15_ONE, lut);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, pixels, count * 3);
+}
+
+static void test_report_transition_frame_time() {
+  char line[96];
+  for (size_t s = 0; s < LEDEffectBench::SIZE_COUNT; s++) {
+    uint16_t count = LEDEffectBench::SIZES[s];
+    uint32_t ns = LEDEffectBench::measureTransition(count, BENCH_FRAMES, pixels);
+    TEST_ASSERT_NOT_EQUAL(0, ns);
+
+    snprintf(line, sizeof(line), "%3u LEDs: %6lu ns/trame de transition (budget carte %lu ns)",
+             count, (unsigned long)ns, (unsigned long)LED_TRANSITION_FRAME_BUDGET_US * 1000UL);
+    TEST_MESSAGE(line);
+  }
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_golden_frames);
+  RUN_TEST(test_fade_endpoints);
+  RUN_TEST(test_report_transition_frame_time);
+  return UNITY_END();
+}
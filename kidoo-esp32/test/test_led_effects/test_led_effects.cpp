@@ -0,0 +1,93 @@
+/**
+ * Rendu des effets LED sur PC : trames de référence et temps par trame
+ *
+ *   pio test -e native -f test_led_effects -v
+ *
+ * Les checksums de référence sont ceux de LEDEffectBench (effects/led_effect_bench.cpp),
+ * également vérifiés sur la carte par la commande série led-bench. En cas d'échec,
+ * le message donne le checksum obtenu : le reporter dans GOLDEN_CHECKSUMS seulement
+ * si le rendu de l'effet a changé volontairement.
+ */
+
+#include <unity.h>
+#include "models/common/managers/led/effects/led_effect.h"
+#include "models/common/managers/led/effects/led_effect_bench.h"
+
+// Trames rendues par taille de bande pour la mesure
+static const uint32_t BENCH_FRAMES = 2000;
+
+static uint8_t pixels[LEDEffectBench::MAX_LEDS * 3];
+
+void setUp() {}
+void tearDown() {}
+
+static void test_every_effect_is_registered() {
+  // Dream compile tous les effets : chaque LEDEffect (sauf NONE) doit être trouvé
+  for (int id = LED_EFFECT_RAINBOW; id <= LED_EFFECT_ANIMATION; id++) {
+    const LEDEffectDescriptor* effect = LEDEffectRegistry::find((LEDEffect)id);
+    TEST_ASSERT_NOT_NULL(effect);
+    TEST_ASSERT_EQUAL_INT(id, effect->id);
+    TEST_ASSERT_NOT_NULL(effect->render);
+  }
+  TEST_ASSERT_NULL(LEDEffectRegistry::find(LED_EFFECT_NONE));
+}
+
+static void test_golden_frames() {
+  for (size_t e = 0; e < LEDEffectRegistry::count(); e++) {
+    const LEDEffectDescriptor* effect = LEDEffectRegistry::at(e);
+    if (effect->id == LED_EFFECT_ANIMATION) {
+      continue;  // Dépend du fichier lu sur la carte SD
+    }
+    uint32_t expected = LEDEffectBench::expectedChecksum(effect->id);
+    TEST_ASSERT_NOT_EQUAL_MESSAGE(0, expected, effect->name);
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(expected, LEDEffectBench::goldenChecksum(effect), effect->name);
+  }
+}
+
+static void test_golden_frames_are_repeatable() {
+  // Les effets avec état (init) doivent repartir de zéro à chaque activation
+  for (size_t e = 0; e < LEDEffectRegistry::count(); e++) {
+    const LEDEffectDescriptor* effect = LEDEffectRegistry::at(e);
+    if (effect->id == LED_EFFECT_ANIMATION) {
+      continue;
+    }
+    uint32_t first = LEDEffectBench::goldenChecksum(effect);
+    LEDEffectBench::measureRender(effect, LEDEffectBench::MAX_LEDS, 100, pixels);
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(first, LEDEffectBench::goldenChecksum(effect), effect->name);
+  }
+}
+
+// Temps affichés sans seuil : ils dépendent de la machine et de sa charge
+// (les vraies mesures de la carte sont données par led-bench)
+static void test_render_time_per_frame() {
+  char line[160];
+  int length = snprintf(line, sizeof(line), "%-13s", "ns/trame");
+  for (size_t s = 0; s < LEDEffectBench::SIZE_COUNT; s++) {
+    length += snprintf(line + length, sizeof(line) - length, " %7u", LEDEffectBench::SIZES[s]);
+  }
+  TEST_MESSAGE(line);
+
+  for (size_t e = 0; e < LEDEffectRegistry::count(); e++) {
+    const LEDEffectDescriptor* effect = LEDEffectRegistry::at(e);
+    if (effect->id == LED_EFFECT_ANIMATION) {
+      continue;
+    }
+    length = snprintf(line, sizeof(line), "%-13s", effect->name);
+    for (size_t s = 0; s < LEDEffectBench::SIZE_COUNT; s++) {
+      uint32_t ns = LEDEffectBench::measureRender(effect, LEDEffectBench::SIZES[s], BENCH_FRAMES, pixels);
+      length += snprintf(line + length, sizeof(line) - length, " %7lu", (unsigned long)ns);
+    }
+    TEST_MESSAGE(line);
+  }
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_every_effect_is_registered);
+  RUN_TEST(test_golden_frames);
+  RUN_TEST(test_golden_frames_are_repeatable);
+  RUN_TEST(test_render_time_per_frame);
+  return UNITY_END();
+}
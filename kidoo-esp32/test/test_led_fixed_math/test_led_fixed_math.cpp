@@ -0,0 +1,218 @@
+/**
+ * Effets en virgule fixe (Q15) comparés à leur ancienne version float
+ *
+ *   pio test -e native -f test_led_fixed_math -v
+ *
+ * Les fonctions *Float ci-dessous reprennent le calcul float de LEDManager avant
+ * le passage en Q15 (sin() par LED pour NIGHTLIGHT, sin() et ease float pour
+ * BREATHE). Chaque composante rendue par l'effet Q15 doit rester à ±1 de la
+ * version float, pour toutes les tailles de bande et sur un cycle complet.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "models/common/managers/led/effects/led_effect.h"
+#include "models/common/managers/led/effects/led_effect_bench.h"
+#include "models/common/managers/led/led_fixed_math.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const uint16_t MAX_LEDS = LEDEffectBench::MAX_LEDS;
+static uint8_t fixedPixels[MAX_LEDS * 3];
+static uint8_t floatPixels[MAX_LEDS * 3];
+
+// ============================================
+// Références float (avant le passage en Q15)
+// ============================================
+
+static const uint32_t NIGHTLIGHT_CYCLE_MS = 6000;
+
+static void renderNightlightFloat(uint8_t* pixels, uint16_t count, uint32_t elapsedMs) {
+  const uint8_t BLUE_R = 30;
+  const uint8_t BLUE_G = 100;
+  const uint8_t BLUE_B = 255;
+  const uint8_t WHITE_R = 200;
+  const uint8_t WHITE_G = 220;
+  const uint8_t WHITE_B = 255;
+
+  uint32_t elapsed = elapsedMs % NIGHTLIGHT_CYCLE_MS;
+  float scrollOffset = ((float)elapsed / (float)NIGHTLIGHT_CYCLE_MS) * (float)(count * 2);
+
+  for (int i = 0; i < count; i++) {
+    float position = (float)i - scrollOffset;
+    float wave1 = sin((position / (float)count) * 2.0 * M_PI * 1.5) * 0.5 + 0.5;
+    float wave2 = sin((position / (float)count) * 2.0 * M_PI * 2.5 + (M_PI / 3.0)) * 0.5 + 0.5;
+    float wave3 = sin((position / (float)count) * 2.0 * M_PI * 4.0 + (M_PI / 2.0)) * 0.3 + 0.3;
+
+    float blueFactor = wave1 * 0.6 + wave3 * 0.4;
+    float whiteFactor = wave2 * 0.2;
+    float baseBlue = 0.3;
+    blueFactor = blueFactor * 0.7 + baseBlue;
+
+    float total = blueFactor + whiteFactor;
+    if (total > 1.0) {
+      blueFactor /= total;
+      whiteFactor /= total;
+    }
+
+    ledSetPixel(pixels, i,
+                (uint8_t)(BLUE_R * blueFactor + WHITE_R * whiteFactor),
+                (uint8_t)(BLUE_G * blueFactor + WHITE_G * whiteFactor),
+                (uint8_t)(BLUE_B * blueFactor + WHITE_B * whiteFactor));
+  }
+}
+
+static const uint8_t BREATHE_COLORS[][3] = {
+  {30, 100, 255}, {100, 150, 255}, {150, 100, 255}, {255, 100, 150},
+  {255, 150, 100}, {150, 255, 150}, {255, 200, 100}
+};
+static const uint32_t BREATHE_NUM_COLORS = sizeof(BREATHE_COLORS) / sizeof(BREATHE_COLORS[0]);
+static const uint32_t COLOR_CHANGE_INTERVAL_MS = 30000;
+static const uint32_t COLOR_TRANSITION_DURATION_MS = 2000;
+static const uint32_t BREATHE_CYCLE_MS = 3000;
+
+static void renderBreatheFloat(uint8_t* pixels, uint16_t count, uint32_t elapsedMs) {
+  uint32_t colorIndex = elapsedMs / COLOR_CHANGE_INTERVAL_MS;
+  const uint8_t* target = BREATHE_COLORS[colorIndex % BREATHE_NUM_COLORS];
+  const uint8_t* previous = BREATHE_COLORS[(colorIndex == 0 ? 0 : colorIndex - 1) % BREATHE_NUM_COLORS];
+
+  uint32_t transitionElapsed = elapsedMs % COLOR_CHANGE_INTERVAL_MS;
+  uint8_t currentR, currentG, currentB;
+  if (transitionElapsed < COLOR_TRANSITION_DURATION_MS) {
+    float transitionFactor = (float)transitionElapsed / (float)COLOR_TRANSITION_DURATION_MS;
+    float easedFactor = transitionFactor * transitionFactor * (3.0 - 2.0 * transitionFactor);
+    currentR = (uint8_t)(previous[0] + (target[0] - previous[0]) * easedFactor);
+    currentG = (uint8_t)(previous[1] + (target[1] - previous[1]) * easedFactor);
+    currentB = (uint8_t)(previous[2] + (target[2] - previous[2]) * easedFactor);
+  } else {
+    currentR = target[0];
+    currentG = target[1];
+    currentB = target[2];
+  }
+
+  uint32_t breatheElapsed = elapsedMs % BREATHE_CYCLE_MS;
+  float breatheFactor = sin((float)breatheElapsed / (float)BREATHE_CYCLE_MS * 2.0 * M_PI) * 0.35 + 0.65;
+  ledFill(pixels, count,
+          (uint8_t)(currentR * breatheFactor),
+          (uint8_t)(currentG * breatheFactor),
+          (uint8_t)(currentB * breatheFactor));
+}
+
+// ============================================
+// Comparaison
+// ============================================
+
+typedef void (*FloatRenderFn)(uint8_t* pixels, uint16_t count, uint32_t elapsedMs);
+
+// Écart maximal (par composante) entre l'effet Q15 et sa référence float
+static int maxDeviation(LEDEffect id, FloatRenderFn reference, uint32_t durationMs, uint32_t stepMs) {
+  const LEDEffectDescriptor* effect = LEDEffectRegistry::find(id);
+  TEST_ASSERT_NOT_NULL(effect);
+  LEDEffectParams params;
+  params.color = 0;
+
+  int worst = 0;
+  for (size_t s = 0; s < LEDEffectBench::SIZE_COUNT; s++) {
+    uint16_t count = LEDEffectBench::SIZES[s];
+    for (uint32_t t = 0; t < durationMs; t += stepMs) {
+      effect->render(fixedPixels, count, t, params);
+      reference(floatPixels, count, t);
+      for (uint16_t i = 0; i < count * 3; i++) {
+        int deviation = abs((int)fixedPixels[i] - (int)floatPixels[i]);
+        if (deviation > worst) {
+          worst = deviation;
+        }
+      }
+    }
+  }
+  return worst;
+}
+
+// Temps moyen d'une trame (ns) pour la version float
+static uint32_t measureFloat(FloatRenderFn reference, uint16_t count, uint32_t frames) {
+  unsigned long start = micros();
+  for (uint32_t f = 0; f < frames; f++) {
+    reference(floatPixels, count, f * 16);
+  }
+  return (uint32_t)((uint64_t)(micros() - start) * 1000 / frames);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_sine_table_matches_sin() {
+  int worst = 0;
+  for (uint32_t step = 0; step < 4096; step++) {
+    uint32_t phase = step << 20;
+    int expected = (int)lround(sin(phase * (2.0 * M_PI / 4294967296.0)) * 32767.0);
+    int deviation = abs(ledSinQ15(phase) - expected);
+    if (deviation > worst) {
+      worst = deviation;
+    }
+  }
+  // Interpolation linéaire entre 256 points : erreur < 0,1 % de l'amplitude
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(32, worst);
+}
+
+static void test_smoothstep_matches_float() {
+  for (uint32_t t = 0; t <= LED_Q15_ONE; t += 64) {
+    double x = t / 32768.0;
+    double expected = x * x * (3.0 - 2.0 * x) * 32768.0;
+    TEST_ASSERT_INT_WITHIN(2, (int)expected, ledSmoothstepQ15((uint16_t)t));
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, ledSmoothstepQ15(0));
+  TEST_ASSERT_EQUAL_UINT32(LED_Q15_ONE, ledSmoothstepQ15(LED_Q15_ONE));
+}
+
+static void test_nightlight_within_one_lsb_of_float() {
+  // Un cycle complet de défilement, toutes les tailles de bande
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, maxDeviation(LED_EFFECT_NIGHTLIGHT, renderNightlightFloat,
+                                                   NIGHTLIGHT_CYCLE_MS, 7));
+}
+
+static void test_breathe_within_one_lsb_of_float() {
+  // Deux changements de couleur complets (transitions comprises) sur plusieurs respirations
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, maxDeviation(LED_EFFECT_BREATHE, renderBreatheFloat,
+                                                   2 * COLOR_CHANGE_INTERVAL_MS + COLOR_TRANSITION_DURATION_MS, 3));
+}
+
+// Durées mesurées sur le PC : affichées pour comparaison, sans seuil (elles
+// dépendent de la machine et de sa charge). Les tests ±1 LSB font foi.
+static void test_report_fixed_and_float_timings() {
+  const uint32_t frames = 2000;
+  const struct {
+    LEDEffect id;
+    FloatRenderFn reference;
+  } cases[] = {
+    {LED_EFFECT_NIGHTLIGHT, renderNightlightFloat},
+    {LED_EFFECT_BREATHE, renderBreatheFloat}
+  };
+
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    const LEDEffectDescriptor* effect = LEDEffectRegistry::find(cases[c].id);
+    for (size_t s = 0; s < LEDEffectBench::SIZE_COUNT; s++) {
+      uint16_t count = LEDEffectBench::SIZES[s];
+      uint32_t fixedNs = LEDEffectBench::measureRender(effect, count, frames, fixedPixels);
+      uint32_t floatNs = measureFloat(cases[c].reference, count, frames);
+
+      char line[96];
+      snprintf(line, sizeof(line), "%-11s %3u LEDs: Q15 %6lu ns/trame, float %6lu ns/trame",
+               effect->name, count, (unsigned long)fixedNs, (unsigned long)floatNs);
+      TEST_MESSAGE(line);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_sine_table_matches_sin);
+  RUN_TEST(test_smoothstep_matches_float);
+  RUN_TEST(test_nightlight_within_one_lsb_of_float);
+  RUN_TEST(test_breathe_within_one_lsb_of_float);
+  RUN_TEST(test_report_fixed_and_float_timings);
+  return UNITY_END();
+}
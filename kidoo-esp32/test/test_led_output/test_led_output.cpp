@@ -0,0 +1,101 @@
+/**
+ * Sortie LED simulée (LED_OUTPUT_MOCK_DRIVER) sur PC
+ *
+ *   pio test -e native -f test_led_output -v
+ *
+ * Le driver est sélectionné par ledOutputDriver() comme sur la carte : les trames
+ * passent par l'interface LEDOutputDriver et sont enregistrées par le mock.
+ */
+
+#include <unity.h>
+#include "models/common/managers/led/output/led_output_mock.h"
+#include "models/common/managers/led/effects/led_effect.h"
+#include "models/model_config.h"
+
+static uint8_t frame[NUM_LEDS * 3];
+
+void setUp() {
+  LEDOutputMock::reset();
+  LEDOutputMock::setWireTiming(true);
+  ledOutputDriver()->begin(NUM_LEDS, 0);
+}
+
+void tearDown() {
+  ledOutputDriver()->end();
+}
+
+static void waitIdle(const LEDOutputDriver* output) {
+  while (output->isBusy()) {
+    delayMicroseconds(10);
+  }
+}
+
+static void test_mock_driver_is_selected() {
+  const LEDOutputDriver* output = ledOutputDriver();
+  TEST_ASSERT_EQUAL_PTR(&LED_OUTPUT_MOCK_DRIVER, output);
+  TEST_ASSERT_EQUAL_UINT32(NUM_LEDS, LEDOutputMock::getLedCount());
+  TEST_ASSERT_FALSE(output->begin(NUM_LEDS + 1, 0));
+}
+
+static void test_frames_are_recorded() {
+  const LEDOutputDriver* output = ledOutputDriver();
+  const LEDEffectDescriptor* effect = LEDEffectRegistry::find(LED_EFFECT_RAINBOW);
+  TEST_ASSERT_NOT_NULL(effect);
+  LEDEffectParams params;
+  params.color = 0;
+
+  for (uint32_t f = 0; f < 3; f++) {
+    effect->render(frame, NUM_LEDS, f * 500, params);
+    waitIdle(output);
+    TEST_ASSERT_TRUE(output->transmit(frame, NUM_LEDS));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, LEDOutputMock::getFrame(f), NUM_LEDS * 3);
+  }
+  TEST_ASSERT_EQUAL_UINT32(3, LEDOutputMock::getFrameCount());
+  TEST_ASSERT_EQUAL_PTR(LEDOutputMock::getFrame(2), LEDOutputMock::getLastFrame());
+  TEST_ASSERT_NULL(LEDOutputMock::getFrame(3));
+}
+
+static void test_busy_while_transmitting() {
+  const LEDOutputDriver* output = ledOutputDriver();
+  ledFill(frame, NUM_LEDS, 255, 0, 0);
+  TEST_ASSERT_TRUE(output->transmit(frame, NUM_LEDS));
+
+  // Une trame WS2812B de NUM_LEDS LEDs dure ~30 us par LED : la suivante est refusée
+  TEST_ASSERT_TRUE(output->isBusy());
+  ledFill(frame, NUM_LEDS, 0, 255, 0);
+  TEST_ASSERT_FALSE(output->transmit(frame, NUM_LEDS));
+  TEST_ASSERT_EQUAL_UINT32(1, LEDOutputMock::getRejectedCount());
+
+  waitIdle(output);
+  TEST_ASSERT_TRUE(output->transmit(frame, NUM_LEDS));
+  TEST_ASSERT_EQUAL_UINT32(2, LEDOutputMock::getFrameCount());
+  TEST_ASSERT_EQUAL_UINT8(255, LEDOutputMock::getLastFrame()[1]);
+
+  unsigned long gapUs = LEDOutputMock::getFrameTimeUs(1) - LEDOutputMock::getFrameTimeUs(0);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(NUM_LEDS * 30UL + 50, gapUs);
+}
+
+static void test_history_keeps_latest_frames() {
+  const LEDOutputDriver* output = ledOutputDriver();
+  LEDOutputMock::setWireTiming(false);
+  const uint32_t total = LEDOutputMock::HISTORY_SIZE + 10;
+  for (uint32_t f = 0; f < total; f++) {
+    ledFill(frame, NUM_LEDS, (uint8_t)f, 0, 0);
+    TEST_ASSERT_TRUE(output->transmit(frame, NUM_LEDS));
+  }
+  TEST_ASSERT_EQUAL_UINT32(total, LEDOutputMock::getFrameCount());
+  TEST_ASSERT_NULL(LEDOutputMock::getFrame(9));
+  TEST_ASSERT_EQUAL_UINT8(10, LEDOutputMock::getFrame(10)[0]);
+  TEST_ASSERT_EQUAL_UINT8(total - 1, LEDOutputMock::getLastFrame()[0]);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_mock_driver_is_selected);
+  RUN_TEST(test_frames_are_recorded);
+  RUN_TEST(test_busy_while_transmitting);
+  RUN_TEST(test_history_keeps_latest_frames);
+  return UNITY_END();
+}
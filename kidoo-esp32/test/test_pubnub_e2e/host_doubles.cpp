@@ -0,0 +1,116 @@
+#include "host_doubles.h"
+#include <time.h>
+#include "models/common/managers/led/led_manager.h"
+#include "models/common/managers/wifi/wifi_manager.h"
+#include "models/common/managers/rtc/rtc_manager.h"
+#include "models/common/managers/nfc/nfc_manager.h"
+#include "models/common/managers/serial/serial_commands.h"
+#include "models/common/managers/pubnub/pubnub_manager.h"
+
+HostLEDCalls hostLEDCalls;
+std::atomic<uint32_t> hostSerialCommands{0};
+
+// ============================================
+// LEDManager : appels comptés, pas de tâche LED
+// ============================================
+
+static uint8_t hostBrightness = 0;
+
+bool LEDManager::setColor(uint8_t r, uint8_t g, uint8_t b) {
+  (void)r;
+  (void)g;
+  (void)b;
+  hostLEDCalls.setColor++;
+  return true;
+}
+
+bool LEDManager::setBrightness(uint8_t brightness) {
+  hostBrightness = brightness;
+  hostLEDCalls.lastBrightness = brightness;
+  hostLEDCalls.setBrightness++;
+  return true;
+}
+
+bool LEDManager::setEffect(LEDEffect effect) {
+  (void)effect;
+  hostLEDCalls.setEffect++;
+  return true;
+}
+
+bool LEDManager::clear() {
+  hostLEDCalls.clear++;
+  return true;
+}
+
+#ifdef HAS_LED_EFFECT_ANIMATION
+bool LEDManager::playAnimation(const char* path) {
+  (void)path;
+  hostLEDCalls.setEffect++;
+  return true;
+}
+#endif
+
+uint8_t LEDManager::getCurrentBrightness() {
+  return hostBrightness;
+}
+
+void LEDManager::wakeUp() {}
+void LEDManager::preventSleep() {}
+void LEDManager::allowSleep() {}
+
+// ============================================
+// Réseau : le serveur local est toujours joignable
+// ============================================
+
+bool WiFiManager::isConnected() {
+  return true;
+}
+
+String WiFiManager::getLocalIP() {
+  return String("127.0.0.1");
+}
+
+int WiFiManager::getRSSI() {
+  return -50;
+}
+
+// ============================================
+// Matériel absent sur le PC
+// ============================================
+
+bool RTCManager::isAvailable() {
+  return false;
+}
+
+DateTime RTCManager::getDateTime() {
+  DateTime dt = {};
+  return dt;
+}
+
+uint32_t RTCManager::getUnixTime() {
+  return (uint32_t)time(nullptr);
+}
+
+bool NFCManager::isAvailable() {
+  return false;
+}
+
+void SerialCommands::processCommand(const String& command) {
+  (void)command;
+  hostSerialCommands++;
+}
+
+// ============================================
+// Accusés du banc de test
+// ============================================
+
+void hostPublishE2EAck(JsonObject message, unsigned long handlerUs) {
+  if (!message["e2e"].is<unsigned long>()) {
+    return;
+  }
+  char ack[128];
+  snprintf(ack, sizeof(ack),
+    "{\"type\":\"e2e-ack\",\"e2e\":%lu,\"handlerUs\":%lu,\"heap\":%u,\"minHeap\":%u}",
+    message["e2e"].as<unsigned long>(), handlerUs, ESP.getFreeHeap(), ESP.getMinFreeHeap());
+  PubNubManager::publish(ack, PUBLISH_PRIORITY_CRITICAL);
+}
@@ -0,0 +1,34 @@
+#ifndef TEST_PUBNUB_HOST_DOUBLES_H
+#define TEST_PUBNUB_HOST_DOUBLES_H
+
+/**
+ * Doubles des gestionnaires matériels appelés par les routes PubNub
+ * (LEDManager, WiFiManager, RTCManager, NFCManager, SerialCommands)
+ *
+ * Les appels LED sont comptés : le test vérifie que chaque commande rejouée
+ * par le serveur a bien atteint son handler.
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+
+struct HostLEDCalls {
+  std::atomic<uint32_t> setBrightness{0};
+  std::atomic<uint32_t> setColor{0};
+  std::atomic<uint32_t> setEffect{0};
+  std::atomic<uint32_t> clear{0};
+  std::atomic<uint8_t> lastBrightness{0};
+};
+
+extern HostLEDCalls hostLEDCalls;
+extern std::atomic<uint32_t> hostSerialCommands;
+
+/**
+ * Accusé de traitement d'une commande numérotée par le serveur local ("e2e"),
+ * publié dès que le handler a rendu la main : observateur de commandes
+ * installé par le test (PubNubManager::setCommandObserver)
+ */
+void hostPublishE2EAck(JsonObject message, unsigned long handlerUs);
+
+#endif // TEST_PUBNUB_HOST_DOUBLES_H
@@ -0,0 +1,307 @@
+/**
+ * Messagerie PubNub de bout en bout sur PC
+ *
+ *   pio test -e native_pubnub -f test_pubnub_e2e -v
+ *
+ * Le test lance le serveur local (tools/pubnub-standin/server.js, Node.js 18+)
+ * et y connecte le vrai PubNubManager : long poll, lecture des réponses au fil
+ * du socket, routes Dream, accusés e2e (observateur de commandes du test,
+ * host_doubles.cpp) publiés par le tampon de publication.
+ * Le serveur rejoue une trace et sort avec 0 si toutes les commandes ont été
+ * accusées. Sans Node.js, les tests sont ignorés.
+ */
+
+#include <unity.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "host_doubles.h"
+#include "models/common/managers/pubnub/pubnub_manager.h"
+
+// Répertoire du serveur, relatif à ce fichier (test/test_pubnub_e2e/)
+static std::string standinDir() {
+  std::string path = __FILE__;
+  for (int level = 0; level < 3; level++) {
+    size_t slash = path.find_last_of('/');
+    path = (slash == std::string::npos) ? "." : path.substr(0, slash);
+  }
+  return path + "/tools/pubnub-standin";
+}
+
+// Port du serveur : celui de PUBNUB_ORIGIN_HOST (platformio.ini)
+static const char* standinPort() {
+  const char* separator = strrchr(PUBNUB_ORIGIN_HOST, ':');
+  return separator != nullptr ? separator + 1 : "80";
+}
+
+/**
+ * Processus node server.js : sortie lue ligne par ligne dans un thread
+ */
+class StandinServer {
+public:
+  ~StandinServer() { stop(); }
+
+  // Démarrer le serveur et attendre qu'il écoute
+  bool start(const std::string& options) {
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) {
+      return false;
+    }
+    std::string command = "exec node '" + standinDir() + "/server.js' --port " + standinPort() +
+                          " --quiet --exit " + options + " 2>&1";
+    pid = fork();
+    if (pid == 0) {
+      dup2(pipeFds[1], STDOUT_FILENO);
+      close(pipeFds[0]);
+      close(pipeFds[1]);
+      execl("/bin/sh", "sh", "-c", command.c_str(), (char*)nullptr);
+      _exit(127);
+    }
+    close(pipeFds[1]);
+    if (pid < 0) {
+      close(pipeFds[0]);
+      return false;
+    }
+    reader = std::thread(&StandinServer::readOutput, this, pipeFds[0]);
+
+    std::unique_lock<std::mutex> guard(lock);
+    return changed.wait_for(guard, std::chrono::seconds(5), [this]() {
+      return ended || contains("Serveur PubNub local");
+    }) && !ended;
+  }
+
+  // Attendre la fin du serveur (rapport écrit) ; -1 si le délai est dépassé
+  int wait(uint32_t timeoutMs) {
+    int status = 0;
+    unsigned long start = millis();
+    while (waitpid(pid, &status, WNOHANG) == 0) {
+      if (millis() - start >= timeoutMs) {
+        stop();
+        return -1;
+      }
+      delay(50);
+    }
+    pid = -1;
+    if (reader.joinable()) {
+      reader.join();
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+  }
+
+  void stop() {
+    if (pid > 0) {
+      kill(pid, SIGTERM);
+      waitpid(pid, nullptr, 0);
+      pid = -1;
+    }
+    if (reader.joinable()) {
+      reader.join();
+    }
+  }
+
+  // Première ligne contenant text ("" si absente)
+  std::string find(const char* text) {
+    std::lock_guard<std::mutex> guard(lock);
+    for (const std::string& line : lines) {
+      if (line.find(text) != std::string::npos) {
+        return line;
+      }
+    }
+    return "";
+  }
+
+private:
+  void readOutput(int fd) {
+    std::string current;
+    char buffer[256];
+    ssize_t count;
+    while ((count = read(fd, buffer, sizeof(buffer))) > 0) {
+      for (ssize_t i = 0; i < count; i++) {
+        if (buffer[i] != '\n') {
+          current += buffer[i];
+          continue;
+        }
+        printf("%s\n", current.c_str());
+        std::lock_guard<std::mutex> guard(lock);
+        lines.push_back(current);
+        current.clear();
+        changed.notify_all();
+      }
+    }
+    close(fd);
+    std::lock_guard<std::mutex> guard(lock);
+    ended = true;
+    changed.notify_all();
+  }
+
+  bool contains(const char* text) const {
+    for (const std::string& line : lines) {
+      if (line.find(text) != std::string::npos) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  pid_t pid = -1;
+  std::thread reader;
+  std::mutex lock;
+  std::condition_variable changed;
+  std::vector<std::string> lines;
+  bool ended = false;
+};
+
+// Rapport du serveur ("Commandes: N envoyees, M accusees, K perdues, ...")
+// et compteurs de connexion du firmware pendant le rejeu
+struct TraceReport {
+  int exitCode;
+  unsigned sent;
+  unsigned acknowledged;
+  unsigned lost;
+  PubNubManager::ConnectionStats subscribe;
+  PubNubManager::ConnectionStats publish;
+};
+
+static PubNubManager::ConnectionStats statsDelta(const PubNubManager::ConnectionStats& after,
+                                                 const PubNubManager::ConnectionStats& before) {
+  PubNubManager::ConnectionStats delta = after;
+  delta.requests -= before.requests;
+  delta.reused -= before.reused;
+  delta.opened -= before.opened;
+  delta.retried -= before.retried;
+  return delta;
+}
+
+/**
+ * Rejouer une trace contre le PubNubManager
+ * Le rejeu commence au premier long poll (tt != 0) : connexion juste après le
+ * démarrage du serveur, déconnexion après son rapport.
+ */
+static TraceReport runTrace(const char* trace, const char* options) {
+  TraceReport report = {};
+  report.exitCode = -1;
+  StandinServer server;
+  std::string arguments = std::string("--hold 2000 --settle 5000 --trace '") + standinDir() +
+                          "/traces/" + trace + "' " + options;
+  if (!server.start(arguments)) {
+    TEST_FAIL_MESSAGE("le serveur local ne demarre pas");
+    return report;
+  }
+
+  PubNubManager::ConnectionStats subscribeBefore = PubNubManager::getSubscribeStats();
+  PubNubManager::ConnectionStats publishBefore = PubNubManager::getPublishStats();
+  TEST_ASSERT_TRUE(PubNubManager::connect());
+  report.exitCode = server.wait(60000);
+  PubNubManager::disconnect();
+  report.subscribe = statsDelta(PubNubManager::getSubscribeStats(), subscribeBefore);
+  report.publish = statsDelta(PubNubManager::getPublishStats(), publishBefore);
+
+  std::string line = server.find("Commandes:");
+  const char* counts = strstr(line.c_str(), "Commandes:");
+  if (counts != nullptr) {
+    sscanf(counts, "Commandes: %u envoyees, %u accusees, %u perdues",
+           &report.sent, &report.acknowledged, &report.lost);
+  }
+  for (const char* metric : {"Latence commande", "Debit:", "Duree handler", "Subscribe:"}) {
+    std::string found = server.find(metric);
+    if (!found.empty()) {
+      TEST_MESSAGE(found.c_str());
+    }
+  }
+  return report;
+}
+
+void setUp() {
+  if (system("node --version > /dev/null 2>&1") != 0) {
+    TEST_IGNORE_MESSAGE("Node.js absent : serveur local indisponible");
+  }
+}
+
+void tearDown() {}
+
+static void test_brightness_burst_all_acknowledged() {
+  uint32_t calls = hostLEDCalls.setBrightness;
+  TraceReport report = runTrace("brightness-burst.json", "");
+
+  TEST_ASSERT_EQUAL_INT(0, report.exitCode);
+  TEST_ASSERT_EQUAL_UINT(25, report.sent);
+  TEST_ASSERT_EQUAL_UINT(25, report.acknowledged);
+  TEST_ASSERT_EQUAL_UINT(0, report.lost);
+  // Chaque commande a atteint son handler ; la dernière (90 %) reste appliquée
+  TEST_ASSERT_EQUAL_UINT32(25, hostLEDCalls.setBrightness - calls);
+  TEST_ASSERT_EQUAL_UINT8((90 * 255 + 50) / 100, hostLEDCalls.lastBrightness);
+}
+
+static void test_dream_trace_chunked() {
+  uint32_t calls = hostLEDCalls.setBrightness;
+  TraceReport report = runTrace("dream-mixed.json", "--chunked");
+
+  TEST_ASSERT_EQUAL_INT(0, report.exitCode);
+  TEST_ASSERT_EQUAL_UINT(18, report.sent);
+  TEST_ASSERT_EQUAL_UINT(18, report.acknowledged);
+  TEST_ASSERT_EQUAL_UINT32(3, hostLEDCalls.setBrightness - calls);
+}
+
+static void printStats(const char* label, const PubNubManager::ConnectionStats& stats) {
+  char line[96];
+  snprintf(line, sizeof(line), "%s: %lu requetes, %lu reutilisees, %lu connexions ouvertes, %lu renvois",
+           label, (unsigned long)stats.requests, (unsigned long)stats.reused,
+           (unsigned long)stats.opened, (unsigned long)stats.retried);
+  TEST_MESSAGE(line);
+}
+
+static void test_keep_alive_reuses_connections() {
+  TraceReport report = runTrace("brightness-burst.json", "");
+  printStats("Subscribe", report.subscribe);
+  printStats("Publish", report.publish);
+
+  TEST_ASSERT_EQUAL_INT(0, report.exitCode);
+  // Une connexion par sens pour toute la trace (plus une si le serveur en ferme
+  // une pendant le rejeu) : les autres requêtes passent sur le socket ouvert.
+  // Au moins un poll par tour de la trace (1 s d'attente entre deux tours).
+  TEST_ASSERT_GREATER_THAN_UINT32(5, report.subscribe.requests);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(2, report.subscribe.opened);
+  TEST_ASSERT_EQUAL_UINT32(report.subscribe.requests - report.subscribe.opened, report.subscribe.reused);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, report.publish.requests);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(2, report.publish.opened);
+  TEST_ASSERT_EQUAL_UINT32(report.publish.requests - report.publish.opened, report.publish.reused);
+}
+
+static void test_close_opens_one_connection_per_request() {
+  TraceReport report = runTrace("brightness-burst.json", "--close");
+  printStats("Subscribe", report.subscribe);
+  printStats("Publish", report.publish);
+
+  // Connection: close après chaque réponse : rien à réutiliser, mais aucune commande perdue
+  TEST_ASSERT_EQUAL_INT(0, report.exitCode);
+  TEST_ASSERT_EQUAL_UINT(report.sent, report.acknowledged);
+  TEST_ASSERT_GREATER_THAN_UINT32(5, report.subscribe.requests);
+  TEST_ASSERT_EQUAL_UINT32(0, report.subscribe.reused);
+  TEST_ASSERT_EQUAL_UINT32(report.subscribe.requests, report.subscribe.opened);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, report.publish.requests);
+  TEST_ASSERT_EQUAL_UINT32(0, report.publish.reused);
+  TEST_ASSERT_EQUAL_UINT32(report.publish.requests, report.publish.opened);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  if (!PubNubManager::init()) {
+    printf("[TEST] PubNubManager::init() echoue\n");
+    return 1;
+  }
+  // Numéro de commande du serveur conservé, accusé après chaque handler
+  PubNubManager::keepMessageField("e2e");
+  PubNubManager::setCommandObserver(hostPublishE2EAck);
+  RUN_TEST(test_brightness_burst_all_acknowledged);
+  RUN_TEST(test_dream_trace_chunked);
+  RUN_TEST(test_keep_alive_reuses_connections);
+  RUN_TEST(test_close_opens_one_connection_per_request);
+  PubNubManager::printInfo();
+  return UNITY_END();
+}
@@ -0,0 +1,464 @@
+#!/usr/bin/env node
+/**
+ * Serveur PubNub local (banc de test)
+ *
+ * Remplace les points d'entrée REST utilisés par le firmware et le serveur :
+ * - GET  /subscribe/:sub/:channel/0/:tt          (long poll, comme ps.pndsn.com)
+ * - POST /publish/:pub/:sub/0/:channel/0         (message dans le corps)
+ * - GET  /publish/:pub/:sub/0/:channel/0/:msg    (message dans l'URL)
+ * - GET  /v2/history/sub-key/:sub/channel/:ch    (count, include_token, end)
+ *
+ * Avec --trace, rejoue une suite de commandes sur le channel du Kidoo et mesure
+ * la latence commande -> handler exécuté grâce aux accusés "e2e-ack" publiés
+ * par l'observateur de commandes du test sur PC (voir README.md).
+ *
+ * Aucune dépendance : node server.js --help
+ */
+
+'use strict';
+
+const http = require('http');
+const fs = require('fs');
+const path = require('path');
+
+// ============================================
+// Options
+// ============================================
+
+const DEFAULTS = {
+  port: 8090,
+  hold: 280000,      // Durée max d'un long poll sans message (ms), comme PubNub
+  chunked: false,    // Réponses subscribe en Transfer-Encoding: chunked
+  close: false,      // Connection: close après chaque réponse (pas de keep-alive)
+  trace: null,       // Fichier de trace à rejouer
+  channel: null,     // Channel cible (défaut : premier channel qui s'abonne)
+  settle: 5000,      // Attente des derniers accusés après la dernière commande (ms)
+  exit: false,       // Quitter après le rapport de la trace
+  quiet: false,      // Ne pas afficher chaque requête
+};
+
+function parseArgs(argv) {
+  const options = { ...DEFAULTS };
+  for (let i = 0; i < argv.length; i++) {
+    const arg = argv[i];
+    const next = () => argv[++i];
+    switch (arg) {
+      case '--port': options.port = parseInt(next(), 10); break;
+      case '--hold': options.hold = parseInt(next(), 10); break;
+      case '--chunked': options.chunked = true; break;
+      case '--close': options.close = true; break;
+      case '--trace': options.trace = next(); break;
+      case '--channel': options.channel = next(); break;
+      case '--settle': options.settle = parseInt(next(), 10); break;
+      case '--exit': options.exit = true; break;
+      case '--quiet': options.quiet = true; break;
+      case '--help':
+      case '-h':
+        printUsage();
+        process.exit(0);
+        break;
+      default:
+        console.error(`[STANDIN] Option inconnue: ${arg}`);
+        printUsage();
+        process.exit(1);
+    }
+  }
+  return options;
+}
+
+function printUsage() {
+  console.log(`Usage: node server.js [options]
+
+  --port <n>        Port d'écoute (défaut ${DEFAULTS.port})
+  --hold <ms>       Durée max d'un long poll sans message (défaut ${DEFAULTS.hold})
+  --chunked         Réponses subscribe en chunked (sinon Content-Length)
+  --close           Fermer la connexion après chaque réponse (pas de keep-alive)
+  --trace <fichier> Rejouer une trace de commandes (voir traces/)
+  --channel <nom>   Channel du Kidoo (défaut : premier channel qui s'abonne)
+  --settle <ms>     Attente des derniers accusés (défaut ${DEFAULTS.settle})
+  --exit            Quitter après le rapport de la trace
+  --quiet           Ne pas afficher chaque requête`);
+}
+
+const options = parseArgs(process.argv.slice(2));
+
+function log(message) {
+  if (!options.quiet) {
+    console.log(`[STANDIN] ${message}`);
+  }
+}
+
+// ============================================
+// Stockage des messages
+// ============================================
+
+// Timetoken PubNub : unités de 100 ns depuis l'epoch Unix (17 chiffres)
+let lastTimetoken = 0n;
+function nextTimetoken() {
+  let timetoken = BigInt(Date.now()) * 10000n;
+  if (timetoken <= lastTimetoken) {
+    timetoken = lastTimetoken + 1n;
+  }
+  lastTimetoken = timetoken;
+  return timetoken;
+}
+
+const channels = new Map();  // nom -> { messages: [{ timetoken, message }], waiters: Set }
+const HISTORY_MAX = 1000;
+
+function getChannel(name) {
+  let channel = channels.get(name);
+  if (!channel) {
+    channel = { messages: [], waiters: new Set() };
+    channels.set(name, channel);
+  }
+  return channel;
+}
+
+function storeMessage(name, message) {
+  const channel = getChannel(name);
+  const timetoken = nextTimetoken();
+  channel.messages.push({ timetoken, message });
+  if (channel.messages.length > HISTORY_MAX) {
+    channel.messages.shift();
+  }
+  // Répondre aux long polls en attente sur ce channel
+  for (const waiter of channel.waiters) {
+    waiter();
+  }
+  return timetoken;
+}
+
+function messagesAfter(name, timetoken) {
+  return getChannel(name).messages.filter((entry) => entry.timetoken > timetoken);
+}
+
+// ============================================
+// Statistiques
+// ============================================
+
+const stats = {
+  connections: 0,
+  subscribeRequests: 0,
+  subscribeTimeouts: 0,
+  publishRequests: 0,
+  publishMessages: 0,
+  publishBatches: 0,
+};
+
+// ============================================
+// Réponses HTTP
+// ============================================
+
+function sendJson(res, status, body, chunked) {
+  const text = JSON.stringify(body);
+  const headers = {
+    'Content-Type': 'text/javascript; charset="UTF-8"',
+    'Connection': options.close ? 'close' : 'keep-alive',
+  };
+  if (chunked) {
+    // Deux morceaux au moins, pour exercer le décodage chunked du firmware
+    res.writeHead(status, headers);
+    const middle = Math.floor(text.length / 2);
+    res.write(text.slice(0, middle));
+    res.end(text.slice(middle));
+  } else {
+    headers['Content-Length'] = Buffer.byteLength(text);
+    res.writeHead(status, headers);
+    res.end(text);
+  }
+}
+
+// ============================================
+// Subscribe (long poll)
+// ============================================
+
+function handleSubscribe(req, res, channelName, timetokenText) {
+  stats.subscribeRequests++;
+
+  // Premier subscribe : timetoken courant, sans attendre
+  if (timetokenText === '0') {
+    sendJson(res, 200, [[], (lastTimetoken || nextTimetoken()).toString()], options.chunked);
+    return;
+  }
+  harness.onSubscribe(channelName);
+
+  let timetoken;
+  try {
+    timetoken = BigInt(timetokenText);
+  } catch (error) {
+    sendJson(res, 400, { status: 400, error: true, message: 'Invalid Timetoken' }, false);
+    return;
+  }
+
+  const channel = getChannel(channelName);
+  let timer = null;
+
+  const respond = () => {
+    const pending = messagesAfter(channelName, timetoken);
+    if (pending.length === 0 && timer !== null) {
+      return;  // Réveil sans nouveau message : continuer d'attendre
+    }
+    channel.waiters.delete(respond);
+    clearTimeout(timer);
+    const next = pending.length > 0 ? pending[pending.length - 1].timetoken : timetoken;
+    if (pending.length === 0) {
+      stats.subscribeTimeouts++;
+    }
+    sendJson(res, 200, [pending.map((entry) => entry.message), next.toString()], options.chunked);
+  };
+
+  if (messagesAfter(channelName, timetoken).length > 0) {
+    respond();
+    return;
+  }
+
+  timer = setTimeout(() => {
+    timer = null;
+    respond();
+  }, options.hold);
+  channel.waiters.add(respond);
+  req.on('close', () => {
+    channel.waiters.delete(respond);
+    clearTimeout(timer);
+  });
+}
+
+// ============================================
+// Publish
+// ============================================
+
+function handlePublish(req, res, channelName, urlMessage) {
+  const finish = (text) => {
+    let message;
+    try {
+      message = JSON.parse(text);
+    } catch (error) {
+      sendJson(res, 400, [0, 'Invalid JSON', '0'], false);
+      return;
+    }
+    stats.publishRequests++;
+    const count = (message && message.type === 'batch' && Array.isArray(message.messages))
+      ? message.messages.length : 1;
+    stats.publishMessages += count;
+    if (count > 1) {
+      stats.publishBatches++;
+    }
+    const timetoken = storeMessage(channelName, message);
+    harness.onPublish(channelName, message);
+    log(`publish ${channelName}: ${text.length > 120 ? text.slice(0, 117) + '...' : text}`);
+    sendJson(res, 200, [1, 'Sent', timetoken.toString()], false);
+  };
+
+  if (urlMessage !== undefined) {
+    finish(decodeURIComponent(urlMessage));
+    return;
+  }
+  const chunks = [];
+  req.on('data', (chunk) => chunks.push(chunk));
+  req.on('end', () => finish(Buffer.concat(chunks).toString('utf8')));
+}
+
+// ============================================
+// History
+// ============================================
+
+function handleHistory(res, channelName, query) {
+  const count = Math.min(parseInt(query.get('count') || '100', 10), 100);
+  const includeToken = query.get('include_token') === 'true';
+  const end = query.get('end');
+  let entries = getChannel(channelName).messages;
+  if (end) {
+    const endToken = BigInt(end);
+    entries = entries.filter((entry) => entry.timetoken > endToken);
+  }
+  entries = entries.slice(-count);
+  const items = entries.map((entry) => (includeToken
+    ? { message: entry.message, timetoken: entry.timetoken.toString() }
+    : entry.message));
+  const first = entries.length > 0 ? entries[0].timetoken.toString() : '0';
+  const last = entries.length > 0 ? entries[entries.length - 1].timetoken.toString() : '0';
+  sendJson(res, 200, [items, first, last], false);
+}
+
+// ============================================
+// Rejeu de trace et mesures
+// ============================================
+
+function percentile(sorted, fraction) {
+  if (sorted.length === 0) {
+    return 0;
+  }
+  const index = Math.min(sorted.length - 1, Math.ceil(fraction * sorted.length) - 1);
+  return sorted[Math.max(0, index)];
+}
+
+function createHarness(tracePath) {
+  if (!tracePath) {
+    return { onSubscribe() {}, onPublish() {} };
+  }
+
+  const trace = JSON.parse(fs.readFileSync(tracePath, 'utf8'));
+  const steps = Array.isArray(trace) ? trace : trace.steps;
+  const repeat = Array.isArray(trace) ? 1 : (trace.repeat || 1);
+  const name = (!Array.isArray(trace) && trace.name) || path.basename(tracePath);
+  if (!Array.isArray(steps) || steps.length === 0) {
+    throw new Error(`Trace vide: ${tracePath}`);
+  }
+
+  let targetChannel = options.channel;
+  let started = false;
+  let nextId = 1;
+  let firstSentAt = 0n;
+  let lastAckAt = 0n;
+  const pending = new Map();  // e2e -> instant d'émission (hrtime ns)
+  const latenciesMs = [];
+  const handlerUs = [];
+  let minHeap = Infinity;
+  let duplicates = 0;
+  const publishAtStart = { ...stats };
+
+  const sleep = (ms) => new Promise((resolve) => setTimeout(resolve, ms));
+
+  async function replay() {
+    console.log(`[STANDIN] Trace "${name}": ${steps.length} etapes x ${repeat} sur ${targetChannel}`);
+    Object.assign(publishAtStart, stats);
+    for (let round = 0; round < repeat; round++) {
+      for (const step of steps) {
+        if (step.delay) {
+          await sleep(step.delay);
+        }
+        const id = nextId++;
+        const message = { ...step.message, e2e: id };
+        const sentAt = process.hrtime.bigint();
+        if (firstSentAt === 0n) {
+          firstSentAt = sentAt;
+        }
+        pending.set(id, sentAt);
+        storeMessage(targetChannel, message);
+      }
+    }
+    // Derniers accusés
+    const deadline = Date.now() + options.settle;
+    while (pending.size > 0 && Date.now() < deadline) {
+      await sleep(50);
+    }
+    report();
+    if (options.exit) {
+      process.exit(pending.size === 0 ? 0 : 2);
+    }
+  }
+
+  function onAck(ack) {
+    const sentAt = pending.get(ack.e2e);
+    if (sentAt === undefined) {
+      duplicates++;
+      return;
+    }
+    pending.delete(ack.e2e);
+    lastAckAt = process.hrtime.bigint();
+    latenciesMs.push(Number(lastAckAt - sentAt) / 1e6);
+    if (typeof ack.handlerUs === 'number') {
+      handlerUs.push(ack.handlerUs);
+    }
+    if (typeof ack.minHeap === 'number') {
+      minHeap = Math.min(minHeap, ack.minHeap);
+    }
+  }
+
+  function report() {
+    const total = nextId - 1;
+    const sorted = [...latenciesMs].sort((a, b) => a - b);
+    const handlers = [...handlerUs].sort((a, b) => a - b);
+    const elapsedS = lastAckAt > firstSentAt ? Number(lastAckAt - firstSentAt) / 1e9 : 0;
+    const fmt = (value) => value.toFixed(1);
+    console.log('');
+    console.log(`========== Trace ${name} ==========`);
+    console.log(`[STANDIN] Commandes: ${total} envoyees, ${sorted.length} accusees, ${pending.size} perdues, ${duplicates} accuses inattendus`);
+    if (sorted.length > 0) {
+      console.log(`[STANDIN] Latence commande -> handler (ms): min ${fmt(sorted[0])}, mediane ${fmt(percentile(sorted, 0.5))}, p95 ${fmt(percentile(sorted, 0.95))}, max ${fmt(sorted[sorted.length - 1])}`);
+    }
+    if (elapsedS > 0) {
+      console.log(`[STANDIN] Debit: ${(sorted.length / elapsedS).toFixed(1)} commandes/s (${elapsedS.toFixed(2)} s)`);
+    }
+    if (handlers.length > 0) {
+      console.log(`[STANDIN] Duree handler (us): mediane ${percentile(handlers, 0.5)}, max ${handlers[handlers.length - 1]}`);
+    }
+    if (minHeap !== Infinity) {
+      console.log(`[STANDIN] Heap appareil: minimum libre ${minHeap} octets`);
+    }
+    console.log(`[STANDIN] Publications appareil: ${stats.publishRequests - publishAtStart.publishRequests} requetes, ` +
+      `${stats.publishMessages - publishAtStart.publishMessages} messages, ${stats.publishBatches - publishAtStart.publishBatches} lots`);
+    console.log(`[STANDIN] Subscribe: ${stats.subscribeRequests - publishAtStart.subscribeRequests} requetes, ` +
+      `${stats.connections - publishAtStart.connections} connexions TCP ouvertes`);
+    console.log('='.repeat(22 + name.length));
+  }
+
+  return {
+    // Le rejeu démarre au premier long poll du Kidoo (après le handshake tt=0)
+    onSubscribe(channelName) {
+      if (started) {
+        return;
+      }
+      if (targetChannel === null) {
+        targetChannel = channelName;
+      }
+      if (channelName === targetChannel) {
+        started = true;
+        setTimeout(() => replay().catch((error) => {
+          console.error(`[STANDIN] Erreur de rejeu: ${error.message}`);
+          process.exit(1);
+        }), 500);
+      }
+    },
+
+    onPublish(channelName, message) {
+      if (channelName !== targetChannel || !message || typeof message !== 'object') {
+        return;
+      }
+      const messages = message.type === 'batch' && Array.isArray(message.messages) ? message.messages : [message];
+      for (const item of messages) {
+        if (item && item.type === 'e2e-ack') {
+          onAck(item);
+        }
+      }
+    },
+  };
+}
+
+const harness = createHarness(options.trace);
+
+// ============================================
+// Serveur
+// ============================================
+
+const server = http.createServer((req, res) => {
+  const url = new URL(req.url, 'http://localhost');
+  const parts = url.pathname.split('/').filter((part) => part.length > 0);
+  log(`${req.method} ${url.pathname}`);
+
+  if (parts[0] === 'subscribe' && parts.length >= 5 && req.method === 'GET') {
+    handleSubscribe(req, res, parts[2], parts[4]);
+  } else if (parts[0] === 'publish' && parts.length >= 6) {
+    handlePublish(req, res, parts[4], req.method === 'GET' ? parts[6] : undefined);
+  } else if (parts[0] === 'v2' && parts[1] === 'history' && parts.length >= 6 && req.method === 'GET') {
+    handleHistory(res, parts[5], url.searchParams);
+  } else {
+    sendJson(res, 404, { status: 404, error: true, message: 'Not Found' }, false);
+  }
+});
+
+server.on('connection', () => {
+  stats.connections++;
+});
+
+// Le long poll dure jusqu'à --hold : ne pas couper la connexion avant
+server.keepAliveTimeout = options.hold + 10000;
+server.headersTimeout = options.hold + 15000;
+server.requestTimeout = 0;
+
+server.listen(options.port, () => {
+  console.log(`[STANDIN] Serveur PubNub local sur le port ${options.port}` +
+    `${options.chunked ? ' (chunked)' : ''}${options.close ? ' (sans keep-alive)' : ''}`);
+  console.log(`[STANDIN] Firmware: -DPUBNUB_ORIGIN_HOST=\\"<ip>:${options.port}\\"`);
+});
@@ -4,8 +4,12 @@
  * 
  * Cette route est publique (sans authentification) car l'ESP32 n'a pas de token JWT.
  * L'adresse MAC sert d'identifiant unique pour retrouver le Kidoo.
+ *
+ * La réponse porte un ETag (empreinte du contenu) : l'ESP32 le renvoie dans
+ * If-None-Match et reçoit 304 sans corps si sa configuration est à jour.
  */
 
+import { createHash } from 'crypto';
 import { NextRequest, NextResponse } from 'next/server';
 import { prisma } from '@/lib/prisma';
 import { createErrorResponse, createSuccessResponse } from '@/lib/api-response';
@@ -18,6 +22,26 @@ function normalizeMacAddress(mac: string): string {
   return mac.replace(/[:.\-]/g, '').toUpperCase();
 }
 
+/**
+ * ETag fort calculé sur le contenu de la réponse
+ */
+function computeEtag(data: unknown): string {
+  const hash = createHash('sha1').update(JSON.stringify(data)).digest('base64url');
+  return `"${hash}"`;
+}
+
+/**
+ * Vérifie si l'un des ETags de If-None-Match correspond (ETags faibles W/ acceptés,
+ * un proxy peut affaiblir l'ETag en compressant la réponse)
+ */
+function etagMatches(ifNoneMatch: string | null, etag: string): boolean {
+  if (!ifNoneMatch) return false;
+  return ifNoneMatch
+    .split(',')
+    .map((candidate) => candidate.trim().replace(/^W\//, ''))
+    .some((candidate) => candidate === etag || candidate === '*');
+}
+
 /**
  * GET /api/kidoos/config/[macAddress]
  * Récupère les configurations bedtime et wakeup pour l'ESP32
@@ -49,8 +73,9 @@ export async function GET(
       include: {
         configDream: {
           include: {
-            bedtimeSchedules: true,
-            wakeupSchedules: true,
+            // Ordre stable : l'ETag ne doit dépendre que du contenu
+            bedtimeSchedules: { orderBy: { weekday: 'asc' } },
+            wakeupSchedules: { orderBy: { weekday: 'asc' } },
           },
         },
       },
@@ -158,7 +183,15 @@ export async function GET(
       };
     }
 
-    return createSuccessResponse(response);
+    // Configuration inchangée depuis la dernière synchronisation de l'ESP32
+    const etag = computeEtag(response);
+    if (etagMatches(request.headers.get('if-none-match'), etag)) {
+      return new NextResponse(null, { status: 304, headers: { ETag: etag } });
+    }
+
+    const successResponse = createSuccessResponse(response);
+    successResponse.headers.set('ETag', etag);
+    return successResponse;
   } catch (error) {
     console.error('Erreur lors de la récupération de la configuration:', error);
     return createErrorResponse('INTERNAL_ERROR', 500, {
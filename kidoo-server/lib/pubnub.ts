@@ -245,6 +245,31 @@ export async function fetchKidooHistory(
   return history?.map(item => item.message) ?? null;
 }
 
+/**
+ * Cherche un message d'un type donné, y compris dans un lot publié par le Kidoo
+ * ({ type: 'batch', messages: [...] } : plusieurs messages en une seule publication)
+ * @returns Le message le plus récent de ce type, ou null
+ */
+function findMessageOfType(
+  msg: unknown,
+  messageType: string
+): Record<string, unknown> | null {
+  if (!msg || typeof msg !== 'object') {
+    return null;
+  }
+  const record = msg as Record<string, unknown>;
+  if (record.type === 'batch' && Array.isArray(record.messages)) {
+    for (let i = record.messages.length - 1; i >= 0; i--) {
+      const found = findMessageOfType(record.messages[i], messageType);
+      if (found) {
+        return found;
+      }
+    }
+    return null;
+  }
+  return record.type === messageType ? record : null;
+}
+
 /**
  * Attend un message de type spécifique sur un channel avec timeout
  * @param macAddress L'adresse MAC du Kidoo
@@ -287,10 +312,10 @@ export async function waitForMessage(
       // On cherche le DERNIER message du type attendu (le plus récent)
       for (let i = messages.length - 1; i >= 0; i--) {
         const item = messages[i];
-        const msg = item.message;
-        if (msg && typeof msg === 'object' && msg.type === messageType) {
+        const found = findMessageOfType(item.message, messageType);
+        if (found) {
           console.log(`[PUBNUB] Message '${messageType}' trouvé (timetoken: ${item.timetoken})`);
-          return msg;
+          return found;
         }
       }
       